@@ -0,0 +1,160 @@
+/* Local Header */
+#include "CoarseCostField.hpp"
+
+/* IndexedHeap */
+#include "../rover-pathfinding-module/IndexedHeap.hpp"
+
+/* NewDijkstras */
+#include "../rover-pathfinding-module/NewDijkstras.hpp"
+
+/* C++ Standard Libraries */
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace mempa
+{
+    /**
+     * @brief Bytes a build holds per level pixel: the elevations, the costs and the frontier.
+     *
+     * @return std::size_t
+     */
+    std::size_t CoarseCostField::buildBytesPerCell() noexcept
+    {
+        return sizeof(float) + sizeof(double) + IndexedHeap::bytes_per_index();
+    }
+
+    /**
+     * @brief Pick the finest pyramid level whose build fits @ref MAX_BUILD_CELLS and a memory budget.
+     *
+     * @param elevationRaster DEM whose levels are considered.
+     * @param memoryBytes Most the build may hold, 0 for no limit.
+     * @return int Level to build on, or -1 if none fits.
+     */
+    int CoarseCostField::levelFor(const DemHandler &elevationRaster, const std::size_t memoryBytes) noexcept
+    {
+        for (int level = 0; level < elevationRaster.getLevelCount(); ++level)
+        {
+            const std::size_t cells = static_cast<std::size_t>(elevationRaster.getXSize(level)) * elevationRaster.getYSize(level); /* Pixels of the level. */
+            if (cells <= MAX_BUILD_CELLS && (memoryBytes == 0 || cells * buildBytesPerCell() <= memoryBytes))
+            {
+                return level;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Find the costs to a goal over one pyramid level of a DEM.
+     *
+     * @param elevationRaster DEM to read the level from.
+     * @param goalPosition Full resolution (x, y) goal.
+     * @param maxSlope Maximum slope in degrees the rover can climb.
+     * @param level Pyramid level to search, usually from @ref levelFor.
+     *
+     * @throws The level does not exist or has more than @ref MAX_BUILD_CELLS pixels, or the read fails.
+     */
+    void CoarseCostField::build(const DemHandler &elevationRaster, const std::pair<int, int> goalPosition, const float maxSlope, const int level)
+    {
+        if (level < 0 || level >= elevationRaster.getLevelCount())
+        {
+            throw std::invalid_argument("build: no such pyramid level");
+        }
+        const int levelXSize = elevationRaster.getXSize(level);
+        const int levelYSize = elevationRaster.getYSize(level);
+        if (static_cast<std::size_t>(levelXSize) * levelYSize > MAX_BUILD_CELLS)
+        {
+            throw std::invalid_argument("build: level is too large to search as a whole");
+        }
+        const Raster2D<float> heights = elevationRaster.readRectangleChunk({{0, 0}, {levelXSize - 1, levelYSize - 1}}, 0, nullptr, level);
+
+        this->level = level;
+        scale = elevationRaster.getLevelScale(level);
+        goal = goalPosition;
+        this->maxSlope = maxSlope;
+        const std::pair<int, int> levelGoal(std::clamp(static_cast<int>(goalPosition.first / scale.first), 0, levelXSize - 1),
+                                            std::clamp(static_cast<int>(goalPosition.second / scale.second), 0, levelYSize - 1));
+        search(heights.view(), levelGoal, static_cast<float>(elevationRaster.getImageResolution(level)));
+    }
+
+    /**
+     * @brief Find the costs to a goal over a raster held in memory, taken as full resolution.
+     *
+     * @param heights Elevations of the whole raster.
+     * @param goalPosition (x, y) goal.
+     * @param maxSlope Maximum slope in degrees the rover can climb.
+     * @param pixelSize Pixel size in meters, as given to the searches.
+     *
+     * @throws The raster has more than @ref MAX_BUILD_CELLS pixels or the goal is outside it.
+     */
+    void CoarseCostField::build(const RasterView<const float> &heights, const std::pair<int, int> goalPosition, const float maxSlope, const float pixelSize)
+    {
+        if (static_cast<std::size_t>(heights.getXSize()) * heights.getYSize() > MAX_BUILD_CELLS)
+        {
+            throw std::invalid_argument("build: raster is too large to search as a whole");
+        }
+        if (goalPosition.first < 0 || goalPosition.first >= heights.getXSize() || goalPosition.second < 0 || goalPosition.second >= heights.getYSize())
+        {
+            throw std::invalid_argument("build: goal is outside the raster");
+        }
+        level = 0;
+        scale = {1.0, 1.0};
+        goal = goalPosition;
+        this->maxSlope = maxSlope;
+        search(heights, goalPosition, pixelSize);
+    }
+
+    /**
+     * @brief Run Dijkstra's back from the goal over a level, adding step costs in the order DStarLite adds them so that at full resolution its costs agree exactly.
+     *
+     * @param heights Elevations of the whole level.
+     * @param levelGoal (x, y) of the goal on the level.
+     * @param pixelSize Pixel size of the level in meters.
+     */
+    void CoarseCostField::search(const RasterView<const float> &heights, const std::pair<int, int> levelGoal, const float pixelSize)
+    {
+        constexpr double UNREACHED = std::numeric_limits<double>::infinity();
+        xSize = heights.getXSize();
+        ySize = heights.getYSize();
+        const int cells = xSize * ySize; /* Level pixels. */
+
+        costs.assign(cells, UNREACHED);
+        IndexedHeap frontier; /* Reached pixels that are not finalized yet. */
+        frontier.reset(cells);
+        const int goalIndex = levelGoal.second * xSize + levelGoal.first;
+        costs[goalIndex] = 0.0;
+        frontier.push_or_decrease(goalIndex, 0.0);
+        while (!frontier.empty())
+        {
+            const int index = frontier.pop();
+            const int row = index / xSize;
+            const int col = index % xSize;
+            for (int step = 0; step < 8; ++step)
+            {
+                const int neighbourRow = row + NewDijkstras::ROW_STEPS[step];
+                const int neighbourCol = col + NewDijkstras::COL_STEPS[step];
+                if (neighbourRow < 0 || neighbourRow >= ySize || neighbourCol < 0 || neighbourCol >= xSize)
+                {
+                    continue;
+                }
+                const bool diagonal = NewDijkstras::ROW_STEPS[step] != 0 && NewDijkstras::COL_STEPS[step] != 0;
+                const double rise = std::abs(heights[row][col] - heights[neighbourRow][neighbourCol]);
+                if (!NewDijkstras::step_navigable(rise, diagonal, maxSlope, pixelSize))
+                {
+                    continue;
+                }
+                const int neighbour = neighbourRow * xSize + neighbourCol;
+                const double reached = costs[index] + NewDijkstras::calculate_distance_between_nodes(diagonal, rise, pixelSize);
+                if (reached < costs[neighbour])
+                {
+                    costs[neighbour] = reached;
+                    frontier.push_or_decrease(neighbour, reached);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+/* mempa::DemHandler */
+#include "DemHandler.hpp"
+
+/* mempa::Raster2D */
+#include "Raster2D.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace mempa
+{
+    /**
+     * @brief Least cost to one goal from every pixel of a pyramid level, as an estimate of the cost to go from cells beyond a chunk.
+     *
+     * @details The costs are found by one Dijkstra's search back from the goal over the whole level, with the slope check and step cost NewDijkstras uses at the level's pixel size. Averaging pixels together smooths slopes, so above level 0 the costs are an estimate rather than a bound, and walls or cliffs narrower than a level pixel can vanish. Wider ones keep their detours, which a flat-ground estimate cannot see.
+     *
+     * Full resolution cells are looked up by interpolating the four nearest level pixels. Pixels the goal cannot be reached from at the level are left out of the interpolation, since the full resolution terrain may still connect them.
+     */
+    class CoarseCostField
+    {
+    private:
+        std::vector<double> costs;                 /* Row-major cost to the goal from each pixel of the level, infinite if unreachable. */
+        int xSize = 0;                             /* Level width in pixels. */
+        int ySize = 0;                             /* Level height in pixels. */
+        int level = 0;                             /* Pyramid level the costs were found on. */
+        std::pair<double, double> scale{1.0, 1.0}; /* Full resolution pixels per level pixel in x and y. */
+        std::pair<int, int> goal{0, 0};            /* Full resolution (x, y) cell the costs lead to. */
+        float maxSlope = 0.0f;                     /* Slope limit in degrees the costs were found for. */
+
+        void search(const RasterView<const float> &heights, std::pair<int, int> levelGoal, float pixelSize);
+
+    protected:
+        /* CoarseCostField is not designed to be subclassed. */
+
+    public:
+        inline static constexpr std::size_t MAX_BUILD_CELLS = std::size_t(1) << 20; /* Most pixels a level may have, about 17 MB of search state. */
+
+        static std::size_t buildBytesPerCell() noexcept;
+        static int levelFor(const DemHandler &elevationRaster, std::size_t memoryBytes) noexcept;
+        void build(const DemHandler &elevationRaster, std::pair<int, int> goalPosition, float maxSlope, int level);
+        void build(const RasterView<const float> &heights, std::pair<int, int> goalPosition, float maxSlope, float pixelSize);
+
+        inline bool empty() const noexcept;
+        inline bool fits(std::pair<int, int> goalPosition, float maxSlope) const noexcept;
+        inline int getLevel() const noexcept;
+        inline int getXSize() const noexcept;
+        inline int getYSize() const noexcept;
+        inline std::size_t getBytes() const noexcept;
+        inline double getCost(int x, int y) const noexcept;
+    };
+}
+
+#include "CoarseCostField.inl"
@@ -0,0 +1,126 @@
+/* Local Header */
+#include "CoarseCostField.hpp"
+
+/* C++ Standard Libraries */
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+namespace mempa
+{
+    /**
+     * @brief Check whether any costs have been found.
+     *
+     * @return true Nothing has been built.
+     * @return false
+     */
+    inline bool CoarseCostField::empty() const noexcept
+    {
+        return costs.empty();
+    }
+
+    /**
+     * @brief Check whether the costs were found for a goal and slope limit.
+     *
+     * @param goalPosition Full resolution (x, y) goal.
+     * @param maxSlope Slope limit in degrees.
+     * @return true The field was built for exactly these.
+     * @return false
+     */
+    inline bool CoarseCostField::fits(const std::pair<int, int> goalPosition, const float maxSlope) const noexcept
+    {
+        return !empty() && goalPosition == goal && maxSlope == this->maxSlope;
+    }
+
+    /**
+     * @brief Get the pyramid level the costs were found on.
+     *
+     * @return int Level, 0 for full resolution.
+     */
+    inline int CoarseCostField::getLevel() const noexcept
+    {
+        return level;
+    }
+
+    /**
+     * @brief Get the width of the level the costs cover.
+     *
+     * @return int Number of pixels per row.
+     */
+    inline int CoarseCostField::getXSize() const noexcept
+    {
+        return xSize;
+    }
+
+    /**
+     * @brief Get the height of the level the costs cover.
+     *
+     * @return int Number of pixels per column.
+     */
+    inline int CoarseCostField::getYSize() const noexcept
+    {
+        return ySize;
+    }
+
+    /**
+     * @brief Get the bytes the costs hold for as long as the field is kept.
+     *
+     * @return std::size_t
+     */
+    inline std::size_t CoarseCostField::getBytes() const noexcept
+    {
+        return costs.size() * sizeof(double);
+    }
+
+    /**
+     * @brief Estimate the cost to the goal from a full resolution cell.
+     *
+     * @param x Full resolution column.
+     * @param y Full resolution row.
+     * @return double Costs of the four nearest level pixels the goal can be reached from, interpolated by distance, or infinite if it can be reached from none.
+     */
+    inline double CoarseCostField::getCost(const int x, const int y) const noexcept
+    {
+        const double levelX = (x + 0.5) / scale.first - 0.5;  /* Column in level pixels, 0 at the first pixel's centre. */
+        const double levelY = (y + 0.5) / scale.second - 0.5; /* Row in level pixels, 0 at the first pixel's centre. */
+        const int left = std::clamp(static_cast<int>(std::floor(levelX)), 0, xSize - 1);
+        const int top = std::clamp(static_cast<int>(std::floor(levelY)), 0, ySize - 1);
+        const int right = std::min(left + 1, xSize - 1);
+        const int bottom = std::min(top + 1, ySize - 1);
+        const double xWeight = std::clamp(levelX - left, 0.0, 1.0); /* Share of the right column. */
+        const double yWeight = std::clamp(levelY - top, 0.0, 1.0);  /* Share of the bottom row. */
+
+        const int corners[4][2] = {{left, top}, {right, top}, {left, bottom}, {right, bottom}};
+        const double weights[4] = {(1.0 - xWeight) * (1.0 - yWeight), xWeight * (1.0 - yWeight), (1.0 - xWeight) * yWeight, xWeight * yWeight};
+        double weighted = 0.0;    /* Sum of reachable corner costs times their weights. */
+        double totalWeight = 0.0; /* Sum of reachable corner weights. */
+        bool reachable = false;   /* Whether any corner reaches the goal. */
+        for (int corner = 0; corner < 4; ++corner)
+        {
+            const double cost = costs[static_cast<std::size_t>(corners[corner][1]) * xSize + corners[corner][0]];
+            if (cost != std::numeric_limits<double>::infinity())
+            {
+                weighted += weights[corner] * cost;
+                totalWeight += weights[corner];
+                reachable = true;
+            }
+        }
+        if (!reachable)
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+        /* A reachable corner can carry no weight when the cell sits on its far edge. */
+        if (totalWeight <= 0.0)
+        {
+            double nearest = std::numeric_limits<double>::infinity();
+            for (const auto &corner : corners)
+            {
+                nearest = std::min(nearest, costs[static_cast<std::size_t>(corner[1]) * xSize + corner[0]]);
+            }
+            return nearest;
+        }
+        return weighted / totalWeight;
+    }
+}
@@ -3,7 +3,6 @@
 
 /* libgdal-dev */
 #include <gdal_priv.h>
-#include <ogr_spatialref.h>
 
 /* C++ Standard Libraries */
 #include <limits>
@@ -12,13 +11,17 @@
 #include <vector>
 #include <utility>
 #include <stdexcept>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
 
 namespace mempa
 {
     /**
      * @brief Construct a new Dem Handler:: Dem Handler object
      *
-     * @param pszFilename Filepath to the DEM raster to be read.
+     * @param pszFilename Filepath to the DEM raster to be read, or a directory or manifest of rasters to read as one mosaic.
 
      * @throws Failure to perform GDAL functions.
      *
@@ -28,6 +31,60 @@ namespace mempa
      */
     DemHandler::DemHandler(const char *const pszFilename)
         : pszFilename(pszFilename)
+    {
+        /* A directory or manifest is read as one raster stitched from many files. Its metadata comes from the files' own sidecars. */
+        if (DemMosaic::isMosaicPath(this->pszFilename))
+        {
+            mosaic = std::make_unique<DemMosaic>(this->pszFilename);
+            metadata.describe(*mosaic);
+            applyMetadata();
+            buildLevels();
+            return;
+        }
+
+        /* Prefer a prepared DEM, which is mapped with no decode step. Fall back to GDAL when there is none. */
+        std::string sourceFilepath = this->pszFilename; /* File the values are read from. */
+        if (PreparedDem::isUsableFor(this->pszFilename))
+        {
+            sourceFilepath = PreparedDem::preparedPathFor(this->pszFilename);
+        }
+        if (PreparedDem::isPreparedPath(sourceFilepath.c_str()))
+        {
+            openPreparedDem(sourceFilepath.c_str());
+        }
+
+        /* A matching sidecar replaces opening, parsing and scanning the raster. GDAL is then left alone until the first tile read. */
+        if (!metadata.load(sourceFilepath.c_str()))
+        {
+            if (preparedDem)
+            {
+                metadata.describe(*preparedDem);
+            }
+            else
+            {
+                openGdalDataset();
+                metadata.describe(*poDataset, ELEVATION_BAND);
+            }
+
+            try
+            {
+                metadata.save(sourceFilepath.c_str());
+            }
+            catch (const std::runtime_error &)
+            {
+                /* The sidecar is only a cache. Without write access the raster is described again next run. */
+            }
+        }
+        applyMetadata();
+        buildLevels();
+    }
+
+    /**
+     * @brief Open the DEM through GDAL.
+     *
+     * @throws Failure to perform GDAL functions.
+     */
+    void DemHandler::openGdalDataset()
     {
         /* Initialize all GDAL operations. */
         GDALAllRegister();
@@ -46,31 +103,145 @@ namespace mempa
             throw std::runtime_error("DemHandler: GetRasterBand() error");
         }
 
-#if DEMHANDLER_MINMAX
-        /* Calculate the minimum and maximum values in the raster. First parameter is 0 for exact calculation, set to 1 for approximate. Causes a delay in runtime while statistics are calculated. */
-        if (poBand->ComputeRasterMinMax(0, elevationMinMax) != CE_None)
+        /* The first handle also serves tile reads, so a single-threaded run never opens a second one. */
+        idleDatasets.push_back(poDataset.get());
+    }
+
+    /**
+     * @brief Copy the raster layout and georeferencing out of the metadata.
+     */
+    void DemHandler::applyMetadata()
+    {
+        rasterXSize = metadata.getXSize();
+        rasterYSize = metadata.getYSize();
+        std::copy(metadata.getGeoTransform(), metadata.getGeoTransform() + GEOTRANSFORM_SIZE, adfGeoTransform);
+        poProjection = metadata.getProjectionWkt();
+
+        if (preparedDem)
         {
-            throw std::runtime_error("DemHandler: ComputeRasterMinMax() error");
+            tileXSize = preparedDem->getTileXSize();
+            tileYSize = preparedDem->getTileYSize();
+            return;
         }
-#endif
 
-        /* Load the GeoTransform metadata from the dataset. */
-        if (poDataset->GetGeoTransform(adfGeoTransform) != CE_None)
+        /* Align cached tiles to the raster's natural blocks. Strip-organized rasters get their strips split and grouped into roughly square tiles. */
+        tileXSize = std::min(std::max(1, metadata.getBlockXSize()), MAX_TILE_DIMENSION);
+        tileYSize = std::max(1, metadata.getBlockYSize());
+        if (tileYSize < MIN_TILE_DIMENSION)
         {
-            throw std::runtime_error("DemHandler: GetGeoTransform() error");
+            tileYSize *= (MIN_TILE_DIMENSION + tileYSize - 1) / tileYSize;
         }
+    }
 
-        /* Get the CRS projection reference from the dataset. */
-        poProjection = poDataset->GetProjectionRef();
-        if (poProjection == nullptr || poProjection[0] == '\0')
+    /**
+     * @brief Take a dataset handle that no other thread is reading through, opening a new one if all are busy.
+     *
+     * @return GDALDataset* Handle to read through. Give it back with @ref releaseDataset.
+     *
+     * @throws Failure to perform GDAL functions.
+     */
+    GDALDataset *DemHandler::acquireDataset() const
+    {
         {
-            throw std::runtime_error("DemHandler: GetProjectionRef() error");
+            const std::lock_guard<std::mutex> poolLock(datasetPoolMutex);
+            if (!idleDatasets.empty())
+            {
+                GDALDataset *const dataset = idleDatasets.back(); /* Most recently used idle handle. */
+                idleDatasets.pop_back();
+                return dataset;
+            }
         }
 
-        /* Initialize the OGRSpatialReference with the CRS Projection. */
-        if (CRS.importFromWkt(poProjection) != OGRERR_NONE)
+        /* Open outside the lock so other threads keep reading while this one opens. Registering drivers again is cheap, and needed when a sidecar let the constructor skip GDAL. */
+        GDALAllRegister();
+        GDALDatasetUniquePtr extraDataset(GDALDataset::FromHandle(GDALOpen(this->pszFilename, GA_ReadOnly))); /* New handle for this read. */
+        if (!extraDataset || !extraDataset->GetRasterBand(ELEVATION_BAND))
         {
-            throw std::runtime_error("DemHandler: importFromWkt() error");
+            throw std::runtime_error("acquireDataset: GDALOpen() error");
+        }
+
+        GDALDataset *const dataset = extraDataset.get();
+        const std::lock_guard<std::mutex> poolLock(datasetPoolMutex);
+        extraDatasets.push_back(std::move(extraDataset));
+        return dataset;
+    }
+
+    /**
+     * @brief Return a handle taken with @ref acquireDataset to the pool.
+     *
+     * @param dataset Handle to return.
+     */
+    void DemHandler::releaseDataset(GDALDataset *const dataset) const
+    {
+        const std::lock_guard<std::mutex> poolLock(datasetPoolMutex);
+        idleDatasets.push_back(dataset);
+    }
+
+    /**
+     * @brief Map a DEM prepared by `mempa-prep`.
+     *
+     * @param preparedFilepath Filepath to the prepared DEM.
+     *
+     * @throws Failure to map or validate the prepared DEM.
+     */
+    void DemHandler::openPreparedDem(const char *const preparedFilepath)
+    {
+        preparedDem = std::make_unique<PreparedDem>(preparedFilepath);
+    }
+
+    /**
+     * @brief Choose whether tiles are cached as 16-bit codes instead of floats, halving the memory each cached tile takes.
+     *
+     * @details Each tile gets its own offset and scale, so the error depends on the local elevation range rather than the whole dataset. Tiles already cached keep their storage. Full resolution tiles of a prepared DEM are read from the mapping and never quantized.
+     *
+     * @param enabled True to quantize tiles as they are cached.
+     */
+    void DemHandler::setQuantizedStorage(const bool enabled)
+    {
+        quantizedStorage = enabled;
+    }
+
+    /**
+     * @brief Work out the size of every pyramid level and which of them the raster file already stores as overviews.
+     *
+     * @details Level n is level n - 1 halved and rounded up, down to a single pixel. A GDAL overview serves a level when its size matches exactly; every other level is averaged from the level below on demand.
+     */
+    void DemHandler::buildLevels()
+    {
+        levelSizes.assign(1, std::pair<int, int>(rasterXSize, rasterYSize));
+        while (static_cast<int>(levelSizes.size()) < MAX_LEVEL_COUNT && (levelSizes.back().first > 1 || levelSizes.back().second > 1))
+        {
+            levelSizes.emplace_back((levelSizes.back().first + 1) / 2, (levelSizes.back().second + 1) / 2);
+        }
+
+        overviewIndices.assign(levelSizes.size(), -1);
+        const std::vector<std::pair<int, int>> &overviewSizes = metadata.getOverviewSizes(); /* Reduced resolution copies stored in the file. */
+        for (size_t overview = 0; overview < overviewSizes.size(); ++overview)
+        {
+            for (size_t level = 1; level < levelSizes.size(); ++level)
+            {
+                if (overviewIndices[level] < 0 && levelSizes[level] == overviewSizes[overview])
+                {
+                    overviewIndices[level] = static_cast<int>(overview);
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Check that a pyramid level exists.
+     *
+     * @param level Pyramid level to check.
+     * @param caller Name of the calling function, used in the error message.
+     *
+     * @throws std::out_of_range The level is negative or past the smallest level.
+     */
+    void DemHandler::validateLevel(const int level, const char *const caller) const
+    {
+        if (level < 0 || level >= getLevelCount())
+        {
+            throw std::out_of_range(std::string(caller) + ": invalid pyramid level");
         }
     }
 
@@ -80,15 +251,18 @@ namespace mempa
      * @param imgCoordinate A pair of integer image coordinates.
      * @param buffer The value used for the general size of the output chunk of elevation data.
      * @param relativeCoordinate Optional parameter to reflect the local vector index of the image coordinate.
+     * @param level Pyramid level to read from. Coordinates and buffer are in pixels of that level.
      *
-     * @return std::vector<std::vector<float>> Elevation values.
+     * @return Raster2D<float> Elevation values, with the origin set to the global coordinate of the chunk's top left corner.
      *
-     * @throws Failure to allocate memory or read raster values.
+     * @throws Failure to allocate memory or read raster values, or an invalid level.
      * 
      * @author Ryan Wagster <rywa2447@colorado.edu>
      */
-    std::vector<std::vector<float>> DemHandler::readSquareChunk(const std::pair<int, int> imgCoordinate, const int buffer, std::pair<int, int> *relativeCoordinate) const
+    Raster2D<float> DemHandler::readSquareChunk(const std::pair<int, int> imgCoordinate, const int buffer, std::pair<int, int> *relativeCoordinate, const int level) const
     {
+        validateLevel(level, "readSquareChunk");
+
         /* Get the X and Y coordiantes from the pair. */
         const int xCenter = imgCoordinate.first;  /* Input X ordinate. */
         const int yCenter = imgCoordinate.second; /* Input Y ordinate. */
@@ -96,26 +270,16 @@ namespace mempa
         /* Ensure the area to read is within raster bounds. */
         const int xOff = std::max(0, xCenter - buffer);                      /* Left X offset. */
         const int yOff = std::max(0, yCenter - buffer);                      /* Bottom Y offset. */
-        const int xEnd = std::min(poBand->GetXSize(), xCenter + buffer + 1); /* Right X offset. */
-        const int yEnd = std::min(poBand->GetYSize(), yCenter + buffer + 1); /* Top Y offset. */
+        const int xEnd = std::min(getXSize(level), xCenter + buffer + 1); /* Right X offset. */
+        const int yEnd = std::min(getYSize(level), yCenter + buffer + 1); /* Top Y offset. */
 
         /* Get size of in-boundary chunk to read. */
         const int xSize = xEnd - xOff; /* Total X size to be read. */
         const int ySize = yEnd - yOff; /* Total Y size to be read. */
 
-        /* Read raster data into 1D vector of floats. */
-        std::vector<float> vScanline(xSize * ySize); /* Vector to hold RasterIO read. */
-        if (poBand->RasterIO(GF_Read, xOff, yOff, xSize, ySize, vScanline.data(), xSize, ySize, GDT_Float32, 0, 0) != CE_None)
-        {
-            throw std::runtime_error("readSquareChunk: RasterIO() error");
-        }
-
-        /* Build a 2D vector of vectors of floats from the 1D vector. */
-        std::vector<std::vector<float>> rasterVector(ySize, std::vector<float>(xSize)); /* Vector to hold RasterIO read in 2D indexing. */
-        for (int rowIndex = 0; rowIndex < ySize; ++rowIndex)                            /* Current row to be copied. */
-        {
-            std::copy(vScanline.begin() + rowIndex * xSize, vScanline.begin() + (rowIndex + 1) * xSize, rasterVector[rowIndex].begin());
-        }
+        /* Read raster data straight into one contiguous chunk. */
+        Raster2D<float> rasterChunk(xSize, ySize, std::pair<int, int>(xOff, yOff)); /* Chunk to hold the cached tile reads. */
+        readWindow(xOff, yOff, xSize, ySize, rasterChunk.data(), level);
 
         /* Modify the input pair to hold the input coordinates as vector indices. */
         if (relativeCoordinate != nullptr)
@@ -123,8 +287,8 @@ namespace mempa
             *relativeCoordinate = std::pair<int, int>(xCenter - xOff, yCenter - yOff);
         }
 
-        /* Return 2D vector of floats. */
-        return rasterVector;
+        /* Return the contiguous chunk of floats. */
+        return rasterChunk;
     }
 
     /**
@@ -135,28 +299,29 @@ namespace mempa
      * @param imgCoordinate A pair of integer image coordinates.
      * @param radius The value used for the general size of the output chunk of elevation data.
      * @param relativeCoordinate Optional parameter to reflect the local vector index of the image coordinate.
+     * @param level Pyramid level to read from. Coordinates and radius are in pixels of that level.
      *
-     * @return std::vector<std::vector<float>> Elevation values.
+     * @return Raster2D<float> Elevation values, with the origin set to the global coordinate of the chunk's top left corner.
      *
-     * @throw Failure to read raster values.
+     * @throw Failure to read raster values, or an invalid level.
      * 
      * @author Ryan Wagster <rywa2447@colorado.edu>
      */
-    std::vector<std::vector<float>> DemHandler::readCircleChunk(const std::pair<int, int> imgCoordinate, const int radius, std::pair<int, int> *relativeCoordinate) const
+    Raster2D<float> DemHandler::readCircleChunk(const std::pair<int, int> imgCoordinate, const int radius, std::pair<int, int> *relativeCoordinate, const int level) const
     {
-        /* Ensure that the initial 2D vector of floats is valid. */
-        std::vector<std::vector<float>> rasterVector = readSquareChunk(imgCoordinate, radius, relativeCoordinate);
-        if (rasterVector.empty())
+        /* Ensure that the initial chunk of floats is valid. */
+        Raster2D<float> rasterChunk = readSquareChunk(imgCoordinate, radius, relativeCoordinate, level);
+        if (rasterChunk.empty())
         {
             throw std::runtime_error("readCircleChunk: readSquareChunk() error");
         }
 
         /* Set up values for distance calculations. */
-        const int xVec = static_cast<int>(rasterVector.front().size()); /* Size of each row. */
-        const int yVec = static_cast<int>(rasterVector.size());         /* Size of each column. */
-        const int xCenter = xVec / 2;                                   /* X center ordinate, assuming square chunk. */
-        const int yCenter = yVec / 2;                                   /* Y center ordinate, assuming square chunk. */
-        const int radiusSquared = radius * radius;                      /* Hypotenuse for pythagorean theorem. */
+        const int xVec = rasterChunk.getXSize(); /* Size of each row. */
+        const int yVec = rasterChunk.getYSize(); /* Size of each column. */
+        const int xCenter = xVec / 2;              /* X center ordinate, assuming square chunk. */
+        const int yCenter = yVec / 2;              /* Y center ordinate, assuming square chunk. */
+        const int radiusSquared = radius * radius; /* Hypotenuse for pythagorean theorem. */
 
         /* For each coordinate in the chunk, change to not a number float if outside the radius. */
         for (int row = 0; row < yVec; ++row)
@@ -167,13 +332,13 @@ namespace mempa
                 int yDistance = (row - yCenter) * (row - yCenter); /* Second length for pythagorean theorem. */
                 if (xDistance + yDistance > radiusSquared)
                 {
-                    rasterVector[row][col] = std::numeric_limits<float>::quiet_NaN();
+                    rasterChunk[row][col] = std::numeric_limits<float>::quiet_NaN();
                 }
             }
         }
 
-        /* Return 2D vector of floats with not a number float corners to resemble a circle of values. */
-        return rasterVector;
+        /* Return the chunk of floats with not a number float corners to resemble a circle of values. */
+        return rasterChunk;
     }
 
     /**
@@ -184,15 +349,18 @@ namespace mempa
      * @param imgCoordinates A pair of pairs of integer coordinates.
      * @param buffer The value used for the general size of the output chunk of elevation data.
      * @param relativeCoordinates Optional parameter to reflect the local vector index of each image coordinate.
+     * @param level Pyramid level to read from. Coordinates and buffer are in pixels of that level.
      *
-     * @return std::vector<std::vector<float>> Elevation values.
+     * @return Raster2D<float> Elevation values, with the origin set to the global coordinate of the chunk's top left corner.
      *
-     * @throws Failure to allocate memory or read raster values.
+     * @throws Failure to allocate memory or read raster values, or an invalid level.
      * 
      * @author Ryan Wagster <rywa2447@colorado.edu>
      */
-    std::vector<std::vector<float>> DemHandler::readRectangleChunk(const std::pair<std::pair<int, int>, std::pair<int, int>> imgCoordinates, const int buffer, std::pair<std::pair<int, int>, std::pair<int, int>> *relativeCoordinates) const
+    Raster2D<float> DemHandler::readRectangleChunk(const std::pair<std::pair<int, int>, std::pair<int, int>> imgCoordinates, const int buffer, std::pair<std::pair<int, int>, std::pair<int, int>> *relativeCoordinates, const int level) const
     {
+        validateLevel(level, "readRectangleChunk");
+
         /* Get X and Y coordinates from both pairs. */
         const int xCenter1 = imgCoordinates.first.first;   /* First coordinate X. */
         const int yCenter1 = imgCoordinates.first.second;  /* First coordinate Y.*/
@@ -202,26 +370,16 @@ namespace mempa
         /* Build boundaries from raster size and offsets from both coordinates. */
         const int xOff = std::max(0, std::min(xCenter1, xCenter2) - buffer);                      /* Left X offset. */
         const int yOff = std::max(0, std::min(yCenter1, yCenter2) - buffer);                      /* Bottom Y offset. */
-        const int xEnd = std::min(poBand->GetXSize(), std::max(xCenter1, xCenter2) + buffer + 1); /* Right X offset. */
-        const int yEnd = std::min(poBand->GetYSize(), std::max(yCenter1, yCenter2) + buffer + 1); /* Top Y offset. */
+        const int xEnd = std::min(getXSize(level), std::max(xCenter1, xCenter2) + buffer + 1); /* Right X offset. */
+        const int yEnd = std::min(getYSize(level), std::max(yCenter1, yCenter2) + buffer + 1); /* Top Y offset. */
 
         /* Get size of in-boundary chunk to read. */
         const int xSize = xEnd - xOff; /* Total X size to be read. */
         const int ySize = yEnd - yOff; /* Total Y size to be read. */
 
-        /* Read raster data within our chunk into the 1D vector. */
-        std::vector<float> vScanline(xSize * ySize); /* Vector to hold RasterIO read. */
-        if (poBand->RasterIO(GF_Read, xOff, yOff, xSize, ySize, vScanline.data(), xSize, ySize, GDT_Float32, 0, 0) != CE_None)
-        {
-            throw std::runtime_error("readRectangleChunk: RasterIO() error");
-        }
-
-        /* Build a 2D vector of vectors of floats from the 1D vector. */
-        std::vector<std::vector<float>> rasterVector(ySize, std::vector<float>(xSize)); /* Vector to hold RasterIO read in 2D indexing. */
-        for (int rowIndex = 0; rowIndex < ySize; ++rowIndex)                            /* Current row to be copied. */
-        {
-            std::copy(vScanline.begin() + rowIndex * xSize, vScanline.begin() + (rowIndex + 1) * xSize, rasterVector[rowIndex].begin());
-        }
+        /* Read raster data within our chunk straight into one contiguous chunk. */
+        Raster2D<float> rasterChunk(xSize, ySize, std::pair<int, int>(xOff, yOff)); /* Chunk to hold the cached tile reads. */
+        readWindow(xOff, yOff, xSize, ySize, rasterChunk.data(), level);
 
         /* Modify the input pair to hold the input coordinates as vector indices. */
         if (relativeCoordinates != nullptr)
@@ -230,14 +388,110 @@ namespace mempa
             relativeCoordinates->second = std::pair<int, int>(xCenter2 - xOff, yCenter2 - yOff);
         }
 
-        /* Return 2D vector of floats. */
-        return rasterVector;
+        /* Return the contiguous chunk of floats. */
+        return rasterChunk;
+    }
+
+    /**
+     * @brief Creates a rectangular chunk like @ref readRectangleChunk, held as 16-bit codes with an offset and scale fitted to the chunk.
+     *
+     * @details Values go straight from the cached tiles into codes, so no float copy of the chunk is made. When every tile under the chunk shares one codec that is no more than ElevationCodec::REUSE_SLACK times coarser than a fitted one, the chunk takes it and copies the tile codes unchanged, adding no error.
+     *
+     * @param imgCoordinates A pair of pairs of integer image coordinates.
+     * @param buffer The value used for the general size of the output chunk of elevation data.
+     *
+     * @return ElevationChunk Elevation codes, with the origin set to the global coordinate of the chunk's top left corner.
+     *
+     * @throws Failure to allocate memory or read raster values.
+     */
+    ElevationChunk DemHandler::readQuantizedChunk(const std::pair<std::pair<int, int>, std::pair<int, int>> imgCoordinates, const int buffer) const
+    {
+        return encodeWindow(imgCoordinates, buffer, nullptr);
+    }
+
+    /**
+     * @brief Creates a rectangular chunk like @ref readRectangleChunk, held as 16-bit codes of a given codec.
+     *
+     * @details Lets a chunk read in pieces keep one codec. Values outside the codec's range are clamped, which shows in the chunk's error.
+     *
+     * @param imgCoordinates A pair of pairs of integer image coordinates.
+     * @param buffer The value used for the general size of the output chunk of elevation data.
+     * @param codec Offset and scale to encode with.
+     *
+     * @return ElevationChunk Elevation codes, with the origin set to the global coordinate of the chunk's top left corner.
+     *
+     * @throws Failure to allocate memory or read raster values.
+     */
+    ElevationChunk DemHandler::readQuantizedChunk(const std::pair<std::pair<int, int>, std::pair<int, int>> imgCoordinates, const int buffer, const ElevationCodec &codec) const
+    {
+        return encodeWindow(imgCoordinates, buffer, &codec);
+    }
+
+    /**
+     * @brief Find the lowest and highest elevation in a rectangle, clipped like @ref readRectangleChunk.
+     *
+     * @param imgCoordinates A pair of pairs of integer image coordinates.
+     * @param buffer The value used for the general size of the rectangle.
+     *
+     * @return std::pair<double, double> Lowest and highest valid elevation, as decoded from the tiles, or (infinity, -infinity) if every value is nodata.
+     *
+     * @throws Failure to read raster values.
+     */
+    std::pair<double, double> DemHandler::getElevationRange(const std::pair<std::pair<int, int>, std::pair<int, int>> imgCoordinates, const int buffer) const
+    {
+        const int xOff = std::max(0, std::min(imgCoordinates.first.first, imgCoordinates.second.first) - buffer);              /* Left X offset. */
+        const int yOff = std::max(0, std::min(imgCoordinates.first.second, imgCoordinates.second.second) - buffer);            /* Top Y offset. */
+        const int xEnd = std::min(getXSize(), std::max(imgCoordinates.first.first, imgCoordinates.second.first) + buffer + 1);   /* Right X offset. */
+        const int yEnd = std::min(getYSize(), std::max(imgCoordinates.first.second, imgCoordinates.second.second) + buffer + 1); /* Bottom Y offset. */
+
+        const WindowRange range = readWindowRange(xOff, yOff, xEnd - xOff, yEnd - yOff);
+        return std::pair<double, double>(range.minimum, range.maximum);
+    }
+
+    /**
+     * @brief Read a rectangle clipped like @ref readRectangleChunk as codes, of a given codec or of one fitted to it.
+     *
+     * @param imgCoordinates A pair of pairs of integer image coordinates.
+     * @param buffer The value used for the general size of the output chunk of elevation data.
+     * @param codec Offset and scale to encode with, or nullptr to fit them to the rectangle.
+     *
+     * @return ElevationChunk Elevation codes, whose error is the tile error so far plus what encoding them added.
+     *
+     * @throws Failure to allocate memory or read raster values.
+     */
+    ElevationChunk DemHandler::encodeWindow(const std::pair<std::pair<int, int>, std::pair<int, int>> imgCoordinates, const int buffer, const ElevationCodec *const codec) const
+    {
+        const int xOff = std::max(0, std::min(imgCoordinates.first.first, imgCoordinates.second.first) - buffer);              /* Left X offset. */
+        const int yOff = std::max(0, std::min(imgCoordinates.first.second, imgCoordinates.second.second) - buffer);            /* Top Y offset. */
+        const int xEnd = std::min(getXSize(), std::max(imgCoordinates.first.first, imgCoordinates.second.first) + buffer + 1);   /* Right X offset. */
+        const int yEnd = std::min(getYSize(), std::max(imgCoordinates.first.second, imgCoordinates.second.second) + buffer + 1); /* Bottom Y offset. */
+
+        ElevationCodec chunkCodec; /* Codec the chunk is encoded with. */
+        if (codec != nullptr)
+        {
+            chunkCodec = *codec;
+        }
+        else
+        {
+            const WindowRange range = readWindowRange(xOff, yOff, xEnd - xOff, yEnd - yOff);
+            const bool reuseTileCodec = range.sharesTileCodec && range.tileCodec.suits(range.minimum, range.maximum);
+            chunkCodec = reuseTileCodec ? range.tileCodec : ElevationCodec::fit(range.minimum, range.maximum);
+        }
+
+        Raster2D<std::int16_t> codeChunk(xEnd - xOff, yEnd - yOff, std::pair<int, int>(xOff, yOff)); /* Chunk to hold the encoded tile reads. */
+        const float encodeError = readWindow(xOff, yOff, xEnd - xOff, yEnd - yOff, codeChunk.data(), chunkCodec);
+        float previousError = maxChunkError;
+        while (encodeError > previousError && !maxChunkError.compare_exchange_weak(previousError, encodeError))
+        {
+        }
+        return ElevationChunk(std::move(codeChunk), chunkCodec, getMaxQuantizationError() + encodeError);
     }
 
     /**
      * @brief Transform a latitide, longitude (x, y) pair of (double) geographical coordinates into the corresponding pair of (integer) image pixel (x, y) coordinates.
      *
      * @param geoCoordinate Coordinate pair of doubles.
+     * @param level Pyramid level whose pixel grid the result is in.
      *
      * @return std::pair<int, int> Pixel-based image coordinates.
      *
@@ -245,10 +499,11 @@ namespace mempa
      * 
      * @author Ryan Wagster <rywa2447@colorado.edu>
      */
-    std::pair<int, int> DemHandler::transformCoordinates(const std::pair<double, double> geoCoordinate) const noexcept
+    std::pair<int, int> DemHandler::transformCoordinates(const std::pair<double, double> geoCoordinate, const int level) const noexcept
     {
-        const int xPixelCoordinate = static_cast<int>((geoCoordinate.first - adfGeoTransform[0]) / adfGeoTransform[1]);  /* Longitude ordinate minus upper-left pixel X coordinate divided by pixel width. */
-        const int yPixelCoordinate = static_cast<int>((geoCoordinate.second - adfGeoTransform[3]) / adfGeoTransform[5]); /* Latitude ordinate minus upper left pixel Y coordinate divided by pixel height. */
+        const std::pair<double, double> levelScale = getLevelScale(level); /* Full resolution pixels per level pixel. */
+        const int xPixelCoordinate = static_cast<int>((geoCoordinate.first - adfGeoTransform[0]) / (adfGeoTransform[1] * levelScale.first));  /* Longitude ordinate minus upper-left pixel X coordinate divided by pixel width. */
+        const int yPixelCoordinate = static_cast<int>((geoCoordinate.second - adfGeoTransform[3]) / (adfGeoTransform[5] * levelScale.second)); /* Latitude ordinate minus upper left pixel Y coordinate divided by pixel height. */
         return std::pair<int, int>(xPixelCoordinate, yPixelCoordinate);
     }
 
@@ -256,28 +511,33 @@ namespace mempa
      * @brief Transform a pair of integer coordinates into the corresponding latitide, longitude (x, y) pair of double geographical coordinates.
      *
      * @param imgCoordinate Coordinate pair of integers.
+     * @param level Pyramid level whose pixel grid imgCoordinate is in.
      * @return std::pair<double, double> Georeferenced coordinates.
      * 
      * @author Ryan Wagster <rywa2447@colorado.edu>
      */
-    std::pair<double, double> DemHandler::revertCoordinates(const std::pair<int, int> imgCoordinate) const noexcept
+    std::pair<double, double> DemHandler::revertCoordinates(const std::pair<int, int> imgCoordinate, const int level) const noexcept
     {
-        const double xGeoCoordinate = (static_cast<double>(imgCoordinate.first) * adfGeoTransform[1]) + adfGeoTransform[0];
-        const double yGeoCoordinate = (static_cast<double>(imgCoordinate.second) * adfGeoTransform[5]) + adfGeoTransform[3];
+        const std::pair<double, double> levelScale = getLevelScale(level); /* Full resolution pixels per level pixel. */
+        const double xGeoCoordinate = (static_cast<double>(imgCoordinate.first) * levelScale.first * adfGeoTransform[1]) + adfGeoTransform[0];
+        const double yGeoCoordinate = (static_cast<double>(imgCoordinate.second) * levelScale.second * adfGeoTransform[5]) + adfGeoTransform[3];
         return std::pair<double, double>(xGeoCoordinate, yGeoCoordinate);
     }
 
     /**
      * @brief Gets the spatial resolution of the raster.
      *
+     * @param level Pyramid level to get the resolution of.
      * @return double Pixel resolution in meters.
      *
-     * @throw Non-Square pixels (inequal height and width) are invalid.
+     * @throw Non-Square pixels (inequal height and width) are invalid, as is an invalid level.
      * 
      * @author Ryan Wagster <rywa2447@colorado.edu>
      */
-    double DemHandler::getImageResolution() const
+    double DemHandler::getImageResolution(const int level) const
     {
+        validateLevel(level, "getImageResolution");
+
         /* Get the west-east pixel resolution and the north-south pixel resolution. */
         const double pixelWidth = adfGeoTransform[1];  /* West-East pixel resolution. */
         const double pixelHeight = adfGeoTransform[5]; /* North-South pixel resolution. */
@@ -289,11 +549,11 @@ namespace mempa
         }
 
         /* Return the spatial resolution in meters. Modify based on the CRS. */
-        double metersResolution = pixelWidth; /* Pixel resolution in meters. */
-        if (CRS.IsGeographic())
+        double metersResolution = pixelWidth * getLevelScale(level).first; /* Pixel resolution in meters. */
+        if (metadata.isGeographic())
         {
             /* Convert from degrees to meters. */
-            const double metersPerDegree = (M_PI * CRS.GetSemiMajor()) / DEM_180; /* Converstion constant for degrees to meters. Pi times the CRS's semi-major axis divided by 180. */
+            const double metersPerDegree = (M_PI * metadata.getSemiMajorAxis()) / DEM_180; /* Converstion constant for degrees to meters. Pi times the CRS's semi-major axis divided by 180. */
             metersResolution *= metersPerDegree;
         }
 
@@ -301,15 +561,421 @@ namespace mempa
         return metersResolution;
     }
 
-    float mempa::DemHandler::getValue(int x, int y) const {
-        // Implement your method here
-        // Example implementation:
-        if (x >= 0 && x < poBand->GetXSize() && y >= 0 && y < poBand->GetYSize()) {
-            float value;
-            if (poBand->RasterIO(GF_Read, x, y, 1, 1, &value, 1, 1, GDT_Float32, 0, 0) == CE_None) {
-                return value;
+    /**
+     * @brief Get the elevation value at a single image coordinate.
+     *
+     * @param x The x-coordinate (column).
+     * @param y The y-coordinate (row).
+     * @param level Pyramid level the coordinate is in.
+     *
+     * @return float The elevation value, or 0 if the coordinate is outside the raster.
+     *
+     * @throws Failure to read raster values, or an invalid level.
+     */
+    float DemHandler::getValue(const int x, const int y, const int level) const
+    {
+        validateLevel(level, "getValue");
+        if (x < 0 || x >= getXSize(level) || y < 0 || y >= getYSize(level))
+        {
+            return 0.0f;
+        }
+
+        /* Serve the value from the tile that holds it. */
+        const TileView tile = fetchTile(x / tileXSize, y / tileYSize, level); /* Tile containing the coordinate. */
+        return tile.valueAt(static_cast<size_t>(y % tileYSize) * tile.stride + (x % tileXSize));
+    }
+
+    /**
+     * @brief Get the elevation values at many image coordinates with one tile fetch per distinct tile.
+     *
+     * @details Points are grouped by the tile that holds them, so a path that crosses a handful of tiles costs a handful of reads no matter how many waypoints it has.
+     *
+     * @param imgCoordinates The (x, y) image coordinates to sample.
+     * @param values Output, resized to match imgCoordinates. Coordinates outside the raster get 0, like @ref getValue.
+     * @param level Pyramid level the coordinates are in.
+     *
+     * @throws Failure to read raster values, or an invalid level.
+     */
+    void DemHandler::getValues(const std::vector<std::pair<int, int>> &imgCoordinates, std::vector<float> &values, const int level) const
+    {
+        validateLevel(level, "getValues");
+        values.assign(imgCoordinates.size(), 0.0f);
+        const int levelXSize = getXSize(level); /* Width of the level. */
+        const int levelYSize = getYSize(level); /* Height of the level. */
+
+        /* Order the in-bounds points by tile so each tile is fetched once. */
+        std::vector<std::pair<std::uint64_t, size_t>> tileOrder; /* Tile key and index into imgCoordinates. */
+        tileOrder.reserve(imgCoordinates.size());
+        for (size_t index = 0; index < imgCoordinates.size(); ++index)
+        {
+            const int x = imgCoordinates[index].first;
+            const int y = imgCoordinates[index].second;
+            if (x >= 0 && x < levelXSize && y >= 0 && y < levelYSize)
+            {
+                tileOrder.emplace_back(TileCache::makeKey(x / tileXSize, y / tileYSize, level), index);
+            }
+        }
+        std::sort(tileOrder.begin(), tileOrder.end());
+
+        TileView tile{nullptr, nullptr, nullptr, 0.0f, 1.0f, 0, 0, 0}; /* Tile holding the current group of points. */
+        std::uint64_t currentKey = 0;                                   /* Key of tile, valid once a tile has been fetched. */
+        for (const std::pair<std::uint64_t, size_t> &entry : tileOrder)
+        {
+            const int x = imgCoordinates[entry.second].first;
+            const int y = imgCoordinates[entry.second].second;
+            if (tile.width == 0 || entry.first != currentKey)
+            {
+                tile = fetchTile(x / tileXSize, y / tileYSize, level);
+                currentKey = entry.first;
+            }
+            values[entry.second] = tile.valueAt(static_cast<size_t>(y % tileYSize) * tile.stride + (x % tileXSize));
+        }
+    }
+
+    /**
+     * @brief Get bilinearly interpolated elevation values at sub-pixel image coordinates.
+     *
+     * @details Integer coordinates land on pixel centers, so a whole-number coordinate returns the same value as @ref getValue. Coordinates are clamped to the raster, so the edge pixels extend outward. The four neighbours of every point are sampled in one batch through @ref getValues.
+     *
+     * @param imgCoordinates The (x, y) image coordinates to sample.
+     * @param values Output, resized to match imgCoordinates.
+     *
+     * @throws Failure to read raster values.
+     */
+    void DemHandler::getInterpolatedValues(const std::vector<std::pair<double, double>> &imgCoordinates, std::vector<float> &values) const
+    {
+        constexpr int NEIGHBOURS = 4; /* Pixels that contribute to each interpolated value. */
+
+        /* Gather the four surrounding pixels of every point. */
+        std::vector<std::pair<int, int>> corners;       /* Top left, top right, bottom left, bottom right per point. */
+        std::vector<std::pair<double, double>> weights; /* Fractional x and y offset of each point from its top left pixel. */
+        corners.reserve(imgCoordinates.size() * NEIGHBOURS);
+        weights.reserve(imgCoordinates.size());
+        for (const std::pair<double, double> &imgCoordinate : imgCoordinates)
+        {
+            const double x = std::clamp(imgCoordinate.first, 0.0, static_cast<double>(rasterXSize - 1));
+            const double y = std::clamp(imgCoordinate.second, 0.0, static_cast<double>(rasterYSize - 1));
+            const int x0 = static_cast<int>(std::floor(x));
+            const int y0 = static_cast<int>(std::floor(y));
+            const int x1 = std::min(x0 + 1, rasterXSize - 1);
+            const int y1 = std::min(y0 + 1, rasterYSize - 1);
+            corners.emplace_back(x0, y0);
+            corners.emplace_back(x1, y0);
+            corners.emplace_back(x0, y1);
+            corners.emplace_back(x1, y1);
+            weights.emplace_back(x - x0, y - y0);
+        }
+
+        std::vector<float> cornerValues; /* Elevations at every corner, in the same order. */
+        getValues(corners, cornerValues);
+
+        /* Blend along x, then along y. */
+        values.resize(imgCoordinates.size());
+        for (size_t index = 0; index < imgCoordinates.size(); ++index)
+        {
+            const float *const corner = cornerValues.data() + index * NEIGHBOURS;
+            const double xWeight = weights[index].first;
+            const double yWeight = weights[index].second;
+            const double top = corner[0] + (corner[1] - corner[0]) * xWeight;
+            const double bottom = corner[2] + (corner[3] - corner[2]) * xWeight;
+            values[index] = static_cast<float>(top + (bottom - top) * yWeight);
+        }
+    }
+
+    /**
+     * @brief Get a decoded tile. Full resolution tiles of prepared DEMs are served straight from the mapping; everything else goes through the tile cache and is read on a miss.
+     *
+     * @details Full resolution tiles of a mosaic are stitched from the files under them. Reduced levels are read from the raster's own overview when it has one, otherwise averaged from the level below, which is itself cached.
+     *
+     * @param tileX Column of the tile in the tile grid.
+     * @param tileY Row of the tile in the tile grid.
+     * @param level Pyramid level of the tile.
+     *
+     * @return TileView The decoded tile.
+     *
+     * @throws Failure to read raster values.
+     */
+    DemHandler::TileView DemHandler::fetchTile(const int tileX, const int tileY, const int level) const
+    {
+        const int xOff = tileX * tileXSize; /* Left X offset of the tile. */
+        const int yOff = tileY * tileYSize; /* Top Y offset of the tile. */
+        const int width = std::min(tileXSize, getXSize(level) - xOff);
+        const int height = std::min(tileYSize, getYSize(level) - yOff);
+
+        if (preparedDem && level == 0)
+        {
+            return TileView{nullptr, preparedDem->getTile(tileX, tileY), nullptr, 0.0f, 1.0f, tileXSize, width, height};
+        }
+
+        const std::uint64_t tileKey = TileCache::makeKey(tileX, tileY, level); /* Cache key for the tile. */
+        std::shared_ptr<const DemTile> cachedTile = tileCache.find(tileKey);
+        if (!cachedTile)
+        {
+            /* Clip the tile to the raster bounds and decode it. */
+            std::shared_ptr<DemTile> decodedTile = std::make_shared<DemTile>();
+            decodedTile->width = width;
+            decodedTile->height = height;
+            decodedTile->values.resize(static_cast<size_t>(width) * height);
+            if (mosaic && level == 0)
+            {
+                mosaic->readWindow(xOff, yOff, width, height, decodedTile->values.data());
+            }
+            else if (level == 0 || hasNativeOverview(level))
+            {
+                GDALDataset *const dataset = acquireDataset();                 /* Handle no other thread is reading through. */
+                GDALRasterBand *band = dataset->GetRasterBand(ELEVATION_BAND); /* Band, or overview band, holding the level. */
+                if (level > 0)
+                {
+                    band = band->GetOverview(overviewIndices[level]);
+                }
+                const CPLErr readError = band->RasterIO(GF_Read, xOff, yOff, width, height, decodedTile->values.data(), width, height, GDT_Float32, 0, 0);
+                releaseDataset(dataset);
+                if (readError != CE_None)
+                {
+                    throw std::runtime_error("fetchTile: RasterIO() error");
+                }
+            }
+            else
+            {
+                downsampleTile(level, xOff, yOff, width, height, decodedTile->values.data());
+            }
+            if (quantizedStorage)
+            {
+                const float tileError = decodedTile->quantize(); /* Worst error in this tile. */
+                float previousError = maxQuantizationError;
+                while (tileError > previousError && !maxQuantizationError.compare_exchange_weak(previousError, tileError))
+                {
+                }
             }
+            tileCache.insert(tileKey, decodedTile);
+            cachedTile = std::move(decodedTile);
         }
-        return 0.0f; // Default value or error handling
+
+        if (cachedTile->isQuantized())
+        {
+            const std::int16_t *const codes = cachedTile->quantizedValues.data(); /* First code of the cached tile. */
+            const float offset = cachedTile->offset;
+            const float scale = cachedTile->scale;
+            return TileView{std::move(cachedTile), nullptr, codes, offset, scale, width, width, height};
+        }
+        const float *const values = cachedTile->values.data(); /* First value of the cached tile. */
+        return TileView{std::move(cachedTile), values, nullptr, 0.0f, 1.0f, width, width, height};
+    }
+
+    /**
+     * @brief Build part of a pyramid level by averaging 2x2 blocks of the level below.
+     *
+     * @details NaN samples and samples past the edge of the level below are left out of the average, so nodata does not bleed into its neighbours. A block with no valid samples stays NaN.
+     *
+     * @param level Pyramid level to build, at least 1.
+     * @param xOff Left X offset of the window in the level.
+     * @param yOff Top Y offset of the window in the level.
+     * @param width Width of the window.
+     * @param height Height of the window.
+     * @param values Destination with room for width * height floats.
+     *
+     * @throws Failure to read raster values.
+     */
+    void DemHandler::downsampleTile(const int level, const int xOff, const int yOff, const int width, const int height, float *const values) const
+    {
+        /* Window of the level below that covers the requested window. */
+        const int sourceXOff = xOff * 2;
+        const int sourceYOff = yOff * 2;
+        const int sourceXSize = std::min(width * 2, getXSize(level - 1) - sourceXOff);
+        const int sourceYSize = std::min(height * 2, getYSize(level - 1) - sourceYOff);
+        std::vector<float> source(static_cast<size_t>(sourceXSize) * sourceYSize); /* Values of the level below. */
+        readWindow(sourceXOff, sourceYOff, sourceXSize, sourceYSize, source.data(), level - 1);
+
+        for (int row = 0; row < height; ++row)
+        {
+            for (int col = 0; col < width; ++col)
+            {
+                double sum = 0.0; /* Sum of the valid samples in the block. */
+                int count = 0;    /* Number of valid samples in the block. */
+                for (int sourceRow = row * 2; sourceRow < std::min(row * 2 + 2, sourceYSize); ++sourceRow)
+                {
+                    for (int sourceCol = col * 2; sourceCol < std::min(col * 2 + 2, sourceXSize); ++sourceCol)
+                    {
+                        const float sample = source[static_cast<size_t>(sourceRow) * sourceXSize + sourceCol];
+                        if (!std::isnan(sample))
+                        {
+                            sum += sample;
+                            ++count;
+                        }
+                    }
+                }
+                values[static_cast<size_t>(row) * width + col] = count > 0 ? static_cast<float>(sum / count) : std::numeric_limits<float>::quiet_NaN();
+            }
+        }
+    }
+
+    /**
+     * @brief Walk an in-bounds window of the raster tile by tile, handing each row of each overlapping tile to a copier.
+     *
+     * @param xOff Left X offset of the window.
+     * @param yOff Top Y offset of the window.
+     * @param xSize Width of the window.
+     * @param ySize Height of the window.
+     * @param level Pyramid level to read from.
+     * @param copyRow Called with the tile, the index of the row's first value in it, the number of values and the row-major index in the window to copy them to.
+     *
+     * @throws Failure to read raster values.
+     */
+    template <typename CopyRow>
+    void DemHandler::visitWindow(const int xOff, const int yOff, const int xSize, const int ySize, const int level, CopyRow copyRow) const
+    {
+        const int xEnd = xOff + xSize; /* Right X offset, exclusive. */
+        const int yEnd = yOff + ySize; /* Bottom Y offset, exclusive. */
+
+        for (int tileY = yOff / tileYSize; tileY * tileYSize < yEnd; ++tileY)
+        {
+            for (int tileX = xOff / tileXSize; tileX * tileXSize < xEnd; ++tileX)
+            {
+                const TileView tile = fetchTile(tileX, tileY, level); /* Tile overlapping the window. */
+
+                /* Intersection of the tile and the window in raster coordinates. */
+                const int copyXOff = std::max(xOff, tileX * tileXSize);
+                const int copyYOff = std::max(yOff, tileY * tileYSize);
+                const int copyXEnd = std::min(xEnd, tileX * tileXSize + tile.width);
+                const int copyYEnd = std::min(yEnd, tileY * tileYSize + tile.height);
+
+                for (int row = copyYOff; row < copyYEnd; ++row)
+                {
+                    const size_t sourceIndex = static_cast<size_t>(row - tileY * tileYSize) * tile.stride + (copyXOff - tileX * tileXSize); /* Index of the first copied value in the tile. */
+                    copyRow(tile, sourceIndex, copyXEnd - copyXOff, static_cast<size_t>(row - yOff) * xSize + (copyXOff - xOff));
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Copy an in-bounds window of the raster into a row-major buffer, assembling it from cached tiles.
+     *
+     * @param xOff Left X offset of the window.
+     * @param yOff Top Y offset of the window.
+     * @param xSize Width of the window.
+     * @param ySize Height of the window.
+     * @param buffer Destination with room for xSize * ySize floats.
+     * @param level Pyramid level to read from.
+     *
+     * @throws Failure to read raster values.
+     */
+    void DemHandler::readWindow(const int xOff, const int yOff, const int xSize, const int ySize, float *const buffer, const int level) const
+    {
+        visitWindow(xOff, yOff, xSize, ySize, level, [&](const TileView &tile, const size_t sourceIndex, const int count, const size_t destinationIndex)
+        {
+            float *const destination = buffer + destinationIndex;
+            if (tile.codes != nullptr)
+            {
+                for (int col = 0; col < count; ++col)
+                {
+                    destination[col] = DemTile::decode(tile.codes[sourceIndex + col], tile.offset, tile.scale);
+                }
+            }
+            else
+            {
+                std::copy(tile.values + sourceIndex, tile.values + sourceIndex + count, destination);
+            }
+        });
+    }
+
+    /**
+     * @brief Encode an in-bounds window of full resolution values into a row-major buffer, assembling it from cached tiles.
+     *
+     * @details Rows of tiles quantized with the same codec are copied as they are.
+     *
+     * @param xOff Left X offset of the window.
+     * @param yOff Top Y offset of the window.
+     * @param xSize Width of the window.
+     * @param ySize Height of the window.
+     * @param buffer Destination with room for xSize * ySize codes.
+     * @param codec Offset and scale to encode with.
+     * @return float Largest difference between a decoded code and the tile value it was made from.
+     *
+     * @throws Failure to read raster values.
+     */
+    float DemHandler::readWindow(const int xOff, const int yOff, const int xSize, const int ySize, std::int16_t *const buffer, const ElevationCodec &codec) const
+    {
+        float encodeError = 0.0f; /* Largest round trip error so far. */
+        visitWindow(xOff, yOff, xSize, ySize, 0, [&](const TileView &tile, const size_t sourceIndex, const int count, const size_t destinationIndex)
+        {
+            std::int16_t *const destination = buffer + destinationIndex;
+            if (tile.codes != nullptr && codec == ElevationCodec{tile.offset, tile.scale})
+            {
+                std::copy(tile.codes + sourceIndex, tile.codes + sourceIndex + count, destination);
+                return;
+            }
+            for (int col = 0; col < count; ++col)
+            {
+                const float value = tile.valueAt(sourceIndex + col);
+                destination[col] = codec.encode(value);
+                if (!std::isnan(value))
+                {
+                    encodeError = std::max(encodeError, std::abs(codec.decode(destination[col]) - value));
+                }
+            }
+        });
+        return encodeError;
+    }
+
+    /**
+     * @brief Find the elevation range of an in-bounds window of full resolution values, and whether its tiles share a codec.
+     *
+     * @param xOff Left X offset of the window.
+     * @param yOff Top Y offset of the window.
+     * @param xSize Width of the window.
+     * @param ySize Height of the window.
+     * @return WindowRange Range of the decoded values.
+     *
+     * @throws Failure to read raster values.
+     */
+    DemHandler::WindowRange DemHandler::readWindowRange(const int xOff, const int yOff, const int xSize, const int ySize) const
+    {
+        WindowRange range{std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), ElevationCodec{}, true};
+        bool firstTile = true; /* Whether no row has been seen yet. */
+        visitWindow(xOff, yOff, xSize, ySize, 0, [&](const TileView &tile, const size_t sourceIndex, const int count, const size_t)
+        {
+            if (tile.codes == nullptr)
+            {
+                range.sharesTileCodec = false;
+                for (int col = 0; col < count; ++col)
+                {
+                    const float value = tile.values[sourceIndex + col];
+                    if (!std::isnan(value))
+                    {
+                        range.minimum = std::min(range.minimum, static_cast<double>(value));
+                        range.maximum = std::max(range.maximum, static_cast<double>(value));
+                    }
+                }
+                return;
+            }
+
+            const ElevationCodec tileCodec{tile.offset, tile.scale};
+            if (firstTile)
+            {
+                range.tileCodec = tileCodec;
+            }
+            range.sharesTileCodec = range.sharesTileCodec && range.tileCodec == tileCodec;
+            firstTile = false;
+
+            /* Codes grow with elevation, so only the extreme codes need decoding. */
+            int lowest = DemTile::MAX_CODE + 1;
+            int highest = -DemTile::MAX_CODE - 1;
+            for (int col = 0; col < count; ++col)
+            {
+                const std::int16_t code = tile.codes[sourceIndex + col];
+                if (code != DemTile::NAN_CODE)
+                {
+                    lowest = std::min(lowest, static_cast<int>(code));
+                    highest = std::max(highest, static_cast<int>(code));
+                }
+            }
+            if (lowest <= highest)
+            {
+                range.minimum = std::min(range.minimum, static_cast<double>(tileCodec.decode(static_cast<std::int16_t>(lowest))));
+                range.maximum = std::max(range.maximum, static_cast<double>(tileCodec.decode(static_cast<std::int16_t>(highest))));
+            }
+        });
+        return range;
     }
 }
@@ -1,10 +1,32 @@
 #pragma once
-#define DEMHANDLER_MINMAX false /* Enable (true) or disable (false) the ComputeRasterMinMax() function call and associated members. */
 
 /* libgdal-dev */
 #include <gdal_priv.h>
 
+/* mempa::TileCache */
+#include "TileCache.hpp"
+
+/* mempa::PreparedDem */
+#include "PreparedDem.hpp"
+
+/* mempa::DemMetadata */
+#include "DemMetadata.hpp"
+
+/* mempa::DemMosaic */
+#include "DemMosaic.hpp"
+
+/* mempa::Raster2D */
+#include "Raster2D.hpp"
+
+/* mempa::ElevationCodec, mempa::ElevationChunk */
+#include "ElevationView.hpp"
+
 /* C++ Standard Libraries */
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <utility>
 
@@ -18,6 +40,10 @@ namespace mempa
     /**
      * @brief Class to hold DEM interactions for CU Boulder MEMPA simulation.
      *
+     * @details The const read API is safe to call from many threads at once. GDAL datasets cannot be shared between threads, so tile reads borrow a dataset handle from a pool. A new handle is opened only when every existing one is busy, so there are never more handles than threads reading at the same time.
+     *
+     * The input may also be a directory or manifest of rasters on one pixel grid, read through a DemMosaic as if it were a single raster.
+     *
      * @author Ryan Wagster <ryan.wagster@colorado.edu>
      */
     class DemHandler
@@ -26,44 +52,111 @@ namespace mempa
         const char *const pszFilename;                     /* Filepath to the input DEM.tif file. */
         inline static constexpr int ELEVATION_BAND = 1;    /* For a DEM, the Elevation Band should be at indice 1. For a slope raster, Band 1 is used for slope values. */
         inline static constexpr double DEM_180 = 180.0;    /* Used to convert degrees to meters for spatial resolution. Only used for DEM data. */
-        GDALDatasetUniquePtr poDataset;                    /* Pointer to the GDAL Dataset. Not actually a pointer. */
-        GDALRasterBand *poBand;                            /* Pointer to the first band of the raster. */
+        GDALDatasetUniquePtr poDataset;                    /* Pointer to the GDAL Dataset. Not actually a pointer. Null until the first tile read when the metadata came from a sidecar. */
+        GDALRasterBand *poBand = nullptr;                  /* Pointer to the first band of the raster. Null whenever poDataset is. */
+        mutable std::mutex datasetPoolMutex;                      /* Guards the dataset pool. Held only to take or return a handle, never during a read. */
+        mutable std::vector<GDALDataset *> idleDatasets;          /* Handles not reading right now, including poDataset. */
+        mutable std::vector<GDALDatasetUniquePtr> extraDatasets;  /* Handles opened because every other handle was busy. */
+        std::unique_ptr<PreparedDem> preparedDem;          /* Memory-mapped prepared DEM. Null when reading through GDAL. */
+        std::unique_ptr<DemMosaic> mosaic;                 /* Files read as one raster. Null unless the input is a directory or manifest. */
+        DemMetadata metadata;                              /* Layout, CRS and statistics, loaded from a sidecar when one matches. */
+        int rasterXSize;                                   /* Number of pixels per raster row. */
+        int rasterYSize;                                   /* Number of pixels per raster column. */
         inline static constexpr int GEOTRANSFORM_SIZE = 6; /* GDAL Geotransforms are sets of 6 coefficients. */
         double adfGeoTransform[GEOTRANSFORM_SIZE];         /* Array to store all Geotransform values. */
         const char *poProjection;                          /* Name of CRS projection used by the raster. */
-        OGRSpatialReference CRS;                           /* Coordinate Reference System of the raster. */
-#if DEMHANDLER_MINMAX
-        inline static constexpr int MINMAX_SIZE = 2; /* Size of the array to hold min and max raster values. */
-        double elevationMinMax[MINMAX_SIZE];         /* Minimum: Index 0, Maximum: Index 1 */
-#endif
+        inline static constexpr int MAX_TILE_DIMENSION = 512; /* Widest tile the cache will hold; wider blocks (strips) are split. */
+        inline static constexpr int MIN_TILE_DIMENSION = 64;  /* Shortest tile the cache will hold; shorter blocks (strips) are grouped. */
+        int tileXSize;                                        /* Width of a cached tile, aligned to the raster's natural block width. */
+        int tileYSize;                                        /* Height of a cached tile, a multiple of the raster's natural block height. */
+        mutable TileCache tileCache;                          /* Decoded tiles, evicted least recently used first. */
+        inline static constexpr int MAX_LEVEL_COUNT = 24;      /* Pyramid levels supported, enough to shrink any raster to one pixel. */
+        std::vector<std::pair<int, int>> levelSizes;          /* Raster (x, y) size at each pyramid level. Level 0 is full resolution. */
+        std::vector<int> overviewIndices;                     /* GDAL overview serving each level, or -1 when DemHandler builds the level itself. */
+        std::atomic<bool> quantizedStorage{false};            /* Whether newly cached tiles are stored as 16-bit codes. */
+        mutable std::atomic<float> maxQuantizationError{0.0f}; /* Largest elevation error of any tile quantized so far. */
+        mutable std::atomic<float> maxChunkError{0.0f};        /* Largest error re-encoding tile values into chunk codes so far. */
+
+        /**
+         * @brief Borrowed view of one tile, either cached or inside a prepared DEM mapping.
+         */
+        struct TileView
+        {
+            std::shared_ptr<const DemTile> owner; /* Keeps a cached tile alive. Null for mapped tiles. */
+            const float *values;                  /* First value of the tile. Null for a quantized tile. */
+            const std::int16_t *codes;            /* First code of a quantized tile. Null otherwise. */
+            float offset;                         /* Elevation of code 0 in a quantized tile. */
+            float scale;                          /* Elevation step between codes in a quantized tile. */
+            int stride;                           /* Distance between rows in values or codes. */
+            int width;                            /* Number of valid columns. */
+            int height;                           /* Number of valid rows. */
+
+            inline float valueAt(std::size_t index) const noexcept;
+        };
+
+        /**
+         * @brief Elevations found in a window, and whether its tiles could lend it their codes.
+         */
+        struct WindowRange
+        {
+            double minimum;            /* Lowest valid elevation, infinite if there is none. */
+            double maximum;            /* Highest valid elevation, minus infinite if there is none. */
+            ElevationCodec tileCodec;  /* Codec of the first tile. */
+            bool sharesTileCodec;      /* Whether every tile is quantized with tileCodec. */
+        };
+
+        void openGdalDataset();
+        void openPreparedDem(const char *preparedFilepath);
+        void applyMetadata();
+        GDALDataset *acquireDataset() const;
+        void releaseDataset(GDALDataset *dataset) const;
+        void buildLevels();
+        void validateLevel(int level, const char *caller) const;
+        TileView fetchTile(int tileX, int tileY, int level = 0) const;
+        void downsampleTile(int level, int xOff, int yOff, int width, int height, float *values) const;
+        template <typename CopyRow>
+        void visitWindow(int xOff, int yOff, int xSize, int ySize, int level, CopyRow copyRow) const;
+        void readWindow(int xOff, int yOff, int xSize, int ySize, float *buffer, int level = 0) const;
+        float readWindow(int xOff, int yOff, int xSize, int ySize, std::int16_t *buffer, const ElevationCodec &codec) const;
+        WindowRange readWindowRange(int xOff, int yOff, int xSize, int ySize) const;
+        ElevationChunk encodeWindow(std::pair<std::pair<int, int>, std::pair<int, int>> imgCoordinates, int buffer, const ElevationCodec *codec) const;
 
     protected:
         /* DemHandler is not designed to be subclassed. */
 
     public:
         explicit DemHandler(const char *pszFilename);
-        std::vector<std::vector<float>> readSquareChunk(std::pair<int, int> imgCoordinate, int buffer, std::pair<int, int> *relativeCoordinate = nullptr) const;
-        std::vector<std::vector<float>> readCircleChunk(std::pair<int, int> imgCoordinate, int radius, std::pair<int, int> *relativeCoordinate = nullptr) const;
-        std::vector<std::vector<float>> readRectangleChunk(std::pair<std::pair<int, int>, std::pair<int, int>> imgCoordinates, int buffer, std::pair<std::pair<int, int>, std::pair<int, int>> *relativeCoordinates = nullptr) const;
-        std::pair<int, int> transformCoordinates(std::pair<double, double> geoCoordinate) const noexcept;
-        std::pair<double, double> revertCoordinates(std::pair<int, int> imgCoordinate) const noexcept;
-        double getImageResolution() const;
-        inline int getXSize() const noexcept;
-        inline int getYSize() const noexcept;
-        
-        /**
-         * @brief Get the elevation value at a specific (x,y) pixel coordinate
-         * 
-         * @param x The x-coordinate (column)
-         * @param y The y-coordinate (row)
-         * @return float The elevation value at the specified coordinate
-         */
-        float getValue(int x, int y) const;
-        
-#if DEMHANDLER_MINMAX
+        Raster2D<float> readSquareChunk(std::pair<int, int> imgCoordinate, int buffer, std::pair<int, int> *relativeCoordinate = nullptr, int level = 0) const;
+        Raster2D<float> readCircleChunk(std::pair<int, int> imgCoordinate, int radius, std::pair<int, int> *relativeCoordinate = nullptr, int level = 0) const;
+        Raster2D<float> readRectangleChunk(std::pair<std::pair<int, int>, std::pair<int, int>> imgCoordinates, int buffer, std::pair<std::pair<int, int>, std::pair<int, int>> *relativeCoordinates = nullptr, int level = 0) const;
+        ElevationChunk readQuantizedChunk(std::pair<std::pair<int, int>, std::pair<int, int>> imgCoordinates, int buffer) const;
+        ElevationChunk readQuantizedChunk(std::pair<std::pair<int, int>, std::pair<int, int>> imgCoordinates, int buffer, const ElevationCodec &codec) const;
+        std::pair<double, double> getElevationRange(std::pair<std::pair<int, int>, std::pair<int, int>> imgCoordinates, int buffer) const;
+        std::pair<int, int> transformCoordinates(std::pair<double, double> geoCoordinate, int level = 0) const noexcept;
+        std::pair<double, double> revertCoordinates(std::pair<int, int> imgCoordinate, int level = 0) const noexcept;
+        double getImageResolution(int level = 0) const;
+        inline int getXSize(int level = 0) const noexcept;
+        inline int getYSize(int level = 0) const noexcept;
+        inline int getLevelCount() const noexcept;
+        inline bool hasNativeOverview(int level) const noexcept;
+        inline std::pair<double, double> getLevelScale(int level) const noexcept;
+        float getValue(int x, int y, int level = 0) const;
+        void getValues(const std::vector<std::pair<int, int>> &imgCoordinates, std::vector<float> &values, int level = 0) const;
+        void getInterpolatedValues(const std::vector<std::pair<double, double>> &imgCoordinates, std::vector<float> &values) const;
+        inline void setTileCacheCapacity(std::size_t capacityBytes) const;
+        inline std::size_t getCacheHits() const noexcept;
+        inline std::size_t getCacheMisses() const noexcept;
+        inline bool isPrepared() const noexcept;
+        inline const DemMosaic *getMosaic() const noexcept;
+        inline void setMaxOpenFiles(std::size_t limit) const;
+        inline std::size_t getTileBytes() const noexcept;
+        void setQuantizedStorage(bool enabled);
+        inline bool isQuantizedStorage() const noexcept;
+        inline float getMaxQuantizationError() const noexcept;
+        inline float getMaxChunkError() const noexcept;
         inline double getMinElevation() const noexcept;
         inline double getMaxElevation() const noexcept;
-#endif
+        inline const DemMetadata &getMetadata() const noexcept;
     };
 }
 
@@ -4,55 +4,227 @@
 /* libgdal-dev */
 #include <gdal_priv.h>
 
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <cstdint>
+
 namespace mempa
 {
     /**
      * @brief Get the total X size of the raster.
      *
-     * @return int Number of pixels per raster row.
+     * @param level Pyramid level, 0 for full resolution.
+     * @return int Number of pixels per raster row, or 0 for a level that does not exist.
      * 
      * @author Ryan Wagster <rywa2447@colorado.edu>
      */
-    inline int DemHandler::getXSize() const noexcept
+    inline int DemHandler::getXSize(const int level) const noexcept
     {
-        return poBand->GetXSize();
+        return (level >= 0 && level < getLevelCount()) ? levelSizes[level].first : 0;
     }
 
     /**
      * @brief Get the total Y size of the raster.
      *
-     * @return int Number of pixels per raster column.
+     * @param level Pyramid level, 0 for full resolution.
+     * @return int Number of pixels per raster column, or 0 for a level that does not exist.
      * 
      * @author Ryan Wagster <rywa2447@colorado.edu>
      */
-    inline int DemHandler::getYSize() const noexcept
+    inline int DemHandler::getYSize(const int level) const noexcept
+    {
+        return (level >= 0 && level < getLevelCount()) ? levelSizes[level].second : 0;
+    }
+
+    /**
+     * @brief Get the number of pyramid levels. Level n halves the resolution of level n - 1, down to a single pixel.
+     *
+     * @return int Number of levels, including full resolution.
+     */
+    inline int DemHandler::getLevelCount() const noexcept
+    {
+        return static_cast<int>(levelSizes.size());
+    }
+
+    /**
+     * @brief Check whether a pyramid level is read from an overview stored in the raster file.
+     *
+     * @param level Pyramid level.
+     * @return true The level is read from a GDAL overview.
+     * @return false The level is full resolution, or DemHandler averages it from the level below.
+     */
+    inline bool DemHandler::hasNativeOverview(const int level) const noexcept
+    {
+        return level > 0 && level < getLevelCount() && overviewIndices[level] >= 0;
+    }
+
+    /**
+     * @brief Get how many full resolution pixels one pixel of a level spans.
+     *
+     * @param level Pyramid level.
+     * @return std::pair<double, double> X and Y scale. Close to 2^level; exact when the raster size divides evenly.
+     */
+    inline std::pair<double, double> DemHandler::getLevelScale(const int level) const noexcept
+    {
+        const int levelXSize = getXSize(level); /* Width of the level. */
+        const int levelYSize = getYSize(level); /* Height of the level. */
+        if (levelXSize == 0 || levelYSize == 0)
+        {
+            return std::pair<double, double>(1.0, 1.0);
+        }
+        return std::pair<double, double>(static_cast<double>(rasterXSize) / levelXSize, static_cast<double>(rasterYSize) / levelYSize);
+    }
+
+    /**
+     * @brief Read one value of the tile, decoding it if the tile is quantized.
+     *
+     * @param index Row-major index into the tile, using the view's stride.
+     * @return float Elevation value.
+     */
+    inline float DemHandler::TileView::valueAt(const std::size_t index) const noexcept
+    {
+        return codes != nullptr ? DemTile::decode(codes[index], offset, scale) : values[index];
+    }
+
+    /**
+     * @brief Set how many bytes of decoded tiles the handler may cache.
+     *
+     * @param capacityBytes Tile cache capacity in bytes.
+     */
+    inline void DemHandler::setTileCacheCapacity(const std::size_t capacityBytes) const
+    {
+        tileCache.setCapacity(capacityBytes);
+    }
+
+    /**
+     * @brief Get the number of tile lookups served without going back through GDAL.
+     *
+     * @return std::size_t Tile cache hits.
+     */
+    inline std::size_t DemHandler::getCacheHits() const noexcept
+    {
+        return tileCache.getHits();
+    }
+
+    /**
+     * @brief Get the number of tile lookups that required a GDAL read.
+     *
+     * @return std::size_t Tile cache misses.
+     */
+    inline std::size_t DemHandler::getCacheMisses() const noexcept
+    {
+        return tileCache.getMisses();
+    }
+
+    /**
+     * @brief Check whether values are served from a memory-mapped prepared DEM rather than GDAL.
+     *
+     * @return true The tile cache and GDAL block cache are not used.
+     * @return false Values are read through GDAL and the tile cache.
+     */
+    inline bool DemHandler::isPrepared() const noexcept
+    {
+        return preparedDem != nullptr;
+    }
+
+    /**
+     * @brief Get the mosaic the handler reads from.
+     *
+     * @return const DemMosaic* The mosaic, or null when the input is a single raster.
+     */
+    inline const DemMosaic *DemHandler::getMosaic() const noexcept
+    {
+        return mosaic.get();
+    }
+
+    /**
+     * @brief Set how many mosaic files may stay open between reads. Does nothing for a single raster.
+     *
+     * @param limit Open file cap, at least 1.
+     */
+    inline void DemHandler::setMaxOpenFiles(const std::size_t limit) const
+    {
+        if (mosaic)
+        {
+            mosaic->setMaxOpenFiles(limit);
+        }
+    }
+
+    /**
+     * @brief Get the size of one decoded tile.
+     *
+     * @return std::size_t Bytes held by one full tile in the current storage mode.
+     */
+    inline std::size_t DemHandler::getTileBytes() const noexcept
+    {
+        const std::size_t valueBytes = isQuantizedStorage() ? sizeof(std::int16_t) : sizeof(float); /* Bytes per cached value. */
+        return static_cast<std::size_t>(tileXSize) * static_cast<std::size_t>(tileYSize) * valueBytes;
+    }
+
+    /**
+     * @brief Check whether cached tiles are stored as 16-bit codes.
+     *
+     * @return true Tiles are quantized as they are cached.
+     * @return false Tiles are cached as floats.
+     */
+    inline bool DemHandler::isQuantizedStorage() const noexcept
+    {
+        return quantizedStorage;
+    }
+
+    /**
+     * @brief Get the largest elevation error introduced by quantized storage so far.
+     *
+     * @return float Error in elevation units, 0 if no tile has been quantized.
+     */
+    inline float DemHandler::getMaxQuantizationError() const noexcept
     {
-        return poBand->GetYSize();
+        return maxQuantizationError;
+    }
+
+    /**
+     * @brief Get the largest error added re-encoding tile values into quantized chunks so far.
+     *
+     * @details It comes on top of the tile error, since chunk codes are made from decoded tile values. Chunks whose codec matches their tile's copy the codes and add none.
+     *
+     * @return float Error in elevation units, 0 if no chunk has been re-encoded.
+     */
+    inline float DemHandler::getMaxChunkError() const noexcept
+    {
+        return maxChunkError;
     }
 
-#if DEMHANDLER_MINMAX
     /**
      * @brief Get the Min Elevation object.
      *
-     * @return double Minimum value in the raster.
+     * @return double Minimum value in the raster, ignoring nodata.
      * 
      * @author Ryan Wagster <rywa2447@colorado.edu>
      */
     inline double DemHandler::getMinElevation() const noexcept
     {
-        return elevationMinMax[0];
+        return metadata.getMinimum();
     }
 
     /**
      * @brief Get the Max Elevation object.
      *
-     * @return double Maximum value in the raster.
+     * @return double Maximum value in the raster, ignoring nodata.
      * 
      * @author Ryan Wagster <rywa2447@colorado.edu>
      */
     inline double DemHandler::getMaxElevation() const noexcept
     {
-        return elevationMinMax[1];
+        return metadata.getMaximum();
+    }
+
+    /**
+     * @brief Get the full metadata of the raster, including nodata and the elevation histogram.
+     *
+     * @return const DemMetadata& Metadata the handler was opened with.
+     */
+    inline const DemMetadata &DemHandler::getMetadata() const noexcept
+    {
+        return metadata;
     }
-#endif
 }
@@ -0,0 +1,384 @@
+/* Local Header */
+#include "DemMetadata.hpp"
+
+/* mempa::getSourceKey */
+#include "SourceKey.hpp"
+
+/* mempa::DemMosaic */
+#include "DemMosaic.hpp"
+
+/* libgdal-dev */
+#include <gdal_priv.h>
+#include <ogr_spatialref.h>
+
+/* C++ Standard Libraries */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mempa
+{
+    static_assert(sizeof(DemMetadata::Header) == 160, "DemMetadata::Header must have no padding");
+
+    /**
+     * @brief Get the sidecar filepath for a raster.
+     *
+     * @param filepath Filepath to the raster.
+     * @return std::string The raster filepath with @ref FILE_EXTENSION appended.
+     */
+    std::string DemMetadata::sidecarPathFor(const char *const filepath)
+    {
+        return std::string(filepath) + FILE_EXTENSION;
+    }
+
+    /**
+     * @brief Load the metadata of a raster from its sidecar.
+     *
+     * @param filepath Filepath to the raster, not the sidecar.
+     * @return true The sidecar exists, is intact and still matches the raster's size and modification time.
+     * @return false The raster must be described again.
+     */
+    bool DemMetadata::load(const char *const filepath)
+    {
+        std::uint64_t sourceSize;    /* Current size of the raster file. */
+        std::int64_t sourceModified; /* Current modification time of the raster file. */
+        if (!getSourceKey(filepath, sourceSize, sourceModified))
+        {
+            return false;
+        }
+
+        std::ifstream inFile(sidecarPathFor(filepath), std::ios::binary);
+        Header inHeader{}; /* Header read from the sidecar. */
+        if (!inFile || !inFile.read(reinterpret_cast<char *>(&inHeader), sizeof(Header)) ||
+            std::memcmp(inHeader.magic, MAGIC, sizeof(MAGIC)) != 0 || inHeader.version != VERSION ||
+            inHeader.sourceSize != sourceSize || inHeader.sourceModified != sourceModified)
+        {
+            return false;
+        }
+
+        /* Reject counts a damaged sidecar could hold before allocating for them. */
+        constexpr std::uint64_t MAX_WKT_LENGTH = 1 << 20; /* Far longer than any real CRS definition. */
+        constexpr std::uint32_t MAX_OVERVIEWS = 64;       /* More than a raster could have levels. */
+        if (inHeader.wktLength == 0 || inHeader.wktLength > MAX_WKT_LENGTH || inHeader.overviewCount > MAX_OVERVIEWS || inHeader.histogramBuckets > HISTOGRAM_BUCKETS)
+        {
+            return false;
+        }
+
+        std::string inWkt(inHeader.wktLength, '\0');                                                 /* CRS WKT read from the sidecar. */
+        std::vector<std::int32_t> inOverviews(static_cast<std::size_t>(inHeader.overviewCount) * 2); /* Overview sizes read from the sidecar. */
+        std::vector<std::uint64_t> inHistogram(inHeader.histogramBuckets);                            /* Histogram read from the sidecar. */
+        inFile.read(&inWkt[0], static_cast<std::streamsize>(inWkt.size()));
+        inFile.read(reinterpret_cast<char *>(inOverviews.data()), static_cast<std::streamsize>(inOverviews.size() * sizeof(std::int32_t)));
+        inFile.read(reinterpret_cast<char *>(inHistogram.data()), static_cast<std::streamsize>(inHistogram.size() * sizeof(std::uint64_t)));
+        if (!inFile)
+        {
+            return false;
+        }
+
+        header = inHeader;
+        projectionWkt = std::move(inWkt);
+        overviewSizes.clear();
+        for (std::size_t overview = 0; overview < inHeader.overviewCount; ++overview)
+        {
+            overviewSizes.emplace_back(inOverviews[overview * 2], inOverviews[overview * 2 + 1]);
+        }
+        histogram = std::move(inHistogram);
+        return true;
+    }
+
+    /**
+     * @brief Write the metadata to the raster's sidecar, keyed to the raster's current size and modification time.
+     *
+     * @param filepath Filepath to the raster, not the sidecar.
+     *
+     * @throws Failure to stat the raster or write the sidecar.
+     */
+    void DemMetadata::save(const char *const filepath) const
+    {
+        Header outHeader = header; /* Header to write. */
+        std::memcpy(outHeader.magic, MAGIC, sizeof(MAGIC));
+        outHeader.version = VERSION;
+        outHeader.overviewCount = static_cast<std::uint32_t>(overviewSizes.size());
+        outHeader.histogramBuckets = static_cast<std::uint32_t>(histogram.size());
+        outHeader.wktLength = projectionWkt.size();
+        if (!getSourceKey(filepath, outHeader.sourceSize, outHeader.sourceModified))
+        {
+            throw std::runtime_error("save: stat() error");
+        }
+
+        std::vector<std::int32_t> outOverviews; /* Overview sizes, flattened. */
+        for (const std::pair<int, int> &overviewSize : overviewSizes)
+        {
+            outOverviews.push_back(overviewSize.first);
+            outOverviews.push_back(overviewSize.second);
+        }
+
+        /* Write beside the sidecar and rename, so a concurrent reader never sees half a file. */
+        const std::string sidecarFilepath = sidecarPathFor(filepath);
+        const std::string temporaryFilepath = sidecarFilepath + ".partial"; /* Written first, then renamed. */
+        std::ofstream outFile(temporaryFilepath, std::ios::binary | std::ios::trunc);
+        if (!outFile)
+        {
+            throw std::runtime_error("save: failed to create " + temporaryFilepath);
+        }
+        outFile.write(reinterpret_cast<const char *>(&outHeader), sizeof(Header));
+        outFile.write(projectionWkt.data(), static_cast<std::streamsize>(projectionWkt.size()));
+        outFile.write(reinterpret_cast<const char *>(outOverviews.data()), static_cast<std::streamsize>(outOverviews.size() * sizeof(std::int32_t)));
+        outFile.write(reinterpret_cast<const char *>(histogram.data()), static_cast<std::streamsize>(histogram.size() * sizeof(std::uint64_t)));
+        outFile.close();
+        if (!outFile || std::rename(temporaryFilepath.c_str(), sidecarFilepath.c_str()) != 0)
+        {
+            std::remove(temporaryFilepath.c_str());
+            throw std::runtime_error("save: failed to write " + sidecarFilepath);
+        }
+    }
+
+    /**
+     * @brief Describe a raster opened through GDAL, including a full pass over its elevations for statistics.
+     *
+     * @param dataset Open GDAL dataset.
+     * @param band Index of the elevation band.
+     *
+     * @throws Failure to perform GDAL functions.
+     */
+    void DemMetadata::describe(GDALDataset &dataset, const int band)
+    {
+        GDALRasterBand *const poBand = dataset.GetRasterBand(band); /* Elevation band. */
+        if (!poBand)
+        {
+            throw std::runtime_error("describe: GetRasterBand() error");
+        }
+
+        header = Header{};
+        header.xSize = poBand->GetXSize();
+        header.ySize = poBand->GetYSize();
+        int blockXSize; /* Natural block width of the raster. */
+        int blockYSize; /* Natural block height of the raster. */
+        poBand->GetBlockSize(&blockXSize, &blockYSize);
+        header.blockXSize = blockXSize;
+        header.blockYSize = blockYSize;
+        if (dataset.GetGeoTransform(header.geoTransform) != CE_None)
+        {
+            throw std::runtime_error("describe: GetGeoTransform() error");
+        }
+        int hasNoData = 0; /* Set by GDAL if the band declares nodata. */
+        header.noDataValue = poBand->GetNoDataValue(&hasNoData);
+        header.hasNoData = hasNoData ? 1 : 0;
+
+        const char *const projection = dataset.GetProjectionRef(); /* CRS WKT of the raster. */
+        if (projection == nullptr || projection[0] == '\0')
+        {
+            throw std::runtime_error("describe: GetProjectionRef() error");
+        }
+        projectionWkt = projection;
+        describeProjection();
+
+        overviewSizes.clear();
+        for (int overview = 0; overview < poBand->GetOverviewCount(); ++overview)
+        {
+            GDALRasterBand *const overviewBand = poBand->GetOverview(overview); /* Reduced resolution copy stored in the file. */
+            overviewSizes.emplace_back(overviewBand ? overviewBand->GetXSize() : 0, overviewBand ? overviewBand->GetYSize() : 0);
+        }
+
+        /* Stream the raster a band of blocks at a time. */
+        const int stripRows = std::max(1, blockYSize); /* Rows read per RasterIO call. */
+        std::vector<float> strip(static_cast<std::size_t>(header.xSize) * stripRows); /* One strip of elevations. */
+        const auto visitStrips = [&](const auto &visit)
+        {
+            for (int yOff = 0; yOff < header.ySize; yOff += stripRows)
+            {
+                const int rows = std::min(stripRows, header.ySize - yOff);
+                if (poBand->RasterIO(GF_Read, 0, yOff, header.xSize, rows, strip.data(), header.xSize, rows, GDT_Float32, 0, 0) != CE_None)
+                {
+                    throw std::runtime_error("describe: RasterIO() error");
+                }
+                visit(strip.data(), static_cast<std::size_t>(header.xSize) * rows);
+            }
+        };
+        computeStatistics(visitStrips);
+    }
+
+    /**
+     * @brief Describe a prepared DEM, including a full pass over its elevations for statistics.
+     *
+     * @param preparedDem Mapped prepared DEM.
+     *
+     * @throws Failure to parse the CRS.
+     */
+    void DemMetadata::describe(const PreparedDem &preparedDem)
+    {
+        header = Header{};
+        header.xSize = preparedDem.getXSize();
+        header.ySize = preparedDem.getYSize();
+        header.blockXSize = preparedDem.getTileXSize();
+        header.blockYSize = preparedDem.getTileYSize();
+        std::copy(preparedDem.getGeoTransform(), preparedDem.getGeoTransform() + 6, header.geoTransform);
+        header.noDataValue = preparedDem.getNoDataValue();
+        header.hasNoData = preparedDem.hasNoDataValue() ? 1 : 0;
+
+        projectionWkt = preparedDem.getProjectionWkt();
+        if (projectionWkt.empty())
+        {
+            throw std::runtime_error("describe: prepared DEM has no projection");
+        }
+        describeProjection();
+        overviewSizes.clear();
+
+        /* Visit the valid part of every tile row straight from the mapping. */
+        const int tileXSize = header.blockXSize; /* Width of a stored tile. */
+        const int tileYSize = header.blockYSize; /* Height of a stored tile. */
+        const auto visitTiles = [&](const auto &visit)
+        {
+            for (int tileY = 0; tileY * tileYSize < header.ySize; ++tileY)
+            {
+                for (int tileX = 0; tileX * tileXSize < header.xSize; ++tileX)
+                {
+                    const float *const tile = preparedDem.getTile(tileX, tileY); /* Tile inside the mapping. */
+                    const int width = std::min(tileXSize, header.xSize - tileX * tileXSize);
+                    const int height = std::min(tileYSize, header.ySize - tileY * tileYSize);
+                    for (int row = 0; row < height; ++row)
+                    {
+                        visit(tile + static_cast<std::size_t>(row) * tileXSize, static_cast<std::size_t>(width));
+                    }
+                }
+            }
+        };
+        computeStatistics(visitTiles);
+    }
+
+    /**
+     * @brief Describe a mosaic by combining the metadata of its files, without reading any elevations.
+     *
+     * @details The mosaic turns every file's nodata into NaN, so it declares no nodata value and has no overviews. The histogram is rebuilt from the files' histograms by moving each file bucket to the mosaic bucket holding its center, so it is accurate to about one file bucket. Pixels covered by more than one file are counted once per file.
+     *
+     * @param mosaic Mosaic whose files have all been described.
+     */
+    void DemMetadata::describe(const DemMosaic &mosaic)
+    {
+        const DemMetadata &reference = mosaic.getFileMetadata(0); /* File whose grid and CRS the mosaic uses. */
+        header = Header{};
+        header.xSize = mosaic.getXSize();
+        header.ySize = mosaic.getYSize();
+        header.blockXSize = reference.getBlockXSize();
+        header.blockYSize = reference.getBlockYSize();
+        std::copy(mosaic.getGeoTransform(), mosaic.getGeoTransform() + 6, header.geoTransform);
+        header.geographic = reference.header.geographic;
+        header.semiMajorAxis = reference.header.semiMajorAxis;
+        projectionWkt = reference.projectionWkt;
+        overviewSizes.clear();
+
+        double minimum = std::numeric_limits<double>::infinity();  /* Lowest valid elevation of any file. */
+        double maximum = -std::numeric_limits<double>::infinity(); /* Highest valid elevation of any file. */
+        for (std::size_t fileIndex = 0; fileIndex < mosaic.getFileCount(); ++fileIndex)
+        {
+            const DemMetadata &file = mosaic.getFileMetadata(fileIndex);
+            if (file.getValidCount() > 0)
+            {
+                minimum = std::min(minimum, file.getMinimum());
+                maximum = std::max(maximum, file.getMaximum());
+                header.validCount += file.getValidCount();
+            }
+        }
+        histogram.assign(HISTOGRAM_BUCKETS, 0);
+        if (header.validCount == 0)
+        {
+            return;
+        }
+        header.minimum = minimum;
+        header.maximum = maximum;
+
+        const double bucketScale = maximum > minimum ? HISTOGRAM_BUCKETS / (maximum - minimum) : 0.0; /* Mosaic buckets per elevation unit. */
+        for (std::size_t fileIndex = 0; fileIndex < mosaic.getFileCount(); ++fileIndex)
+        {
+            const DemMetadata &file = mosaic.getFileMetadata(fileIndex);
+            const std::vector<std::uint64_t> &fileHistogram = file.getHistogram();
+            const double fileBucketWidth = fileHistogram.empty() ? 0.0 : (file.getMaximum() - file.getMinimum()) / fileHistogram.size(); /* Elevation span of one file bucket. */
+            for (std::size_t fileBucket = 0; fileBucket < fileHistogram.size(); ++fileBucket)
+            {
+                const double center = file.getMinimum() + (fileBucket + 0.5) * fileBucketWidth;
+                const std::size_t bucket = static_cast<std::size_t>(std::max(0.0, (center - minimum) * bucketScale));
+                histogram[std::min<std::size_t>(bucket, HISTOGRAM_BUCKETS - 1)] += fileHistogram[fileBucket];
+            }
+        }
+    }
+
+    /**
+     * @brief Parse the CRS WKT once and keep the two facts the resolution calculation needs.
+     *
+     * @throws Failure to parse the CRS.
+     */
+    void DemMetadata::describeProjection()
+    {
+        OGRSpatialReference CRS; /* Coordinate Reference System of the raster. */
+        if (CRS.importFromWkt(projectionWkt.c_str()) != OGRERR_NONE)
+        {
+            throw std::runtime_error("describe: importFromWkt() error");
+        }
+        header.geographic = CRS.IsGeographic() ? 1 : 0;
+        header.semiMajorAxis = CRS.GetSemiMajor();
+    }
+
+    /**
+     * @brief Compute the minimum, maximum, valid count and histogram of the raster in two passes.
+     *
+     * @param visitRows Callable taking a visitor and calling it with (const float *values, std::size_t count) for every run of pixels in the raster.
+     */
+    template <typename VisitRows>
+    void DemMetadata::computeStatistics(VisitRows visitRows)
+    {
+        const bool hasNoData = header.hasNoData != 0;
+        const float noData = static_cast<float>(header.noDataValue);
+        const auto isValid = [&](const float value)
+        {
+            return !std::isnan(value) && !(hasNoData && value == noData);
+        };
+
+        /* First pass: range of the valid elevations. */
+        double minimum = std::numeric_limits<double>::infinity();  /* Lowest valid elevation so far. */
+        double maximum = -std::numeric_limits<double>::infinity(); /* Highest valid elevation so far. */
+        std::uint64_t validCount = 0;                              /* Valid pixels so far. */
+        visitRows([&](const float *const values, const std::size_t count)
+        {
+            for (std::size_t index = 0; index < count; ++index)
+            {
+                if (isValid(values[index]))
+                {
+                    minimum = std::min(minimum, static_cast<double>(values[index]));
+                    maximum = std::max(maximum, static_cast<double>(values[index]));
+                    ++validCount;
+                }
+            }
+        });
+        header.validCount = validCount;
+        histogram.assign(HISTOGRAM_BUCKETS, 0);
+        if (validCount == 0)
+        {
+            header.minimum = header.maximum = 0.0;
+            return;
+        }
+        header.minimum = minimum;
+        header.maximum = maximum;
+
+        /* Second pass: bucket the valid elevations over that range. */
+        const double bucketScale = maximum > minimum ? HISTOGRAM_BUCKETS / (maximum - minimum) : 0.0; /* Buckets per elevation unit. */
+        visitRows([&](const float *const values, const std::size_t count)
+        {
+            for (std::size_t index = 0; index < count; ++index)
+            {
+                if (isValid(values[index]))
+                {
+                    const std::size_t bucket = static_cast<std::size_t>((values[index] - minimum) * bucketScale);
+                    ++histogram[std::min<std::size_t>(bucket, HISTOGRAM_BUCKETS - 1)];
+                }
+            }
+        });
+    }
+}
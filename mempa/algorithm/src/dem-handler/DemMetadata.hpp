@@ -0,0 +1,106 @@
+#pragma once
+
+/* libgdal-dev */
+#include <gdal_priv.h>
+
+/* mempa::PreparedDem */
+#include "PreparedDem.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mempa
+{
+    class DemMosaic;
+
+    /**
+     * @brief Everything DemHandler needs to know about a raster before reading it: size, block layout, geotransform, CRS, nodata, overviews and elevation statistics.
+     *
+     * @details Describing a raster takes a GDAL open, a CRS parse and two full passes over the elevations, so the result is saved to a sidecar file next to the raster. The sidecar records the raster's size and modification time and is ignored once either changes.
+     *
+     * ## Sidecar Layout
+     *
+     * - A fixed @ref Header.
+     * - The CRS WKT string (Header::wktLength bytes, not null-terminated).
+     * - Header::overviewCount (x, y) Int32 pairs, the size of each GDAL overview.
+     * - Header::histogramBuckets UInt64 counts spanning [minimum, maximum].
+     */
+    class DemMetadata
+    {
+    public:
+        /**
+         * @brief Fixed-size header at the start of a metadata sidecar.
+         */
+        struct Header
+        {
+            char magic[8];                  /* Always @ref MAGIC. */
+            std::uint32_t version;          /* Format version, currently @ref VERSION. */
+            std::int32_t xSize;             /* Raster width in pixels. */
+            std::int32_t ySize;             /* Raster height in pixels. */
+            std::int32_t blockXSize;        /* Natural block width of the raster. */
+            std::int32_t blockYSize;        /* Natural block height of the raster. */
+            std::uint32_t hasNoData;        /* Non-zero if noDataValue is meaningful. */
+            std::uint32_t geographic;       /* Non-zero if the CRS is in degrees rather than meters. */
+            std::uint32_t overviewCount;    /* Number of overview sizes after the WKT. */
+            std::uint32_t histogramBuckets; /* Number of histogram counts after the overview sizes. */
+            std::uint32_t reserved;         /* Zero. Keeps the 64-bit fields aligned. */
+            std::uint64_t sourceSize;       /* Size in bytes of the described raster file. */
+            std::int64_t sourceModified;    /* Modification time of the described raster file, in seconds. */
+            double geoTransform[6];         /* GDAL geotransform coefficients. */
+            double noDataValue;             /* Raster nodata value. */
+            double semiMajorAxis;           /* Semi-major axis of the CRS ellipsoid in meters. */
+            double minimum;                 /* Lowest valid elevation. */
+            double maximum;                 /* Highest valid elevation. */
+            std::uint64_t validCount;       /* Number of pixels that are neither nodata nor NaN. */
+            std::uint64_t wktLength;        /* Length of the CRS WKT that follows the header. */
+        };
+
+        inline static constexpr char MAGIC[8] = {'M', 'E', 'M', 'P', 'A', 'M', 'E', 'T'}; /* File signature. */
+        inline static constexpr std::uint32_t VERSION = 1;                                 /* Current format version. */
+        inline static constexpr std::uint32_t HISTOGRAM_BUCKETS = 256;                     /* Buckets in a computed histogram. */
+        inline static constexpr const char *FILE_EXTENSION = ".mempa-meta";                /* Suffix appended to a raster path for its sidecar. */
+
+    private:
+        Header header{};                                  /* Scalar metadata, stored as written to the sidecar. */
+        std::string projectionWkt;                        /* CRS WKT. */
+        std::vector<std::pair<int, int>> overviewSizes;   /* Size of each GDAL overview, in GDAL's order. */
+        std::vector<std::uint64_t> histogram;             /* Valid pixel counts in equal buckets from minimum to maximum. */
+
+        void describeProjection();
+        template <typename VisitRows>
+        void computeStatistics(VisitRows visitRows);
+
+    protected:
+        /* DemMetadata is not designed to be subclassed. */
+
+    public:
+        static std::string sidecarPathFor(const char *filepath);
+        bool load(const char *filepath);
+        void save(const char *filepath) const;
+        void describe(GDALDataset &dataset, int band);
+        void describe(const PreparedDem &preparedDem);
+        void describe(const DemMosaic &mosaic);
+
+        inline int getXSize() const noexcept;
+        inline int getYSize() const noexcept;
+        inline int getBlockXSize() const noexcept;
+        inline int getBlockYSize() const noexcept;
+        inline const double *getGeoTransform() const noexcept;
+        inline const char *getProjectionWkt() const noexcept;
+        inline bool isGeographic() const noexcept;
+        inline double getSemiMajorAxis() const noexcept;
+        inline bool hasNoDataValue() const noexcept;
+        inline double getNoDataValue() const noexcept;
+        inline double getMinimum() const noexcept;
+        inline double getMaximum() const noexcept;
+        inline std::uint64_t getValidCount() const noexcept;
+        inline const std::vector<std::uint64_t> &getHistogram() const noexcept;
+        inline const std::vector<std::pair<int, int>> &getOverviewSizes() const noexcept;
+    };
+}
+
+#include "DemMetadata.inl"
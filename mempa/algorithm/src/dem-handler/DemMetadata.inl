@@ -0,0 +1,162 @@
+/* Local Header */
+#include "DemMetadata.hpp"
+
+/* C++ Standard Libraries */
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace mempa
+{
+    /**
+     * @brief Get the total X size of the raster.
+     *
+     * @return int Number of pixels per raster row.
+     */
+    inline int DemMetadata::getXSize() const noexcept
+    {
+        return header.xSize;
+    }
+
+    /**
+     * @brief Get the total Y size of the raster.
+     *
+     * @return int Number of pixels per raster column.
+     */
+    inline int DemMetadata::getYSize() const noexcept
+    {
+        return header.ySize;
+    }
+
+    /**
+     * @brief Get the natural block width of the raster.
+     *
+     * @return int Block width in pixels.
+     */
+    inline int DemMetadata::getBlockXSize() const noexcept
+    {
+        return header.blockXSize;
+    }
+
+    /**
+     * @brief Get the natural block height of the raster.
+     *
+     * @return int Block height in pixels.
+     */
+    inline int DemMetadata::getBlockYSize() const noexcept
+    {
+        return header.blockYSize;
+    }
+
+    /**
+     * @brief Get the GDAL geotransform of the raster.
+     *
+     * @return const double* Array of 6 coefficients.
+     */
+    inline const double *DemMetadata::getGeoTransform() const noexcept
+    {
+        return header.geoTransform;
+    }
+
+    /**
+     * @brief Get the CRS of the raster as WKT.
+     *
+     * @return const char* Null-terminated WKT string.
+     */
+    inline const char *DemMetadata::getProjectionWkt() const noexcept
+    {
+        return projectionWkt.c_str();
+    }
+
+    /**
+     * @brief Check whether the CRS measures positions in degrees.
+     *
+     * @return true Pixel sizes are in degrees.
+     * @return false Pixel sizes are in meters.
+     */
+    inline bool DemMetadata::isGeographic() const noexcept
+    {
+        return header.geographic != 0;
+    }
+
+    /**
+     * @brief Get the semi-major axis of the CRS ellipsoid.
+     *
+     * @return double Semi-major axis in meters.
+     */
+    inline double DemMetadata::getSemiMajorAxis() const noexcept
+    {
+        return header.semiMajorAxis;
+    }
+
+    /**
+     * @brief Check whether the raster declares a nodata value.
+     *
+     * @return true @ref getNoDataValue is meaningful.
+     * @return false Only NaN marks missing data.
+     */
+    inline bool DemMetadata::hasNoDataValue() const noexcept
+    {
+        return header.hasNoData != 0;
+    }
+
+    /**
+     * @brief Get the nodata value of the raster.
+     *
+     * @return double Nodata value. Only meaningful if @ref hasNoDataValue.
+     */
+    inline double DemMetadata::getNoDataValue() const noexcept
+    {
+        return header.noDataValue;
+    }
+
+    /**
+     * @brief Get the lowest valid elevation in the raster.
+     *
+     * @return double Minimum, or 0 if the raster has no valid pixels.
+     */
+    inline double DemMetadata::getMinimum() const noexcept
+    {
+        return header.minimum;
+    }
+
+    /**
+     * @brief Get the highest valid elevation in the raster.
+     *
+     * @return double Maximum, or 0 if the raster has no valid pixels.
+     */
+    inline double DemMetadata::getMaximum() const noexcept
+    {
+        return header.maximum;
+    }
+
+    /**
+     * @brief Get the number of pixels that are neither nodata nor NaN.
+     *
+     * @return std::uint64_t Valid pixel count.
+     */
+    inline std::uint64_t DemMetadata::getValidCount() const noexcept
+    {
+        return header.validCount;
+    }
+
+    /**
+     * @brief Get the elevation histogram.
+     *
+     * @return const std::vector<std::uint64_t>& Valid pixel counts in equal-width buckets from @ref getMinimum to @ref getMaximum. The maximum falls in the last bucket.
+     */
+    inline const std::vector<std::uint64_t> &DemMetadata::getHistogram() const noexcept
+    {
+        return histogram;
+    }
+
+    /**
+     * @brief Get the size of each overview stored in the raster file.
+     *
+     * @return const std::vector<std::pair<int, int>>& (x, y) size of each GDAL overview, in GDAL's overview order.
+     */
+    inline const std::vector<std::pair<int, int>> &DemMetadata::getOverviewSizes() const noexcept
+    {
+        return overviewSizes;
+    }
+}
@@ -0,0 +1,396 @@
+/* Local Header */
+#include "DemMosaic.hpp"
+
+/* libgdal-dev */
+#include <gdal_priv.h>
+
+/* C++ Standard Libraries */
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* POSIX Libraries */
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace mempa
+{
+    /**
+     * @brief Open a mosaic, describing every file that has no up to date metadata sidecar.
+     *
+     * @param mosaicPath Directory of rasters, or a manifest listing them.
+     *
+     * @throws No rasters listed, a raster that cannot be opened or described, or rasters that do not share one pixel grid.
+     */
+    DemMosaic::DemMosaic(const char *const mosaicPath)
+        : maxOpenFiles(DEFAULT_MAX_OPEN_FILES)
+    {
+        for (std::string &filepath : listMembers(mosaicPath))
+        {
+            members.push_back(Member{std::move(filepath), DemMetadata(), PixelBox()});
+        }
+        if (members.empty())
+        {
+            throw std::runtime_error("DemMosaic: no rasters in " + std::string(mosaicPath));
+        }
+
+        for (size_t memberIndex = 0; memberIndex < members.size(); ++memberIndex)
+        {
+            describeMember(static_cast<int>(memberIndex));
+        }
+        layOut();
+    }
+
+    /**
+     * @brief Check whether a path names a mosaic rather than a single raster.
+     *
+     * @param filepath Path given as the DEM input.
+     * @return true The path is a directory or ends in @ref MANIFEST_EXTENSION.
+     * @return false The path should be opened as one raster.
+     */
+    bool DemMosaic::isMosaicPath(const char *const filepath)
+    {
+        struct stat fileStatus; /* Status of the input path. */
+        if (stat(filepath, &fileStatus) == 0 && S_ISDIR(fileStatus.st_mode))
+        {
+            return true;
+        }
+
+        const std::string path = filepath;
+        const std::string extension = MANIFEST_EXTENSION;
+        return path.size() > extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+    }
+
+    /**
+     * @brief List the rasters of a mosaic.
+     *
+     * @param mosaicPath Directory of rasters, or a manifest listing them.
+     * @return std::vector<std::string> Raster paths. A directory's are sorted by name; a manifest's keep their order.
+     *
+     * @throws Failure to read the directory or manifest.
+     */
+    std::vector<std::string> DemMosaic::listMembers(const char *const mosaicPath)
+    {
+        std::vector<std::string> filepaths; /* Rasters found. */
+        struct stat fileStatus;             /* Status of the mosaic path. */
+        if (stat(mosaicPath, &fileStatus) == 0 && S_ISDIR(fileStatus.st_mode))
+        {
+            DIR *const directory = opendir(mosaicPath);
+            if (directory == nullptr)
+            {
+                throw std::runtime_error("listMembers: opendir() error");
+            }
+            while (const dirent *const entry = readdir(directory))
+            {
+                std::string name = entry->d_name;
+                const size_t dot = name.rfind('.');
+                std::string extension = dot == std::string::npos ? "" : name.substr(dot);
+                std::transform(extension.begin(), extension.end(), extension.begin(), [](const unsigned char character)
+                               { return static_cast<char>(std::tolower(character)); });
+                if (extension == ".tif" || extension == ".tiff")
+                {
+                    filepaths.push_back(std::string(mosaicPath) + "/" + name);
+                }
+            }
+            closedir(directory);
+            std::sort(filepaths.begin(), filepaths.end());
+            return filepaths;
+        }
+
+        std::ifstream manifest(mosaicPath);
+        if (!manifest)
+        {
+            throw std::runtime_error("listMembers: failed to open " + std::string(mosaicPath));
+        }
+        const std::string manifestPath = mosaicPath;
+        const size_t slash = manifestPath.rfind('/');
+        const std::string baseDirectory = slash == std::string::npos ? "" : manifestPath.substr(0, slash + 1); /* Relative paths start here. */
+        std::string line;
+        while (std::getline(manifest, line))
+        {
+            const size_t first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#')
+            {
+                continue;
+            }
+            const std::string filepath = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+            filepaths.push_back(filepath[0] == '/' ? filepath : baseDirectory + filepath);
+        }
+        return filepaths;
+    }
+
+    /**
+     * @brief Load a file's metadata from its sidecar, or open and describe it and save the sidecar.
+     *
+     * @details A file opened to be described keeps its handle in the pool, so the first read of it does not open it again.
+     *
+     * @param memberIndex Index of the file.
+     *
+     * @throws Failure to open or describe the file.
+     */
+    void DemMosaic::describeMember(const int memberIndex)
+    {
+        Member &member = members[memberIndex];
+        if (member.metadata.load(member.filepath.c_str()))
+        {
+            return;
+        }
+
+        GDALAllRegister();
+        GDALDatasetUniquePtr dataset(GDALDataset::FromHandle(GDALOpen(member.filepath.c_str(), GA_ReadOnly))); /* Handle used to describe the file. */
+        ++fileOpens;
+        if (!dataset)
+        {
+            throw std::runtime_error("DemMosaic: GDALOpen() error on " + member.filepath);
+        }
+        member.metadata.describe(*dataset, ELEVATION_BAND);
+        try
+        {
+            member.metadata.save(member.filepath.c_str());
+        }
+        catch (const std::runtime_error &)
+        {
+            /* The sidecar is only a cache. Without write access the file is described again next run. */
+        }
+
+        std::list<std::pair<int, GDALDatasetUniquePtr>> excessHandles; /* Closed once the lock is released. */
+        const std::lock_guard<std::mutex> handleLock(handleMutex);
+        ++openFiles;
+        peakOpenFiles = std::max(peakOpenFiles, openFiles);
+        idleHandles.emplace_front(memberIndex, std::move(dataset));
+        excessHandles = takeExcessHandles(maxOpenFiles);
+    }
+
+    /**
+     * @brief Place every file on the pixel grid of the first, size the mosaic to cover them all and index their footprints.
+     *
+     * @throws A file that is rotated, has a different pixel size or CRS, or is not a whole number of pixels from the first.
+     */
+    void DemMosaic::layOut()
+    {
+        constexpr double ALIGNMENT_TOLERANCE = 1e-3; /* Fraction of a pixel two grids may be apart and still count as one. */
+        const Member &reference = members.front();   /* File whose grid the mosaic uses. */
+        const double *const referenceTransform = reference.metadata.getGeoTransform();
+        const double pixelWidth = referenceTransform[1];  /* West-East pixel size. */
+        const double pixelHeight = referenceTransform[5]; /* North-South pixel size. */
+
+        long long mosaicXMin = std::numeric_limits<long long>::max(); /* Bounding box of every footprint, in reference pixels. */
+        long long mosaicYMin = std::numeric_limits<long long>::max();
+        long long mosaicXMax = std::numeric_limits<long long>::min();
+        long long mosaicYMax = std::numeric_limits<long long>::min();
+        std::vector<std::pair<long long, long long>> origins; /* Top left pixel of every file in reference pixels. */
+        for (const Member &member : members)
+        {
+            const double *const memberTransform = member.metadata.getGeoTransform();
+            const double column = (memberTransform[0] - referenceTransform[0]) / pixelWidth;
+            const double row = (memberTransform[3] - referenceTransform[3]) / pixelHeight;
+            if (memberTransform[2] != 0.0 || memberTransform[4] != 0.0 ||
+                std::abs(memberTransform[1] - pixelWidth) > std::abs(pixelWidth) * ALIGNMENT_TOLERANCE ||
+                std::abs(memberTransform[5] - pixelHeight) > std::abs(pixelHeight) * ALIGNMENT_TOLERANCE ||
+                std::abs(column - std::round(column)) > ALIGNMENT_TOLERANCE || std::abs(row - std::round(row)) > ALIGNMENT_TOLERANCE ||
+                member.metadata.isGeographic() != reference.metadata.isGeographic() || member.metadata.getSemiMajorAxis() != reference.metadata.getSemiMajorAxis())
+            {
+                throw std::runtime_error("DemMosaic: " + member.filepath + " is not on the pixel grid of " + reference.filepath);
+            }
+
+            origins.emplace_back(std::llround(column), std::llround(row));
+            mosaicXMin = std::min(mosaicXMin, origins.back().first);
+            mosaicYMin = std::min(mosaicYMin, origins.back().second);
+            mosaicXMax = std::max(mosaicXMax, origins.back().first + member.metadata.getXSize());
+            mosaicYMax = std::max(mosaicYMax, origins.back().second + member.metadata.getYSize());
+        }
+        if (mosaicXMax - mosaicXMin > std::numeric_limits<int>::max() || mosaicYMax - mosaicYMin > std::numeric_limits<int>::max())
+        {
+            throw std::runtime_error("DemMosaic: mosaic is too large");
+        }
+
+        rasterXSize = static_cast<int>(mosaicXMax - mosaicXMin);
+        rasterYSize = static_cast<int>(mosaicYMax - mosaicYMin);
+        std::copy(referenceTransform, referenceTransform + 6, geoTransform);
+        geoTransform[0] = referenceTransform[0] + static_cast<double>(mosaicXMin) * pixelWidth;
+        geoTransform[3] = referenceTransform[3] + static_cast<double>(mosaicYMin) * pixelHeight;
+
+        std::vector<PixelBox> footprints; /* Footprint of every file, by member index. */
+        for (size_t memberIndex = 0; memberIndex < members.size(); ++memberIndex)
+        {
+            Member &member = members[memberIndex];
+            member.footprint.xMin = static_cast<int>(origins[memberIndex].first - mosaicXMin);
+            member.footprint.yMin = static_cast<int>(origins[memberIndex].second - mosaicYMin);
+            member.footprint.xMax = member.footprint.xMin + member.metadata.getXSize();
+            member.footprint.yMax = member.footprint.yMin + member.metadata.getYSize();
+            footprints.push_back(member.footprint);
+        }
+        footprintIndex.build(footprints);
+    }
+
+    /**
+     * @brief Copy a window of the mosaic into a row-major buffer, reading only the files under it.
+     *
+     * @param xOff Left X offset of the window.
+     * @param yOff Top Y offset of the window.
+     * @param xSize Width of the window.
+     * @param ySize Height of the window.
+     * @param values Destination with room for xSize * ySize floats. Pixels no file holds a valid value for are set to NaN.
+     *
+     * @throws Failure to open or read a file.
+     */
+    void DemMosaic::readWindow(const int xOff, const int yOff, const int xSize, const int ySize, float *const values) const
+    {
+        std::fill(values, values + static_cast<size_t>(xSize) * ySize, std::numeric_limits<float>::quiet_NaN());
+
+        std::vector<int> hits; /* Files under the window, in listing order. */
+        footprintIndex.query(PixelBox{xOff, yOff, xOff + xSize, yOff + ySize}, hits);
+        std::vector<float> fileValues; /* Part of one file inside the window. */
+        for (const int memberIndex : hits)
+        {
+            const Member &member = members[memberIndex];
+            const int copyXOff = std::max(xOff, member.footprint.xMin);
+            const int copyYOff = std::max(yOff, member.footprint.yMin);
+            const int width = std::min(xOff + xSize, member.footprint.xMax) - copyXOff;
+            const int height = std::min(yOff + ySize, member.footprint.yMax) - copyYOff;
+            fileValues.resize(static_cast<size_t>(width) * height);
+
+            GDALDatasetUniquePtr handle = acquireHandle(memberIndex); /* Handle no other thread is reading through. */
+            const CPLErr readError = handle->GetRasterBand(ELEVATION_BAND)->RasterIO(GF_Read, copyXOff - member.footprint.xMin, copyYOff - member.footprint.yMin, width, height, fileValues.data(), width, height, GDT_Float32, 0, 0);
+            releaseHandle(memberIndex, std::move(handle));
+            if (readError != CE_None)
+            {
+                throw std::runtime_error("readWindow: RasterIO() error on " + member.filepath);
+            }
+
+            /* Fill only pixels an earlier file left empty, turning this file's nodata into NaN. */
+            const bool hasNoData = member.metadata.hasNoDataValue();
+            const float noData = static_cast<float>(member.metadata.getNoDataValue());
+            for (int row = 0; row < height; ++row)
+            {
+                const float *const source = fileValues.data() + static_cast<size_t>(row) * width;
+                float *const destination = values + static_cast<size_t>(copyYOff - yOff + row) * xSize + (copyXOff - xOff);
+                for (int col = 0; col < width; ++col)
+                {
+                    if (std::isnan(destination[col]) && !(hasNoData && source[col] == noData))
+                    {
+                        destination[col] = source[col];
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Change the open file cap, closing idle handles at once if more than the new cap are open.
+     *
+     * @param limit Handles to keep open. At least one is always allowed.
+     */
+    void DemMosaic::setMaxOpenFiles(const std::size_t limit) const
+    {
+        maxOpenFiles = std::max<std::size_t>(1, limit);
+        std::list<std::pair<int, GDALDatasetUniquePtr>> excessHandles; /* Closed once the lock is released. */
+        const std::lock_guard<std::mutex> handleLock(handleMutex);
+        excessHandles = takeExcessHandles(maxOpenFiles);
+    }
+
+    /**
+     * @brief Get the number of file handles open right now.
+     *
+     * @return std::size_t Idle and busy handles.
+     */
+    std::size_t DemMosaic::getOpenFiles() const
+    {
+        const std::lock_guard<std::mutex> handleLock(handleMutex);
+        return openFiles;
+    }
+
+    /**
+     * @brief Get the most file handles that were ever open at once.
+     *
+     * @return std::size_t Peak open handles. Exceeds the cap only while more threads read at once than the cap allows.
+     */
+    std::size_t DemMosaic::getPeakOpenFiles() const
+    {
+        const std::lock_guard<std::mutex> handleLock(handleMutex);
+        return peakOpenFiles;
+    }
+
+    /**
+     * @brief Take a handle to a file that no other thread is reading through, opening one if none is idle.
+     *
+     * @details Opening a handle first closes the least recently used idle handles of any file to stay within the cap. When every open handle is busy the cap is exceeded until they are released.
+     *
+     * @param memberIndex Index of the file.
+     * @return GDALDatasetUniquePtr Handle to read through. Give it back with @ref releaseHandle.
+     *
+     * @throws Failure to open the file.
+     */
+    GDALDatasetUniquePtr DemMosaic::acquireHandle(const int memberIndex) const
+    {
+        {
+            std::list<std::pair<int, GDALDatasetUniquePtr>> excessHandles; /* Closed once the lock is released. */
+            const std::lock_guard<std::mutex> handleLock(handleMutex);
+            for (auto idleHandle = idleHandles.begin(); idleHandle != idleHandles.end(); ++idleHandle)
+            {
+                if (idleHandle->first == memberIndex)
+                {
+                    GDALDatasetUniquePtr handle = std::move(idleHandle->second);
+                    idleHandles.erase(idleHandle);
+                    return handle;
+                }
+            }
+            excessHandles = takeExcessHandles(maxOpenFiles - 1);
+            ++openFiles;
+            peakOpenFiles = std::max(peakOpenFiles, openFiles);
+        }
+
+        /* Open outside the lock so other threads keep reading while this one opens. */
+        GDALAllRegister();
+        GDALDatasetUniquePtr handle(GDALDataset::FromHandle(GDALOpen(members[memberIndex].filepath.c_str(), GA_ReadOnly))); /* New handle for this read. */
+        ++fileOpens;
+        if (!handle || !handle->GetRasterBand(ELEVATION_BAND))
+        {
+            const std::lock_guard<std::mutex> handleLock(handleMutex);
+            --openFiles;
+            throw std::runtime_error("acquireHandle: GDALOpen() error on " + members[memberIndex].filepath);
+        }
+        return handle;
+    }
+
+    /**
+     * @brief Return a handle taken with @ref acquireHandle to the pool, closing idle handles past the cap.
+     *
+     * @param memberIndex Index of the file the handle reads.
+     * @param handle Handle to return.
+     */
+    void DemMosaic::releaseHandle(const int memberIndex, GDALDatasetUniquePtr handle) const
+    {
+        std::list<std::pair<int, GDALDatasetUniquePtr>> excessHandles; /* Closed once the lock is released. */
+        const std::lock_guard<std::mutex> handleLock(handleMutex);
+        idleHandles.emplace_front(memberIndex, std::move(handle));
+        excessHandles = takeExcessHandles(maxOpenFiles);
+    }
+
+    /**
+     * @brief Remove the least recently used idle handles until no more than a limit are open.
+     *
+     * @param limit Open handles to allow.
+     * @return std::list<std::pair<int, GDALDatasetUniquePtr>> Removed handles. They close when the list is destroyed, which the caller does after releasing handleMutex.
+     */
+    std::list<std::pair<int, GDALDatasetUniquePtr>> DemMosaic::takeExcessHandles(const std::size_t limit) const
+    {
+        std::list<std::pair<int, GDALDatasetUniquePtr>> excessHandles; /* Handles to close. */
+        while (openFiles > limit && !idleHandles.empty())
+        {
+            excessHandles.splice(excessHandles.end(), idleHandles, std::prev(idleHandles.end()));
+            --openFiles;
+        }
+        return excessHandles;
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+/* libgdal-dev */
+#include <gdal_priv.h>
+
+/* mempa::DemMetadata */
+#include "DemMetadata.hpp"
+
+/* mempa::RTree */
+#include "RTree.hpp"
+
+/* C++ Standard Libraries */
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mempa
+{
+    /**
+     * @brief Many DEM files on one shared pixel grid, read as if they were a single raster.
+     *
+     * @details The files are listed from a directory (every .tif or .tiff in it) or a manifest (a text file ending in @ref MANIFEST_EXTENSION with one raster path per line, relative to the manifest, blank lines and lines starting with '#' ignored). Every file must share the CRS and pixel size of the first and sit a whole number of pixels from it; the mosaic covers the bounding box of them all.
+     *
+     * Each file's footprint is indexed in an R-tree, so a read touches only the files under it. Footprints and statistics come from each file's metadata sidecar, so a mosaic that has been opened before costs no GDAL opens until a read needs one. Handles are pooled per file and the least recently used idle ones are closed whenever more than @ref getMaxOpenFiles are open.
+     *
+     * Where files overlap, the first file listed with a valid value wins. Pixels no file covers, and nodata pixels of the files, read as NaN.
+     */
+    class DemMosaic
+    {
+    private:
+        inline static constexpr int ELEVATION_BAND = 1; /* Band holding elevations in every file. */
+
+        /**
+         * @brief One raster of the mosaic.
+         */
+        struct Member
+        {
+            std::string filepath; /* Path GDAL opens. */
+            DemMetadata metadata; /* Size, georeferencing and nodata of the file. */
+            PixelBox footprint;   /* Pixels of the mosaic the file covers. */
+        };
+
+        std::vector<Member> members;                                         /* Every file, in listing order. */
+        RTree footprintIndex;                                                /* Footprint of every member, by member index. */
+        int rasterXSize = 0;                                                 /* Width of the mosaic. */
+        int rasterYSize = 0;                                                 /* Height of the mosaic. */
+        double geoTransform[6];                                              /* Geotransform of the mosaic's top left pixel. */
+        mutable std::atomic<std::size_t> maxOpenFiles;                       /* Open handles allowed while none are busy. */
+        mutable std::mutex handleMutex;                                      /* Guards idleHandles and openFiles. Never held while GDAL opens or reads. */
+        mutable std::list<std::pair<int, GDALDatasetUniquePtr>> idleHandles; /* Member index and handle, most recently used first. */
+        mutable std::size_t openFiles = 0;                                   /* Handles open, idle or busy. */
+        mutable std::size_t peakOpenFiles = 0;                               /* Most handles open at once. */
+        mutable std::atomic<std::size_t> fileOpens{0};                       /* GDALOpen calls made, including to describe files. */
+
+        void describeMember(int memberIndex);
+        void layOut();
+        GDALDatasetUniquePtr acquireHandle(int memberIndex) const;
+        void releaseHandle(int memberIndex, GDALDatasetUniquePtr handle) const;
+        std::list<std::pair<int, GDALDatasetUniquePtr>> takeExcessHandles(std::size_t limit) const; /* Caller must hold handleMutex. */
+
+    protected:
+        /* DemMosaic is not designed to be subclassed. */
+
+    public:
+        inline static constexpr const char *MANIFEST_EXTENSION = ".mosaic"; /* Suffix marking a manifest of raster paths. */
+        inline static constexpr std::size_t DEFAULT_MAX_OPEN_FILES = 32;      /* Well under the usual 1024 descriptor limit. */
+
+        explicit DemMosaic(const char *mosaicPath);
+        DemMosaic(const DemMosaic &) = delete;
+        DemMosaic &operator=(const DemMosaic &) = delete;
+        static bool isMosaicPath(const char *filepath);
+        static std::vector<std::string> listMembers(const char *mosaicPath);
+        void readWindow(int xOff, int yOff, int xSize, int ySize, float *values) const;
+        void setMaxOpenFiles(std::size_t limit) const;
+        inline int getXSize() const noexcept;
+        inline int getYSize() const noexcept;
+        inline const double *getGeoTransform() const noexcept;
+        inline std::size_t getFileCount() const noexcept;
+        inline const DemMetadata &getFileMetadata(std::size_t fileIndex) const noexcept;
+        inline std::size_t getMaxOpenFiles() const noexcept;
+        std::size_t getOpenFiles() const;
+        std::size_t getPeakOpenFiles() const;
+        inline std::size_t getFileOpens() const noexcept;
+    };
+}
+
+#include "DemMosaic.inl"
@@ -0,0 +1,79 @@
+/* Local Header */
+#include "DemMosaic.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+
+namespace mempa
+{
+    /**
+     * @brief Get the width of the mosaic.
+     *
+     * @return int Pixels across the bounding box of every file.
+     */
+    inline int DemMosaic::getXSize() const noexcept
+    {
+        return rasterXSize;
+    }
+
+    /**
+     * @brief Get the height of the mosaic.
+     *
+     * @return int Pixels down the bounding box of every file.
+     */
+    inline int DemMosaic::getYSize() const noexcept
+    {
+        return rasterYSize;
+    }
+
+    /**
+     * @brief Get the GDAL geotransform of the mosaic.
+     *
+     * @return const double* Array of 6 coefficients, with the origin at the mosaic's top left pixel.
+     */
+    inline const double *DemMosaic::getGeoTransform() const noexcept
+    {
+        return geoTransform;
+    }
+
+    /**
+     * @brief Get the number of files in the mosaic.
+     *
+     * @return std::size_t Files listed by the directory or manifest.
+     */
+    inline std::size_t DemMosaic::getFileCount() const noexcept
+    {
+        return members.size();
+    }
+
+    /**
+     * @brief Get the metadata of one file.
+     *
+     * @param fileIndex Index of the file, in listing order.
+     * @return const DemMetadata& Metadata of the file in its own pixel grid.
+     */
+    inline const DemMetadata &DemMosaic::getFileMetadata(const std::size_t fileIndex) const noexcept
+    {
+        return members[fileIndex].metadata;
+    }
+
+    /**
+     * @brief Get the open file cap.
+     *
+     * @return std::size_t Handles kept open once reads finish.
+     */
+    inline std::size_t DemMosaic::getMaxOpenFiles() const noexcept
+    {
+        return maxOpenFiles;
+    }
+
+    /**
+     * @brief Get the number of times a file had to be opened to serve a read.
+     *
+     * @return std::size_t GDALOpen calls, counting reopens of files closed by the cap.
+     */
+    inline std::size_t DemMosaic::getFileOpens() const noexcept
+    {
+        return fileOpens;
+    }
+}
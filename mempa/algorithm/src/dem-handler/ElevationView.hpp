@@ -0,0 +1,99 @@
+#pragma once
+
+/* mempa::Raster2D */
+#include "Raster2D.hpp"
+
+/* C++ Standard Libraries */
+#include <cstdint>
+#include <utility>
+
+namespace mempa
+{
+    /**
+     * @brief One offset and scale shared by every code of a quantized chunk.
+     *
+     * @details Codes are spread evenly over an elevation range the same way DemTile::quantize spreads them over a tile, and NaN keeps DemTile::NAN_CODE, so the worst error is half a code step.
+     */
+    struct ElevationCodec
+    {
+        inline static constexpr float REUSE_SLACK = 2.0f; /* How many times coarser than a codec fitted to a range one may be and still be used for it. */
+
+        float offset = 0.0f; /* Elevation of code 0. */
+        float scale = 1.0f;  /* Elevation step between neighbouring codes. */
+
+        inline static ElevationCodec fit(double minimum, double maximum) noexcept;
+        inline std::int16_t encode(float value) const noexcept;
+        inline float decode(std::int16_t code) const noexcept;
+        inline float getMaxError() const noexcept;
+        inline bool suits(double minimum, double maximum, float slack = REUSE_SLACK) const noexcept;
+        inline bool operator==(const ElevationCodec &other) const noexcept;
+    };
+
+    /**
+     * @brief Cheap, non-owning view of a chunk's elevations, held either as floats or as 16-bit codes with an @ref ElevationCodec.
+     *
+     * @details Searches read heights through @ref at, which decodes codes as it goes, so a quantized chunk never has a float copy. A float view converts implicitly, so code that only has floats passes them as before.
+     *
+     * A view also carries how far its heights may be from the DEM's own, so a search that compares them with something built from full precision heights can allow for it.
+     */
+    class ElevationView
+    {
+    private:
+        RasterView<const float> values;       /* Elevations. Empty when quantized. */
+        RasterView<const std::int16_t> codes; /* Elevation codes. Empty unless quantized. */
+        ElevationCodec codec;                 /* Offset and scale of the codes. */
+        float maxError = 0.0f;                /* Largest difference between a height read through the view and the DEM's own. */
+
+    protected:
+        /* ElevationView is not designed to be subclassed. */
+
+    public:
+        ElevationView() noexcept = default;
+        inline ElevationView(const RasterView<const float> &values) noexcept;
+        inline ElevationView(const RasterView<float> &values) noexcept;
+        inline ElevationView(const RasterView<const std::int16_t> &codes, ElevationCodec codec, float maxError) noexcept;
+
+        inline float at(int x, int y) const noexcept;
+        inline bool isQuantized() const noexcept;
+        inline const RasterView<const float> &getValues() const noexcept;
+        inline const RasterView<const std::int16_t> &getCodes() const noexcept;
+        inline const ElevationCodec &getCodec() const noexcept;
+        inline float getMaxError() const noexcept;
+        inline int getXSize() const noexcept;
+        inline int getYSize() const noexcept;
+        inline std::pair<int, int> getOrigin() const noexcept;
+        inline bool empty() const noexcept;
+        inline bool contains(std::pair<int, int> globalCoordinate) const noexcept;
+    };
+
+    /**
+     * @brief Owning chunk of elevations, held as floats or, when the DEM is read with quantized storage, as 16-bit codes with an offset and scale of its own.
+     */
+    class ElevationChunk
+    {
+    private:
+        Raster2D<float> values;       /* Elevations. Empty when quantized. */
+        Raster2D<std::int16_t> codes; /* Elevation codes. Empty unless quantized. */
+        ElevationCodec codec;         /* Offset and scale of the codes. */
+        float maxError = 0.0f;        /* Largest difference between a decoded height and the DEM's own. */
+
+    protected:
+        /* ElevationChunk is not designed to be subclassed. */
+
+    public:
+        ElevationChunk() noexcept = default;
+        inline ElevationChunk(Raster2D<float> values) noexcept;
+        inline ElevationChunk(Raster2D<std::int16_t> codes, ElevationCodec codec, float maxError) noexcept;
+
+        inline bool isQuantized() const noexcept;
+        inline Raster2D<float> &getValues() noexcept;
+        inline Raster2D<std::int16_t> &getCodes() noexcept;
+        inline const ElevationCodec &getCodec() const noexcept;
+        inline float getMaxError() const noexcept;
+        inline std::pair<int, int> getOrigin() const noexcept;
+        inline bool empty() const noexcept;
+        inline ElevationView view() const noexcept;
+    };
+}
+
+#include "ElevationView.inl"
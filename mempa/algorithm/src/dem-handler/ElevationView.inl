@@ -0,0 +1,353 @@
+/* Local Header */
+#include "ElevationView.hpp"
+
+/* mempa::DemTile */
+#include "TileCache.hpp"
+
+/* C++ Standard Libraries */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+namespace mempa
+{
+    /**
+     * @brief Spread the codes evenly over an elevation range.
+     *
+     * @param minimum Lowest elevation to encode.
+     * @param maximum Highest elevation to encode.
+     * @return ElevationCodec Codec whose codes span the range, or an identity codec if the range is empty or not finite.
+     */
+    inline ElevationCodec ElevationCodec::fit(const double minimum, const double maximum) noexcept
+    {
+        ElevationCodec codec;
+        if (!std::isfinite(minimum) || !std::isfinite(maximum) || maximum < minimum)
+        {
+            return codec;
+        }
+        codec.offset = static_cast<float>(minimum + (maximum - minimum) / 2.0);
+        codec.scale = maximum > minimum ? static_cast<float>((maximum - minimum) / (2.0 * DemTile::MAX_CODE)) : 1.0f;
+        return codec;
+    }
+
+    /**
+     * @brief Turn an elevation into the nearest code.
+     *
+     * @param value Elevation, NaN for nodata.
+     * @return std::int16_t Code, clamped to the codec's range, or DemTile::NAN_CODE for NaN.
+     */
+    inline std::int16_t ElevationCodec::encode(const float value) const noexcept
+    {
+        if (std::isnan(value))
+        {
+            return DemTile::NAN_CODE;
+        }
+        const long code = std::lround((value - offset) / scale);
+        return static_cast<std::int16_t>(std::clamp(code, -static_cast<long>(DemTile::MAX_CODE), static_cast<long>(DemTile::MAX_CODE)));
+    }
+
+    /**
+     * @brief Turn a code back into an elevation.
+     *
+     * @param code Code from @ref encode.
+     * @return float Elevation, or NaN for DemTile::NAN_CODE.
+     */
+    inline float ElevationCodec::decode(const std::int16_t code) const noexcept
+    {
+        return DemTile::decode(code, offset, scale);
+    }
+
+    /**
+     * @brief Get the largest error @ref encode adds to an elevation inside the fitted range.
+     *
+     * @return float Half a code step.
+     */
+    inline float ElevationCodec::getMaxError() const noexcept
+    {
+        return scale / 2.0f;
+    }
+
+    /**
+     * @brief Check whether the codec can hold a range of elevations about as finely as one fitted to it.
+     *
+     * @param minimum Lowest elevation to encode.
+     * @param maximum Highest elevation to encode.
+     * @param slack How many times coarser than the fitted codec this one may be.
+     * @return true Every elevation in the range is within half a step of a code, at most slack times the fitted step apart. Also true for an empty range.
+     * @return false
+     */
+    inline bool ElevationCodec::suits(const double minimum, const double maximum, const float slack) const noexcept
+    {
+        if (!(minimum <= maximum))
+        {
+            return true;
+        }
+        const double reach = static_cast<double>(scale) * (DemTile::MAX_CODE + 0.5); /* Farthest from the offset a value still rounds to a code within half a step. */
+        return offset - reach <= minimum && maximum <= offset + reach && scale <= slack * fit(minimum, maximum).scale;
+    }
+
+    /**
+     * @brief Check whether two codecs give every code the same elevation.
+     *
+     * @param other Codec to compare with.
+     * @return true Codes can be copied between them unchanged.
+     * @return false
+     */
+    inline bool ElevationCodec::operator==(const ElevationCodec &other) const noexcept
+    {
+        return offset == other.offset && scale == other.scale;
+    }
+
+    /**
+     * @brief View float elevations.
+     *
+     * @param values Elevations of the chunk.
+     */
+    inline ElevationView::ElevationView(const RasterView<const float> &values) noexcept
+        : values(values)
+    {
+    }
+
+    /**
+     * @brief View mutable float elevations read-only.
+     *
+     * @param values Elevations of the chunk.
+     */
+    inline ElevationView::ElevationView(const RasterView<float> &values) noexcept
+        : values(values)
+    {
+    }
+
+    /**
+     * @brief View quantized elevations.
+     *
+     * @param codes Elevation codes of the chunk.
+     * @param codec Offset and scale the codes were made with.
+     * @param maxError Largest difference between a decoded code and the DEM's own elevation.
+     */
+    inline ElevationView::ElevationView(const RasterView<const std::int16_t> &codes, const ElevationCodec codec, const float maxError) noexcept
+        : codes(codes), codec(codec), maxError(maxError)
+    {
+    }
+
+    /**
+     * @brief Get an elevation by local (x, y) index, decoding it if the view is quantized.
+     *
+     * @param x Local column index.
+     * @param y Local row index.
+     * @return float Elevation, NaN for nodata.
+     */
+    inline float ElevationView::at(const int x, const int y) const noexcept
+    {
+        return codes.data() != nullptr ? codec.decode(codes.at(x, y)) : values.at(x, y);
+    }
+
+    /**
+     * @brief Check whether the view holds codes rather than floats.
+     *
+     * @return true Read the codes through @ref at or @ref getCodec.
+     * @return false
+     */
+    inline bool ElevationView::isQuantized() const noexcept
+    {
+        return codes.data() != nullptr;
+    }
+
+    /**
+     * @brief Get the float elevations.
+     *
+     * @return const RasterView<const float>& Empty when quantized.
+     */
+    inline const RasterView<const float> &ElevationView::getValues() const noexcept
+    {
+        return values;
+    }
+
+    /**
+     * @brief Get the elevation codes.
+     *
+     * @return const RasterView<const std::int16_t>& Empty unless quantized.
+     */
+    inline const RasterView<const std::int16_t> &ElevationView::getCodes() const noexcept
+    {
+        return codes;
+    }
+
+    /**
+     * @brief Get the offset and scale of the codes.
+     *
+     * @return const ElevationCodec&
+     */
+    inline const ElevationCodec &ElevationView::getCodec() const noexcept
+    {
+        return codec;
+    }
+
+    /**
+     * @brief Get how far a height read through the view may be from the DEM's own.
+     *
+     * @return float Error bound in meters, 0 for floats.
+     */
+    inline float ElevationView::getMaxError() const noexcept
+    {
+        return maxError;
+    }
+
+    /**
+     * @brief Get the number of columns.
+     *
+     * @return int
+     */
+    inline int ElevationView::getXSize() const noexcept
+    {
+        return isQuantized() ? codes.getXSize() : values.getXSize();
+    }
+
+    /**
+     * @brief Get the number of rows.
+     *
+     * @return int
+     */
+    inline int ElevationView::getYSize() const noexcept
+    {
+        return isQuantized() ? codes.getYSize() : values.getYSize();
+    }
+
+    /**
+     * @brief Get the global image coordinate of element (0, 0).
+     *
+     * @return std::pair<int, int> Global (x, y) coordinate.
+     */
+    inline std::pair<int, int> ElevationView::getOrigin() const noexcept
+    {
+        return isQuantized() ? codes.getOrigin() : values.getOrigin();
+    }
+
+    /**
+     * @brief Check whether the view has no elements.
+     *
+     * @return true The view is empty.
+     * @return false The view has at least one element.
+     */
+    inline bool ElevationView::empty() const noexcept
+    {
+        return isQuantized() ? codes.empty() : values.empty();
+    }
+
+    /**
+     * @brief Check whether a global image coordinate falls inside the view.
+     *
+     * @param globalCoordinate Global (x, y) coordinate.
+     * @return true The coordinate is inside the view.
+     * @return false The coordinate is outside the view.
+     */
+    inline bool ElevationView::contains(const std::pair<int, int> globalCoordinate) const noexcept
+    {
+        return isQuantized() ? codes.contains(globalCoordinate) : values.contains(globalCoordinate);
+    }
+
+    /**
+     * @brief Take ownership of float elevations.
+     *
+     * @param values Elevations of the chunk.
+     */
+    inline ElevationChunk::ElevationChunk(Raster2D<float> values) noexcept
+        : values(std::move(values))
+    {
+    }
+
+    /**
+     * @brief Take ownership of quantized elevations.
+     *
+     * @param codes Elevation codes of the chunk.
+     * @param codec Offset and scale the codes were made with.
+     * @param maxError Largest difference between a decoded code and the DEM's own elevation.
+     */
+    inline ElevationChunk::ElevationChunk(Raster2D<std::int16_t> codes, const ElevationCodec codec, const float maxError) noexcept
+        : codes(std::move(codes)), codec(codec), maxError(maxError)
+    {
+    }
+
+    /**
+     * @brief Check whether the chunk holds codes rather than floats.
+     *
+     * @return true The elevations are in @ref getCodes.
+     * @return false The elevations are in @ref getValues.
+     */
+    inline bool ElevationChunk::isQuantized() const noexcept
+    {
+        return !codes.empty();
+    }
+
+    /**
+     * @brief Get the float elevations, to fill in place.
+     *
+     * @return Raster2D<float>& Empty when quantized.
+     */
+    inline Raster2D<float> &ElevationChunk::getValues() noexcept
+    {
+        return values;
+    }
+
+    /**
+     * @brief Get the elevation codes, to fill in place.
+     *
+     * @return Raster2D<std::int16_t>& Empty unless quantized.
+     */
+    inline Raster2D<std::int16_t> &ElevationChunk::getCodes() noexcept
+    {
+        return codes;
+    }
+
+    /**
+     * @brief Get the offset and scale of the codes.
+     *
+     * @return const ElevationCodec&
+     */
+    inline const ElevationCodec &ElevationChunk::getCodec() const noexcept
+    {
+        return codec;
+    }
+
+    /**
+     * @brief Get how far a decoded height may be from the DEM's own.
+     *
+     * @return float Error bound in meters, 0 for floats.
+     */
+    inline float ElevationChunk::getMaxError() const noexcept
+    {
+        return maxError;
+    }
+
+    /**
+     * @brief Get the global image coordinate of element (0, 0).
+     *
+     * @return std::pair<int, int> Global (x, y) coordinate.
+     */
+    inline std::pair<int, int> ElevationChunk::getOrigin() const noexcept
+    {
+        return isQuantized() ? codes.getOrigin() : values.getOrigin();
+    }
+
+    /**
+     * @brief Check whether the chunk has no elements.
+     *
+     * @return true The chunk is empty.
+     * @return false The chunk has at least one element.
+     */
+    inline bool ElevationChunk::empty() const noexcept
+    {
+        return values.empty() && codes.empty();
+    }
+
+    /**
+     * @brief Get a view of the chunk for the search.
+     *
+     * @return ElevationView View of the codes if quantized, of the floats otherwise.
+     */
+    inline ElevationView ElevationChunk::view() const noexcept
+    {
+        return isQuantized() ? ElevationView(codes.view(), codec, maxError) : ElevationView(values.view());
+    }
+}
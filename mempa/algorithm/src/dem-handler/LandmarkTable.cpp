@@ -0,0 +1,403 @@
+/* Local Header */
+#include "LandmarkTable.hpp"
+
+/* mempa::getSourceKey */
+#include "SourceKey.hpp"
+
+/* IndexedHeap */
+#include "../rover-pathfinding-module/IndexedHeap.hpp"
+
+/* NewDijkstras */
+#include "../rover-pathfinding-module/NewDijkstras.hpp"
+
+/* C++ Standard Libraries */
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* POSIX Libraries */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mempa
+{
+    static_assert(sizeof(LandmarkTable::Header) == 48, "LandmarkTable::Header must have no padding");
+
+    /**
+     * @brief Compute the landmark tables of a raster, kept in memory.
+     *
+     * @param heights Elevation values of the whole raster.
+     * @param landmarkCount Number of landmarks to pick.
+     * @param maxSlope Maximum slope in degrees the rover can climb.
+     * @param pixelSize Pixel size in meters, as given to the searches.
+     *
+     * @throws The raster has no traversable cell.
+     */
+    LandmarkTable::LandmarkTable(const RasterView<const float> &heights, const int landmarkCount, const float maxSlope, const float pixelSize)
+        : xSize(heights.getXSize()), ySize(heights.getYSize()), maxSlope(maxSlope), pixelSize(pixelSize)
+    {
+        computeTables(heights, landmarkCount, maxSlope, pixelSize, [&](const std::pair<int, int> landmark, const std::vector<float> &table)
+                      {
+                          landmarks.push_back(landmark);
+                          ownedCosts.insert(ownedCosts.end(), table.begin(), table.end()); });
+        costs = ownedCosts.data();
+    }
+
+    /**
+     * @brief Unmap the sidecar, if one is loaded.
+     */
+    LandmarkTable::~LandmarkTable()
+    {
+        unmap();
+    }
+
+    /**
+     * @brief Get the sidecar filepath for a DEM.
+     *
+     * @param filepath Filepath to the DEM.
+     * @return std::string The DEM filepath with @ref FILE_EXTENSION appended.
+     */
+    std::string LandmarkTable::sidecarPathFor(const char *const filepath)
+    {
+        return std::string(filepath) + FILE_EXTENSION;
+    }
+
+    /**
+     * @brief Map the tables of a DEM from its sidecar, replacing any tables held before.
+     *
+     * @param filepath Filepath to the DEM, not the sidecar.
+     * @param rasterSize Width and height of the DEM.
+     * @param landmarkCount Number of landmarks the tables must have.
+     * @param maxSlope Slope limit the tables must have been built for.
+     * @param pixelSize Pixel size the tables must have been built with.
+     * @return true The sidecar exists, is intact, and matches the DEM and settings.
+     * @return false The sidecar must be built again. The tables are left empty.
+     */
+    bool LandmarkTable::load(const char *const filepath, const std::pair<int, int> rasterSize, const int landmarkCount, const float maxSlope, const float pixelSize)
+    {
+        unmap();
+        ownedCosts.clear();
+        landmarks.clear();
+        costs = nullptr;
+
+        std::uint64_t sourceSize;    /* Current size of the DEM file. */
+        std::int64_t sourceModified; /* Current modification time of the DEM file. */
+        if (!getSourceKey(filepath, sourceSize, sourceModified) || landmarkCount <= 0)
+        {
+            return false;
+        }
+
+        fileDescriptor = open(sidecarPathFor(filepath).c_str(), O_RDONLY);
+        if (fileDescriptor < 0)
+        {
+            return false;
+        }
+        struct stat fileStatus;                                                                        /* Used for the size of the sidecar. */
+        const std::size_t cells = static_cast<std::size_t>(rasterSize.first) * rasterSize.second;     /* Cells per table. */
+        const std::size_t landmarkBytes = static_cast<std::size_t>(landmarkCount) * 2 * sizeof(std::int32_t); /* Bytes of landmark cells. */
+        if (fstat(fileDescriptor, &fileStatus) != 0 ||
+            static_cast<std::size_t>(fileStatus.st_size) != sizeof(Header) + landmarkBytes + landmarkCount * cells * sizeof(float))
+        {
+            unmap();
+            return false;
+        }
+        mappingSize = static_cast<std::size_t>(fileStatus.st_size);
+        mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+        if (mapping == MAP_FAILED)
+        {
+            mapping = nullptr;
+            unmap();
+            return false;
+        }
+
+        Header inHeader; /* Header read from the sidecar. */
+        std::memcpy(&inHeader, mapping, sizeof(Header));
+        if (std::memcmp(inHeader.magic, MAGIC, sizeof(MAGIC)) != 0 || inHeader.version != VERSION ||
+            inHeader.sourceSize != sourceSize || inHeader.sourceModified != sourceModified ||
+            inHeader.xSize != rasterSize.first || inHeader.ySize != rasterSize.second || inHeader.landmarkCount != landmarkCount ||
+            inHeader.maxSlope != maxSlope || inHeader.pixelSize != pixelSize)
+        {
+            unmap();
+            return false;
+        }
+
+        const char *const landmarkBytesStart = static_cast<const char *>(mapping) + sizeof(Header); /* Landmark cells in the mapping. */
+        for (int landmark = 0; landmark < landmarkCount; ++landmark)
+        {
+            std::int32_t cell[2]; /* (x, y) of this landmark. */
+            std::memcpy(cell, landmarkBytesStart + landmark * sizeof(cell), sizeof(cell));
+            landmarks.emplace_back(cell[0], cell[1]);
+        }
+        costs = reinterpret_cast<const float *>(landmarkBytesStart + landmarkBytes);
+        xSize = inHeader.xSize;
+        ySize = inHeader.ySize;
+        this->maxSlope = inHeader.maxSlope;
+        this->pixelSize = inHeader.pixelSize;
+        return true;
+    }
+
+    /**
+     * @brief Compute the landmark tables of a whole DEM and write them to its sidecar, keyed to the DEM's current size and modification time.
+     *
+     * @details The whole DEM is read at once, and each table is written as soon as its search finishes, so only one table is held in memory. The build is refused rather than started when that does not fit the memory budget. The sidecar is written beside its final path and renamed into place once complete.
+     *
+     * @param elevationRaster DEM to compute the tables of.
+     * @param filepath Filepath to the DEM, not the sidecar.
+     * @param landmarkCount Number of landmarks to pick.
+     * @param maxSlope Maximum slope in degrees the rover can climb.
+     * @param pixelSize Pixel size in meters, as given to the searches.
+     * @param memoryBytes Most the build may hold, 0 to allow up to @ref MAX_BUILD_CELLS cells.
+     *
+     * @throws The DEM does not fit the memory budget or has no traversable cell, or failure to stat or read the DEM or write the sidecar.
+     */
+    void LandmarkTable::build(const DemHandler &elevationRaster, const char *const filepath, const int landmarkCount, const float maxSlope, const float pixelSize, const std::size_t memoryBytes)
+    {
+        if (landmarkCount <= 0)
+        {
+            throw std::invalid_argument("build: landmark count must be positive");
+        }
+        const std::size_t cells = static_cast<std::size_t>(elevationRaster.getXSize()) * elevationRaster.getYSize(); /* DEM cells searched at once. */
+        if (memoryBytes == 0 && cells > MAX_BUILD_CELLS)
+        {
+            throw std::invalid_argument("build: DEM is too large to search as a whole");
+        }
+        if (memoryBytes > 0 && cells * buildBytesPerCell() > memoryBytes)
+        {
+            throw std::invalid_argument("build: searching the whole DEM needs " + std::to_string(cells * buildBytesPerCell()) + " bytes, more than the memory budget of " + std::to_string(memoryBytes));
+        }
+
+        Header outHeader{}; /* Header to write, with the landmark count filled in once known. */
+        std::memcpy(outHeader.magic, MAGIC, sizeof(MAGIC));
+        outHeader.version = VERSION;
+        outHeader.xSize = elevationRaster.getXSize();
+        outHeader.ySize = elevationRaster.getYSize();
+        outHeader.maxSlope = maxSlope;
+        outHeader.pixelSize = pixelSize;
+        if (!getSourceKey(filepath, outHeader.sourceSize, outHeader.sourceModified))
+        {
+            throw std::runtime_error("build: stat() error");
+        }
+        const Raster2D<float> heights = elevationRaster.readRectangleChunk({{0, 0}, {outHeader.xSize - 1, outHeader.ySize - 1}}, 0);
+
+        const std::string sidecarFilepath = sidecarPathFor(filepath);
+        const std::string temporaryFilepath = sidecarFilepath + ".partial"; /* Written first, then renamed. */
+        std::ofstream outFile(temporaryFilepath, std::ios::binary | std::ios::trunc);
+        if (!outFile)
+        {
+            throw std::runtime_error("build: failed to create " + temporaryFilepath);
+        }
+
+        /* The landmark cells come before the tables, so their space is skipped and filled in at the end. */
+        const std::streamoff landmarkBytes = static_cast<std::streamoff>(landmarkCount) * 2 * sizeof(std::int32_t); /* Bytes reserved for landmark cells. */
+        std::vector<std::pair<int, int>> pickedLandmarks;                                                          /* Landmarks in the order their tables were written. */
+        try
+        {
+            outFile.seekp(static_cast<std::streamoff>(sizeof(Header)) + landmarkBytes);
+            computeTables(heights.view(), landmarkCount, maxSlope, pixelSize, [&](const std::pair<int, int> landmark, const std::vector<float> &table)
+                          {
+                              pickedLandmarks.push_back(landmark);
+                              outFile.write(reinterpret_cast<const char *>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(float))); });
+        }
+        catch (...)
+        {
+            outFile.close();
+            std::remove(temporaryFilepath.c_str());
+            throw;
+        }
+
+        /* Fewer landmarks than asked for would leave a gap before the tables, and a sidecar that never loads for the count asked for. */
+        outHeader.landmarkCount = static_cast<std::int32_t>(pickedLandmarks.size());
+        if (outHeader.landmarkCount != landmarkCount)
+        {
+            outFile.close();
+            std::remove(temporaryFilepath.c_str());
+            throw std::runtime_error("build: only " + std::to_string(pickedLandmarks.size()) + " distinct landmarks on the traversable terrain");
+        }
+        outFile.seekp(0);
+        outFile.write(reinterpret_cast<const char *>(&outHeader), sizeof(Header));
+        for (const std::pair<int, int> &landmark : pickedLandmarks)
+        {
+            const std::int32_t cell[2] = {landmark.first, landmark.second}; /* (x, y) of this landmark. */
+            outFile.write(reinterpret_cast<const char *>(cell), sizeof(cell));
+        }
+
+        outFile.close();
+        if (!outFile || std::rename(temporaryFilepath.c_str(), sidecarFilepath.c_str()) != 0)
+        {
+            std::remove(temporaryFilepath.c_str());
+            throw std::runtime_error("build: failed to write " + sidecarFilepath);
+        }
+    }
+
+    /**
+     * @brief Bytes @ref computeTables holds per raster cell: the elevations, the table being searched, the costs from the nearest landmark and the frontier.
+     *
+     * @return std::size_t
+     */
+    std::size_t LandmarkTable::buildBytesPerCell() noexcept
+    {
+        return 3 * sizeof(float) + IndexedHeap::bytes_per_index();
+    }
+
+    /**
+     * @brief Pick the landmarks of a raster by the farthest-point rule and find the least cost from each to every cell.
+     *
+     * @details A cell is traversable if at least one step out of it is within the slope limit. The searches are Dijkstra's over the whole raster, with costs accumulated in floats as NewDijkstras accumulates them. Picking stops early if every cell a landmark reaches is already a landmark.
+     *
+     * @param heights Elevation values of the whole raster.
+     * @param landmarkCount Number of landmarks to pick.
+     * @param maxSlope Maximum slope in degrees the rover can climb.
+     * @param pixelSize Pixel size in meters.
+     * @param onTable Called with each landmark and its table, in the order they are picked.
+     *
+     * @throws The raster has no traversable cell.
+     */
+    void LandmarkTable::computeTables(const RasterView<const float> &heights, const int landmarkCount, const float maxSlope, const float pixelSize, const std::function<void(std::pair<int, int>, const std::vector<float> &)> &onTable)
+    {
+        constexpr float UNREACHED = std::numeric_limits<float>::infinity();
+        const int columns = heights.getXSize(); /* Raster width. */
+        const int rows = heights.getYSize();    /* Raster height. */
+        const int cells = columns * rows;       /* Raster cells. */
+
+        /* Cost of a step, false if it leaves the raster or is too steep, exactly as NewDijkstras checks and costs it. */
+        const auto stepCost = [&](const int row, const int col, const int step, double &cost)
+        {
+            const int neighbourRow = row + NewDijkstras::ROW_STEPS[step];
+            const int neighbourCol = col + NewDijkstras::COL_STEPS[step];
+            if (neighbourRow < 0 || neighbourRow >= rows || neighbourCol < 0 || neighbourCol >= columns)
+            {
+                return false;
+            }
+            const bool diagonal = NewDijkstras::ROW_STEPS[step] != 0 && NewDijkstras::COL_STEPS[step] != 0;
+            const double rise = std::abs(heights[row][col] - heights[neighbourRow][neighbourCol]);
+            if (!NewDijkstras::step_navigable(rise, diagonal, maxSlope, pixelSize))
+            {
+                return false;
+            }
+            cost = NewDijkstras::calculate_distance_between_nodes(diagonal, rise, pixelSize);
+            return true;
+        };
+
+        std::vector<float> table(cells);  /* Costs from the landmark being searched from. */
+        IndexedHeap frontier;             /* Reached cells that are not finalized yet. */
+        const auto searchFrom = [&](const int source)
+        {
+            std::fill(table.begin(), table.end(), UNREACHED);
+            frontier.reset(cells);
+            table[source] = 0.0f;
+            frontier.push_or_decrease(source, 0.0);
+            while (!frontier.empty())
+            {
+                const int index = frontier.pop();
+                const int row = index / columns;
+                const int col = index % columns;
+                for (int step = 0; step < 8; ++step)
+                {
+                    double cost; /* Cost of this step. */
+                    if (!stepCost(row, col, step, cost))
+                    {
+                        continue;
+                    }
+                    const int neighbour = index + NewDijkstras::ROW_STEPS[step] * columns + NewDijkstras::COL_STEPS[step];
+                    const double reached = table[index] + cost;
+                    if (reached < table[neighbour])
+                    {
+                        table[neighbour] = static_cast<float>(reached);
+                        frontier.push_or_decrease(neighbour, reached);
+                    }
+                }
+            }
+        };
+
+        /* Seed from the traversable cell nearest the middle, scanning outward ring by ring. */
+        int seed = -1; /* Flat index of the seed cell. */
+        const int middleRow = rows / 2;
+        const int middleCol = columns / 2;
+        for (int radius = 0; seed < 0 && radius <= std::max(rows, columns); ++radius)
+        {
+            for (int row = std::max(0, middleRow - radius); seed < 0 && row <= std::min(rows - 1, middleRow + radius); ++row)
+            {
+                for (int col = std::max(0, middleCol - radius); seed < 0 && col <= std::min(columns - 1, middleCol + radius); ++col)
+                {
+                    if (std::max(std::abs(row - middleRow), std::abs(col - middleCol)) != radius)
+                    {
+                        continue;
+                    }
+                    double cost;
+                    for (int step = 0; step < 8 && seed < 0; ++step)
+                    {
+                        if (stepCost(row, col, step, cost))
+                        {
+                            seed = row * columns + col;
+                        }
+                    }
+                }
+            }
+        }
+        if (seed < 0)
+        {
+            throw std::invalid_argument("computeTables: no cell is traversable at this slope limit");
+        }
+
+        /* The cell farthest from the seed is the first landmark, then the cell farthest from its nearest landmark. */
+        std::vector<float> nearestCost(cells, UNREACHED); /* Cost from each cell's nearest landmark. */
+        searchFrom(seed);
+        const std::vector<float> *farthestFrom = &table; /* Costs the next landmark is the farthest cell of. */
+        for (int picked = 0; picked < landmarkCount; ++picked)
+        {
+            int landmark = -1;      /* Flat index of the next landmark. */
+            float farthest = 0.0f;  /* Its cost from the seed or its nearest landmark. */
+            for (int index = 0; index < cells; ++index)
+            {
+                const float cost = (*farthestFrom)[index];
+                if (cost != UNREACHED && (cost > farthest || (landmark < 0 && picked == 0)))
+                {
+                    landmark = index;
+                    farthest = cost;
+                }
+            }
+            if (landmark < 0)
+            {
+                break;
+            }
+
+            searchFrom(landmark);
+            onTable({landmark % columns, landmark / columns}, table);
+            for (int index = 0; index < cells; ++index)
+            {
+                nearestCost[index] = std::min(nearestCost[index], table[index]);
+            }
+            farthestFrom = &nearestCost;
+        }
+    }
+
+    /**
+     * @brief Release the sidecar mapping and descriptor, if any.
+     */
+    void LandmarkTable::unmap() noexcept
+    {
+        if (mapping != nullptr)
+        {
+            munmap(mapping, mappingSize);
+            mapping = nullptr;
+            mappingSize = 0;
+            costs = nullptr;
+        }
+        if (fileDescriptor >= 0)
+        {
+            close(fileDescriptor);
+            fileDescriptor = -1;
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+/* mempa::DemHandler */
+#include "DemHandler.hpp"
+
+/* mempa::Raster2D */
+#include "Raster2D.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mempa
+{
+    /**
+     * @brief Least cost from a few landmark cells to every cell of a DEM, for ALT (A*, landmarks and the triangle inequality) lower bounds.
+     *
+     * @details A route from a cell to a goal cannot cost less than the difference between their costs from any landmark, because a step costs the same both ways. Where the terrain is rugged, detours make those differences far tighter than the straight-line distance. The costs are found by Dijkstra's searches over the whole DEM, with the slope check and step cost NewDijkstras uses, so a search confined to a chunk finds costs no lower than the table's. A table built for a slope limit also bounds searches with a lower limit, which only removes steps.
+     *
+     * Landmarks are picked on traversable terrain by the farthest-point rule: the first is the cell farthest from a traversable cell near the middle of the DEM, and each next one is the cell whose cost from its nearest landmark is highest. Cells no landmark can reach keep an infinite cost, which tells a search those cells cannot reach the goal.
+     *
+     * Building takes one search over the whole DEM per landmark, so the tables are saved to a sidecar next to the DEM. The sidecar records the DEM's size and modification time along with the slope limit and pixel size, and is ignored once any of them differ.
+     *
+     * ## Sidecar Layout
+     *
+     * - A fixed @ref Header.
+     * - Header::landmarkCount (x, y) Int32 pairs, the raster cell of each landmark.
+     * - Header::landmarkCount tables of Header::xSize * Header::ySize Float32 costs, row-major.
+     */
+    class LandmarkTable
+    {
+    public:
+        /**
+         * @brief Fixed-size header at the start of a landmark table sidecar.
+         */
+        struct Header
+        {
+            char magic[8];               /* Always @ref MAGIC. */
+            std::uint32_t version;       /* Format version, currently @ref VERSION. */
+            std::int32_t xSize;          /* Raster width in pixels. */
+            std::int32_t ySize;          /* Raster height in pixels. */
+            std::int32_t landmarkCount;  /* Number of landmarks and tables. */
+            float maxSlope;              /* Slope limit in degrees the tables were built for. */
+            float pixelSize;             /* Pixel size in meters the step costs were computed with. */
+            std::uint64_t sourceSize;    /* Size in bytes of the DEM file. */
+            std::int64_t sourceModified; /* Modification time of the DEM file, in seconds. */
+        };
+
+        inline static constexpr char MAGIC[8] = {'M', 'E', 'M', 'P', 'A', 'A', 'L', 'T'}; /* File signature. */
+        inline static constexpr std::uint32_t VERSION = 1;                                 /* Current format version. */
+        inline static constexpr int DEFAULT_LANDMARKS = 8;                                 /* Enough to bound most queries tightly for 32 bytes per pixel. */
+        inline static constexpr std::size_t MAX_BUILD_CELLS = std::size_t(1) << 25;        /* Largest DEM built without a memory budget, about 570 MB of search state. */
+        inline static constexpr const char *FILE_EXTENSION = ".mempa-alt";                 /* Suffix appended to a DEM path for its sidecar. */
+
+    private:
+        std::vector<float> ownedCosts;                  /* Tables computed in memory. Empty when the tables are mapped from a sidecar. */
+        int fileDescriptor = -1;                        /* Open descriptor of the sidecar, -1 if none. */
+        void *mapping = nullptr;                        /* Start of the read-only mapping of the sidecar. */
+        std::size_t mappingSize = 0;                    /* Size of the mapping in bytes. */
+        const float *costs = nullptr;                   /* One table per landmark, in ownedCosts or the mapping. */
+        std::vector<std::pair<int, int>> landmarks;     /* Raster (x, y) cell of each landmark. */
+        int xSize = 0;                                  /* Raster width in cells. */
+        int ySize = 0;                                  /* Raster height in cells. */
+        float maxSlope = 0.0f;                          /* Slope limit in degrees the tables were built for. */
+        float pixelSize = 0.0f;                         /* Pixel size in meters the tables were built with. */
+
+        static std::size_t buildBytesPerCell() noexcept;
+        static void computeTables(const RasterView<const float> &heights, int landmarkCount, float maxSlope, float pixelSize, const std::function<void(std::pair<int, int>, const std::vector<float> &)> &onTable);
+        void unmap() noexcept;
+
+    protected:
+        /* LandmarkTable is not designed to be subclassed. */
+
+    public:
+        LandmarkTable() noexcept = default;
+        explicit LandmarkTable(const RasterView<const float> &heights, int landmarkCount, float maxSlope, float pixelSize);
+        ~LandmarkTable();
+        LandmarkTable(const LandmarkTable &) = delete;
+        LandmarkTable &operator=(const LandmarkTable &) = delete;
+
+        static std::string sidecarPathFor(const char *filepath);
+        bool load(const char *filepath, std::pair<int, int> rasterSize, int landmarkCount, float maxSlope, float pixelSize);
+        static void build(const DemHandler &elevationRaster, const char *filepath, int landmarkCount, float maxSlope, float pixelSize, std::size_t memoryBytes);
+
+        inline bool empty() const noexcept;
+        inline int getXSize() const noexcept;
+        inline int getYSize() const noexcept;
+        inline int getLandmarkCount() const noexcept;
+        inline std::pair<int, int> getLandmark(int landmark) const noexcept;
+        inline float getMaxSlope() const noexcept;
+        inline float getPixelSize() const noexcept;
+        inline float getCost(int landmark, int x, int y) const noexcept;
+    };
+}
+
+#include "LandmarkTable.inl"
@@ -0,0 +1,94 @@
+/* Local Header */
+#include "LandmarkTable.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <utility>
+
+namespace mempa
+{
+    /**
+     * @brief Check whether the tables hold any landmarks.
+     *
+     * @return true Nothing has been computed or loaded.
+     * @return false
+     */
+    inline bool LandmarkTable::empty() const noexcept
+    {
+        return costs == nullptr || landmarks.empty();
+    }
+
+    /**
+     * @brief Get the width of the raster the tables cover.
+     *
+     * @return int Number of cells per row.
+     */
+    inline int LandmarkTable::getXSize() const noexcept
+    {
+        return xSize;
+    }
+
+    /**
+     * @brief Get the height of the raster the tables cover.
+     *
+     * @return int Number of cells per column.
+     */
+    inline int LandmarkTable::getYSize() const noexcept
+    {
+        return ySize;
+    }
+
+    /**
+     * @brief Get the number of landmarks, which can be fewer than asked for when the traversable terrain has fewer distinct cells.
+     *
+     * @return int Number of landmarks and tables.
+     */
+    inline int LandmarkTable::getLandmarkCount() const noexcept
+    {
+        return static_cast<int>(landmarks.size());
+    }
+
+    /**
+     * @brief Get the cell of a landmark.
+     *
+     * @param landmark Index of the landmark.
+     * @return std::pair<int, int> Raster (x, y) cell.
+     */
+    inline std::pair<int, int> LandmarkTable::getLandmark(const int landmark) const noexcept
+    {
+        return landmarks[landmark];
+    }
+
+    /**
+     * @brief Get the slope limit the tables were built for.
+     *
+     * @return float Slope limit in degrees. The tables bound searches with this limit or a lower one.
+     */
+    inline float LandmarkTable::getMaxSlope() const noexcept
+    {
+        return maxSlope;
+    }
+
+    /**
+     * @brief Get the pixel size the tables were built with.
+     *
+     * @return float Pixel size in meters.
+     */
+    inline float LandmarkTable::getPixelSize() const noexcept
+    {
+        return pixelSize;
+    }
+
+    /**
+     * @brief Get the least cost from a landmark to a cell.
+     *
+     * @param landmark Index of the landmark.
+     * @param x Raster column.
+     * @param y Raster row.
+     * @return float Cost in meters, infinite if the landmark cannot reach the cell.
+     */
+    inline float LandmarkTable::getCost(const int landmark, const int x, const int y) const noexcept
+    {
+        return costs[(static_cast<std::size_t>(landmark) * ySize + y) * xSize + x];
+    }
+}
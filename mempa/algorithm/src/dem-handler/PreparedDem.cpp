@@ -0,0 +1,261 @@
+/* Local Header */
+#include "PreparedDem.hpp"
+
+/* libgdal-dev */
+#include <gdal_priv.h>
+
+/* C++ Standard Libraries */
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/* POSIX Libraries */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mempa
+{
+    static_assert(sizeof(PreparedDem::Header) == 104, "PreparedDem::Header must have no padding");
+
+    /**
+     * @brief Open a prepared DEM file and map it read-only into memory.
+     *
+     * @param preparedFilepath Filepath to a file written by @ref convert.
+     *
+     * @throws Failure to open, map or validate the file.
+     */
+    PreparedDem::PreparedDem(const char *const preparedFilepath)
+    {
+        if (!isLittleEndianHost())
+        {
+            throw std::runtime_error("PreparedDem: big-endian hosts are not supported");
+        }
+
+        fileDescriptor = open(preparedFilepath, O_RDONLY);
+        if (fileDescriptor < 0)
+        {
+            throw std::runtime_error("PreparedDem: open() error");
+        }
+
+        struct stat fileStatus; /* Used for the size of the file. */
+        if (fstat(fileDescriptor, &fileStatus) != 0 || static_cast<std::size_t>(fileStatus.st_size) < sizeof(Header))
+        {
+            close(fileDescriptor);
+            throw std::runtime_error("PreparedDem: file is too small");
+        }
+
+        mappingSize = static_cast<std::size_t>(fileStatus.st_size);
+        mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+        if (mapping == MAP_FAILED)
+        {
+            close(fileDescriptor);
+            throw std::runtime_error("PreparedDem: mmap() error");
+        }
+
+        /* Validate the header before trusting any offsets in it. */
+        std::memcpy(&header, mapping, sizeof(Header));
+        const int tilesPerColumn = header.tileYSize > 0 ? (header.ySize + header.tileYSize - 1) / header.tileYSize : 0; /* Number of tiles down the raster. */
+        tilesPerRow = header.tileXSize > 0 ? (header.xSize + header.tileXSize - 1) / header.tileXSize : 0;
+        const std::size_t tileBytes = static_cast<std::size_t>(header.tileXSize) * header.tileYSize * sizeof(float); /* Bytes stored per tile. */
+        const char *failure = nullptr;                                                                                /* Reason the file was rejected. */
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+        {
+            failure = "PreparedDem: not a prepared DEM file";
+        }
+        else if (header.version != VERSION)
+        {
+            failure = "PreparedDem: unsupported format version";
+        }
+        else if (header.xSize <= 0 || header.ySize <= 0 || header.tileXSize <= 0 || header.tileYSize <= 0 || header.dataOffset % PAGE_SIZE != 0 ||
+                 sizeof(Header) + header.wktLength > header.dataOffset ||
+                 header.dataOffset + static_cast<std::size_t>(tilesPerRow) * tilesPerColumn * tileBytes > mappingSize)
+        {
+            failure = "PreparedDem: truncated or corrupt file";
+        }
+        if (failure != nullptr)
+        {
+            munmap(mapping, mappingSize);
+            close(fileDescriptor);
+            throw std::runtime_error(failure);
+        }
+
+        const char *const mappedBytes = static_cast<const char *>(mapping); /* Byte view of the mapping. */
+        projectionWkt.assign(mappedBytes + sizeof(Header), header.wktLength);
+        tileData = reinterpret_cast<const float *>(mappedBytes + header.dataOffset);
+    }
+
+    /**
+     * @brief Unmap and close the prepared DEM file.
+     */
+    PreparedDem::~PreparedDem()
+    {
+        munmap(mapping, mappingSize);
+        close(fileDescriptor);
+    }
+
+    /**
+     * @brief Convert a GDAL-readable DEM into the prepared, memory-mappable format.
+     *
+     * @details The file is written next to its final path and renamed into place once complete, so a partially written file is never picked up.
+     *
+     * @param demFilepath Filepath to the source DEM raster.
+     * @param preparedFilepath Filepath to write the prepared DEM to.
+     * @param tileSize Width and height of each tile. Must keep every tile a whole number of pages.
+     *
+     * @throws Failure to perform GDAL functions or to write the output file.
+     */
+    void PreparedDem::convert(const char *const demFilepath, const char *const preparedFilepath, const int tileSize)
+    {
+        if (!isLittleEndianHost())
+        {
+            throw std::runtime_error("convert: big-endian hosts are not supported");
+        }
+        if (tileSize <= 0 || (static_cast<std::size_t>(tileSize) * tileSize * sizeof(float)) % PAGE_SIZE != 0)
+        {
+            throw std::invalid_argument("convert: tile size must keep tiles page-aligned");
+        }
+
+        GDALAllRegister();
+        GDALDatasetUniquePtr poDataset(GDALDataset::FromHandle(GDALOpen(demFilepath, GA_ReadOnly))); /* Source dataset. */
+        if (!poDataset)
+        {
+            throw std::runtime_error("convert: GDALOpen() error");
+        }
+        GDALRasterBand *const poBand = poDataset->GetRasterBand(1); /* Elevation band. */
+        if (!poBand)
+        {
+            throw std::runtime_error("convert: GetRasterBand() error");
+        }
+
+        Header outHeader{}; /* Header to write. */
+        std::memcpy(outHeader.magic, MAGIC, sizeof(MAGIC));
+        outHeader.version = VERSION;
+        outHeader.xSize = poBand->GetXSize();
+        outHeader.ySize = poBand->GetYSize();
+        outHeader.tileXSize = tileSize;
+        outHeader.tileYSize = tileSize;
+        if (poDataset->GetGeoTransform(outHeader.geoTransform) != CE_None)
+        {
+            throw std::runtime_error("convert: GetGeoTransform() error");
+        }
+        int hasNoData = 0; /* Set by GDAL if the band declares nodata. */
+        outHeader.noDataValue = poBand->GetNoDataValue(&hasNoData);
+        outHeader.hasNoData = hasNoData ? 1 : 0;
+        const char *const projection = poDataset->GetProjectionRef(); /* CRS WKT of the source. */
+        if (projection == nullptr || projection[0] == '\0')
+        {
+            throw std::runtime_error("convert: GetProjectionRef() error");
+        }
+        outHeader.wktLength = std::strlen(projection);
+        outHeader.dataOffset = ((sizeof(Header) + outHeader.wktLength + PAGE_SIZE - 1) / PAGE_SIZE) * PAGE_SIZE;
+
+        const std::string temporaryFilepath = std::string(preparedFilepath) + ".partial"; /* Written first, then renamed. */
+        std::ofstream outFile(temporaryFilepath, std::ios::binary | std::ios::trunc);
+        if (!outFile)
+        {
+            throw std::runtime_error("convert: failed to create " + temporaryFilepath);
+        }
+        outFile.write(reinterpret_cast<const char *>(&outHeader), sizeof(Header));
+        outFile.write(projection, static_cast<std::streamsize>(outHeader.wktLength));
+        const std::vector<char> padding(outHeader.dataOffset - sizeof(Header) - outHeader.wktLength, 0); /* Zeroes up to the first page boundary. */
+        outFile.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+        /* Read one row of tiles at a time so strip-organized sources are decoded sequentially. */
+        const float padValue = hasNoData ? static_cast<float>(outHeader.noDataValue) : std::numeric_limits<float>::quiet_NaN(); /* Fill for edge tiles. */
+        std::vector<float> tileRow(static_cast<std::size_t>(outHeader.xSize) * tileSize);                                        /* One band of tileSize rows. */
+        std::vector<float> tile(static_cast<std::size_t>(tileSize) * tileSize);                                                  /* One tile being written. */
+        for (int yOff = 0; yOff < outHeader.ySize; yOff += tileSize)
+        {
+            const int rows = std::min(tileSize, outHeader.ySize - yOff); /* Valid rows in this band of tiles. */
+            if (poBand->RasterIO(GF_Read, 0, yOff, outHeader.xSize, rows, tileRow.data(), outHeader.xSize, rows, GDT_Float32, 0, 0) != CE_None)
+            {
+                outFile.close();
+                std::remove(temporaryFilepath.c_str());
+                throw std::runtime_error("convert: RasterIO() error");
+            }
+            for (int xOff = 0; xOff < outHeader.xSize; xOff += tileSize)
+            {
+                const int cols = std::min(tileSize, outHeader.xSize - xOff); /* Valid columns in this tile. */
+                std::fill(tile.begin(), tile.end(), padValue);
+                for (int row = 0; row < rows; ++row)
+                {
+                    const float *source = tileRow.data() + static_cast<std::size_t>(row) * outHeader.xSize + xOff;
+                    std::copy(source, source + cols, tile.begin() + static_cast<std::size_t>(row) * tileSize);
+                }
+                outFile.write(reinterpret_cast<const char *>(tile.data()), static_cast<std::streamsize>(tile.size() * sizeof(float)));
+            }
+        }
+
+        outFile.close();
+        if (!outFile || std::rename(temporaryFilepath.c_str(), preparedFilepath) != 0)
+        {
+            std::remove(temporaryFilepath.c_str());
+            throw std::runtime_error("convert: failed to write " + std::string(preparedFilepath));
+        }
+    }
+
+    /**
+     * @brief Get the default prepared filepath for a DEM.
+     *
+     * @param demFilepath Filepath to the source DEM raster.
+     * @return std::string The DEM filepath with @ref FILE_EXTENSION appended.
+     */
+    std::string PreparedDem::preparedPathFor(const char *const demFilepath)
+    {
+        return std::string(demFilepath) + FILE_EXTENSION;
+    }
+
+    /**
+     * @brief Check whether a filepath names a prepared DEM rather than a GDAL raster.
+     *
+     * @param filepath Filepath to check.
+     * @return true The filepath ends in @ref FILE_EXTENSION.
+     * @return false The filepath should be opened through GDAL.
+     */
+    bool PreparedDem::isPreparedPath(const char *const filepath) noexcept
+    {
+        const std::size_t pathLength = std::strlen(filepath);           /* Length of the filepath. */
+        const std::size_t extensionLength = std::strlen(FILE_EXTENSION); /* Length of the prepared extension. */
+        return pathLength > extensionLength && std::strcmp(filepath + pathLength - extensionLength, FILE_EXTENSION) == 0;
+    }
+
+    /**
+     * @brief Check whether a DEM has a prepared file next to it that is at least as new as the DEM.
+     *
+     * @param demFilepath Filepath to the source DEM raster.
+     * @return true The prepared file can be used in place of the DEM.
+     * @return false The DEM must be read through GDAL.
+     */
+    bool PreparedDem::isUsableFor(const char *const demFilepath) noexcept
+    {
+        struct stat demStatus;      /* Status of the source DEM. */
+        struct stat preparedStatus; /* Status of the prepared file. */
+        if (stat(preparedPathFor(demFilepath).c_str(), &preparedStatus) != 0)
+        {
+            return false;
+        }
+        return stat(demFilepath, &demStatus) != 0 || preparedStatus.st_mtime >= demStatus.st_mtime;
+    }
+
+    /**
+     * @brief Check the byte order of the host.
+     *
+     * @return true The host is little-endian.
+     * @return false The host is big-endian.
+     */
+    bool PreparedDem::isLittleEndianHost() noexcept
+    {
+        const std::uint32_t probe = 1; /* Low byte is set on little-endian hosts. */
+        unsigned char firstByte;       /* First byte of the probe in memory. */
+        std::memcpy(&firstByte, &probe, 1);
+        return firstByte == 1;
+    }
+}
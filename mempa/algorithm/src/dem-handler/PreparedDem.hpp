@@ -0,0 +1,88 @@
+#pragma once
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mempa
+{
+    /**
+     * @brief Read-only, memory-mapped view of a DEM that has been converted by `mempa-prep`.
+     *
+     * ## File Layout
+     *
+     * All values are little-endian.
+     *
+     * - A fixed @ref Header.
+     * - The CRS WKT string (Header::wktLength bytes, not null-terminated).
+     * - Zero padding up to Header::dataOffset, which is page-aligned.
+     * - Every tile in row-major tile order. Each tile holds tileXSize * tileYSize Float32 values, row-major. Edge tiles are padded with the nodata value (or NaN).
+     *
+     * Tiles are a whole number of pages, so every tile starts on a page boundary and can be read straight out of the mapping with no decode step.
+     */
+    class PreparedDem
+    {
+    public:
+        /**
+         * @brief Fixed-size header at the start of a prepared DEM file.
+         */
+        struct Header
+        {
+            char magic[8];             /* Always @ref MAGIC. */
+            std::uint32_t version;     /* Format version, currently @ref VERSION. */
+            std::int32_t xSize;        /* Raster width in pixels. */
+            std::int32_t ySize;        /* Raster height in pixels. */
+            std::int32_t tileXSize;    /* Tile width in pixels. */
+            std::int32_t tileYSize;    /* Tile height in pixels. */
+            std::uint32_t hasNoData;   /* Non-zero if noDataValue is meaningful. */
+            double geoTransform[6];    /* GDAL geotransform coefficients. */
+            double noDataValue;        /* Raster nodata value. */
+            std::uint64_t wktLength;   /* Length of the CRS WKT that follows the header. */
+            std::uint64_t dataOffset;  /* Page-aligned byte offset of the first tile. */
+        };
+
+        inline static constexpr char MAGIC[8] = {'M', 'E', 'M', 'P', 'A', 'D', 'E', 'M'}; /* File signature. */
+        inline static constexpr std::uint32_t VERSION = 1;                                 /* Current format version. */
+        inline static constexpr int DEFAULT_TILE_SIZE = 256;                               /* 256 x 256 Float32 tiles are 64 pages each. */
+        inline static constexpr std::size_t PAGE_SIZE = 4096;                              /* Alignment used for the tile data. */
+        inline static constexpr const char *FILE_EXTENSION = ".mempa";                     /* Suffix appended to a DEM path for its prepared file. */
+
+    private:
+        int fileDescriptor = -1;              /* Open descriptor of the prepared file. */
+        void *mapping = nullptr;              /* Start of the read-only mapping. */
+        std::size_t mappingSize = 0;          /* Size of the mapping in bytes. */
+        Header header;                        /* Copy of the file header. */
+        std::string projectionWkt;            /* CRS WKT copied out of the file. */
+        const float *tileData = nullptr;      /* First tile inside the mapping. */
+        int tilesPerRow = 0;                  /* Number of tiles across the raster. */
+
+        static bool isLittleEndianHost() noexcept;
+
+    protected:
+        /* PreparedDem is not designed to be subclassed. */
+
+    public:
+        explicit PreparedDem(const char *preparedFilepath);
+        ~PreparedDem();
+        PreparedDem(const PreparedDem &) = delete;
+        PreparedDem &operator=(const PreparedDem &) = delete;
+
+        static void convert(const char *demFilepath, const char *preparedFilepath, int tileSize = DEFAULT_TILE_SIZE);
+        static std::string preparedPathFor(const char *demFilepath);
+        static bool isPreparedPath(const char *filepath) noexcept;
+        static bool isUsableFor(const char *demFilepath) noexcept;
+
+        inline int getXSize() const noexcept;
+        inline int getYSize() const noexcept;
+        inline int getTileXSize() const noexcept;
+        inline int getTileYSize() const noexcept;
+        inline const double *getGeoTransform() const noexcept;
+        inline const char *getProjectionWkt() const noexcept;
+        inline bool hasNoDataValue() const noexcept;
+        inline double getNoDataValue() const noexcept;
+        inline const float *getTile(int tileX, int tileY) const noexcept;
+    };
+}
+
+#include "PreparedDem.inl"
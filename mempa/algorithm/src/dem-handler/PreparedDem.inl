@@ -0,0 +1,102 @@
+/* Local Header */
+#include "PreparedDem.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+
+namespace mempa
+{
+    /**
+     * @brief Get the total X size of the prepared raster.
+     *
+     * @return int Number of pixels per raster row.
+     */
+    inline int PreparedDem::getXSize() const noexcept
+    {
+        return header.xSize;
+    }
+
+    /**
+     * @brief Get the total Y size of the prepared raster.
+     *
+     * @return int Number of pixels per raster column.
+     */
+    inline int PreparedDem::getYSize() const noexcept
+    {
+        return header.ySize;
+    }
+
+    /**
+     * @brief Get the width of each stored tile.
+     *
+     * @return int Tile width in pixels.
+     */
+    inline int PreparedDem::getTileXSize() const noexcept
+    {
+        return header.tileXSize;
+    }
+
+    /**
+     * @brief Get the height of each stored tile.
+     *
+     * @return int Tile height in pixels.
+     */
+    inline int PreparedDem::getTileYSize() const noexcept
+    {
+        return header.tileYSize;
+    }
+
+    /**
+     * @brief Get the six geotransform coefficients stored with the raster.
+     *
+     * @return const double* Geotransform array.
+     */
+    inline const double *PreparedDem::getGeoTransform() const noexcept
+    {
+        return header.geoTransform;
+    }
+
+    /**
+     * @brief Get the CRS of the raster as WKT.
+     *
+     * @return const char* Null-terminated WKT string.
+     */
+    inline const char *PreparedDem::getProjectionWkt() const noexcept
+    {
+        return projectionWkt.c_str();
+    }
+
+    /**
+     * @brief Check whether the source raster declared a nodata value.
+     *
+     * @return true A nodata value is stored.
+     * @return false No nodata value was declared.
+     */
+    inline bool PreparedDem::hasNoDataValue() const noexcept
+    {
+        return header.hasNoData != 0;
+    }
+
+    /**
+     * @brief Get the nodata value of the source raster.
+     *
+     * @return double Nodata value, only meaningful if @ref hasNoDataValue is true.
+     */
+    inline double PreparedDem::getNoDataValue() const noexcept
+    {
+        return header.noDataValue;
+    }
+
+    /**
+     * @brief Get a pointer to a tile inside the mapping. The tile is tileXSize values wide for every row.
+     *
+     * @param tileX Column of the tile in the tile grid.
+     * @param tileY Row of the tile in the tile grid.
+     * @return const float* First value of the tile.
+     */
+    inline const float *PreparedDem::getTile(const int tileX, const int tileY) const noexcept
+    {
+        const std::size_t tileValues = static_cast<std::size_t>(header.tileXSize) * header.tileYSize; /* Values stored per tile. */
+        return tileData + (static_cast<std::size_t>(tileY) * tilesPerRow + tileX) * tileValues;
+    }
+}
@@ -0,0 +1,128 @@
+/* Local Header */
+#include "RTree.hpp"
+
+/* C++ Standard Libraries */
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace mempa
+{
+    /**
+     * @brief Order a run of boxes for packing: vertical slices by center x, then each slice by center y.
+     *
+     * @details Afterwards every consecutive group of @ref NODE_CAPACITY items is a compact tile and becomes one parent.
+     *
+     * @param first First item of the run.
+     * @param last One past the last item of the run.
+     */
+    template <typename Item>
+    void RTree::packSlices(const typename std::vector<Item>::iterator first, const typename std::vector<Item>::iterator last)
+    {
+        /* Twice the center avoids halving odd widths. */
+        const auto centerX = [](const Item &item)
+        { return static_cast<long long>(item.bounds.xMin) + item.bounds.xMax; };
+        const auto centerY = [](const Item &item)
+        { return static_cast<long long>(item.bounds.yMin) + item.bounds.yMax; };
+
+        const std::size_t count = static_cast<std::size_t>(last - first);                                    /* Items in the run. */
+        const std::size_t parents = (count + NODE_CAPACITY - 1) / NODE_CAPACITY;                             /* Nodes the run will fill. */
+        const std::size_t slices = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(parents)))); /* Vertical slices. */
+        const std::size_t sliceSize = slices * NODE_CAPACITY;                                                 /* Items per slice. */
+
+        std::sort(first, last, [&](const Item &left, const Item &right)
+                  { return centerX(left) < centerX(right); });
+        for (std::size_t sliceStart = 0; sliceStart < count; sliceStart += sliceSize)
+        {
+            const auto sliceEnd = first + static_cast<std::ptrdiff_t>(std::min(count, sliceStart + sliceSize));
+            std::sort(first + static_cast<std::ptrdiff_t>(sliceStart), sliceEnd, [&](const Item &left, const Item &right)
+                      { return centerY(left) < centerY(right); });
+        }
+    }
+
+    /**
+     * @brief Replace the contents of the tree with a new set of boxes.
+     *
+     * @param boxes Boxes to index. The id returned for a box is its index in this vector.
+     */
+    void RTree::build(const std::vector<PixelBox> &boxes)
+    {
+        entries.clear();
+        nodes.clear();
+        if (boxes.empty())
+        {
+            return;
+        }
+
+        entries.reserve(boxes.size());
+        for (std::size_t index = 0; index < boxes.size(); ++index)
+        {
+            entries.push_back(Entry{boxes[index], static_cast<int>(index)});
+        }
+        packSlices<Entry>(entries.begin(), entries.end());
+
+        /* Leaves over consecutive runs of entries. */
+        for (std::size_t first = 0; first < entries.size(); first += NODE_CAPACITY)
+        {
+            Node leaf{entries[first].bounds, first, std::min(NODE_CAPACITY, entries.size() - first), true};
+            for (std::size_t entry = first + 1; entry < first + leaf.count; ++entry)
+            {
+                leaf.bounds.expand(entries[entry].bounds);
+            }
+            nodes.push_back(leaf);
+        }
+
+        /* Pack each level under a new one until a single root is left. */
+        std::size_t levelStart = 0; /* First node of the level being grouped. */
+        while (nodes.size() - levelStart > 1)
+        {
+            const std::size_t levelEnd = nodes.size(); /* One past the last node of the level. */
+            packSlices<Node>(nodes.begin() + static_cast<std::ptrdiff_t>(levelStart), nodes.end());
+            for (std::size_t first = levelStart; first < levelEnd; first += NODE_CAPACITY)
+            {
+                Node parent{nodes[first].bounds, first, std::min(NODE_CAPACITY, levelEnd - first), false};
+                for (std::size_t child = first + 1; child < first + parent.count; ++child)
+                {
+                    parent.bounds.expand(nodes[child].bounds);
+                }
+                nodes.push_back(parent);
+            }
+            levelStart = levelEnd;
+        }
+    }
+
+    /**
+     * @brief Find every box that overlaps a window.
+     *
+     * @param window Window to search.
+     * @param hits Output, replaced with the ids of the overlapping boxes in ascending order.
+     */
+    void RTree::query(const PixelBox &window, std::vector<int> &hits) const
+    {
+        hits.clear();
+        if (nodes.empty() || !nodes.back().bounds.intersects(window))
+        {
+            return;
+        }
+
+        std::vector<std::size_t> pending{nodes.size() - 1}; /* Nodes whose bounds overlap the window, starting at the root. */
+        while (!pending.empty())
+        {
+            const Node &node = nodes[pending.back()];
+            pending.pop_back();
+            for (std::size_t child = node.first; child < node.first + node.count; ++child)
+            {
+                if (node.leaf && entries[child].bounds.intersects(window))
+                {
+                    hits.push_back(entries[child].id);
+                }
+                else if (!node.leaf && nodes[child].bounds.intersects(window))
+                {
+                    pending.push_back(child);
+                }
+            }
+        }
+        std::sort(hits.begin(), hits.end());
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <vector>
+
+namespace mempa
+{
+    /**
+     * @brief Axis-aligned rectangle of pixels, [xMin, xMax) by [yMin, yMax).
+     */
+    struct PixelBox
+    {
+        int xMin = 0; /* Left edge, inclusive. */
+        int yMin = 0; /* Top edge, inclusive. */
+        int xMax = 0; /* Right edge, exclusive. */
+        int yMax = 0; /* Bottom edge, exclusive. */
+
+        inline bool intersects(const PixelBox &other) const noexcept;
+        inline void expand(const PixelBox &other) noexcept;
+    };
+
+    /**
+     * @brief Static R-tree over rectangles, bulk loaded once and then only queried.
+     *
+     * @details Built with Sort-Tile-Recursive packing: each level sorts its boxes into vertical slices by center x, then into runs by center y, and groups every run of @ref NODE_CAPACITY boxes under one parent. Every node is full except the last of each slice, so a query touches O(log n + hits) nodes. All nodes sit in one vector with each node's children contiguous, so the tree takes two allocations however many boxes it holds.
+     */
+    class RTree
+    {
+    private:
+        /**
+         * @brief One node. Leaves point into the entry array, inner nodes into the node array.
+         */
+        struct Node
+        {
+            PixelBox bounds;   /* Union of every box under the node. */
+            std::size_t first; /* Index of the first child node, or first entry for a leaf. */
+            std::size_t count; /* Number of children or entries. */
+            bool leaf;         /* Whether the children are entries. */
+        };
+
+        /**
+         * @brief Indexed box and the caller's identifier for it.
+         */
+        struct Entry
+        {
+            PixelBox bounds; /* Box as passed to @ref build. */
+            int id;          /* Identifier returned by @ref query. */
+        };
+
+        std::vector<Entry> entries; /* Every box, in leaf order. */
+        std::vector<Node> nodes;    /* Every node, leaves first, root last. */
+
+        template <typename Item>
+        static void packSlices(typename std::vector<Item>::iterator first, typename std::vector<Item>::iterator last);
+
+    protected:
+        /* RTree is not designed to be subclassed. */
+
+    public:
+        inline static constexpr std::size_t NODE_CAPACITY = 8; /* Children per node. */
+
+        void build(const std::vector<PixelBox> &boxes);
+        void query(const PixelBox &window, std::vector<int> &hits) const;
+        inline std::size_t size() const noexcept;
+        inline bool empty() const noexcept;
+    };
+}
+
+#include "RTree.inl"
@@ -0,0 +1,55 @@
+/* Local Header */
+#include "RTree.hpp"
+
+/* C++ Standard Libraries */
+#include <algorithm>
+#include <cstddef>
+
+namespace mempa
+{
+    /**
+     * @brief Check whether two boxes share at least one pixel.
+     *
+     * @param other Box to test against.
+     * @return true The boxes overlap.
+     * @return false The boxes are disjoint or only touch along an edge.
+     */
+    inline bool PixelBox::intersects(const PixelBox &other) const noexcept
+    {
+        return xMin < other.xMax && other.xMin < xMax && yMin < other.yMax && other.yMin < yMax;
+    }
+
+    /**
+     * @brief Grow the box to also cover another.
+     *
+     * @param other Box to cover.
+     */
+    inline void PixelBox::expand(const PixelBox &other) noexcept
+    {
+        xMin = std::min(xMin, other.xMin);
+        yMin = std::min(yMin, other.yMin);
+        xMax = std::max(xMax, other.xMax);
+        yMax = std::max(yMax, other.yMax);
+    }
+
+    /**
+     * @brief Get the number of indexed boxes.
+     *
+     * @return std::size_t Boxes passed to the last @ref build.
+     */
+    inline std::size_t RTree::size() const noexcept
+    {
+        return entries.size();
+    }
+
+    /**
+     * @brief Check whether the tree indexes no boxes.
+     *
+     * @return true Every query returns no hits.
+     * @return false At least one box is indexed.
+     */
+    inline bool RTree::empty() const noexcept
+    {
+        return entries.empty();
+    }
+}
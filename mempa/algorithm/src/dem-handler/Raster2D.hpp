@@ -0,0 +1,86 @@
+#pragma once
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mempa
+{
+    /**
+     * @brief Cheap, non-owning view of a row-major 2D raster.
+     *
+     * @details A view does not own its values; whatever it was made from must outlive it. Rows are indexed with `view[row][col]` like the nested vectors this replaces, or with `at(x, y)`.
+     *
+     * @tparam T Element type. Use `const` element types for read-only views.
+     */
+    template <typename T>
+    class RasterView
+    {
+    private:
+        T *values = nullptr;                /* First element of the view. */
+        int xSize = 0;                      /* Number of columns. */
+        int ySize = 0;                      /* Number of rows. */
+        std::ptrdiff_t stride = 0;          /* Distance in elements between consecutive rows. */
+        std::pair<int, int> origin{0, 0};   /* Global image (x, y) coordinate of element (0, 0). */
+
+    protected:
+        /* RasterView is not designed to be subclassed. */
+
+    public:
+        RasterView() noexcept = default;
+        RasterView(T *values, int xSize, int ySize, std::ptrdiff_t stride, std::pair<int, int> origin = {0, 0}) noexcept;
+        template <typename U, typename = std::enable_if_t<std::is_same_v<const U, T> && !std::is_same_v<U, T>>>
+        RasterView(const RasterView<U> &other) noexcept;
+
+        inline T *operator[](int row) const noexcept;
+        inline T &at(int x, int y) const noexcept;
+        inline T *data() const noexcept;
+        inline int getXSize() const noexcept;
+        inline int getYSize() const noexcept;
+        inline std::ptrdiff_t getStride() const noexcept;
+        inline std::pair<int, int> getOrigin() const noexcept;
+        inline bool empty() const noexcept;
+        inline bool contains(std::pair<int, int> globalCoordinate) const noexcept;
+        inline RasterView subview(int xOff, int yOff, int xSize, int ySize) const noexcept;
+    };
+
+    /**
+     * @brief Contiguous, owning 2D raster. A chunk is one allocation no matter how many rows it has.
+     *
+     * @tparam T Element type.
+     */
+    template <typename T>
+    class Raster2D
+    {
+    private:
+        std::vector<T> values;              /* Row-major elements. */
+        int xSize = 0;                      /* Number of columns. */
+        int ySize = 0;                      /* Number of rows. */
+        std::pair<int, int> origin{0, 0};   /* Global image (x, y) coordinate of element (0, 0). */
+
+    protected:
+        /* Raster2D is not designed to be subclassed. */
+
+    public:
+        Raster2D() noexcept = default;
+        Raster2D(int xSize, int ySize, std::pair<int, int> origin = {0, 0}, T fill = T());
+
+        inline T *operator[](int row) noexcept;
+        inline const T *operator[](int row) const noexcept;
+        inline T &at(int x, int y) noexcept;
+        inline const T &at(int x, int y) const noexcept;
+        inline T *data() noexcept;
+        inline const T *data() const noexcept;
+        inline int getXSize() const noexcept;
+        inline int getYSize() const noexcept;
+        inline std::pair<int, int> getOrigin() const noexcept;
+        inline void setOrigin(std::pair<int, int> origin) noexcept;
+        inline bool empty() const noexcept;
+        inline RasterView<T> view() noexcept;
+        inline RasterView<const T> view() const noexcept;
+    };
+}
+
+#include "Raster2D.inl"
@@ -0,0 +1,322 @@
+/* Local Header */
+#include "Raster2D.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <utility>
+
+namespace mempa
+{
+    /**
+     * @brief Construct a view over existing row-major values.
+     *
+     * @param values First element of the view.
+     * @param xSize Number of columns.
+     * @param ySize Number of rows.
+     * @param stride Distance in elements between consecutive rows.
+     * @param origin Global image (x, y) coordinate of element (0, 0).
+     */
+    template <typename T>
+    RasterView<T>::RasterView(T *const values, const int xSize, const int ySize, const std::ptrdiff_t stride, const std::pair<int, int> origin) noexcept
+        : values(values), xSize(xSize), ySize(ySize), stride(stride), origin(origin)
+    {
+    }
+
+    /**
+     * @brief Convert a mutable view into a read-only view of the same values.
+     *
+     * @param other View to convert.
+     */
+    template <typename T>
+    template <typename U, typename>
+    RasterView<T>::RasterView(const RasterView<U> &other) noexcept
+        : values(other.data()), xSize(other.getXSize()), ySize(other.getYSize()), stride(other.getStride()), origin(other.getOrigin())
+    {
+    }
+
+    /**
+     * @brief Get a pointer to the start of a row.
+     *
+     * @param row Local row index.
+     * @return T* First element of the row.
+     */
+    template <typename T>
+    inline T *RasterView<T>::operator[](const int row) const noexcept
+    {
+        return values + row * stride;
+    }
+
+    /**
+     * @brief Get an element by local (x, y) index.
+     *
+     * @param x Local column index.
+     * @param y Local row index.
+     * @return T& The element.
+     */
+    template <typename T>
+    inline T &RasterView<T>::at(const int x, const int y) const noexcept
+    {
+        return values[y * stride + x];
+    }
+
+    /**
+     * @brief Get the first element of the view.
+     *
+     * @return T*
+     */
+    template <typename T>
+    inline T *RasterView<T>::data() const noexcept
+    {
+        return values;
+    }
+
+    /**
+     * @brief Get the number of columns.
+     *
+     * @return int
+     */
+    template <typename T>
+    inline int RasterView<T>::getXSize() const noexcept
+    {
+        return xSize;
+    }
+
+    /**
+     * @brief Get the number of rows.
+     *
+     * @return int
+     */
+    template <typename T>
+    inline int RasterView<T>::getYSize() const noexcept
+    {
+        return ySize;
+    }
+
+    /**
+     * @brief Get the distance in elements between consecutive rows.
+     *
+     * @return std::ptrdiff_t
+     */
+    template <typename T>
+    inline std::ptrdiff_t RasterView<T>::getStride() const noexcept
+    {
+        return stride;
+    }
+
+    /**
+     * @brief Get the global image coordinate of element (0, 0).
+     *
+     * @return std::pair<int, int> Global (x, y) coordinate.
+     */
+    template <typename T>
+    inline std::pair<int, int> RasterView<T>::getOrigin() const noexcept
+    {
+        return origin;
+    }
+
+    /**
+     * @brief Check whether the view has no elements.
+     *
+     * @return true The view is empty.
+     * @return false The view has at least one element.
+     */
+    template <typename T>
+    inline bool RasterView<T>::empty() const noexcept
+    {
+        return values == nullptr || xSize <= 0 || ySize <= 0;
+    }
+
+    /**
+     * @brief Check whether a global image coordinate falls inside the view.
+     *
+     * @param globalCoordinate Global (x, y) coordinate.
+     * @return true The coordinate is inside the view.
+     * @return false The coordinate is outside the view.
+     */
+    template <typename T>
+    inline bool RasterView<T>::contains(const std::pair<int, int> globalCoordinate) const noexcept
+    {
+        const int x = globalCoordinate.first - origin.first;  /* Local column index. */
+        const int y = globalCoordinate.second - origin.second; /* Local row index. */
+        return x >= 0 && x < xSize && y >= 0 && y < ySize;
+    }
+
+    /**
+     * @brief Get a view of a rectangle inside this view. No values are copied.
+     *
+     * @param xOff Local left column of the rectangle.
+     * @param yOff Local top row of the rectangle.
+     * @param xSize Number of columns in the rectangle.
+     * @param ySize Number of rows in the rectangle.
+     * @return RasterView The narrower view, with its origin moved to match.
+     */
+    template <typename T>
+    inline RasterView<T> RasterView<T>::subview(const int xOff, const int yOff, const int xSize, const int ySize) const noexcept
+    {
+        return RasterView<T>(values + yOff * stride + xOff, xSize, ySize, stride, std::pair<int, int>(origin.first + xOff, origin.second + yOff));
+    }
+
+    /**
+     * @brief Construct a new Raster2D and fill every element.
+     *
+     * @param xSize Number of columns.
+     * @param ySize Number of rows.
+     * @param origin Global image (x, y) coordinate of element (0, 0).
+     * @param fill Value for every element.
+     */
+    template <typename T>
+    Raster2D<T>::Raster2D(const int xSize, const int ySize, const std::pair<int, int> origin, const T fill)
+        : values(static_cast<std::size_t>(xSize) * static_cast<std::size_t>(ySize), fill), xSize(xSize), ySize(ySize), origin(origin)
+    {
+    }
+
+    /**
+     * @brief Get a pointer to the start of a row.
+     *
+     * @param row Local row index.
+     * @return T* First element of the row.
+     */
+    template <typename T>
+    inline T *Raster2D<T>::operator[](const int row) noexcept
+    {
+        return values.data() + static_cast<std::size_t>(row) * xSize;
+    }
+
+    /**
+     * @brief Get a pointer to the start of a row.
+     *
+     * @param row Local row index.
+     * @return const T* First element of the row.
+     */
+    template <typename T>
+    inline const T *Raster2D<T>::operator[](const int row) const noexcept
+    {
+        return values.data() + static_cast<std::size_t>(row) * xSize;
+    }
+
+    /**
+     * @brief Get an element by local (x, y) index.
+     *
+     * @param x Local column index.
+     * @param y Local row index.
+     * @return T& The element.
+     */
+    template <typename T>
+    inline T &Raster2D<T>::at(const int x, const int y) noexcept
+    {
+        return values[static_cast<std::size_t>(y) * xSize + x];
+    }
+
+    /**
+     * @brief Get an element by local (x, y) index.
+     *
+     * @param x Local column index.
+     * @param y Local row index.
+     * @return const T& The element.
+     */
+    template <typename T>
+    inline const T &Raster2D<T>::at(const int x, const int y) const noexcept
+    {
+        return values[static_cast<std::size_t>(y) * xSize + x];
+    }
+
+    /**
+     * @brief Get the first element of the raster.
+     *
+     * @return T*
+     */
+    template <typename T>
+    inline T *Raster2D<T>::data() noexcept
+    {
+        return values.data();
+    }
+
+    /**
+     * @brief Get the first element of the raster.
+     *
+     * @return const T*
+     */
+    template <typename T>
+    inline const T *Raster2D<T>::data() const noexcept
+    {
+        return values.data();
+    }
+
+    /**
+     * @brief Get the number of columns.
+     *
+     * @return int
+     */
+    template <typename T>
+    inline int Raster2D<T>::getXSize() const noexcept
+    {
+        return xSize;
+    }
+
+    /**
+     * @brief Get the number of rows.
+     *
+     * @return int
+     */
+    template <typename T>
+    inline int Raster2D<T>::getYSize() const noexcept
+    {
+        return ySize;
+    }
+
+    /**
+     * @brief Get the global image coordinate of element (0, 0).
+     *
+     * @return std::pair<int, int> Global (x, y) coordinate.
+     */
+    template <typename T>
+    inline std::pair<int, int> Raster2D<T>::getOrigin() const noexcept
+    {
+        return origin;
+    }
+
+    /**
+     * @brief Set the global image coordinate of element (0, 0).
+     *
+     * @param origin Global (x, y) coordinate.
+     */
+    template <typename T>
+    inline void Raster2D<T>::setOrigin(const std::pair<int, int> origin) noexcept
+    {
+        this->origin = origin;
+    }
+
+    /**
+     * @brief Check whether the raster has no elements.
+     *
+     * @return true The raster is empty.
+     * @return false The raster has at least one element.
+     */
+    template <typename T>
+    inline bool Raster2D<T>::empty() const noexcept
+    {
+        return values.empty();
+    }
+
+    /**
+     * @brief Get a mutable view of the whole raster.
+     *
+     * @return RasterView<T>
+     */
+    template <typename T>
+    inline RasterView<T> Raster2D<T>::view() noexcept
+    {
+        return RasterView<T>(values.data(), xSize, ySize, xSize, origin);
+    }
+
+    /**
+     * @brief Get a read-only view of the whole raster.
+     *
+     * @return RasterView<const T>
+     */
+    template <typename T>
+    inline RasterView<const T> Raster2D<T>::view() const noexcept
+    {
+        return RasterView<const T>(values.data(), xSize, ySize, xSize, origin);
+    }
+}
@@ -0,0 +1,339 @@
+/* Local Header */
+#include "SlopeRaster.hpp"
+
+/* mempa::getSourceKey */
+#include "SourceKey.hpp"
+
+/* NewDijkstras */
+#include "../rover-pathfinding-module/NewDijkstras.hpp"
+
+/* C++ Standard Libraries */
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* POSIX Libraries */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mempa
+{
+    static_assert(sizeof(SlopeRaster::Header) == 40, "SlopeRaster::Header must have no padding");
+
+    /* Stored direction holding each step's code, and whether it is stored at the neighbour rather than the cell itself. */
+    static constexpr int stepDirections[8] = {2, 2, 0, 0, 1, 3, 3, 1};
+    static constexpr bool storedAtNeighbour[8] = {true, false, true, false, true, true, false, false};
+
+    /**
+     * @brief Compute the codes of every step between the cells of a chunk, kept in memory.
+     *
+     * @details Steps leaving the chunk are @ref NOT_NAVIGABLE, since the heights beyond it are unknown.
+     *
+     * @param heights Chunk of elevation values, whose origin becomes the raster's.
+     * @param pixelSize Pixel size in meters, as given to the searches.
+     */
+    SlopeRaster::SlopeRaster(const RasterView<const float> &heights, const float pixelSize)
+        : origin(heights.getOrigin()), xSize(heights.getXSize()), ySize(heights.getYSize()), pixelSize(pixelSize)
+    {
+        ownedCodes.resize(static_cast<std::size_t>(xSize) * ySize * DIRECTIONS);
+        encodeRows(heights, ySize, pixelSize, ownedCodes.data());
+        codes = ownedCodes.data();
+    }
+
+    /**
+     * @brief Unmap the sidecar, if one is loaded.
+     */
+    SlopeRaster::~SlopeRaster()
+    {
+        unmap();
+    }
+
+    /**
+     * @brief Get the sidecar filepath for a DEM.
+     *
+     * @param filepath Filepath to the DEM.
+     * @return std::string The DEM filepath with @ref FILE_EXTENSION appended.
+     */
+    std::string SlopeRaster::sidecarPathFor(const char *const filepath)
+    {
+        return std::string(filepath) + FILE_EXTENSION;
+    }
+
+    /**
+     * @brief Map the codes of a DEM from its sidecar, replacing any codes held before.
+     *
+     * @param filepath Filepath to the DEM, not the sidecar.
+     * @param rasterSize Width and height of the DEM.
+     * @param pixelSize Pixel size the codes must have been computed with.
+     * @return true The sidecar exists, is intact, and matches the DEM and pixel size.
+     * @return false The sidecar must be built again. The raster is left empty.
+     */
+    bool SlopeRaster::load(const char *const filepath, const std::pair<int, int> rasterSize, const float pixelSize)
+    {
+        unmap();
+        ownedCodes.clear();
+        codes = nullptr;
+
+        std::uint64_t sourceSize;    /* Current size of the DEM file. */
+        std::int64_t sourceModified; /* Current modification time of the DEM file. */
+        if (!getSourceKey(filepath, sourceSize, sourceModified))
+        {
+            return false;
+        }
+
+        fileDescriptor = open(sidecarPathFor(filepath).c_str(), O_RDONLY);
+        if (fileDescriptor < 0)
+        {
+            return false;
+        }
+        struct stat fileStatus; /* Used for the size of the sidecar. */
+        const std::size_t codeBytes = static_cast<std::size_t>(rasterSize.first) * rasterSize.second * DIRECTIONS; /* Bytes of codes the DEM needs. */
+        if (fstat(fileDescriptor, &fileStatus) != 0 || static_cast<std::size_t>(fileStatus.st_size) != sizeof(Header) + codeBytes)
+        {
+            unmap();
+            return false;
+        }
+        mappingSize = static_cast<std::size_t>(fileStatus.st_size);
+        mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+        if (mapping == MAP_FAILED)
+        {
+            mapping = nullptr;
+            unmap();
+            return false;
+        }
+
+        Header inHeader; /* Header read from the sidecar. */
+        std::memcpy(&inHeader, mapping, sizeof(Header));
+        if (std::memcmp(inHeader.magic, MAGIC, sizeof(MAGIC)) != 0 || inHeader.version != VERSION ||
+            inHeader.sourceSize != sourceSize || inHeader.sourceModified != sourceModified ||
+            inHeader.xSize != rasterSize.first || inHeader.ySize != rasterSize.second || inHeader.pixelSize != pixelSize)
+        {
+            unmap();
+            return false;
+        }
+
+        codes = static_cast<const std::uint8_t *>(mapping) + sizeof(Header);
+        origin = {0, 0};
+        xSize = inHeader.xSize;
+        ySize = inHeader.ySize;
+        this->pixelSize = inHeader.pixelSize;
+        return true;
+    }
+
+    /**
+     * @brief Compute the codes of a whole DEM and write them to its sidecar, keyed to the DEM's current size and modification time.
+     *
+     * @details The DEM is read in bands of up to @ref BUILD_ROWS rows, plus the row below each band for the steps south, so the build holds only one band in memory. Bands are narrowed until their elevations and codes fit the memory budget. The sidecar is written beside its final path and renamed into place once complete.
+     *
+     * @param elevationRaster DEM to compute the codes of.
+     * @param filepath Filepath to the DEM, not the sidecar.
+     * @param pixelSize Pixel size in meters, as given to the searches.
+     * @param memoryBytes Most the build may hold, 0 for no limit.
+     *
+     * @throws Not even a band of one row fits the memory budget, or failure to stat the DEM, read it, or write the sidecar.
+     */
+    void SlopeRaster::build(const DemHandler &elevationRaster, const char *const filepath, const float pixelSize, const std::size_t memoryBytes)
+    {
+        const std::size_t rowBytes = static_cast<std::size_t>(elevationRaster.getXSize()) * (sizeof(float) + DIRECTIONS); /* Elevations and codes of one row. */
+        int bandRows = BUILD_ROWS; /* Rows whose codes each band writes. */
+        if (memoryBytes > 0)
+        {
+            /* One more row of elevations is read below each band. */
+            const std::size_t rowsThatFit = memoryBytes / rowBytes;
+            bandRows = rowsThatFit > 1 ? static_cast<int>(std::min<std::size_t>(BUILD_ROWS, rowsThatFit - 1)) : 0;
+        }
+        if (bandRows < 1)
+        {
+            throw std::invalid_argument("build: memory budget is too small for one row of the DEM");
+        }
+
+
+        Header outHeader{}; /* Header to write. */
+        std::memcpy(outHeader.magic, MAGIC, sizeof(MAGIC));
+        outHeader.version = VERSION;
+        outHeader.xSize = elevationRaster.getXSize();
+        outHeader.ySize = elevationRaster.getYSize();
+        outHeader.pixelSize = pixelSize;
+        if (!getSourceKey(filepath, outHeader.sourceSize, outHeader.sourceModified))
+        {
+            throw std::runtime_error("build: stat() error");
+        }
+
+        const std::string sidecarFilepath = sidecarPathFor(filepath);
+        const std::string temporaryFilepath = sidecarFilepath + ".partial"; /* Written first, then renamed. */
+        std::ofstream outFile(temporaryFilepath, std::ios::binary | std::ios::trunc);
+        if (!outFile)
+        {
+            throw std::runtime_error("build: failed to create " + temporaryFilepath);
+        }
+        outFile.write(reinterpret_cast<const char *>(&outHeader), sizeof(Header));
+
+        std::vector<std::uint8_t> bandCodes(static_cast<std::size_t>(outHeader.xSize) * bandRows * DIRECTIONS); /* Codes of one band of rows. */
+        try
+        {
+            for (int yOff = 0; yOff < outHeader.ySize; yOff += bandRows)
+            {
+                const int rows = std::min(bandRows, outHeader.ySize - yOff);             /* Rows whose codes this band writes. */
+                const int yLast = std::min(yOff + rows, outHeader.ySize - 1);           /* Last row read, one past the band when there is one. */
+                const Raster2D<float> band = elevationRaster.readRectangleChunk({{0, yOff}, {outHeader.xSize - 1, yLast}}, 0);
+                encodeRows(band.view(), rows, pixelSize, bandCodes.data());
+                outFile.write(reinterpret_cast<const char *>(bandCodes.data()), static_cast<std::streamsize>(static_cast<std::size_t>(outHeader.xSize) * rows * DIRECTIONS));
+            }
+        }
+        catch (...)
+        {
+            outFile.close();
+            std::remove(temporaryFilepath.c_str());
+            throw;
+        }
+
+        outFile.close();
+        if (!outFile || std::rename(temporaryFilepath.c_str(), sidecarFilepath.c_str()) != 0)
+        {
+            std::remove(temporaryFilepath.c_str());
+            throw std::runtime_error("build: failed to write " + sidecarFilepath);
+        }
+    }
+
+    /**
+     * @brief Quantize the slope of one step.
+     *
+     * @param fromHeight Height of the cell the step leaves.
+     * @param toHeight Height of the cell the step enters.
+     * @param diagonal Whether the cells are diagonal neighbours rather than sharing an edge.
+     * @param pixelSize Pixel size in meters.
+     * @return std::uint8_t Slope in half degrees rounded down, computed exactly as NewDijkstras computes it, or @ref NOT_NAVIGABLE for a NaN height.
+     */
+    std::uint8_t SlopeRaster::slopeCode(const float fromHeight, const float toHeight, const bool diagonal, const float pixelSize) noexcept
+    {
+        const double slope = NewDijkstras::step_slope(std::abs(fromHeight - toHeight), diagonal, pixelSize); /* Slope in degrees. */
+        if (!(slope <= 90.0))
+        {
+            return NOT_NAVIGABLE;
+        }
+        return static_cast<std::uint8_t>(std::floor(slope * CODES_PER_DEGREE));
+    }
+
+    /**
+     * @brief Bytes @ref traversability's mask holds per chunk cell.
+     *
+     * @return std::size_t
+     */
+    std::size_t SlopeRaster::maskBytesPerCell() noexcept
+    {
+        return sizeof(std::uint8_t);
+    }
+
+    /**
+     * @brief Build the traversability mask of a chunk for a slope tolerance: one byte per cell, bit i set when step i of NewDijkstras's order stays on the chunk and within the tolerance.
+     *
+     * @param chunk Elevation values or codes of the chunk, which must lie inside the raster. Only read for steps whose code equals the tolerance's.
+     * @param maxSlope Slope tolerance in degrees.
+     * @param mask Resized to the chunk if needed and overwritten.
+     *
+     * @throws The chunk is not inside the raster.
+     */
+    void SlopeRaster::traversability(const ElevationView &chunk, const float maxSlope, Raster2D<std::uint8_t> &mask) const
+    {
+        const int chunkXSize = chunk.getXSize();                   /* Chunk width. */
+        const int chunkYSize = chunk.getYSize();                   /* Chunk height. */
+        const int xOff = chunk.getOrigin().first - origin.first;   /* Chunk's first column in the raster. */
+        const int yOff = chunk.getOrigin().second - origin.second; /* Chunk's first row in the raster. */
+        if (xOff < 0 || yOff < 0 || xOff + chunkXSize > xSize || yOff + chunkYSize > ySize)
+        {
+            throw std::out_of_range("traversability: chunk is outside the slope raster");
+        }
+        if (mask.getXSize() != chunkXSize || mask.getYSize() != chunkYSize)
+        {
+            mask = Raster2D<std::uint8_t>(chunkXSize, chunkYSize);
+        }
+        mask.setOrigin(chunk.getOrigin());
+
+        /* Codes below the limit pass and codes above it fail. A code equal to it covers slopes either side of maxSlope. */
+        const double limit = std::floor(static_cast<double>(maxSlope) * CODES_PER_DEGREE); /* Code of maxSlope itself. */
+        for (int row = 0; row < chunkYSize; ++row)
+        {
+            std::uint8_t *const maskRow = mask[row]; /* Masks of this row. */
+            for (int col = 0; col < chunkXSize; ++col)
+            {
+                std::uint8_t steps = 0; /* Bits of the steps that pass. */
+                for (int step = 0; step < 8; ++step)
+                {
+                    const int neighbourRow = row + NewDijkstras::ROW_STEPS[step];
+                    const int neighbourCol = col + NewDijkstras::COL_STEPS[step];
+                    if (neighbourRow < 0 || neighbourRow >= chunkYSize || neighbourCol < 0 || neighbourCol >= chunkXSize)
+                    {
+                        continue;
+                    }
+                    const std::uint8_t code = storedAtNeighbour[step] ? getCode(xOff + neighbourCol, yOff + neighbourRow, stepDirections[step])
+                                                                      : getCode(xOff + col, yOff + row, stepDirections[step]);
+                    bool passes = code != NOT_NAVIGABLE && code < limit;
+                    if (code != NOT_NAVIGABLE && code == limit)
+                    {
+                        const bool diagonal = NewDijkstras::ROW_STEPS[step] != 0 && NewDijkstras::COL_STEPS[step] != 0;
+                        const double rise = std::abs(chunk.at(col, row) - chunk.at(neighbourCol, neighbourRow));
+                        passes = NewDijkstras::step_navigable(rise, diagonal, maxSlope, pixelSize);
+                    }
+                    steps |= static_cast<std::uint8_t>(passes) << step;
+                }
+                maskRow[col] = steps;
+            }
+        }
+    }
+
+    /**
+     * @brief Compute the codes of the first rows of a chunk.
+     *
+     * @param heights Elevation values, holding the row below the last one encoded if the steps south of it are to be known.
+     * @param rowCount Rows to encode.
+     * @param pixelSize Pixel size in meters.
+     * @param rowCodes Receives @ref DIRECTIONS codes for each cell of those rows.
+     */
+    void SlopeRaster::encodeRows(const RasterView<const float> &heights, const int rowCount, const float pixelSize, std::uint8_t *rowCodes) noexcept
+    {
+        const int columns = heights.getXSize(); /* Cells per row. */
+        const int rows = heights.getYSize();    /* Rows available, including any below the encoded ones. */
+        for (int row = 0; row < rowCount; ++row)
+        {
+            const float *const heightRow = heights[row];                                 /* Heights of this row. */
+            const float *const belowRow = row + 1 < rows ? heights[row + 1] : nullptr;   /* Heights of the row below, if known. */
+            for (int col = 0; col < columns; ++col)
+            {
+                rowCodes[0] = col + 1 < columns ? slopeCode(heightRow[col], heightRow[col + 1], false, pixelSize) : NOT_NAVIGABLE;
+                rowCodes[1] = belowRow != nullptr && col + 1 < columns ? slopeCode(heightRow[col], belowRow[col + 1], true, pixelSize) : NOT_NAVIGABLE;
+                rowCodes[2] = belowRow != nullptr ? slopeCode(heightRow[col], belowRow[col], false, pixelSize) : NOT_NAVIGABLE;
+                rowCodes[3] = belowRow != nullptr && col > 0 ? slopeCode(heightRow[col], belowRow[col - 1], true, pixelSize) : NOT_NAVIGABLE;
+                rowCodes += DIRECTIONS;
+            }
+        }
+    }
+
+    /**
+     * @brief Release the sidecar mapping and descriptor, if any.
+     */
+    void SlopeRaster::unmap() noexcept
+    {
+        if (mapping != nullptr)
+        {
+            munmap(mapping, mappingSize);
+            mapping = nullptr;
+            mappingSize = 0;
+            codes = nullptr;
+        }
+        if (fileDescriptor >= 0)
+        {
+            close(fileDescriptor);
+            fileDescriptor = -1;
+        }
+    }
+}
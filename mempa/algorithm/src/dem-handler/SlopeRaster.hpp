@@ -0,0 +1,100 @@
+#pragma once
+
+/* mempa::DemHandler */
+#include "DemHandler.hpp"
+
+/* mempa::Raster2D */
+#include "Raster2D.hpp"
+
+/* mempa::ElevationView */
+#include "ElevationView.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mempa
+{
+    /**
+     * @brief Slope of every step between neighbouring cells of a DEM, quantized to bytes, so checking a route against any slope tolerance needs no trigonometry.
+     *
+     * @details Each cell stores the codes of its steps east, south-east, south and south-west. The other four steps from a cell are those steps from a neighbour taken backwards, and a step's slope only depends on the absolute rise, so they share the neighbour's code. A code is the slope in half degrees, rounded down, using the same rise, run and arctangent as NewDijkstras. A step off the raster or touching a NaN height has @ref NOT_NAVIGABLE.
+     *
+     * @ref traversability turns the codes of a chunk into one byte per cell with a bit per step for a given tolerance. A code below the tolerance's passes and one above it fails without looking at the heights. Only a code equal to the tolerance's is ambiguous, and those few steps get the exact check, so the mask always agrees with the search's own slope check.
+     *
+     * The codes do not depend on the tolerance, so one sidecar next to the DEM serves every `--slope`. It records the DEM's size and modification time and the pixel size, and is ignored once any of them differ.
+     *
+     * ## Sidecar Layout
+     *
+     * - A fixed @ref Header.
+     * - Header::xSize * Header::ySize * @ref DIRECTIONS codes, row-major, the directions of each cell together.
+     */
+    class SlopeRaster
+    {
+    public:
+        /**
+         * @brief Fixed-size header at the start of a slope raster sidecar.
+         */
+        struct Header
+        {
+            char magic[8];               /* Always @ref MAGIC. */
+            std::uint32_t version;       /* Format version, currently @ref VERSION. */
+            std::int32_t xSize;          /* Raster width in pixels. */
+            std::int32_t ySize;          /* Raster height in pixels. */
+            float pixelSize;             /* Pixel size in meters the slopes were computed with. */
+            std::uint64_t sourceSize;    /* Size in bytes of the DEM file. */
+            std::int64_t sourceModified; /* Modification time of the DEM file, in seconds. */
+        };
+
+        inline static constexpr char MAGIC[8] = {'M', 'E', 'M', 'P', 'A', 'S', 'L', 'P'}; /* File signature. */
+        inline static constexpr std::uint32_t VERSION = 1;                                 /* Current format version. */
+        inline static constexpr int DIRECTIONS = 4;                                        /* Steps stored per cell: east, south-east, south, south-west. */
+        inline static constexpr int CODES_PER_DEGREE = 2;                                  /* Half-degree steps put 0 to 90 degrees in codes 0 to 180. */
+        inline static constexpr std::uint8_t NOT_NAVIGABLE = 0xFF;                         /* Code of a step that fails every tolerance. */
+        inline static constexpr int BUILD_ROWS = 256;                                      /* Most rows read from the DEM at a time while building. */
+        inline static constexpr const char *FILE_EXTENSION = ".mempa-slope";               /* Suffix appended to a DEM path for its sidecar. */
+
+    private:
+        std::vector<std::uint8_t> ownedCodes; /* Codes computed in memory. Empty when the codes are mapped from a sidecar. */
+        int fileDescriptor = -1;              /* Open descriptor of the sidecar, -1 if none. */
+        void *mapping = nullptr;              /* Start of the read-only mapping of the sidecar. */
+        std::size_t mappingSize = 0;          /* Size of the mapping in bytes. */
+        const std::uint8_t *codes = nullptr;  /* @ref DIRECTIONS codes per cell, in ownedCodes or the mapping. */
+        std::pair<int, int> origin{0, 0};     /* Global image (x, y) coordinate of the first cell. */
+        int xSize = 0;                        /* Width in cells. */
+        int ySize = 0;                        /* Height in cells. */
+        float pixelSize = 0.0f;               /* Pixel size in meters the slopes were computed with. */
+
+        static void encodeRows(const RasterView<const float> &heights, int rowCount, float pixelSize, std::uint8_t *rowCodes) noexcept;
+        void unmap() noexcept;
+
+    protected:
+        /* SlopeRaster is not designed to be subclassed. */
+
+    public:
+        SlopeRaster() noexcept = default;
+        explicit SlopeRaster(const RasterView<const float> &heights, float pixelSize);
+        ~SlopeRaster();
+        SlopeRaster(const SlopeRaster &) = delete;
+        SlopeRaster &operator=(const SlopeRaster &) = delete;
+
+        static std::string sidecarPathFor(const char *filepath);
+        bool load(const char *filepath, std::pair<int, int> rasterSize, float pixelSize);
+        static void build(const DemHandler &elevationRaster, const char *filepath, float pixelSize, std::size_t memoryBytes);
+        static std::uint8_t slopeCode(float fromHeight, float toHeight, bool diagonal, float pixelSize) noexcept;
+        static std::size_t maskBytesPerCell() noexcept;
+        void traversability(const ElevationView &chunk, float maxSlope, Raster2D<std::uint8_t> &mask) const;
+
+        inline bool empty() const noexcept;
+        inline int getXSize() const noexcept;
+        inline int getYSize() const noexcept;
+        inline std::pair<int, int> getOrigin() const noexcept;
+        inline float getPixelSize() const noexcept;
+        inline std::uint8_t getCode(int x, int y, int direction) const noexcept;
+    };
+}
+
+#include "SlopeRaster.inl"
@@ -0,0 +1,74 @@
+/* Local Header */
+#include "SlopeRaster.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace mempa
+{
+    /**
+     * @brief Check whether the raster holds any codes.
+     *
+     * @return true Nothing has been computed or loaded.
+     * @return false
+     */
+    inline bool SlopeRaster::empty() const noexcept
+    {
+        return codes == nullptr;
+    }
+
+    /**
+     * @brief Get the width of the raster.
+     *
+     * @return int Number of cells per row.
+     */
+    inline int SlopeRaster::getXSize() const noexcept
+    {
+        return xSize;
+    }
+
+    /**
+     * @brief Get the height of the raster.
+     *
+     * @return int Number of cells per column.
+     */
+    inline int SlopeRaster::getYSize() const noexcept
+    {
+        return ySize;
+    }
+
+    /**
+     * @brief Get the global image coordinate of the first cell.
+     *
+     * @return std::pair<int, int> (0, 0) for a whole DEM, the chunk's origin for one computed from a chunk.
+     */
+    inline std::pair<int, int> SlopeRaster::getOrigin() const noexcept
+    {
+        return origin;
+    }
+
+    /**
+     * @brief Get the pixel size the slopes were computed with.
+     *
+     * @return float Pixel size in meters.
+     */
+    inline float SlopeRaster::getPixelSize() const noexcept
+    {
+        return pixelSize;
+    }
+
+    /**
+     * @brief Get the code of one stored step.
+     *
+     * @param x Column relative to the origin.
+     * @param y Row relative to the origin.
+     * @param direction 0 to 3 for the step east, south-east, south or south-west.
+     * @return std::uint8_t Slope in half degrees rounded down, or @ref NOT_NAVIGABLE.
+     */
+    inline std::uint8_t SlopeRaster::getCode(const int x, const int y, const int direction) const noexcept
+    {
+        return codes[(static_cast<std::size_t>(y) * xSize + x) * DIRECTIONS + direction];
+    }
+}
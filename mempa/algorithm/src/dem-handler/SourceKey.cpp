@@ -0,0 +1,96 @@
+/* Local Header */
+#include "SourceKey.hpp"
+
+/* mempa::DemMosaic */
+#include "DemMosaic.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <vector>
+
+/* POSIX Libraries */
+#include <sys/stat.h>
+
+namespace mempa
+{
+    /* 64-bit FNV-1a, folding each member's key into a mosaic's. */
+    static constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+    static constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+    /**
+     * @brief Fold bytes into an FNV-1a hash.
+     *
+     * @param hash Hash to extend.
+     * @param bytes First byte to fold in.
+     * @param byteCount Number of bytes.
+     */
+    static void fold(std::uint64_t &hash, const void *const bytes, const std::size_t byteCount) noexcept
+    {
+        const unsigned char *const byte = static_cast<const unsigned char *>(bytes);
+        for (std::size_t i = 0; i < byteCount; ++i)
+        {
+            hash = (hash ^ byte[i]) * FNV_PRIME;
+        }
+    }
+
+    /**
+     * @brief Get the size and modification time of a DEM, which together decide whether a sidecar built from it is stale.
+     *
+     * @details Every sidecar records this key in its header and is rebuilt once the DEM's key differs. Sidecar values are all in host byte order, so a sidecar written on a host of the other byte order fails its version check and is rebuilt too.
+     *
+     * Rewriting a mosaic member in place changes neither the mosaic's directory nor its manifest, so a mosaic is keyed on its members: the size is their total and the modification time is a hash of each member's path, size and modification time, along with the modification time of the directory or manifest itself.
+     *
+     * @param filepath Filepath to a raster, or a directory or manifest of rasters read as one mosaic.
+     * @param size Set to the size in bytes.
+     * @param modified Set to the modification time in seconds, or the hash of a mosaic's.
+     * @return true Every file was found.
+     * @return false A file could not be stat'ed, or a mosaic's members could not be listed.
+     */
+    bool getSourceKey(const char *const filepath, std::uint64_t &size, std::int64_t &modified) noexcept
+    {
+        struct stat fileStatus; /* Status of the raster, directory or manifest. */
+        if (stat(filepath, &fileStatus) != 0)
+        {
+            return false;
+        }
+        if (!DemMosaic::isMosaicPath(filepath))
+        {
+            size = static_cast<std::uint64_t>(fileStatus.st_size);
+            modified = static_cast<std::int64_t>(fileStatus.st_mtime);
+            return true;
+        }
+
+        std::vector<std::string> memberPaths; /* Rasters of the mosaic. */
+        try
+        {
+            memberPaths = DemMosaic::listMembers(filepath);
+        }
+        catch (const std::exception &)
+        {
+            return false;
+        }
+        std::uint64_t totalSize = 0;                           /* Sum of the members' sizes. */
+        std::uint64_t hash = FNV_OFFSET_BASIS;                 /* Hash of every member's key. */
+        const std::int64_t listModified = fileStatus.st_mtime; /* Changes when members are added or removed. */
+        fold(hash, &listModified, sizeof(listModified));
+        for (const std::string &memberPath : memberPaths)
+        {
+            if (stat(memberPath.c_str(), &fileStatus) != 0)
+            {
+                return false;
+            }
+            const std::uint64_t memberSize = static_cast<std::uint64_t>(fileStatus.st_size);
+            const std::int64_t memberModified = static_cast<std::int64_t>(fileStatus.st_mtime);
+            fold(hash, memberPath.data(), memberPath.size() + 1);
+            fold(hash, &memberSize, sizeof(memberSize));
+            fold(hash, &memberModified, sizeof(memberModified));
+            totalSize += memberSize;
+        }
+        size = totalSize;
+        modified = static_cast<std::int64_t>(hash);
+        return true;
+    }
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+/* C++ Standard Libraries */
+#include <cstdint>
+
+namespace mempa
+{
+    bool getSourceKey(const char *filepath, std::uint64_t &size, std::int64_t &modified) noexcept;
+}
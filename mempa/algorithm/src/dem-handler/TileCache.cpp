@@ -0,0 +1,165 @@
+/* Local Header */
+#include "TileCache.hpp"
+
+/* C++ Standard Libraries */
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace mempa
+{
+    /**
+     * @brief Replace the tile's float values with 16-bit codes spread evenly over the tile's elevation range.
+     *
+     * @details The worst error is half a code step, so a tile spanning 1000 m is held to within about 1.5 cm. NaN values are kept exactly.
+     *
+     * @return float Largest difference between an original value and its decoded code.
+     */
+    float DemTile::quantize()
+    {
+        /* Fit the code range to the valid values. */
+        float minimum = std::numeric_limits<float>::infinity();  /* Lowest valid elevation. */
+        float maximum = -std::numeric_limits<float>::infinity(); /* Highest valid elevation. */
+        for (const float value : values)
+        {
+            if (!std::isnan(value))
+            {
+                minimum = std::min(minimum, value);
+                maximum = std::max(maximum, value);
+            }
+        }
+        if (minimum > maximum)
+        {
+            minimum = maximum = 0.0f;
+        }
+        offset = minimum + (maximum - minimum) / 2.0f;
+        scale = maximum > minimum ? (maximum - minimum) / (2.0f * MAX_CODE) : 1.0f;
+
+        float maxError = 0.0f; /* Largest round trip error so far. */
+        quantizedValues.resize(values.size());
+        for (std::size_t index = 0; index < values.size(); ++index)
+        {
+            if (std::isnan(values[index]))
+            {
+                quantizedValues[index] = NAN_CODE;
+                continue;
+            }
+            const long code = std::lround((values[index] - offset) / scale);
+            quantizedValues[index] = static_cast<std::int16_t>(std::clamp(code, -static_cast<long>(MAX_CODE), static_cast<long>(MAX_CODE)));
+            maxError = std::max(maxError, std::abs(decode(quantizedValues[index], offset, scale) - values[index]));
+        }
+
+        /* Release the float copy. */
+        std::vector<float>().swap(values);
+        return maxError;
+    }
+
+    /**
+     * @brief Construct a new Tile Cache:: Tile Cache object
+     *
+     * @param capacityBytes Maximum number of bytes of decoded tile values to keep.
+     */
+    TileCache::TileCache(const std::size_t capacityBytes) noexcept
+        : capacityBytes(capacityBytes)
+    {
+    }
+
+    /**
+     * @brief Look up a tile and mark it as the most recently used.
+     *
+     * @param tileKey Key built by @ref makeKey.
+     * @return std::shared_ptr<const DemTile> The cached tile, or nullptr on a miss.
+     */
+    std::shared_ptr<const DemTile> TileCache::find(const std::uint64_t tileKey)
+    {
+        const std::lock_guard<std::mutex> cacheLock(cacheMutex);
+        const auto indexIterator = tileIndex.find(tileKey);
+        if (indexIterator == tileIndex.end())
+        {
+            ++misses;
+            return nullptr;
+        }
+
+        /* Move the entry to the front of the recency list. */
+        recencyList.splice(recencyList.begin(), recencyList, indexIterator->second);
+        ++hits;
+        return indexIterator->second->second;
+    }
+
+    /**
+     * @brief Add a decoded tile to the cache, evicting the least recently used tiles if over capacity.
+     *
+     * @param tileKey Key built by @ref makeKey.
+     * @param tile Decoded tile.
+     */
+    void TileCache::insert(const std::uint64_t tileKey, std::shared_ptr<const DemTile> tile)
+    {
+        const std::lock_guard<std::mutex> cacheLock(cacheMutex);
+        const auto indexIterator = tileIndex.find(tileKey);
+        if (indexIterator != tileIndex.end())
+        {
+            /* Another thread decoded the same tile first; keep the newest copy. */
+            usedBytes -= tileBytes(*indexIterator->second->second);
+            recencyList.erase(indexIterator->second);
+            tileIndex.erase(indexIterator);
+        }
+
+        usedBytes += tileBytes(*tile);
+        recencyList.emplace_front(tileKey, std::move(tile));
+        tileIndex[tileKey] = recencyList.begin();
+        evict();
+    }
+
+    /**
+     * @brief Change the cache capacity, evicting tiles if the cache is now over capacity.
+     *
+     * @param capacityBytes New capacity in bytes.
+     */
+    void TileCache::setCapacity(const std::size_t capacityBytes)
+    {
+        const std::lock_guard<std::mutex> cacheLock(cacheMutex);
+        this->capacityBytes = capacityBytes;
+        evict();
+    }
+
+    /**
+     * @brief Drop every cached tile. Hit and miss counters are kept.
+     */
+    void TileCache::clear()
+    {
+        const std::lock_guard<std::mutex> cacheLock(cacheMutex);
+        recencyList.clear();
+        tileIndex.clear();
+        usedBytes = 0;
+    }
+
+    /**
+     * @brief Number of bytes a tile counts against the cache capacity.
+     *
+     * @param tile Tile to measure.
+     * @return std::size_t Size of the tile's values or codes in bytes.
+     */
+    std::size_t TileCache::tileBytes(const DemTile &tile) noexcept
+    {
+        return tile.values.size() * sizeof(float) + tile.quantizedValues.size() * sizeof(std::int16_t);
+    }
+
+    /**
+     * @brief Remove least recently used tiles until the cache fits its capacity. The most recent tile is always kept.
+     */
+    void TileCache::evict() noexcept
+    {
+        while (usedBytes > capacityBytes && recencyList.size() > static_cast<std::size_t>(1))
+        {
+            const TileEntry &oldestEntry = recencyList.back();
+            usedBytes -= tileBytes(*oldestEntry.second);
+            tileIndex.erase(oldestEntry.first);
+            recencyList.pop_back();
+        }
+    }
+}
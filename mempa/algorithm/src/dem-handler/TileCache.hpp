@@ -0,0 +1,82 @@
+#pragma once
+
+/* C++ Standard Libraries */
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mempa
+{
+    /**
+     * @brief A decoded, block-aligned tile of elevation values.
+     *
+     * @details Values are stored row-major with a row stride of @ref width. Tiles on the right and bottom raster edges may be smaller than the nominal tile size.
+     * A quantized tile keeps 16-bit codes instead of floats, with an offset and scale fitted to the tile's own elevation range.
+     */
+    struct DemTile
+    {
+        inline static constexpr std::int16_t NAN_CODE = INT16_MIN; /* Code reserved for NaN (nodata) values. */
+        inline static constexpr int MAX_CODE = INT16_MAX;         /* Largest code; valid codes span -MAX_CODE to MAX_CODE. */
+
+        std::vector<float> values;                 /* Decoded elevation values, row-major. Empty once quantized. */
+        std::vector<std::int16_t> quantizedValues; /* Quantized elevation codes, row-major. Empty unless quantized. */
+        float offset = 0.0f;                       /* Elevation of code 0. */
+        float scale = 1.0f;                        /* Elevation step between neighbouring codes. */
+        int width = 0;                             /* Number of valid columns in the tile. */
+        int height = 0;                            /* Number of valid rows in the tile. */
+
+        float quantize();
+        inline bool isQuantized() const noexcept;
+        inline static float decode(std::int16_t code, float offset, float scale) noexcept;
+    };
+
+    /**
+     * @brief Least-recently-used cache of decoded DEM tiles.
+     *
+     * @details Tiles are shared out as std::shared_ptr so a caller can keep using a tile after it has been evicted. All members are safe to call from many threads at once; the lock is held only while the recency list is updated, never while a tile is decoded.
+     */
+    class TileCache
+    {
+    private:
+        using TileEntry = std::pair<std::uint64_t, std::shared_ptr<const DemTile>>; /* Tile key and the tile it identifies. */
+
+        mutable std::mutex cacheMutex;                                                    /* Guards recencyList and tileIndex. */
+        std::atomic<std::size_t> capacityBytes;                                           /* Maximum number of bytes of tile values to hold. */
+        std::atomic<std::size_t> usedBytes{0};                                            /* Bytes of tile values currently held. */
+        std::list<TileEntry> recencyList;                                                 /* Most recently used tile at the front. */
+        std::unordered_map<std::uint64_t, std::list<TileEntry>::iterator> tileIndex;       /* Key lookup into the recency list. */
+        std::atomic<std::size_t> hits{0};                                                 /* Number of lookups served from the cache. */
+        std::atomic<std::size_t> misses{0};                                               /* Number of lookups that had to be decoded. */
+
+        static std::size_t tileBytes(const DemTile &tile) noexcept;
+        void evict() noexcept; /* Caller must hold cacheMutex. */
+
+    protected:
+        /* TileCache is not designed to be subclassed. */
+
+    public:
+        inline static constexpr std::size_t DEFAULT_CAPACITY = static_cast<std::size_t>(64) << 20; /* 64 MiB of decoded tiles. */
+
+        explicit TileCache(std::size_t capacityBytes = DEFAULT_CAPACITY) noexcept;
+        TileCache(const TileCache &) = delete;
+        TileCache &operator=(const TileCache &) = delete;
+        std::shared_ptr<const DemTile> find(std::uint64_t tileKey);
+        void insert(std::uint64_t tileKey, std::shared_ptr<const DemTile> tile);
+        void setCapacity(std::size_t capacityBytes);
+        void clear();
+        inline std::size_t getCapacity() const noexcept;
+        inline std::size_t getUsedBytes() const noexcept;
+        inline std::size_t getHits() const noexcept;
+        inline std::size_t getMisses() const noexcept;
+        inline static std::uint64_t makeKey(int tileX, int tileY, int level = 0) noexcept;
+    };
+}
+
+#include "TileCache.inl"
@@ -0,0 +1,89 @@
+/* Local Header */
+#include "TileCache.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace mempa
+{
+    /**
+     * @brief Check whether the tile holds quantized codes rather than floats.
+     *
+     * @return true Read the tile through @ref decode.
+     * @return false Read the tile's values directly.
+     */
+    inline bool DemTile::isQuantized() const noexcept
+    {
+        return !quantizedValues.empty();
+    }
+
+    /**
+     * @brief Turn a quantized code back into an elevation.
+     *
+     * @param code Quantized code.
+     * @param offset Elevation of code 0.
+     * @param scale Elevation step between neighbouring codes.
+     * @return float Elevation, or NaN for @ref NAN_CODE.
+     */
+    inline float DemTile::decode(const std::int16_t code, const float offset, const float scale) noexcept
+    {
+        return code == NAN_CODE ? std::numeric_limits<float>::quiet_NaN() : offset + static_cast<float>(code) * scale;
+    }
+
+    /**
+     * @brief Get the maximum number of bytes the cache may hold.
+     *
+     * @return std::size_t Capacity in bytes.
+     */
+    inline std::size_t TileCache::getCapacity() const noexcept
+    {
+        return capacityBytes;
+    }
+
+    /**
+     * @brief Get the number of bytes of tile values currently cached.
+     *
+     * @return std::size_t Used bytes.
+     */
+    inline std::size_t TileCache::getUsedBytes() const noexcept
+    {
+        return usedBytes;
+    }
+
+    /**
+     * @brief Get the number of lookups that were served from the cache.
+     *
+     * @return std::size_t Cache hits.
+     */
+    inline std::size_t TileCache::getHits() const noexcept
+    {
+        return hits;
+    }
+
+    /**
+     * @brief Get the number of lookups that missed the cache.
+     *
+     * @return std::size_t Cache misses.
+     */
+    inline std::size_t TileCache::getMisses() const noexcept
+    {
+        return misses;
+    }
+
+    /**
+     * @brief Build the cache key for a tile from its tile-grid indices and pyramid level.
+     *
+     * @param tileX Column of the tile in the tile grid.
+     * @param tileY Row of the tile in the tile grid. Must fit in 24 bits.
+     * @param level Pyramid level of the tile, 0 for full resolution. Must fit in 8 bits.
+     * @return std::uint64_t Unique key for the tile.
+     */
+    inline std::uint64_t TileCache::makeKey(const int tileX, const int tileY, const int level) noexcept
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint8_t>(level)) << 56) |
+               (static_cast<std::uint64_t>(static_cast<std::uint32_t>(tileY) & 0xFFFFFFu) << 32) |
+               static_cast<std::uint32_t>(tileX);
+    }
+}
@@ -0,0 +1,544 @@
+/* Local Header */
+#include "ClusterGraph.hpp"
+
+/* mempa::getSourceKey */
+#include "../dem-handler/SourceKey.hpp"
+
+/* NewDijkstras */
+#include "../rover-pathfinding-module/NewDijkstras.hpp"
+
+/* C++ Standard Libraries */
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mempa
+{
+    static_assert(sizeof(ClusterGraph::Header) == 72, "ClusterGraph::Header must have no padding");
+
+    /**
+     * @brief A pair of cells on either side of a cluster border that the rover can step straight across.
+     */
+    struct Entrance
+    {
+        std::pair<int, int> inside;  /* Cell in the cluster whose border was scanned. */
+        std::pair<int, int> outside; /* Cell in the cluster to its right or below it. */
+        float cost;                  /* Cost of the step between them. */
+    };
+
+    /**
+     * @brief Run a task on every cluster, spread over worker threads that each claim the next unclaimed cluster.
+     *
+     * @details Each thread keeps one SearchWorkspace for all the clusters it claims. The first exception thrown stops every thread from claiming more and is rethrown once they have all finished.
+     *
+     * @tparam ClusterTask Callable as task(int cluster, ClusterGraph::SearchWorkspace &workspace).
+     * @param clusterCount Number of clusters.
+     * @param threadCount Number of threads to run, including the calling one.
+     * @param task Work to do for one cluster.
+     */
+    template <typename ClusterTask>
+    static void forEachCluster(const int clusterCount, const unsigned threadCount, ClusterTask task)
+    {
+        std::atomic<int> nextCluster{0}; /* Next cluster no thread has claimed. */
+        std::exception_ptr failure;      /* First exception thrown by a task. */
+        std::mutex failureMutex;         /* Guards failure. */
+        const auto work = [&]()
+        {
+            ClusterGraph::SearchWorkspace workspace; /* Reused for every cluster this thread claims. */
+            try
+            {
+                for (int cluster = nextCluster++; cluster < clusterCount; cluster = nextCluster++)
+                {
+                    task(cluster, workspace);
+                }
+            }
+            catch (...)
+            {
+                const std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure)
+                {
+                    failure = std::current_exception();
+                }
+                nextCluster = clusterCount;
+            }
+        };
+
+        std::vector<std::thread> workers; /* Threads besides the calling one. */
+        for (unsigned worker = 1; worker < threadCount; ++worker)
+        {
+            workers.emplace_back(work);
+        }
+        work();
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+        if (failure)
+        {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    /**
+     * @brief Get the sidecar filepath for a DEM.
+     *
+     * @param filepath Filepath to the DEM.
+     * @return std::string The DEM filepath with @ref FILE_EXTENSION appended.
+     */
+    std::string ClusterGraph::sidecarPathFor(const char *const filepath)
+    {
+        return std::string(filepath) + FILE_EXTENSION;
+    }
+
+    /**
+     * @brief Load the graph of a DEM from its sidecar.
+     *
+     * @param filepath Filepath to the DEM, not the sidecar.
+     * @param rasterSize Width and height of the DEM.
+     * @param clusterSize Cluster size the graph must have been built with.
+     * @param maxSlope Slope limit the graph must have been built for.
+     * @param pixelSize Pixel size the graph must have been built with.
+     * @return true The sidecar exists, is intact, and matches the DEM and every setting.
+     * @return false The graph must be built again.
+     */
+    bool ClusterGraph::load(const char *const filepath, const std::pair<int, int> rasterSize, const int clusterSize, const float maxSlope, const float pixelSize)
+    {
+        std::uint64_t sourceSize;    /* Current size of the DEM file. */
+        std::int64_t sourceModified; /* Current modification time of the DEM file. */
+        if (!getSourceKey(filepath, sourceSize, sourceModified))
+        {
+            return false;
+        }
+
+        std::ifstream inFile(sidecarPathFor(filepath), std::ios::binary);
+        Header inHeader{}; /* Header read from the sidecar. */
+        if (!inFile || !inFile.read(reinterpret_cast<char *>(&inHeader), sizeof(Header)) ||
+            std::memcmp(inHeader.magic, MAGIC, sizeof(MAGIC)) != 0 || inHeader.version != VERSION ||
+            inHeader.sourceSize != sourceSize || inHeader.sourceModified != sourceModified ||
+            inHeader.xSize != rasterSize.first || inHeader.ySize != rasterSize.second || inHeader.clusterSize != clusterSize ||
+            inHeader.maxSlope != maxSlope || inHeader.pixelSize != pixelSize)
+        {
+            return false;
+        }
+
+        /* Reject counts a damaged sidecar could hold before allocating for them. */
+        const std::uint64_t clustersAcross = (static_cast<std::uint64_t>(rasterSize.first) + clusterSize - 1) / clusterSize;  /* Clusters per row. */
+        const std::uint64_t clustersDown = (static_cast<std::uint64_t>(rasterSize.second) + clusterSize - 1) / clusterSize;   /* Clusters per column. */
+        const std::uint64_t cellCount = static_cast<std::uint64_t>(rasterSize.first) * static_cast<std::uint64_t>(rasterSize.second); /* No more nodes than cells. */
+        if (inHeader.clusterCount != clustersAcross * clustersDown || inHeader.nodeCount > cellCount ||
+            inHeader.nodeCount > std::numeric_limits<std::int32_t>::max() || inHeader.edgeCount > std::numeric_limits<std::uint32_t>::max())
+        {
+            return false;
+        }
+
+        std::vector<std::uint32_t> inClusterOffsets(inHeader.clusterCount + 1);           /* Cluster offsets read from the sidecar. */
+        std::vector<std::int32_t> inNodes(static_cast<std::size_t>(inHeader.nodeCount) * 2); /* Node cells read from the sidecar. */
+        std::vector<std::uint32_t> inEdgeOffsets(inHeader.nodeCount + 1);                 /* Edge offsets read from the sidecar. */
+        std::vector<Edge> inEdges(inHeader.edgeCount);                                    /* Edges read from the sidecar. */
+        inFile.read(reinterpret_cast<char *>(inClusterOffsets.data()), static_cast<std::streamsize>(inClusterOffsets.size() * sizeof(std::uint32_t)));
+        inFile.read(reinterpret_cast<char *>(inNodes.data()), static_cast<std::streamsize>(inNodes.size() * sizeof(std::int32_t)));
+        inFile.read(reinterpret_cast<char *>(inEdgeOffsets.data()), static_cast<std::streamsize>(inEdgeOffsets.size() * sizeof(std::uint32_t)));
+        inFile.read(reinterpret_cast<char *>(inEdges.data()), static_cast<std::streamsize>(inEdges.size() * sizeof(Edge)));
+        if (!inFile || inClusterOffsets.front() != 0 || inClusterOffsets.back() != inHeader.nodeCount ||
+            !std::is_sorted(inClusterOffsets.begin(), inClusterOffsets.end()) || inEdgeOffsets.front() != 0 ||
+            inEdgeOffsets.back() != inHeader.edgeCount || !std::is_sorted(inEdgeOffsets.begin(), inEdgeOffsets.end()))
+        {
+            return false;
+        }
+        for (const Edge &edge : inEdges)
+        {
+            if (edge.target < 0 || static_cast<std::uint64_t>(edge.target) >= inHeader.nodeCount)
+            {
+                return false;
+            }
+        }
+
+        header = inHeader;
+        clusterOffsets = std::move(inClusterOffsets);
+        nodes.clear();
+        nodes.reserve(inHeader.nodeCount);
+        for (std::size_t node = 0; node < inHeader.nodeCount; ++node)
+        {
+            nodes.emplace_back(inNodes[node * 2], inNodes[node * 2 + 1]);
+        }
+        edgeOffsets = std::move(inEdgeOffsets);
+        edges = std::move(inEdges);
+        return true;
+    }
+
+    /**
+     * @brief Write the graph to the DEM's sidecar, keyed to the DEM's current size and modification time.
+     *
+     * @param filepath Filepath to the DEM, not the sidecar.
+     *
+     * @throws Failure to stat the DEM or write the sidecar.
+     */
+    void ClusterGraph::save(const char *const filepath) const
+    {
+        Header outHeader = header; /* Header to write. */
+        if (!getSourceKey(filepath, outHeader.sourceSize, outHeader.sourceModified))
+        {
+            throw std::runtime_error("save: stat() error");
+        }
+
+        std::vector<std::int32_t> outNodes; /* Node cells, flattened. */
+        outNodes.reserve(nodes.size() * 2);
+        for (const std::pair<int, int> &node : nodes)
+        {
+            outNodes.push_back(node.first);
+            outNodes.push_back(node.second);
+        }
+
+        /* Write beside the sidecar and rename, so a concurrent reader never sees half a file. */
+        const std::string sidecarFilepath = sidecarPathFor(filepath);
+        const std::string temporaryFilepath = sidecarFilepath + ".partial"; /* Written first, then renamed. */
+        std::ofstream outFile(temporaryFilepath, std::ios::binary | std::ios::trunc);
+        if (!outFile)
+        {
+            throw std::runtime_error("save: failed to create " + temporaryFilepath);
+        }
+        outFile.write(reinterpret_cast<const char *>(&outHeader), sizeof(Header));
+        outFile.write(reinterpret_cast<const char *>(clusterOffsets.data()), static_cast<std::streamsize>(clusterOffsets.size() * sizeof(std::uint32_t)));
+        outFile.write(reinterpret_cast<const char *>(outNodes.data()), static_cast<std::streamsize>(outNodes.size() * sizeof(std::int32_t)));
+        outFile.write(reinterpret_cast<const char *>(edgeOffsets.data()), static_cast<std::streamsize>(edgeOffsets.size() * sizeof(std::uint32_t)));
+        outFile.write(reinterpret_cast<const char *>(edges.data()), static_cast<std::streamsize>(edges.size() * sizeof(Edge)));
+        outFile.close();
+        if (!outFile || std::rename(temporaryFilepath.c_str(), sidecarFilepath.c_str()) != 0)
+        {
+            std::remove(temporaryFilepath.c_str());
+            throw std::runtime_error("save: failed to write " + sidecarFilepath);
+        }
+    }
+
+    /**
+     * @brief Build the graph of a DEM: find the entrances on every cluster border, then the least cost between the entrances of each cluster.
+     *
+     * @details Both passes read one cluster at a time and run on several threads, which the DemHandler read API allows. The second pass runs one search per node over its cluster, so it dominates the build.
+     *
+     * @param elevationRaster DEM to build the graph over.
+     * @param clusterSize Width and height of a cluster in pixels.
+     * @param maxSlope Maximum slope in degrees the rover can climb.
+     * @param pixelSize Pixel size in meters, as given to the searches.
+     * @param threadCount Threads to build with, or 0 for one per hardware thread.
+     *
+     * @throws The cluster size is too small, or a DEM read fails.
+     */
+    void ClusterGraph::build(const DemHandler &elevationRaster, const int clusterSize, const float maxSlope, const float pixelSize, unsigned threadCount)
+    {
+        if (clusterSize < 2)
+        {
+            throw std::invalid_argument("build: cluster size must be at least 2");
+        }
+        if (threadCount == 0)
+        {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        header = Header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.xSize = elevationRaster.getXSize();
+        header.ySize = elevationRaster.getYSize();
+        header.clusterSize = clusterSize;
+        header.maxSlope = maxSlope;
+        header.pixelSize = pixelSize;
+        const int clustersAcross = (header.xSize + clusterSize - 1) / clusterSize; /* Clusters per row. */
+        const int clustersDown = (header.ySize + clusterSize - 1) / clusterSize;   /* Clusters per column. */
+        const int clusterCount = clustersAcross * clustersDown;                    /* Clusters in the raster. */
+        header.clusterCount = static_cast<std::uint64_t>(clusterCount);
+
+        /* Find the entrances on the right and bottom border of every cluster, which covers every border once. */
+        std::vector<std::vector<Entrance>> borderEntrances(clusterCount); /* Entrances found on each cluster's borders. */
+        const auto findEntrances = [&](const int cluster, SearchWorkspace &)
+        {
+            const std::pair<std::pair<int, int>, std::pair<int, int>> bounds = clusterBounds(cluster);
+            const bool hasRight = cluster % clustersAcross + 1 < clustersAcross; /* Whether a cluster lies to the right. */
+            const bool hasBelow = cluster / clustersAcross + 1 < clustersDown;   /* Whether a cluster lies below. */
+            if (!hasRight && !hasBelow)
+            {
+                return;
+            }
+
+            /* One more column and row than the cluster, so both sides of its right and bottom borders are read. */
+            const Raster2D<float> window = elevationRaster.readRectangleChunk(
+                {bounds.first, {bounds.second.first + (hasRight ? 1 : 0), bounds.second.second + (hasBelow ? 1 : 0)}}, 0);
+            const auto heightAt = [&](const std::pair<int, int> cell)
+            {
+                return window.at(cell.first - bounds.first.first, cell.second - bounds.first.second);
+            };
+            const auto scanBorder = [&](const int length, const auto cellsAt)
+            {
+                int runStart = 0; /* First cell of the current crossable run. */
+                for (int position = 0; position <= length; ++position)
+                {
+                    double cost = 0.0; /* Cost of stepping across at this position. */
+                    if (position < length)
+                    {
+                        const std::pair<std::pair<int, int>, std::pair<int, int>> cells = cellsAt(position);
+                        if (stepCost(heightAt(cells.first), heightAt(cells.second), false, maxSlope, pixelSize, cost))
+                        {
+                            continue;
+                        }
+                    }
+
+                    /* The run ended just before this position. */
+                    const int runLength = position - runStart; /* Crossable cells in the run. */
+                    std::vector<int> entrancePositions;        /* Where the run gets its entrances. */
+                    if (runLength >= WIDE_ENTRANCE)
+                    {
+                        entrancePositions = {runStart, position - 1};
+                    }
+                    else if (runLength > 0)
+                    {
+                        entrancePositions = {runStart + (runLength - 1) / 2};
+                    }
+                    for (const int entrancePosition : entrancePositions)
+                    {
+                        const std::pair<std::pair<int, int>, std::pair<int, int>> cells = cellsAt(entrancePosition);
+                        stepCost(heightAt(cells.first), heightAt(cells.second), false, maxSlope, pixelSize, cost);
+                        borderEntrances[cluster].push_back({cells.first, cells.second, static_cast<float>(cost)});
+                    }
+                    runStart = position + 1;
+                }
+            };
+
+            if (hasRight)
+            {
+                scanBorder(bounds.second.second - bounds.first.second + 1, [&](const int position)
+                           { return std::make_pair(std::make_pair(bounds.second.first, bounds.first.second + position),
+                                                   std::make_pair(bounds.second.first + 1, bounds.first.second + position)); });
+            }
+            if (hasBelow)
+            {
+                scanBorder(bounds.second.first - bounds.first.first + 1, [&](const int position)
+                           { return std::make_pair(std::make_pair(bounds.first.first + position, bounds.second.second),
+                                                   std::make_pair(bounds.first.first + position, bounds.second.second + 1)); });
+            }
+        };
+        forEachCluster(clusterCount, threadCount, findEntrances);
+
+        /* Both cells of every entrance are nodes of their cluster, kept in raster order so nodeAt can binary search them. */
+        std::vector<std::vector<std::pair<int, int>>> clusterCells(clusterCount); /* Entrance cells of each cluster. */
+        for (const std::vector<Entrance> &entrances : borderEntrances)
+        {
+            for (const Entrance &entrance : entrances)
+            {
+                clusterCells[clusterOf(entrance.inside)].push_back(entrance.inside);
+                clusterCells[clusterOf(entrance.outside)].push_back(entrance.outside);
+            }
+        }
+        const auto rasterOrder = [](const std::pair<int, int> &cell1, const std::pair<int, int> &cell2)
+        {
+            return std::make_pair(cell1.second, cell1.first) < std::make_pair(cell2.second, cell2.first);
+        };
+        clusterOffsets.assign(1, 0);
+        nodes.clear();
+        for (std::vector<std::pair<int, int>> &cells : clusterCells)
+        {
+            std::sort(cells.begin(), cells.end(), rasterOrder);
+            cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+            nodes.insert(nodes.end(), cells.begin(), cells.end());
+            clusterOffsets.push_back(static_cast<std::uint32_t>(nodes.size()));
+        }
+
+        /* Each entrance is a step both ways. */
+        std::vector<std::vector<Edge>> nodeEdges(nodes.size()); /* Edges leaving each node. */
+        for (const std::vector<Entrance> &entrances : borderEntrances)
+        {
+            for (const Entrance &entrance : entrances)
+            {
+                const int insideNode = nodeAt(entrance.inside);   /* Node of the cell in the scanned cluster. */
+                const int outsideNode = nodeAt(entrance.outside); /* Node of the cell across the border. */
+                nodeEdges[insideNode].push_back({outsideNode, entrance.cost});
+                nodeEdges[outsideNode].push_back({insideNode, entrance.cost});
+            }
+        }
+
+        /* Connect the nodes of each cluster. A cluster only writes to its own nodes' edges, so clusters need no locking. */
+        const auto connectCluster = [&](const int cluster, SearchWorkspace &workspace)
+        {
+            const std::pair<int, int> clusterNodes = getClusterNodes(cluster);
+            if (clusterNodes.second - clusterNodes.first < 2)
+            {
+                return;
+            }
+            const Raster2D<float> window = elevationRaster.readRectangleChunk(clusterBounds(cluster), 0);
+            const std::vector<std::pair<int, int>> targets(nodes.begin() + clusterNodes.first, nodes.begin() + clusterNodes.second);
+            std::vector<float> targetCosts; /* Cost from the source node to each node of the cluster. */
+            for (int source = clusterNodes.first; source < clusterNodes.second; ++source)
+            {
+                searchWindow(window.view(), nodes[source], targets, maxSlope, pixelSize, workspace, targetCosts);
+                for (int target = clusterNodes.first; target < clusterNodes.second; ++target)
+                {
+                    if (target != source && std::isfinite(targetCosts[target - clusterNodes.first]))
+                    {
+                        nodeEdges[source].push_back({target, targetCosts[target - clusterNodes.first]});
+                    }
+                }
+            }
+        };
+        forEachCluster(clusterCount, threadCount, connectCluster);
+
+        edgeOffsets.assign(1, 0);
+        edges.clear();
+        for (const std::vector<Edge> &outEdges : nodeEdges)
+        {
+            edges.insert(edges.end(), outEdges.begin(), outEdges.end());
+            edgeOffsets.push_back(static_cast<std::uint32_t>(edges.size()));
+        }
+        header.nodeCount = nodes.size();
+        header.edgeCount = edges.size();
+    }
+
+    /**
+     * @brief Check a step between neighbouring cells against the slope limit and get its cost, exactly as NewDijkstras does.
+     *
+     * @param fromHeight Elevation of the cell stepped from.
+     * @param toHeight Elevation of the cell stepped to.
+     * @param diagonal Whether the cells are diagonal neighbours.
+     * @param maxSlope Maximum slope in degrees the rover can climb.
+     * @param pixelSize Pixel size in meters.
+     * @param cost Set to the 3D length of the step when it can be taken.
+     * @return true The step is within the slope limit. A NaN elevation never is.
+     * @return false The rover cannot take the step.
+     */
+    bool ClusterGraph::stepCost(const float fromHeight, const float toHeight, const bool diagonal, const float maxSlope, const float pixelSize, double &cost) noexcept
+    {
+        const double rise = std::abs(fromHeight - toHeight); /* Height difference, NaN if either is. */
+        if (!NewDijkstras::step_navigable(rise, diagonal, maxSlope, pixelSize))
+        {
+            return false;
+        }
+        cost = NewDijkstras::calculate_distance_between_nodes(diagonal, rise, pixelSize);
+        return true;
+    }
+
+    /**
+     * @brief Find the least cost from one cell of a window to each of a set of cells, without leaving the window.
+     *
+     * @details A Dijkstra's search over the window that stops once every target is finalized. Costs are kept as floats and accumulated as NewDijkstras accumulates them, so a search over the same window reproduces them.
+     *
+     * @param window Elevations the search may use. Its origin places it in the raster.
+     * @param source Raster (x, y) cell to search from. Must be inside the window.
+     * @param targets Raster (x, y) cells to find the cost to. Must be inside the window.
+     * @param maxSlope Maximum slope in degrees the rover can climb.
+     * @param pixelSize Pixel size in meters.
+     * @param workspace Cell state to reuse.
+     * @param targetCosts Set to the cost to each target, infinite where a target cannot be reached.
+     */
+    void ClusterGraph::searchWindow(const RasterView<const float> &window, const std::pair<int, int> source, const std::vector<std::pair<int, int>> &targets, const float maxSlope, const float pixelSize, SearchWorkspace &workspace, std::vector<float> &targetCosts)
+    {
+        const int cols = window.getXSize();                /* Window width. */
+        const int rows = window.getYSize();                /* Window height. */
+        const std::pair<int, int> origin = window.getOrigin(); /* Raster cell of the window's (0, 0). */
+        const auto localIndex = [&](const std::pair<int, int> cell)
+        {
+            return (cell.second - origin.second) * cols + (cell.first - origin.first);
+        };
+
+        workspace.costs.assign(static_cast<std::size_t>(rows) * cols, std::numeric_limits<float>::infinity());
+        workspace.target.assign(static_cast<std::size_t>(rows) * cols, 0);
+        workspace.frontier.reset(rows * cols);
+        int remaining = 0; /* Targets not finalized yet. */
+        for (const std::pair<int, int> &target : targets)
+        {
+            std::uint8_t &isTarget = workspace.target[localIndex(target)];
+            remaining += isTarget == 0 ? 1 : 0;
+            isTarget = 1;
+        }
+
+        const int sourceIndex = localIndex(source); /* Window index of the source. */
+        workspace.costs[sourceIndex] = 0.0f;
+        workspace.frontier.push_or_decrease(sourceIndex, 0.0);
+        while (!workspace.frontier.empty() && remaining > 0)
+        {
+            const int index = workspace.frontier.pop(); /* Cell being finalized. */
+            remaining -= workspace.target[index];
+            const int row = index / cols;
+            const int col = index % cols;
+            const float height = window[row][col];
+            for (int step = 0; step < 8; ++step)
+            {
+                const int neighbourRow = row + NewDijkstras::ROW_STEPS[step];
+                const int neighbourCol = col + NewDijkstras::COL_STEPS[step];
+                if (neighbourRow < 0 || neighbourRow >= rows || neighbourCol < 0 || neighbourCol >= cols)
+                {
+                    continue;
+                }
+                const bool diagonal = NewDijkstras::ROW_STEPS[step] != 0 && NewDijkstras::COL_STEPS[step] != 0; /* Whether the step is diagonal. */
+                double stepLength; /* Cost of the step, when it can be taken. */
+                if (!stepCost(height, window[neighbourRow][neighbourCol], diagonal, maxSlope, pixelSize, stepLength))
+                {
+                    continue;
+                }
+                const int neighbourIndex = neighbourRow * cols + neighbourCol;
+                const double cost = workspace.costs[index] + stepLength;
+                if (cost < workspace.costs[neighbourIndex])
+                {
+                    workspace.costs[neighbourIndex] = static_cast<float>(cost);
+                    workspace.frontier.push_or_decrease(neighbourIndex, cost);
+                }
+            }
+        }
+
+        targetCosts.resize(targets.size());
+        for (std::size_t target = 0; target < targets.size(); ++target)
+        {
+            targetCosts[target] = workspace.costs[localIndex(targets[target])];
+        }
+    }
+
+    /**
+     * @brief Get the cluster a cell lies in.
+     *
+     * @param cell Raster (x, y) coordinate inside the raster.
+     * @return int Index of the cluster, in row-major order.
+     */
+    int ClusterGraph::clusterOf(const std::pair<int, int> cell) const noexcept
+    {
+        const int clustersAcross = (header.xSize + header.clusterSize - 1) / header.clusterSize; /* Clusters per row. */
+        return (cell.second / header.clusterSize) * clustersAcross + cell.first / header.clusterSize;
+    }
+
+    /**
+     * @brief Get the cells a cluster covers.
+     *
+     * @param cluster Index of the cluster, in row-major order.
+     * @return std::pair<std::pair<int, int>, std::pair<int, int>> Top left and bottom right raster (x, y) cells, inclusive, as taken by DemHandler::readRectangleChunk.
+     */
+    std::pair<std::pair<int, int>, std::pair<int, int>> ClusterGraph::clusterBounds(const int cluster) const noexcept
+    {
+        const int clustersAcross = (header.xSize + header.clusterSize - 1) / header.clusterSize; /* Clusters per row. */
+        const int xOff = (cluster % clustersAcross) * header.clusterSize;                         /* Left column. */
+        const int yOff = (cluster / clustersAcross) * header.clusterSize;                         /* Top row. */
+        return {{xOff, yOff}, {std::min(xOff + header.clusterSize, header.xSize) - 1, std::min(yOff + header.clusterSize, header.ySize) - 1}};
+    }
+
+    /**
+     * @brief Find the node at a cell.
+     *
+     * @param cell Raster (x, y) coordinate inside the raster.
+     * @return int Index of the node, or -1 if the cell is not an entrance.
+     */
+    int ClusterGraph::nodeAt(const std::pair<int, int> cell) const noexcept
+    {
+        const std::pair<int, int> clusterNodes = getClusterNodes(clusterOf(cell));
+        const auto first = nodes.begin() + clusterNodes.first; /* First node of the cell's cluster. */
+        const auto last = nodes.begin() + clusterNodes.second; /* One past its last node. */
+        const auto found = std::lower_bound(first, last, cell, [](const std::pair<int, int> &node, const std::pair<int, int> &wanted)
+                                            { return std::make_pair(node.second, node.first) < std::make_pair(wanted.second, wanted.first); });
+        return found != last && *found == cell ? static_cast<int>(found - nodes.begin()) : -1;
+    }
+}
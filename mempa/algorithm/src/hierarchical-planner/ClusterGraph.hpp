@@ -0,0 +1,114 @@
+#pragma once
+
+/* mempa::DemHandler */
+#include "../dem-handler/DemHandler.hpp"
+
+/* mempa::Raster2D */
+#include "../dem-handler/Raster2D.hpp"
+
+/* IndexedHeap */
+#include "../rover-pathfinding-module/IndexedHeap.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mempa
+{
+    /**
+     * @brief Abstract graph of a DEM for hierarchical (HPA*) planning: the raster cut into square clusters, the cells where the rover can cross from one cluster into the next, and the least cost between those cells inside each cluster.
+     *
+     * @details Every border between two neighbouring clusters is scanned for runs of cells the rover can step straight across at the slope limit. A run shorter than @ref WIDE_ENTRANCE gets one entrance in its middle, a longer one an entrance at each end. Both cells of an entrance become nodes, joined by the cost of that step. Inside each cluster, a Dijkstra's search from every node finds the least cost to each other node of the cluster without leaving it, using the same slope check and step cost as NewDijkstras, so a search confined to the cluster can always reproduce an edge.
+     *
+     * Building takes one search per node, so the graph is saved to a sidecar next to the DEM. The sidecar records the DEM's size and modification time along with the cluster size, slope limit and pixel size it was built for, and is ignored once any of them differ.
+     *
+     * ## Sidecar Layout
+     *
+     * - A fixed @ref Header.
+     * - Header::clusterCount + 1 UInt32 offsets into the nodes. The nodes of each cluster are contiguous, clusters in row-major order.
+     * - Header::nodeCount (x, y) Int32 pairs, the raster cell of each node, in raster order within a cluster.
+     * - Header::nodeCount + 1 UInt32 offsets into the edges. The edges leaving each node are contiguous.
+     * - Header::edgeCount @ref Edge records.
+     */
+    class ClusterGraph
+    {
+    public:
+        /**
+         * @brief Fixed-size header at the start of a cluster graph sidecar.
+         */
+        struct Header
+        {
+            char magic[8];               /* Always @ref MAGIC. */
+            std::uint32_t version;       /* Format version, currently @ref VERSION. */
+            std::int32_t xSize;          /* Raster width in pixels. */
+            std::int32_t ySize;          /* Raster height in pixels. */
+            std::int32_t clusterSize;    /* Width and height of a cluster in pixels. */
+            float maxSlope;              /* Slope limit in degrees the graph was built for. */
+            float pixelSize;             /* Pixel size in meters the step costs were computed with. */
+            std::uint64_t sourceSize;    /* Size in bytes of the DEM file. */
+            std::int64_t sourceModified; /* Modification time of the DEM file, in seconds. */
+            std::uint64_t clusterCount;  /* Number of clusters. */
+            std::uint64_t nodeCount;     /* Number of nodes. */
+            std::uint64_t edgeCount;     /* Number of directed edges. */
+        };
+
+        /**
+         * @brief Directed edge of the abstract graph.
+         */
+        struct Edge
+        {
+            std::int32_t target; /* Node the edge leads to. */
+            float cost;          /* Least cost of the route the edge stands for. */
+        };
+
+        /**
+         * @brief Cell state reused by every search over a cluster, so a thread allocates only once.
+         */
+        struct SearchWorkspace
+        {
+            std::vector<float> costs;         /* Least cost found to each cell of the window. */
+            std::vector<std::uint8_t> target; /* Non-zero for cells whose cost is wanted. */
+            IndexedHeap frontier;             /* Reached cells that are not finalized yet. */
+        };
+
+        inline static constexpr char MAGIC[8] = {'M', 'E', 'M', 'P', 'A', 'H', 'P', 'A'}; /* File signature. */
+        inline static constexpr std::uint32_t VERSION = 1;                                 /* Current format version. */
+        inline static constexpr int DEFAULT_CLUSTER_SIZE = 64;                             /* 4096 cells, so a cluster and its search state fit in well under 100 kB. */
+        inline static constexpr int WIDE_ENTRANCE = 6;                                     /* Crossable runs at least this long get an entrance at each end. */
+        inline static constexpr const char *FILE_EXTENSION = ".mempa-hpa";                 /* Suffix appended to a DEM path for its sidecar. */
+
+    private:
+        Header header{};                            /* Sizes and the settings the graph was built for. */
+        std::vector<std::uint32_t> clusterOffsets;  /* First node of each cluster, plus the node count. */
+        std::vector<std::pair<int, int>> nodes;     /* Raster (x, y) cell of each node. */
+        std::vector<std::uint32_t> edgeOffsets;     /* First edge of each node, plus the edge count. */
+        std::vector<Edge> edges;                    /* Edges of every node. */
+
+    protected:
+        /* ClusterGraph is not designed to be subclassed. */
+
+    public:
+        static std::string sidecarPathFor(const char *filepath);
+        bool load(const char *filepath, std::pair<int, int> rasterSize, int clusterSize, float maxSlope, float pixelSize);
+        void save(const char *filepath) const;
+        void build(const DemHandler &elevationRaster, int clusterSize, float maxSlope, float pixelSize, unsigned threadCount = 0);
+        static bool stepCost(float fromHeight, float toHeight, bool diagonal, float maxSlope, float pixelSize, double &cost) noexcept;
+        static void searchWindow(const RasterView<const float> &window, std::pair<int, int> source, const std::vector<std::pair<int, int>> &targets, float maxSlope, float pixelSize, SearchWorkspace &workspace, std::vector<float> &targetCosts);
+
+        int clusterOf(std::pair<int, int> cell) const noexcept;
+        std::pair<std::pair<int, int>, std::pair<int, int>> clusterBounds(int cluster) const noexcept;
+        int nodeAt(std::pair<int, int> cell) const noexcept;
+        inline int getClusterSize() const noexcept;
+        inline std::size_t getClusterCount() const noexcept;
+        inline std::size_t getNodeCount() const noexcept;
+        inline std::size_t getEdgeCount() const noexcept;
+        inline std::pair<int, int> getNode(int node) const noexcept;
+        inline std::pair<const Edge *, const Edge *> getEdges(int node) const noexcept;
+        inline std::pair<int, int> getClusterNodes(int cluster) const noexcept;
+    };
+}
+
+#include "ClusterGraph.inl"
@@ -0,0 +1,82 @@
+/* Local Header */
+#include "ClusterGraph.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <utility>
+
+namespace mempa
+{
+    /**
+     * @brief Get the width and height of a cluster.
+     *
+     * @return int Pixels along each side of a cluster. Clusters on the right and bottom edges of the raster may be smaller.
+     */
+    inline int ClusterGraph::getClusterSize() const noexcept
+    {
+        return header.clusterSize;
+    }
+
+    /**
+     * @brief Get the number of clusters.
+     *
+     * @return std::size_t
+     */
+    inline std::size_t ClusterGraph::getClusterCount() const noexcept
+    {
+        return static_cast<std::size_t>(header.clusterCount);
+    }
+
+    /**
+     * @brief Get the number of nodes.
+     *
+     * @return std::size_t
+     */
+    inline std::size_t ClusterGraph::getNodeCount() const noexcept
+    {
+        return nodes.size();
+    }
+
+    /**
+     * @brief Get the number of directed edges.
+     *
+     * @return std::size_t
+     */
+    inline std::size_t ClusterGraph::getEdgeCount() const noexcept
+    {
+        return edges.size();
+    }
+
+    /**
+     * @brief Get the raster cell of a node.
+     *
+     * @param node Index of the node.
+     * @return std::pair<int, int> Raster (x, y) coordinate.
+     */
+    inline std::pair<int, int> ClusterGraph::getNode(const int node) const noexcept
+    {
+        return nodes[node];
+    }
+
+    /**
+     * @brief Get the edges leaving a node.
+     *
+     * @param node Index of the node.
+     * @return std::pair<const Edge *, const Edge *> First edge and one past the last.
+     */
+    inline std::pair<const ClusterGraph::Edge *, const ClusterGraph::Edge *> ClusterGraph::getEdges(const int node) const noexcept
+    {
+        return {edges.data() + edgeOffsets[node], edges.data() + edgeOffsets[node + 1]};
+    }
+
+    /**
+     * @brief Get the nodes of a cluster.
+     *
+     * @param cluster Index of the cluster, in row-major order.
+     * @return std::pair<int, int> First node of the cluster and one past its last.
+     */
+    inline std::pair<int, int> ClusterGraph::getClusterNodes(const int cluster) const noexcept
+    {
+        return {static_cast<int>(clusterOffsets[cluster]), static_cast<int>(clusterOffsets[cluster + 1])};
+    }
+}
@@ -0,0 +1,861 @@
+/* Local Header */
+#include "ContractionHierarchy.hpp"
+
+/* mempa::getSourceKey */
+#include "../dem-handler/SourceKey.hpp"
+
+/* mempa::ClusterGraph */
+#include "ClusterGraph.hpp"
+
+/* NewDijkstras */
+#include "../rover-pathfinding-module/NewDijkstras.hpp"
+
+/* C++ Standard Libraries */
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mempa
+{
+    static_assert(sizeof(ContractionHierarchy::Header) == 80, "ContractionHierarchy::Header must have no padding");
+    static_assert(sizeof(ContractionHierarchy::Arc) == 12, "ContractionHierarchy::Arc must have no padding");
+
+    /* Node states while building. */
+    static constexpr std::uint8_t REMAINING = 0;   /* Still in the graph. */
+    static constexpr std::uint8_t CONTRACTING = 1; /* Picked for the current round. */
+    static constexpr std::uint8_t CONTRACTED = 2;  /* Removed, its arcs kept. */
+
+    /**
+     * @brief Shortcut the contraction of a node adds between two of its neighbours.
+     */
+    struct Shortcut
+    {
+        std::int32_t from; /* One neighbour. */
+        std::int32_t to;   /* The other neighbour. */
+        float cost;        /* Cost of the route through the contracted node. */
+    };
+
+    /**
+     * @brief Node state for the witness searches of one thread, kept for the whole build.
+     */
+    struct WitnessWorkspace
+    {
+        std::vector<double> costs;          /* Least cost found from the search's source, infinite for nodes not reached. */
+        std::vector<std::int32_t> touched;  /* Nodes whose cost must be cleared after the search. */
+        std::vector<std::uint8_t> isTarget; /* 1 for the neighbours the search is looking for. */
+        IndexedHeap frontier;               /* Reached nodes that are not finalized yet. */
+        std::vector<Shortcut> shortcuts;    /* Shortcuts found for the node last looked at. */
+        std::vector<std::int32_t> picked;   /* Nodes this thread picked for the round. */
+    };
+
+    /**
+     * @brief Run a task on every item of a list, spread over worker threads that each claim the next unclaimed block of items.
+     *
+     * @details Thread i uses workspaces[i] for every block it claims. The first exception thrown stops every thread from claiming more and is rethrown once they have all finished.
+     *
+     * @tparam BlockTask Callable as task(int first, int last, WitnessWorkspace &workspace) for the items first to last - 1.
+     * @param itemCount Number of items.
+     * @param workspaces One workspace per thread to run, including the calling one.
+     * @param task Work to do for one block.
+     */
+    template <typename BlockTask>
+    static void forEachBlock(const int itemCount, std::vector<WitnessWorkspace> &workspaces, BlockTask task)
+    {
+        constexpr int blockSize = 256; /* Items claimed at a time, enough to keep the counter cold. */
+        std::atomic<int> nextItem{0};  /* First item no thread has claimed. */
+        std::exception_ptr failure;    /* First exception thrown by a task. */
+        std::mutex failureMutex;       /* Guards failure. */
+        const auto work = [&](WitnessWorkspace &workspace)
+        {
+            try
+            {
+                for (int first = nextItem.fetch_add(blockSize); first < itemCount; first = nextItem.fetch_add(blockSize))
+                {
+                    task(first, std::min(first + blockSize, itemCount), workspace);
+                }
+            }
+            catch (...)
+            {
+                const std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure)
+                {
+                    failure = std::current_exception();
+                }
+                nextItem = itemCount;
+            }
+        };
+
+        std::vector<std::thread> workers; /* Threads besides the calling one. */
+        for (std::size_t worker = 1; worker < workspaces.size(); ++worker)
+        {
+            workers.emplace_back(work, std::ref(workspaces[worker]));
+        }
+        work(workspaces.front());
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+        if (failure)
+        {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    /**
+     * @brief Find the shortcuts contracting a node would need.
+     *
+     * @details For each pair of the node's neighbours, a Dijkstra's search from one of them, which stops once it has finalized all the others, looks for a route to the other that avoids the node and every node of the round and costs no more than going through the node. The search gives up after settleLimit nodes, which only costs a shortcut that was not needed.
+     *
+     * @param adjacency Arcs of every node still in the graph.
+     * @param state State of every node.
+     * @param node Node to contract.
+     * @param settleLimit Nodes each search finalizes at most.
+     * @param workspace Search state to reuse. Its shortcuts are set to those found.
+     */
+    static void findShortcuts(const std::vector<std::vector<ContractionHierarchy::Arc>> &adjacency, const std::vector<std::uint8_t> &state, const int node, const int settleLimit, WitnessWorkspace &workspace)
+    {
+        workspace.shortcuts.clear();
+        const std::vector<ContractionHierarchy::Arc> &nodeArcs = adjacency[node];
+        const int degree = static_cast<int>(nodeArcs.size());
+        if (degree < 2)
+        {
+            return;
+        }
+        if (workspace.costs.size() != adjacency.size())
+        {
+            workspace.costs.assign(adjacency.size(), std::numeric_limits<double>::infinity());
+            workspace.isTarget.assign(adjacency.size(), 0);
+            workspace.frontier.reset(static_cast<int>(adjacency.size()));
+        }
+
+        for (int source = 0; source + 1 < degree; ++source)
+        {
+            /* Pairs are looked at once, from the neighbour that comes first. */
+            double farthest = 0.0; /* Most a route to a later neighbour can cost through the node. */
+            for (int target = source + 1; target < degree; ++target)
+            {
+                farthest = std::max(farthest, static_cast<double>(nodeArcs[source].cost) + nodeArcs[target].cost);
+            }
+
+            int targetsLeft = 0; /* Later neighbours not finalized yet. */
+            for (int target = source + 1; target < degree; ++target)
+            {
+                targetsLeft += workspace.isTarget[nodeArcs[target].target] == 0 ? 1 : 0;
+                workspace.isTarget[nodeArcs[target].target] = 1;
+            }
+
+            const int sourceNode = nodeArcs[source].target;
+            workspace.costs[sourceNode] = 0.0;
+            workspace.touched.push_back(sourceNode);
+            workspace.frontier.push_or_decrease(sourceNode, 0.0);
+            int settled = 0; /* Nodes finalized so far. */
+            while (!workspace.frontier.empty() && targetsLeft > 0 && workspace.frontier.top_key() <= farthest &&
+                   settled < settleLimit)
+            {
+                const int reached = workspace.frontier.pop(); /* Node being finalized. */
+                ++settled;
+                targetsLeft -= workspace.isTarget[reached];
+                for (const ContractionHierarchy::Arc &arc : adjacency[reached])
+                {
+                    if (arc.target == node || state[arc.target] != REMAINING)
+                    {
+                        continue;
+                    }
+                    const double cost = workspace.costs[reached] + arc.cost;
+                    if (cost < workspace.costs[arc.target])
+                    {
+                        if (std::isinf(workspace.costs[arc.target]))
+                        {
+                            workspace.touched.push_back(arc.target);
+                        }
+                        workspace.costs[arc.target] = cost;
+                        workspace.frontier.push_or_decrease(arc.target, cost);
+                    }
+                }
+            }
+
+            for (int target = source + 1; target < degree; ++target)
+            {
+                /* Sums of two floats are exact in double, so a witness that ties the route through the node is never lost to rounding. */
+                const double throughNode = static_cast<double>(nodeArcs[source].cost) + nodeArcs[target].cost; /* Cost of the route through the node. */
+                if (!(workspace.costs[nodeArcs[target].target] <= throughNode))
+                {
+                    workspace.shortcuts.push_back({sourceNode, nodeArcs[target].target, static_cast<float>(throughNode)});
+                }
+            }
+
+            for (int target = source + 1; target < degree; ++target)
+            {
+                workspace.isTarget[nodeArcs[target].target] = 0;
+            }
+            for (const std::int32_t touchedNode : workspace.touched)
+            {
+                workspace.costs[touchedNode] = std::numeric_limits<double>::infinity();
+            }
+            workspace.touched.clear();
+            workspace.frontier.reset(static_cast<int>(adjacency.size()));
+        }
+    }
+
+    /**
+     * @brief Add an arc to a node's arcs, or lower the cost of the arc it already has to the same target.
+     *
+     * @param nodeArcs Arcs of the node.
+     * @param target Node the arc leads to.
+     * @param cost Cost of the arc.
+     * @param middle Node the arc skips, or -1.
+     */
+    static void addArc(std::vector<ContractionHierarchy::Arc> &nodeArcs, const std::int32_t target, const float cost, const std::int32_t middle)
+    {
+        for (ContractionHierarchy::Arc &arc : nodeArcs)
+        {
+            if (arc.target == target)
+            {
+                if (cost < arc.cost)
+                {
+                    arc.cost = cost;
+                    arc.middle = middle;
+                }
+                return;
+            }
+        }
+        nodeArcs.push_back({target, cost, middle});
+    }
+
+    /**
+     * @brief Order in which the nodes of a round are picked: lower priority first, then an arbitrary but fixed order.
+     *
+     * @details Multiplying by an odd constant is a bijection on 32 bits, so no two nodes tie, and neighbouring nodes are not picked in scan order.
+     *
+     * @param priority Priority of the node.
+     * @param node Index of the node.
+     * @return std::uint64_t Smaller keys are contracted first.
+     */
+    static std::uint64_t contractionKey(const int priority, const int node) noexcept
+    {
+        const std::uint32_t rank = static_cast<std::uint32_t>(priority) ^ 0x80000000u; /* Priority in unsigned order. */
+        return (static_cast<std::uint64_t>(rank) << 32) | (static_cast<std::uint32_t>(node) * 2654435761u);
+    }
+
+    /**
+     * @brief Get the sidecar filepath for a DEM.
+     *
+     * @param filepath Filepath to the DEM.
+     * @return std::string The DEM filepath with @ref FILE_EXTENSION appended.
+     */
+    std::string ContractionHierarchy::sidecarPathFor(const char *const filepath)
+    {
+        return std::string(filepath) + FILE_EXTENSION;
+    }
+
+    /**
+     * @brief Get the most pixels a build may cover within a memory budget.
+     *
+     * @param memoryBytes Most the build may hold, 0 for no limit.
+     * @return std::size_t @ref MAX_BUILD_CELLS without a budget, otherwise the pixels the budget holds at @ref BUILD_BYTES_PER_CELL each, at most @ref MAX_REGION_CELLS.
+     */
+    std::size_t ContractionHierarchy::maxBuildCells(const std::size_t memoryBytes) noexcept
+    {
+        return memoryBytes == 0 ? MAX_BUILD_CELLS : std::min(memoryBytes / BUILD_BYTES_PER_CELL, MAX_REGION_CELLS);
+    }
+
+    /**
+     * @brief Pick the region of a DEM to build a hierarchy over for a route, within a memory budget.
+     *
+     * @details The whole DEM is picked if it fits. Otherwise the region is the box around the start and goal, widened on every side by half its longer side and at least @ref MIN_REGION_MARGIN pixels so detours around obstacles stay inside, or by the widest margin the budget allows.
+     *
+     * @param rasterSize Width and height of the DEM.
+     * @param startPosition DEM (x, y) pixel the rover starts at.
+     * @param goalPosition DEM (x, y) pixel to reach.
+     * @param memoryBytes Most the build may hold, 0 for no limit.
+     * @return std::pair<std::pair<int, int>, std::pair<int, int>> Top-left and bottom-right DEM pixels of the region, inclusive.
+     *
+     * @throws Even the box around the start and goal is larger than the budget allows.
+     */
+    std::pair<std::pair<int, int>, std::pair<int, int>> ContractionHierarchy::regionFor(const std::pair<int, int> rasterSize, const std::pair<int, int> startPosition, const std::pair<int, int> goalPosition, const std::size_t memoryBytes)
+    {
+        const std::size_t maxCells = maxBuildCells(memoryBytes); /* Most pixels the region may cover. */
+        const auto widened = [&](const int margin)
+        {
+            return std::make_pair(std::make_pair(std::max(0, std::min(startPosition.first, goalPosition.first) - margin),
+                                                 std::max(0, std::min(startPosition.second, goalPosition.second) - margin)),
+                                  std::make_pair(std::min(rasterSize.first - 1, std::max(startPosition.first, goalPosition.first) + margin),
+                                                 std::min(rasterSize.second - 1, std::max(startPosition.second, goalPosition.second) + margin)));
+        };
+        const auto cellsOf = [](const std::pair<std::pair<int, int>, std::pair<int, int>> &region)
+        {
+            return static_cast<std::size_t>(region.second.first - region.first.first + 1) * static_cast<std::size_t>(region.second.second - region.first.second + 1);
+        };
+
+        if (static_cast<std::size_t>(rasterSize.first) * static_cast<std::size_t>(rasterSize.second) <= maxCells)
+        {
+            return {{0, 0}, {rasterSize.first - 1, rasterSize.second - 1}};
+        }
+        if (cellsOf(widened(0)) > maxCells)
+        {
+            throw std::invalid_argument("regionFor: the box around the start and goal needs " + std::to_string(cellsOf(widened(0)) * BUILD_BYTES_PER_CELL) + " bytes, more than the memory budget of " + std::to_string(memoryBytes));
+        }
+
+        /* Widest margin up to the one wanted that still fits. */
+        const int span = std::max(std::abs(goalPosition.first - startPosition.first), std::abs(goalPosition.second - startPosition.second)); /* Longer side of the box. */
+        int fitting = 0;                                         /* Margin known to fit. */
+        int tooWide = std::max(MIN_REGION_MARGIN, span / 2) + 1; /* Margin known not to fit, or one past the wanted margin. */
+        while (tooWide - fitting > 1)
+        {
+            const int margin = fitting + (tooWide - fitting) / 2;
+            if (cellsOf(widened(margin)) <= maxCells)
+            {
+                fitting = margin;
+            }
+            else
+            {
+                tooWide = margin;
+            }
+        }
+        return widened(fitting);
+    }
+
+    /**
+     * @brief Load the hierarchy of a DEM from its sidecar.
+     *
+     * @param filepath Filepath to the DEM, not the sidecar.
+     * @param rasterSize Width and height of the DEM.
+     * @param maxSlope Slope limit the hierarchy must have been built for.
+     * @param pixelSize Pixel size the hierarchy must have been built with.
+     * @return true The sidecar exists, is intact, and matches the DEM and every setting. Check @ref covers for the route's ends.
+     * @return false The hierarchy must be built again.
+     */
+    bool ContractionHierarchy::load(const char *const filepath, const std::pair<int, int> rasterSize, const float maxSlope, const float pixelSize)
+    {
+        std::uint64_t sourceSize;    /* Current size of the DEM file. */
+        std::int64_t sourceModified; /* Current modification time of the DEM file. */
+        if (!getSourceKey(filepath, sourceSize, sourceModified))
+        {
+            return false;
+        }
+
+        std::ifstream inFile(sidecarPathFor(filepath), std::ios::binary);
+        Header inHeader{}; /* Header read from the sidecar. */
+        if (!inFile || !inFile.read(reinterpret_cast<char *>(&inHeader), sizeof(Header)) ||
+            std::memcmp(inHeader.magic, MAGIC, sizeof(MAGIC)) != 0 || inHeader.version != VERSION ||
+            inHeader.sourceSize != sourceSize || inHeader.sourceModified != sourceModified ||
+            inHeader.maxSlope != maxSlope || inHeader.pixelSize != pixelSize)
+        {
+            return false;
+        }
+
+        /* Reject a region off the DEM and counts a damaged sidecar could hold before allocating for them. */
+        const std::uint64_t nodeCount = static_cast<std::uint64_t>(std::max(inHeader.xSize, 0)) * static_cast<std::uint64_t>(std::max(inHeader.ySize, 0)); /* One node per region pixel. */
+        if (inHeader.xSize <= 0 || inHeader.ySize <= 0 || inHeader.xOffset < 0 || inHeader.yOffset < 0 ||
+            inHeader.xSize > rasterSize.first - inHeader.xOffset || inHeader.ySize > rasterSize.second - inHeader.yOffset || nodeCount > MAX_REGION_CELLS ||
+            inHeader.arcCount > std::numeric_limits<std::uint32_t>::max() || inHeader.shortcutCount > inHeader.arcCount || inHeader.coreCount > nodeCount)
+        {
+            return false;
+        }
+
+        std::vector<std::uint32_t> inArcOffsets(nodeCount + 1); /* Arc offsets read from the sidecar. */
+        std::vector<Arc> inArcs(inHeader.arcCount);             /* Arcs read from the sidecar. */
+        inFile.read(reinterpret_cast<char *>(inArcOffsets.data()), static_cast<std::streamsize>(inArcOffsets.size() * sizeof(std::uint32_t)));
+        inFile.read(reinterpret_cast<char *>(inArcs.data()), static_cast<std::streamsize>(inArcs.size() * sizeof(Arc)));
+        if (!inFile || inArcOffsets.front() != 0 || inArcOffsets.back() != inHeader.arcCount ||
+            !std::is_sorted(inArcOffsets.begin(), inArcOffsets.end()))
+        {
+            return false;
+        }
+        for (const Arc &arc : inArcs)
+        {
+            if (arc.target < 0 || static_cast<std::uint64_t>(arc.target) >= nodeCount || arc.middle < -1 ||
+                (arc.middle >= 0 && static_cast<std::uint64_t>(arc.middle) >= nodeCount))
+            {
+                return false;
+            }
+        }
+
+        header = inHeader;
+        arcOffsets = std::move(inArcOffsets);
+        arcs = std::move(inArcs);
+        return true;
+    }
+
+    /**
+     * @brief Write the hierarchy to the DEM's sidecar, keyed to the DEM's current size and modification time.
+     *
+     * @param filepath Filepath to the DEM, not the sidecar.
+     *
+     * @throws Failure to stat the DEM or write the sidecar.
+     */
+    void ContractionHierarchy::save(const char *const filepath) const
+    {
+        Header outHeader = header; /* Header to write. */
+        if (!getSourceKey(filepath, outHeader.sourceSize, outHeader.sourceModified))
+        {
+            throw std::runtime_error("save: stat() error");
+        }
+
+        /* Write beside the sidecar and rename, so a concurrent reader never sees half a file. */
+        const std::string sidecarFilepath = sidecarPathFor(filepath);
+        const std::string temporaryFilepath = sidecarFilepath + ".partial"; /* Written first, then renamed. */
+        std::ofstream outFile(temporaryFilepath, std::ios::binary | std::ios::trunc);
+        if (!outFile)
+        {
+            throw std::runtime_error("save: failed to create " + temporaryFilepath);
+        }
+        outFile.write(reinterpret_cast<const char *>(&outHeader), sizeof(Header));
+        outFile.write(reinterpret_cast<const char *>(arcOffsets.data()), static_cast<std::streamsize>(arcOffsets.size() * sizeof(std::uint32_t)));
+        outFile.write(reinterpret_cast<const char *>(arcs.data()), static_cast<std::streamsize>(arcs.size() * sizeof(Arc)));
+        outFile.close();
+        if (!outFile || std::rename(temporaryFilepath.c_str(), sidecarFilepath.c_str()) != 0)
+        {
+            std::remove(temporaryFilepath.c_str());
+            throw std::runtime_error("save: failed to write " + sidecarFilepath);
+        }
+    }
+
+    /**
+     * @brief Build the hierarchy of a region of a DEM.
+     *
+     * @param elevationRaster DEM to build the hierarchy over.
+     * @param region Top-left and bottom-right DEM pixels of the region, inclusive, usually from @ref regionFor.
+     * @param maxSlope Maximum slope in degrees the rover can climb.
+     * @param pixelSize Pixel size in meters, as given to the searches.
+     * @param memoryBytes Most the build may hold, 0 for no limit.
+     * @param threadCount Threads to build with, or 0 for one per hardware thread.
+     *
+     * @throws The region has more pixels than @ref maxBuildCells allows, or the read fails.
+     */
+    void ContractionHierarchy::build(const DemHandler &elevationRaster, const std::pair<std::pair<int, int>, std::pair<int, int>> region, const float maxSlope, const float pixelSize, const std::size_t memoryBytes, const unsigned threadCount)
+    {
+        const std::size_t cells = static_cast<std::size_t>(std::max(region.second.first - region.first.first + 1, 0)) *
+                                  static_cast<std::size_t>(std::max(region.second.second - region.first.second + 1, 0)); /* Pixels of the region. */
+        if (cells > maxBuildCells(memoryBytes))
+        {
+            throw std::invalid_argument("build: region of " + std::to_string(cells) + " pixels too large for a contraction hierarchy within the memory budget");
+        }
+        const Raster2D<float> heights = elevationRaster.readRectangleChunk(region, 0);
+        build(heights.view(), maxSlope, pixelSize, memoryBytes, threadCount);
+    }
+
+    /**
+     * @brief Build the hierarchy of a raster held in memory.
+     *
+     * @details The grid graph is contracted in rounds. In each round every node whose key ranks before those of all nodes within two arcs of it is picked, the shortcuts each picked node needs are found on every thread at once, and then the picked nodes are removed and their shortcuts added. Only the neighbours of removed nodes have their priority worked out again, also on every thread.
+     *
+     * A node's priority is twice the shortcuts contracting it would add, less the arcs it would remove, plus the neighbours already contracted and the depth of contracted nodes below it, which spreads the contraction evenly over the raster. The shortcuts are only counted against witnesses of a single arc (@ref PRIORITY_SETTLE_LIMIT), since priorities are worked out many times more often than nodes are contracted. Contraction stops, leaving the core, once the remaining nodes average @ref CORE_DEGREE arcs.
+     *
+     * @param heights Elevations of the region, with its origin at the region's DEM position. Region pixel (x, y) is node y * xSize + x.
+     * @param maxSlope Maximum slope in degrees the rover can climb.
+     * @param pixelSize Pixel size in meters, as given to the searches.
+     * @param memoryBytes Most the build may hold, 0 for no limit.
+     * @param threadCount Threads to build with, or 0 for one per hardware thread.
+     *
+     * @throws The raster has more pixels than @ref maxBuildCells allows.
+     */
+    void ContractionHierarchy::build(const RasterView<const float> &heights, const float maxSlope, const float pixelSize, const std::size_t memoryBytes, unsigned threadCount)
+    {
+        const int xSize = heights.getXSize();
+        const int ySize = heights.getYSize();
+        if (static_cast<std::size_t>(xSize) * static_cast<std::size_t>(ySize) > maxBuildCells(memoryBytes))
+        {
+            throw std::invalid_argument("build: raster of " + std::to_string(static_cast<std::size_t>(xSize) * static_cast<std::size_t>(ySize)) + " pixels too large for a contraction hierarchy within the memory budget");
+        }
+        if (threadCount == 0)
+        {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        header = Header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.xSize = xSize;
+        header.ySize = ySize;
+        header.xOffset = heights.getOrigin().first;
+        header.yOffset = heights.getOrigin().second;
+        header.maxSlope = maxSlope;
+        header.pixelSize = pixelSize;
+        const int nodeCount = xSize * ySize; /* One node per pixel. */
+        std::vector<std::uint32_t>().swap(arcOffsets);
+        std::vector<Arc>().swap(arcs);
+
+        /* Every step within the slope limit is an arc both ways. */
+        std::vector<std::vector<Arc>> adjacency(nodeCount);    /* Arcs to nodes still in the graph, then frozen once a node is contracted. */
+        std::vector<WitnessWorkspace> workspaces(threadCount); /* Search state of each thread. */
+        forEachBlock(ySize, workspaces, [&](const int firstRow, const int lastRow, WitnessWorkspace &)
+                     {
+                         for (int row = firstRow; row < lastRow; ++row)
+                         {
+                             for (int col = 0; col < xSize; ++col)
+                             {
+                                 std::vector<Arc> &nodeArcs = adjacency[row * xSize + col];
+                                 for (int step = 0; step < 8; ++step)
+                                 {
+                                     const int neighbourRow = row + NewDijkstras::ROW_STEPS[step];
+                                     const int neighbourCol = col + NewDijkstras::COL_STEPS[step];
+                                     const bool diagonal = NewDijkstras::ROW_STEPS[step] != 0 && NewDijkstras::COL_STEPS[step] != 0; /* Whether the step is diagonal. */
+                                     double cost; /* Cost of the step, when it can be taken. */
+                                     if (neighbourRow >= 0 && neighbourRow < ySize && neighbourCol >= 0 && neighbourCol < xSize &&
+                                         ClusterGraph::stepCost(heights[row][col], heights[neighbourRow][neighbourCol], diagonal, maxSlope, pixelSize, cost))
+                                     {
+                                         nodeArcs.push_back({neighbourRow * xSize + neighbourCol, static_cast<float>(cost), -1});
+                                     }
+                                 }
+                             }
+                         } });
+
+        std::vector<std::uint8_t> state(nodeCount, REMAINING); /* Where each node is in the contraction. */
+        std::vector<int> contractedNeighbours(nodeCount, 0);   /* Neighbours of each node already contracted. */
+        std::vector<int> level(nodeCount, 0);                  /* Longest chain of contracted nodes below each node. */
+        std::vector<int> priority(nodeCount, 0);               /* Priority of each node still in the graph. */
+        const auto updatePriorities = [&](const std::vector<std::int32_t> &nodes)
+        {
+            forEachBlock(static_cast<int>(nodes.size()), workspaces, [&](const int first, const int last, WitnessWorkspace &workspace)
+                         {
+                             for (int item = first; item < last; ++item)
+                             {
+                                 const int node = nodes[item];
+                                 findShortcuts(adjacency, state, node, ContractionHierarchy::PRIORITY_SETTLE_LIMIT, workspace);
+                                 priority[node] = 2 * static_cast<int>(workspace.shortcuts.size()) - static_cast<int>(adjacency[node].size()) + contractedNeighbours[node] + level[node];
+                             } });
+        };
+
+        std::vector<std::int32_t> remaining(nodeCount); /* Nodes still in the graph. */
+        for (int node = 0; node < nodeCount; ++node)
+        {
+            remaining[node] = node;
+        }
+        updatePriorities(remaining);
+
+        std::vector<std::int32_t> round;                                                   /* Nodes contracted in the current round. */
+        std::vector<std::vector<Shortcut>> roundShortcuts;                                 /* Shortcuts each node of the round needs. */
+        std::vector<std::int32_t> changed;                                                 /* Neighbours of the round, whose priorities change. */
+        std::vector<std::uint8_t> isChanged(nodeCount, 0);                                 /* Whether a node is in changed. */
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> neighbourhoodKeys(nodeCount); /* Two smallest keys among each node and its neighbours. */
+        while (!remaining.empty())
+        {
+            /* Stop once the remaining nodes are so densely joined that contracting them costs more than searching them. */
+            std::size_t remainingArcs = 0; /* Arcs of the nodes still in the graph. */
+            for (const std::int32_t node : remaining)
+            {
+                remainingArcs += adjacency[node].size();
+            }
+            if (remainingArcs > static_cast<std::size_t>(CORE_DEGREE) * remaining.size())
+            {
+                break;
+            }
+
+            /* Pick every node that ranks before all nodes within two arcs of it. Arcs only lead to nodes still in the graph, so it is
+             * enough that the node is the smallest of its own neighbourhood and the smallest but for it of each neighbour's. */
+            forEachBlock(static_cast<int>(remaining.size()), workspaces, [&](const int first, const int last, WitnessWorkspace &)
+                         {
+                             for (int item = first; item < last; ++item)
+                             {
+                                 const int node = remaining[item];
+                                 std::uint64_t smallest = contractionKey(priority[node], node);
+                                 std::uint64_t second = std::numeric_limits<std::uint64_t>::max();
+                                 for (const Arc &arc : adjacency[node])
+                                 {
+                                     const std::uint64_t key = contractionKey(priority[arc.target], arc.target);
+                                     if (key < smallest)
+                                     {
+                                         second = smallest;
+                                         smallest = key;
+                                     }
+                                     else if (key < second)
+                                     {
+                                         second = key;
+                                     }
+                                 }
+                                 neighbourhoodKeys[node] = {smallest, second};
+                             } });
+            forEachBlock(static_cast<int>(remaining.size()), workspaces, [&](const int first, const int last, WitnessWorkspace &workspace)
+                         {
+                             for (int item = first; item < last; ++item)
+                             {
+                                 const int node = remaining[item];
+                                 const std::uint64_t key = contractionKey(priority[node], node);
+                                 bool ranksFirst = neighbourhoodKeys[node].first == key; /* Whether the node ranks before every node within two arcs. */
+                                 for (auto arc = adjacency[node].begin(); ranksFirst && arc != adjacency[node].end(); ++arc)
+                                 {
+                                     const std::pair<std::uint64_t, std::uint64_t> &keys = neighbourhoodKeys[arc->target];
+                                     ranksFirst = (keys.first == key ? keys.second : keys.first) > key;
+                                 }
+                                 if (ranksFirst)
+                                 {
+                                     workspace.picked.push_back(node);
+                                 }
+                             } });
+            round.clear();
+            for (WitnessWorkspace &workspace : workspaces)
+            {
+                round.insert(round.end(), workspace.picked.begin(), workspace.picked.end());
+                workspace.picked.clear();
+            }
+            for (const std::int32_t node : round)
+            {
+                state[node] = CONTRACTING;
+            }
+
+            /* The picked nodes share no arcs or neighbours, so their searches only read the graph, and the detours around a node through
+             * its neighbours' neighbours are never blocked by another node of the round. */
+            roundShortcuts.resize(round.size());
+            forEachBlock(static_cast<int>(round.size()), workspaces, [&](const int first, const int last, WitnessWorkspace &workspace)
+                         {
+                             for (int item = first; item < last; ++item)
+                             {
+                                 findShortcuts(adjacency, state, round[item], ContractionHierarchy::WITNESS_SETTLE_LIMIT, workspace);
+                                 roundShortcuts[item] = workspace.shortcuts;
+                             } });
+
+            /* Remove the picked nodes, keeping their arcs, and join their neighbours where needed. */
+            changed.clear();
+            for (std::size_t item = 0; item < round.size(); ++item)
+            {
+                const int node = round[item];
+                for (const Arc &arc : adjacency[node])
+                {
+                    std::vector<Arc> &neighbourArcs = adjacency[arc.target];
+                    neighbourArcs.erase(std::find_if(neighbourArcs.begin(), neighbourArcs.end(), [&](const Arc &back)
+                                                     { return back.target == node; }));
+                    ++contractedNeighbours[arc.target];
+                    level[arc.target] = std::max(level[arc.target], level[node] + 1);
+                    if (!isChanged[arc.target])
+                    {
+                        isChanged[arc.target] = 1;
+                        changed.push_back(arc.target);
+                    }
+                }
+                adjacency[node].shrink_to_fit();
+                state[node] = CONTRACTED;
+                for (const Shortcut &shortcut : roundShortcuts[item])
+                {
+                    addArc(adjacency[shortcut.from], shortcut.to, shortcut.cost, node);
+                    addArc(adjacency[shortcut.to], shortcut.from, shortcut.cost, node);
+                }
+            }
+            for (const std::int32_t node : changed)
+            {
+                isChanged[node] = 0;
+            }
+            updatePriorities(changed);
+            remaining.erase(std::remove_if(remaining.begin(), remaining.end(), [&](const std::int32_t node)
+                                           { return state[node] != REMAINING; }),
+                            remaining.end());
+            ++header.roundCount;
+        }
+        header.coreCount = remaining.size();
+
+        arcOffsets.assign(1, 0);
+        arcs.clear();
+        for (const std::vector<Arc> &nodeArcs : adjacency)
+        {
+            arcs.insert(arcs.end(), nodeArcs.begin(), nodeArcs.end());
+            arcOffsets.push_back(static_cast<std::uint32_t>(arcs.size()));
+        }
+        header.arcCount = arcs.size();
+        header.shortcutCount = static_cast<std::uint64_t>(std::count_if(arcs.begin(), arcs.end(), [](const Arc &arc)
+                                                                        { return arc.middle >= 0; }));
+    }
+
+    /**
+     * @brief Find the least-cost route between two pixels.
+     *
+     * @details A Dijkstra's search from each end follows arcs to later nodes and within the core, alternating by whichever has the cheaper node to finalize, until neither can finalize a node cheaper than the best route found. A node that a later node it has an arc with reaches more cheaply is not on a least-cost upward route, so its arcs are skipped (stall-on-demand). The route through the best meeting node is then unpacked shortcut by shortcut into single steps.
+     *
+     * @param startPosition DEM (x, y) pixel the rover starts at.
+     * @param goalPosition DEM (x, y) pixel to reach.
+     * @param workspace Node state to reuse. Its stats are set to those of this query.
+     * @return std::vector<std::pair<int, int>> Every DEM pixel of the route, from the start to the goal, each a neighbour of the one before.
+     *
+     * @throws Nothing has been built or loaded, the start or goal is outside the region, or no route between them within the region stays within the slope limit.
+     */
+    std::vector<std::pair<int, int>> ContractionHierarchy::route(const std::pair<int, int> startPosition, const std::pair<int, int> goalPosition, QueryWorkspace &workspace) const
+    {
+        if (empty())
+        {
+            throw std::logic_error("route: no contraction hierarchy built or loaded");
+        }
+        if (!covers(startPosition) || !covers(goalPosition))
+        {
+            throw std::out_of_range("route: start or goal is outside the hierarchy's region");
+        }
+        workspace.stats = QueryStats{};
+        if (startPosition == goalPosition)
+        {
+            return {startPosition};
+        }
+
+        const int nodeCount = header.xSize * header.ySize; /* One node per pixel. */
+        for (int direction = 0; direction < 2; ++direction)
+        {
+            if (workspace.costs[direction].size() != static_cast<std::size_t>(nodeCount))
+            {
+                workspace.costs[direction].assign(nodeCount, std::numeric_limits<double>::infinity());
+                workspace.parents[direction].assign(nodeCount, -1);
+                workspace.touched.clear();
+            }
+        }
+        for (const std::int32_t node : workspace.touched)
+        {
+            workspace.costs[0][node] = workspace.costs[1][node] = std::numeric_limits<double>::infinity();
+            workspace.parents[0][node] = workspace.parents[1][node] = -1;
+        }
+        workspace.touched.clear();
+
+        /* Search 0 runs from the start, search 1 from the goal. */
+        const int endNodes[2] = {(startPosition.second - header.yOffset) * header.xSize + startPosition.first - header.xOffset,
+                                 (goalPosition.second - header.yOffset) * header.xSize + goalPosition.first - header.xOffset};
+        for (int direction = 0; direction < 2; ++direction)
+        {
+            workspace.frontiers[direction].reset(nodeCount);
+            workspace.costs[direction][endNodes[direction]] = 0.0;
+            workspace.touched.push_back(endNodes[direction]);
+            workspace.frontiers[direction].push_or_decrease(endNodes[direction], 0.0);
+        }
+
+        double bestCost = std::numeric_limits<double>::infinity(); /* Cost of the cheapest route found so far. */
+        int meetingNode = -1;                                       /* Node that route passes through. */
+        while (true)
+        {
+            int direction = -1;          /* Search to advance. */
+            double lowestKey = bestCost; /* Only nodes cheaper than the best route can improve it. */
+            for (int candidate = 0; candidate < 2; ++candidate)
+            {
+                if (!workspace.frontiers[candidate].empty() && workspace.frontiers[candidate].top_key() < lowestKey)
+                {
+                    lowestKey = workspace.frontiers[candidate].top_key();
+                    direction = candidate;
+                }
+            }
+            if (direction < 0)
+            {
+                break;
+            }
+
+            std::vector<double> &costs = workspace.costs[direction];
+            const int node = workspace.frontiers[direction].pop(); /* Node being finalized. */
+            ++workspace.stats.settledNodes;
+            const double cost = costs[node];
+            const double meetingCost = cost + workspace.costs[1 - direction][node];
+            if (meetingCost < bestCost)
+            {
+                bestCost = meetingCost;
+                meetingNode = node;
+            }
+
+            const std::pair<const Arc *, const Arc *> nodeArcs = getArcs(node);
+            bool stalled = false; /* Whether a later node reaches this one more cheaply. */
+            for (const Arc *arc = nodeArcs.first; arc != nodeArcs.second && !stalled; ++arc)
+            {
+                stalled = costs[arc->target] + arc->cost < cost;
+            }
+            if (stalled)
+            {
+                ++workspace.stats.stalledNodes;
+                continue;
+            }
+            for (const Arc *arc = nodeArcs.first; arc != nodeArcs.second; ++arc)
+            {
+                const double reachedCost = cost + arc->cost;
+                if (reachedCost < costs[arc->target])
+                {
+                    if (std::isinf(workspace.costs[0][arc->target]) && std::isinf(workspace.costs[1][arc->target]))
+                    {
+                        workspace.touched.push_back(arc->target);
+                    }
+                    costs[arc->target] = reachedCost;
+                    workspace.parents[direction][arc->target] = node;
+                    workspace.frontiers[direction].push_or_decrease(arc->target, reachedCost);
+                }
+            }
+        }
+        if (meetingNode < 0)
+        {
+            throw std::runtime_error("route: no route between the start and goal within the slope limit");
+        }
+
+        /* The nodes of the upward route from the start, then those of the one from the goal, joined at the meeting node. */
+        std::vector<int> hierarchyRoute; /* Nodes of the route in the hierarchy, start first. */
+        for (int node = meetingNode; node != -1; node = workspace.parents[0][node])
+        {
+            hierarchyRoute.push_back(node);
+        }
+        std::reverse(hierarchyRoute.begin(), hierarchyRoute.end());
+        for (int node = workspace.parents[1][meetingNode]; node != -1; node = workspace.parents[1][node])
+        {
+            hierarchyRoute.push_back(node);
+        }
+
+        std::vector<std::pair<int, int>> route = {startPosition}; /* DEM pixels of the unpacked route. */
+        for (std::size_t leg = 1; leg < hierarchyRoute.size(); ++leg)
+        {
+            unpackArc(hierarchyRoute[leg - 1], hierarchyRoute[leg], route);
+        }
+        workspace.stats.routeSteps = route.size() - 1;
+        return route;
+    }
+
+    /**
+     * @brief Find the arc a node kept to another node.
+     *
+     * @param node Node that kept the arc, the one contracted first.
+     * @param target Node the arc leads to.
+     * @return const Arc* The arc, or nullptr if the node kept none to the target.
+     */
+    const ContractionHierarchy::Arc *ContractionHierarchy::findArc(const int node, const int target) const noexcept
+    {
+        const std::pair<const Arc *, const Arc *> nodeArcs = getArcs(node);
+        const Arc *const found = std::find_if(nodeArcs.first, nodeArcs.second, [&](const Arc &arc)
+                                              { return arc.target == target; });
+        return found != nodeArcs.second ? found : nullptr;
+    }
+
+    /**
+     * @brief Append the pixels of an arc's route to a route, replacing each shortcut with the two arcs it joins.
+     *
+     * @details The node a shortcut skips was contracted before both its ends, so each of the two arcs is kept by that node. Shortcuts nest as deep as the rounds go, so they are unpacked with a stack rather than recursion.
+     *
+     * @param from Node the arc starts at, already the last pixel of the route.
+     * @param to Node the arc leads to.
+     * @param route Route to extend, in DEM pixels.
+     *
+     * @throws The hierarchy has no arc between two nodes of a shortcut, which a damaged sidecar could cause.
+     */
+    void ContractionHierarchy::unpackArc(const int from, const int to, std::vector<std::pair<int, int>> &route) const
+    {
+        std::vector<std::pair<int, int>> pending = {{from, to}}; /* Arcs left to unpack, the next one last. */
+        while (!pending.empty())
+        {
+            const std::pair<int, int> leg = pending.back();
+            pending.pop_back();
+            const Arc *arc = findArc(leg.first, leg.second);
+            if (arc == nullptr)
+            {
+                arc = findArc(leg.second, leg.first);
+            }
+            if (arc == nullptr)
+            {
+                throw std::runtime_error("unpackArc: shortcut skips a node without arcs to both ends");
+            }
+            if (arc->middle < 0)
+            {
+                route.emplace_back(leg.second % header.xSize + header.xOffset, leg.second / header.xSize + header.yOffset);
+                continue;
+            }
+            pending.emplace_back(arc->middle, leg.second);
+            pending.emplace_back(leg.first, arc->middle);
+        }
+    }
+}
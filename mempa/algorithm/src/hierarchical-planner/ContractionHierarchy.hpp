@@ -0,0 +1,144 @@
+#pragma once
+
+/* mempa::DemHandler */
+#include "../dem-handler/DemHandler.hpp"
+
+/* mempa::Raster2D */
+#include "../dem-handler/Raster2D.hpp"
+
+/* IndexedHeap */
+#include "../rover-pathfinding-module/IndexedHeap.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mempa
+{
+    /**
+     * @brief Contraction hierarchy of the grid graph over a region of a DEM for one slope limit, answering point-to-point routes within the region in milliseconds.
+     *
+     * @details The graph has a node for every pixel and an arc for every step between neighbouring pixels within the slope limit, with the slope check and step cost NewDijkstras uses. Nodes are contracted one after another: a contracted node is removed, and wherever the only least-cost route between two of its neighbours ran through it, a shortcut joining them takes its place. Each node keeps the arcs it had when it was contracted, which all lead to nodes contracted later, and each shortcut remembers the node it skipped so a route can be unpacked back into single steps.
+     *
+     * Nodes are contracted in rounds. Each round picks the nodes that rank before every node within two arcs of them, by the shortcuts contracting them would add, and contracts them together on every thread. Those nodes share no arcs or neighbours, so their witness searches only read the graph, and no detour around one of them runs through another.
+     *
+     * Shortcuts gather on the nodes contracted last, since a grid has no few nodes that most routes pass through, so contraction stops once the remaining nodes average @ref CORE_DEGREE arcs. Those nodes are left as the core: each keeps its arcs to the others, and queries search the core like the grid.
+     *
+     * A query runs a Dijkstra's search from each end that only follows arcs to nodes contracted later or within the core, and the cheapest node both searches reach joins them. Steps cost the same both ways, so one set of arcs serves both searches.
+     *
+     * Building takes minutes on a million pixels and holds about @ref BUILD_BYTES_PER_CELL bytes per pixel, so a large DEM is only built over the region @ref regionFor picks around a route's ends to fit the memory budget. Routes leave the region nowhere, so a route that would detour outside it is only the least-cost route within it.
+     *
+     * The hierarchy is saved to a sidecar next to the DEM. The sidecar records the region, the DEM's size and modification time, the slope limit and pixel size, and is ignored once any of them differ or the region misses a route's ends, when it is rebuilt around the new ends.
+     *
+     * ## Sidecar Layout
+     *
+     * - A fixed @ref Header.
+     * - Header::xSize * Header::ySize + 1 UInt32 offsets into the arcs. The arcs kept by each pixel of the region are contiguous, pixels in row-major order.
+     * - Header::arcCount @ref Arc records.
+     */
+    class ContractionHierarchy
+    {
+    public:
+        /**
+         * @brief Fixed-size header at the start of a contraction hierarchy sidecar.
+         */
+        struct Header
+        {
+            char magic[8];               /* Always @ref MAGIC. */
+            std::uint32_t version;       /* Format version, currently @ref VERSION. */
+            std::int32_t xSize;          /* Region width in pixels. */
+            std::int32_t ySize;          /* Region height in pixels. */
+            std::int32_t xOffset;        /* DEM column of the region's first pixel. */
+            std::int32_t yOffset;        /* DEM row of the region's first pixel. */
+            float maxSlope;              /* Slope limit in degrees the hierarchy was built for. */
+            float pixelSize;             /* Pixel size in meters the step costs were computed with. */
+            std::int32_t roundCount;     /* Contraction rounds the build took. */
+            std::uint64_t sourceSize;    /* Size in bytes of the DEM file. */
+            std::int64_t sourceModified; /* Modification time of the DEM file, in seconds. */
+            std::uint64_t arcCount;      /* Number of arcs, steps and shortcuts. */
+            std::uint64_t shortcutCount; /* Number of those arcs that are shortcuts. */
+            std::uint64_t coreCount;     /* Nodes left uncontracted, each keeping its arcs to the others. */
+        };
+
+        /**
+         * @brief Arc from a node to one contracted after it.
+         */
+        struct Arc
+        {
+            std::int32_t target; /* Region pixel index, y * xSize + x, of the node the arc leads to. */
+            float cost;          /* Least cost of the route the arc stands for. */
+            std::int32_t middle; /* Node the shortcut skips, or -1 for a single step. */
+        };
+
+        /**
+         * @brief Totals from the last query.
+         */
+        struct QueryStats
+        {
+            std::size_t settledNodes = 0; /* Nodes both searches finalized. */
+            std::size_t stalledNodes = 0; /* Finalized nodes whose arcs were skipped because a later node reaches them cheaper. */
+            std::size_t routeSteps = 0;   /* Steps in the unpacked route. */
+        };
+
+        /**
+         * @brief Node state reused by every query, so each query thread allocates only once.
+         */
+        struct QueryWorkspace
+        {
+            std::vector<double> costs[2];         /* Least cost found from the start and from the goal to each node. */
+            std::vector<std::int32_t> parents[2]; /* Node each node was reached from in each search. */
+            std::vector<std::int32_t> touched;    /* Nodes whose state must be cleared before the next query. */
+            IndexedHeap frontiers[2];             /* Reached nodes that are not finalized yet, from each end. */
+            QueryStats stats;                     /* Totals from the last query. */
+        };
+
+        inline static constexpr char MAGIC[8] = {'M', 'E', 'M', 'P', 'A', 'C', 'H', 'G'}; /* File signature. */
+        inline static constexpr std::uint32_t VERSION = 2;                                 /* Current format version. */
+        inline static constexpr std::size_t MAX_BUILD_CELLS = std::size_t(1) << 20;        /* Largest region built without a memory budget, 1024 x 1024 pixels. */
+        inline static constexpr std::size_t MAX_REGION_CELLS = std::size_t(1) << 28;       /* Largest region built under any budget, keeping node indices in Int32 and arc offsets in UInt32 at about six arcs per node. */
+        inline static constexpr std::size_t BUILD_BYTES_PER_CELL = 320;                    /* Peak bytes a build holds per region pixel, measured at about 300 on rough 1024 x 1024 terrain. */
+        inline static constexpr int MIN_REGION_MARGIN = 128;                               /* Fewest pixels a region reaches past the box around a route's ends, budget permitting. */
+        inline static constexpr int WITNESS_SETTLE_LIMIT = 128;                            /* Nodes a witness search finalizes before giving up and keeping the shortcut. Lower limits add shortcuts that slow every later round. */
+        inline static constexpr int CORE_DEGREE = 48;                                      /* Average arcs per remaining node at which contraction stops and the rest are left as the core. */
+        inline static constexpr int PRIORITY_SETTLE_LIMIT = 1;                             /* Nodes a witness search finalizes when only counting shortcuts to rank a node, so only single arcs between neighbours are witnesses. */
+        inline static constexpr const char *FILE_EXTENSION = ".mempa-ch";                  /* Suffix appended to a DEM path for its sidecar. */
+
+    private:
+        Header header{};                       /* Sizes and the settings the hierarchy was built for. */
+        std::vector<std::uint32_t> arcOffsets; /* First arc of each pixel, plus the arc count. */
+        std::vector<Arc> arcs;                 /* Arcs of every pixel. */
+
+        const Arc *findArc(int node, int target) const noexcept;
+        void unpackArc(int from, int to, std::vector<std::pair<int, int>> &route) const;
+
+    protected:
+        /* ContractionHierarchy is not designed to be subclassed. */
+
+    public:
+        static std::string sidecarPathFor(const char *filepath);
+        static std::size_t maxBuildCells(std::size_t memoryBytes) noexcept;
+        static std::pair<std::pair<int, int>, std::pair<int, int>> regionFor(std::pair<int, int> rasterSize, std::pair<int, int> startPosition, std::pair<int, int> goalPosition, std::size_t memoryBytes);
+        bool load(const char *filepath, std::pair<int, int> rasterSize, float maxSlope, float pixelSize);
+        void save(const char *filepath) const;
+        void build(const DemHandler &elevationRaster, std::pair<std::pair<int, int>, std::pair<int, int>> region, float maxSlope, float pixelSize, std::size_t memoryBytes = 0, unsigned threadCount = 0);
+        void build(const RasterView<const float> &heights, float maxSlope, float pixelSize, std::size_t memoryBytes = 0, unsigned threadCount = 0);
+        std::vector<std::pair<int, int>> route(std::pair<int, int> startPosition, std::pair<int, int> goalPosition, QueryWorkspace &workspace) const;
+
+        inline bool empty() const noexcept;
+        inline bool covers(std::pair<int, int> position) const noexcept;
+        inline std::pair<int, int> getOrigin() const noexcept;
+        inline int getXSize() const noexcept;
+        inline int getYSize() const noexcept;
+        inline float getMaxSlope() const noexcept;
+        inline int getRoundCount() const noexcept;
+        inline std::size_t getArcCount() const noexcept;
+        inline std::size_t getShortcutCount() const noexcept;
+        inline std::size_t getCoreCount() const noexcept;
+        inline std::pair<const Arc *, const Arc *> getArcs(int node) const noexcept;
+    };
+}
+
+#include "ContractionHierarchy.inl"
@@ -0,0 +1,124 @@
+/* Local Header */
+#include "ContractionHierarchy.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <utility>
+
+namespace mempa
+{
+    /**
+     * @brief Check whether a hierarchy has been built or loaded.
+     *
+     * @return true Nothing can be routed yet.
+     * @return false
+     */
+    inline bool ContractionHierarchy::empty() const noexcept
+    {
+        return arcOffsets.empty();
+    }
+
+    /**
+     * @brief Check whether a DEM pixel lies within the hierarchy's region.
+     *
+     * @param position DEM (x, y) pixel.
+     * @return true Routes can start or end at the pixel.
+     * @return false
+     */
+    inline bool ContractionHierarchy::covers(const std::pair<int, int> position) const noexcept
+    {
+        return position.first >= header.xOffset && position.first - header.xOffset < header.xSize &&
+               position.second >= header.yOffset && position.second - header.yOffset < header.ySize;
+    }
+
+    /**
+     * @brief Get the DEM pixel of the region's first pixel.
+     *
+     * @return std::pair<int, int> DEM (x, y) of the region's top-left pixel.
+     */
+    inline std::pair<int, int> ContractionHierarchy::getOrigin() const noexcept
+    {
+        return {header.xOffset, header.yOffset};
+    }
+
+    /**
+     * @brief Get the width of the region the hierarchy covers.
+     *
+     * @return int Number of pixels per row.
+     */
+    inline int ContractionHierarchy::getXSize() const noexcept
+    {
+        return header.xSize;
+    }
+
+    /**
+     * @brief Get the height of the region the hierarchy covers.
+     *
+     * @return int Number of pixels per column.
+     */
+    inline int ContractionHierarchy::getYSize() const noexcept
+    {
+        return header.ySize;
+    }
+
+    /**
+     * @brief Get the slope limit the hierarchy was built for.
+     *
+     * @return float Slope limit in degrees. Routes are only valid for this limit.
+     */
+    inline float ContractionHierarchy::getMaxSlope() const noexcept
+    {
+        return header.maxSlope;
+    }
+
+    /**
+     * @brief Get the number of contraction rounds the build took.
+     *
+     * @return int
+     */
+    inline int ContractionHierarchy::getRoundCount() const noexcept
+    {
+        return header.roundCount;
+    }
+
+    /**
+     * @brief Get the number of arcs kept, steps and shortcuts.
+     *
+     * @return std::size_t
+     */
+    inline std::size_t ContractionHierarchy::getArcCount() const noexcept
+    {
+        return static_cast<std::size_t>(header.arcCount);
+    }
+
+    /**
+     * @brief Get the number of arcs that are shortcuts.
+     *
+     * @return std::size_t
+     */
+    inline std::size_t ContractionHierarchy::getShortcutCount() const noexcept
+    {
+        return static_cast<std::size_t>(header.shortcutCount);
+    }
+
+    /**
+     * @brief Get the number of nodes left uncontracted, which every query searches without the hierarchy's help.
+     *
+     * @return std::size_t
+     */
+    inline std::size_t ContractionHierarchy::getCoreCount() const noexcept
+    {
+        return static_cast<std::size_t>(header.coreCount);
+    }
+
+    /**
+     * @brief Get the arcs a node kept when it was contracted, each to a node contracted after it.
+     *
+     * @param node Region pixel index, y * xSize + x.
+     * @return std::pair<const Arc *, const Arc *> Begin and end of the node's arcs.
+     */
+    inline std::pair<const ContractionHierarchy::Arc *, const ContractionHierarchy::Arc *> ContractionHierarchy::getArcs(const int node) const noexcept
+    {
+        return {arcs.data() + arcOffsets[node], arcs.data() + arcOffsets[node + 1]};
+    }
+}
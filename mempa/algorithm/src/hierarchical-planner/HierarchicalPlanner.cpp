@@ -0,0 +1,237 @@
+/* Local Header */
+#include "HierarchicalPlanner.hpp"
+
+/* IndexedHeap */
+#include "../rover-pathfinding-module/IndexedHeap.hpp"
+
+/* C++ Standard Libraries */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace mempa
+{
+    /**
+     * @brief Construct a new HierarchicalPlanner, loading the DEM's cluster graph from its sidecar or building and saving it.
+     *
+     * @param elevationRaster Handler for the DEM to plan over.
+     * @param demFilepath Filepath the DEM was opened from, which the sidecar is named after.
+     * @param maxSlope Maximum slope in degrees the rover can climb.
+     * @param clusterSize Width and height of a cluster in pixels.
+     *
+     * @throws Failure to build the graph.
+     */
+    HierarchicalPlanner::HierarchicalPlanner(const DemHandler *const elevationRaster, const char *const demFilepath, const float maxSlope, const int clusterSize)
+        : elevationRaster(elevationRaster), maxSlope(maxSlope), pixelSize(static_cast<float>(elevationRaster->getImageResolution()))
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+        planStats.graphLoaded = clusterGraph.load(demFilepath, {elevationRaster->getXSize(), elevationRaster->getYSize()}, clusterSize, maxSlope, pixelSize);
+        if (!planStats.graphLoaded)
+        {
+            clusterGraph.build(*elevationRaster, clusterSize, maxSlope, pixelSize);
+            try
+            {
+                clusterGraph.save(demFilepath);
+            }
+            catch (const std::runtime_error &)
+            {
+                /* The sidecar is only a cache. Without write access the graph is built again next run. */
+            }
+        }
+        planStats.graphSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    /**
+     * @brief Plan a route from one raster cell to another.
+     *
+     * @param startPosition Raster (x, y) cell the rover starts at.
+     * @param goalPosition Raster (x, y) cell to reach.
+     * @return std::vector<std::pair<int, int>> Every cell of the route, from the start to the goal, each a neighbour of the one before.
+     *
+     * @throws The start or goal is outside the raster, or no route between them stays within the slope limit.
+     */
+    std::vector<std::pair<int, int>> HierarchicalPlanner::plan(const std::pair<int, int> startPosition, const std::pair<int, int> goalPosition)
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+        const auto insideRaster = [&](const std::pair<int, int> cell)
+        {
+            return cell.first >= 0 && cell.first < elevationRaster->getXSize() && cell.second >= 0 && cell.second < elevationRaster->getYSize();
+        };
+        if (!insideRaster(startPosition) || !insideRaster(goalPosition))
+        {
+            throw std::out_of_range("plan: start or goal is outside the raster");
+        }
+        planStats.abstractExpansions = 0;
+        planStats.clustersRefined = 0;
+        planStats.cellExpansions = 0;
+        if (startPosition == goalPosition)
+        {
+            return {startPosition};
+        }
+
+        /* The start and goal join the graph as two extra nodes after the real ones. */
+        const int nodeCount = static_cast<int>(clusterGraph.getNodeCount()); /* Nodes of the graph itself. */
+        const int startNode = nodeCount;                                      /* Node standing for the start. */
+        const int goalNode = nodeCount + 1;                                   /* Node standing for the goal. */
+        const int startCluster = clusterGraph.clusterOf(startPosition);
+        const int goalCluster = clusterGraph.clusterOf(goalPosition);
+        const auto cellOf = [&](const int node)
+        {
+            return node == startNode ? startPosition : node == goalNode ? goalPosition : clusterGraph.getNode(node);
+        };
+
+        /* Link the start to the nodes of its cluster, and straight to the goal when they share it. */
+        const std::pair<int, int> startClusterNodes = clusterGraph.getClusterNodes(startCluster);
+        std::vector<std::pair<int, int>> targets; /* Cells to find the cost to from the start. */
+        for (int node = startClusterNodes.first; node < startClusterNodes.second; ++node)
+        {
+            targets.push_back(clusterGraph.getNode(node));
+        }
+        if (goalCluster == startCluster)
+        {
+            targets.push_back(goalPosition);
+        }
+        const std::vector<float> startCosts = linkCosts(startPosition, targets); /* Cost from the start to each target. */
+
+        /* Link the nodes of the goal's cluster to the goal. Step costs do not depend on direction, so searching from the goal gives them. */
+        const std::pair<int, int> goalClusterNodes = clusterGraph.getClusterNodes(goalCluster);
+        targets.clear();
+        for (int node = goalClusterNodes.first; node < goalClusterNodes.second; ++node)
+        {
+            targets.push_back(clusterGraph.getNode(node));
+        }
+        const std::vector<float> goalCosts = linkCosts(goalPosition, targets); /* Cost from each node of the goal's cluster to the goal. */
+
+        /* A* over the graph. Every edge costs at least the octile distance it covers, so that distance never overestimates. */
+        const auto estimate = [&](const int node)
+        {
+            const std::pair<int, int> cell = cellOf(node);
+            const int dx = std::abs(cell.first - goalPosition.first);
+            const int dy = std::abs(cell.second - goalPosition.second);
+            return (std::max(dx, dy) + (std::sqrt(2.0) - 1.0) * std::min(dx, dy)) * pixelSize;
+        };
+        std::vector<double> costs(nodeCount + 2, std::numeric_limits<double>::infinity()); /* Least cost found from the start to each node. */
+        std::vector<int> parents(nodeCount + 2, -1);                                        /* Node each node was reached from. */
+        IndexedHeap frontier;                                                                /* Reached nodes that are not finalized yet. */
+        frontier.reset(nodeCount + 2);
+        const auto relax = [&](const int fromNode, const int toNode, const double edgeCost)
+        {
+            const double cost = costs[fromNode] + edgeCost;
+            if (cost < costs[toNode])
+            {
+                costs[toNode] = cost;
+                parents[toNode] = fromNode;
+                frontier.push_or_decrease(toNode, cost + estimate(toNode));
+            }
+        };
+        costs[startNode] = 0.0;
+        frontier.push_or_decrease(startNode, estimate(startNode));
+        while (!frontier.empty())
+        {
+            const int node = frontier.pop(); /* Node being expanded. */
+            ++planStats.abstractExpansions;
+            if (node == goalNode)
+            {
+                break;
+            }
+            if (node == startNode)
+            {
+                /* The targets were the start's cluster nodes in order, then the goal if it shares the cluster. */
+                for (int target = 0; target < static_cast<int>(startCosts.size()); ++target)
+                {
+                    const int targetNode = startClusterNodes.first + target < startClusterNodes.second ? startClusterNodes.first + target : goalNode;
+                    if (std::isfinite(startCosts[target]))
+                    {
+                        relax(node, targetNode, startCosts[target]);
+                    }
+                }
+                continue;
+            }
+            const std::pair<const ClusterGraph::Edge *, const ClusterGraph::Edge *> edges = clusterGraph.getEdges(node);
+            for (const ClusterGraph::Edge *edge = edges.first; edge != edges.second; ++edge)
+            {
+                relax(node, edge->target, edge->cost);
+            }
+            if (node >= goalClusterNodes.first && node < goalClusterNodes.second && std::isfinite(goalCosts[node - goalClusterNodes.first]))
+            {
+                relax(node, goalNode, goalCosts[node - goalClusterNodes.first]);
+            }
+        }
+        if (parents[goalNode] < 0)
+        {
+            throw std::runtime_error("plan: no route between the start and goal within the slope limit");
+        }
+
+        /* Walk the corridor back from the goal, then refine it leg by leg from the start. */
+        std::vector<std::pair<int, int>> corridor; /* Cells of the abstract route, goal first. */
+        for (int node = goalNode; node != -1; node = parents[node])
+        {
+            corridor.push_back(cellOf(node));
+        }
+        std::reverse(corridor.begin(), corridor.end());
+        std::vector<std::pair<int, int>> route = {startPosition}; /* Cells of the refined route. */
+        for (std::size_t leg = 1; leg < corridor.size(); ++leg)
+        {
+            if (corridor[leg] == corridor[leg - 1])
+            {
+                continue;
+            }
+            if (clusterGraph.clusterOf(corridor[leg]) != clusterGraph.clusterOf(corridor[leg - 1]))
+            {
+                /* Legs between clusters are the single step of an entrance. */
+                route.push_back(corridor[leg]);
+                continue;
+            }
+            refineLeg(corridor[leg - 1], corridor[leg], route);
+        }
+
+        planStats.planSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        return route;
+    }
+
+    /**
+     * @brief Find the cost from a cell to each of a set of cells in its cluster, without leaving the cluster.
+     *
+     * @param cell Raster (x, y) cell to search from.
+     * @param targets Raster (x, y) cells in the same cluster.
+     * @return std::vector<float> Cost to each target, infinite where a target cannot be reached.
+     */
+    std::vector<float> HierarchicalPlanner::linkCosts(const std::pair<int, int> cell, const std::vector<std::pair<int, int>> &targets)
+    {
+        std::vector<float> targetCosts; /* Cost to each target. */
+        if (targets.empty())
+        {
+            return targetCosts;
+        }
+        const Raster2D<float> window = elevationRaster->readRectangleChunk(clusterGraph.clusterBounds(clusterGraph.clusterOf(cell)), 0);
+        ClusterGraph::searchWindow(window.view(), cell, targets, maxSlope, pixelSize, workspace, targetCosts);
+        return targetCosts;
+    }
+
+    /**
+     * @brief Search the cluster holding both ends of a leg of the corridor and append the cells of the leg to the route.
+     *
+     * @param from Raster (x, y) cell the leg starts at, already the last cell of the route.
+     * @param to Raster (x, y) cell the leg ends at, in the same cluster.
+     * @param route Route to extend.
+     *
+     * @throws The search found no route, which the graph said existed.
+     */
+    void HierarchicalPlanner::refineLeg(const std::pair<int, int> from, const std::pair<int, int> to, std::vector<std::pair<int, int>> &route)
+    {
+        const Raster2D<float> window = elevationRaster->readRectangleChunk(clusterGraph.clusterBounds(clusterGraph.clusterOf(from)), 0);
+        const std::vector<std::pair<int, int>> leg = clusterSearch.get_step(window.view(), window.getOrigin(), from, to, maxSlope, pixelSize);
+        ++planStats.clustersRefined;
+        planStats.cellExpansions += clusterSearch.getExpansions();
+        if (leg.empty() || leg.back() != to)
+        {
+            throw std::runtime_error("refineLeg: no route inside a cluster the graph connects");
+        }
+        route.insert(route.end(), leg.begin() + 1, leg.end());
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+/* mempa::DemHandler */
+#include "../dem-handler/DemHandler.hpp"
+
+/* mempa::ClusterGraph */
+#include "ClusterGraph.hpp"
+
+/* AStar */
+#include "../rover-pathfinding-module/AStar.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace mempa
+{
+    /**
+     * @brief Totals from building or loading the cluster graph and from the last plan.
+     */
+    struct PlanStats
+    {
+        bool graphLoaded = false;           /* Whether the graph came from its sidecar rather than being built. */
+        double graphSeconds = 0.0;          /* Time taken to load or build the graph. */
+        std::size_t abstractExpansions = 0; /* Nodes the abstract search expanded. */
+        std::size_t clustersRefined = 0;    /* Cluster searches run to turn the abstract route into cells. */
+        std::size_t cellExpansions = 0;     /* Cells those searches expanded. */
+        double planSeconds = 0.0;           /* Time taken by the last plan, abstract search and refinement. */
+    };
+
+    /**
+     * @brief Plans whole routes across a DEM with HPA*: a search over the small ClusterGraph picks the corridor, then only the clusters on it are searched cell by cell.
+     *
+     * @details The start and goal are linked to the nodes of their own clusters by a search over each of those clusters, and to each other when they share one. An A* search over the graph, with the octile distance as its bound, then picks the sequence of entrances to pass through. Each leg inside a cluster is refined with A* over that cluster alone, and each leg between clusters is a single step, so a route reads only the clusters it passes through.
+     *
+     * Routes keep to the entrances, so they can be a few percent longer than a search over the whole raster would find.
+     */
+    class HierarchicalPlanner
+    {
+    private:
+        const DemHandler *elevationRaster;       /* Handler for the DEM file containing elevation data. */
+        const float maxSlope;                    /* Maximum slope in degrees the rover can climb. */
+        const float pixelSize;                   /* Pixel size in meters, as the searches see it. */
+        ClusterGraph clusterGraph;               /* Entrances of every cluster and the costs between them. */
+        AStar clusterSearch;                     /* Refines one leg of the corridor at a time. */
+        ClusterGraph::SearchWorkspace workspace; /* Links the start and goal to their clusters' nodes. */
+        PlanStats planStats;                     /* Totals from the graph and the last plan. */
+
+        std::vector<float> linkCosts(std::pair<int, int> cell, const std::vector<std::pair<int, int>> &targets);
+        void refineLeg(std::pair<int, int> from, std::pair<int, int> to, std::vector<std::pair<int, int>> &route);
+
+    protected:
+        /* HierarchicalPlanner is not designed to be subclassed. */
+
+    public:
+        explicit HierarchicalPlanner(const DemHandler *elevationRaster, const char *demFilepath, float maxSlope, int clusterSize = ClusterGraph::DEFAULT_CLUSTER_SIZE);
+        std::vector<std::pair<int, int>> plan(std::pair<int, int> startPosition, std::pair<int, int> goalPosition);
+        inline const ClusterGraph &getGraph() const noexcept;
+        inline const PlanStats &getStats() const noexcept;
+    };
+}
+
+#include "HierarchicalPlanner.inl"
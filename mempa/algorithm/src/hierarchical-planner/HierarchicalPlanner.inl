@@ -0,0 +1,25 @@
+/* Local Header */
+#include "HierarchicalPlanner.hpp"
+
+namespace mempa
+{
+    /**
+     * @brief Get the cluster graph the planner searches.
+     *
+     * @return const ClusterGraph&
+     */
+    inline const ClusterGraph &HierarchicalPlanner::getGraph() const noexcept
+    {
+        return clusterGraph;
+    }
+
+    /**
+     * @brief Get the totals from the graph and the last plan.
+     *
+     * @return const PlanStats&
+     */
+    inline const PlanStats &HierarchicalPlanner::getStats() const noexcept
+    {
+        return planStats;
+    }
+}
@@ -114,6 +114,44 @@ namespace mempa
             case 'j': /* Toggle JSON output. */
                 makeJSON = true;
                 break;
+            case 'f': /* Toggle background chunk prefetching. */
+                prefetchChunks = true;
+                break;
+            case 'q': /* Toggle 16-bit tile storage. */
+                quantizeTiles = true;
+                break;
+            case 'n': /* Mosaic open file cap. */
+                maxOpenFiles = std::stoi(optarg);
+                if (maxOpenFiles <= 0)
+                {
+                    throw std::out_of_range("Max open files must be greater than 0.");
+                }
+                break;
+            case 'g': /* Search algorithm. */
+                searchAlgorithm = optarg;
+                if (searchAlgorithm != "dijkstra" && searchAlgorithm != "astar" && searchAlgorithm != "dstar" &&
+                    searchAlgorithm != "bidijkstra" && searchAlgorithm != "biastar" && searchAlgorithm != "deltastep" &&
+                    searchAlgorithm != "dial" && searchAlgorithm != "alt")
+                {
+                    throw std::invalid_argument("Search algorithm must be dijkstra, astar, dstar, bidijkstra, biastar, deltastep, dial or alt.");
+                }
+                break;
+            case 'c': /* Toggle hierarchical planning. */
+                hierarchicalPlanning = true;
+                break;
+            case 'l': /* Toggle the precomputed slope raster. */
+                useSlopeRaster = true;
+                break;
+            case 'k': /* Landmark count for alt. */
+                landmarkCount = std::stoi(optarg);
+                if (landmarkCount <= 0)
+                {
+                    throw std::out_of_range("Landmark count must be greater than 0.");
+                }
+                break;
+            case 't': /* Toggle contraction hierarchy planning. */
+                contractionPlanning = true;
+                break;
             case 'h': /* View help menu. */
                 print_helper();
                 throw std::runtime_error("User argument help menu requested.");
@@ -46,7 +46,7 @@ namespace mempa
      *   - `--start_area`
      *   - `--end_area`
      *
-     * - `--input`          (Path to the input DEM file)
+     * - `--input`          (Path to the input DEM file, or a directory or .mosaic manifest of DEM files)
      * - `--output`         (Path to the output file)
      * - `--memory`         (Amount of memory capacity on rover in kilobytes)
      * - `--slope`          (Max slope threshold)
@@ -74,6 +74,14 @@ namespace mempa
             {"slope", required_argument, nullptr, 'p'},
             {"radius", required_argument, nullptr, 'r'},
             {"json", no_argument, nullptr, 'j'},
+            {"prefetch", no_argument, nullptr, 'f'},
+            {"quantize", no_argument, nullptr, 'q'},
+            {"max-open-files", required_argument, nullptr, 'n'},
+            {"algorithm", required_argument, nullptr, 'g'},
+            {"hierarchical", no_argument, nullptr, 'c'},
+            {"slope-raster", no_argument, nullptr, 'l'},
+            {"landmarks", required_argument, nullptr, 'k'},
+            {"contraction", no_argument, nullptr, 't'},
             {"help", no_argument, nullptr, 'h'},
             {nullptr, 0, nullptr, 0}};
         inline static constexpr const char *shortOptions = "s:e:a:b:i:o:m:p:h"; /* Single character identifiers for getopt_long(). */
@@ -85,6 +93,22 @@ namespace mempa
 
         bool makeJSON = false; /* Flag to set whether to use a text or json output file format. */
 
+        bool prefetchChunks = false; /* Flag to set whether the simulator reads the next chunk in the background. */
+
+        bool quantizeTiles = false; /* Flag to set whether cached DEM tiles are stored as 16-bit codes. */
+
+        int maxOpenFiles = 0; /* Mosaic files kept open between reads, 0 for the DemMosaic default. */
+
+        std::string searchAlgorithm = "dijkstra"; /* Name of the SearchAlgorithm to route with. */
+
+        bool hierarchicalPlanning = false; /* Flag to set whether the whole route is planned over the DEM's cluster graph. */
+
+        bool useSlopeRaster = false; /* Flag to set whether step slopes are read from the DEM's precomputed slope raster. */
+
+        int landmarkCount = 8; /* Landmarks the alt search builds its distance tables from. */
+
+        bool contractionPlanning = false; /* Flag to set whether the whole route is planned over the DEM's contraction hierarchy. */
+
         bool isStartSet = false; /* Tracks if the starting position has been set. */
         bool isGoalSet = false;  /* Tracks if the goal position has been set. */
 
@@ -131,6 +155,14 @@ namespace mempa
         inline bool isImgCRS() const noexcept;
         inline bool isGeoCRS() const noexcept;
         inline bool getJSONFlag() const noexcept;
+        inline bool getPrefetchFlag() const noexcept;
+        inline bool getQuantizeFlag() const noexcept;
+        inline int getMaxOpenFiles() const noexcept;
+        inline std::string getSearchAlgorithm() const noexcept;
+        inline bool getHierarchicalFlag() const noexcept;
+        inline bool getSlopeRasterFlag() const noexcept;
+        inline int getLandmarkCount() const noexcept;
+        inline bool getContractionFlag() const noexcept;
         inline float getSlopeTolerance() const noexcept;
         inline int getMemorySize() const noexcept;
         inline int getBufferSize() const noexcept;
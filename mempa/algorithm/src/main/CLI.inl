@@ -87,12 +87,20 @@ namespace mempa
               --end-area       End area range (e.g., <double>,<double>:<double>,<double>)
               --start-pixel    Start pixel coordinate (e.g., <int>,<int>)
               --end-pixel      End pixel coordinate (e.g., <int>,<int>)
-              --input          Input DEM file (.tif format)
+              --input          Input DEM file (.tif format), or a directory or .mosaic manifest of them
               --output         Output results file
               --memory         Memory Size on rover (in kilobytes)
               --slope          Slope tolerances (e.g., 10,20,30)
               --radius         Visibility Radius of Rover (in meters)
               --json           Print output into JSON format
+              --prefetch       Read the next chunk in the background while planning
+              --quantize       Hold tiles and chunks as 16-bit values to halve their memory
+              --max-open-files Mosaic files to keep open at once (default 32)
+              --algorithm      Search algorithm: dijkstra (default), astar, dstar, bidijkstra, biastar, deltastep, dial or alt
+              --hierarchical   Plan the whole route over a cached cluster graph of the DEM (HPA*)
+              --slope-raster   Check slopes against a cached raster of step slopes
+              --landmarks      Landmarks for the alt search's cached distance tables (default 8)
+              --contraction    Plan the whole route over a cached contraction hierarchy of the DEM
               --help           Print help message
             )" << std::endl;
     }
@@ -116,6 +124,14 @@ namespace mempa
                   << "\nMemory Size: " << memorySize
                   << "\nSlope Tolerance: " << maxSlopeTolerance
                   << "\nRadius: " << pixelBuffer
+                  << "\nPrefetch: " << (prefetchChunks ? "on" : "off")
+                  << "\nQuantize: " << (quantizeTiles ? "on" : "off")
+                  << "\nMax Open Files: " << (maxOpenFiles > 0 ? std::to_string(maxOpenFiles) : "default")
+                  << "\nAlgorithm: " << searchAlgorithm
+                  << "\nHierarchical: " << (hierarchicalPlanning ? "on" : "off")
+                  << "\nSlope Raster: " << (useSlopeRaster ? "on" : "off")
+                  << "\nLandmarks: " << landmarkCount
+                  << "\nContraction: " << (contractionPlanning ? "on" : "off")
                   << std::endl;
     }
 
@@ -182,6 +198,91 @@ namespace mempa
         return makeJSON;
     }
 
+    /**
+     * @brief Get the chunk prefetching flag.
+     *
+     * @return true
+     * @return false
+     */
+    inline bool CLI::getPrefetchFlag() const noexcept
+    {
+        return prefetchChunks;
+    }
+
+    /**
+     * @brief Get the quantized tile storage flag.
+     *
+     * @return true
+     * @return false
+     */
+    inline bool CLI::getQuantizeFlag() const noexcept
+    {
+        return quantizeTiles;
+    }
+
+    /**
+     * @brief Get the mosaic open file cap.
+     *
+     * @return int Cap from `--max-open-files`, or 0 if not given.
+     */
+    inline int CLI::getMaxOpenFiles() const noexcept
+    {
+        return maxOpenFiles;
+    }
+
+    /**
+     * @brief Get the name of the search algorithm.
+     *
+     * @return std::string Name from `--algorithm`, "dijkstra" if not given.
+     */
+    inline std::string CLI::getSearchAlgorithm() const noexcept
+    {
+        return searchAlgorithm;
+    }
+
+    /**
+     * @brief Get the hierarchical planning flag.
+     *
+     * @return true
+     * @return false
+     */
+    inline bool CLI::getHierarchicalFlag() const noexcept
+    {
+        return hierarchicalPlanning;
+    }
+
+    /**
+     * @brief Get the precomputed slope raster flag.
+     *
+     * @return true
+     * @return false
+     */
+    inline bool CLI::getSlopeRasterFlag() const noexcept
+    {
+        return useSlopeRaster;
+    }
+
+    /**
+     * @brief Get the number of landmarks for the alt search.
+     *
+     * @return int
+     */
+    inline int CLI::getLandmarkCount() const noexcept
+    {
+        return landmarkCount;
+    }
+
+    /**
+     * @brief Get the contraction hierarchy planning flag.
+     *
+     * @return true
+     * @return false
+     */
+    inline bool CLI::getContractionFlag() const noexcept
+    {
+        return contractionPlanning;
+    }
+
     /**
      * @brief Get the max slope tolerance.
      *
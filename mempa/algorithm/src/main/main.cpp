@@ -4,11 +4,31 @@
 /* mempa::DemHandler */
 #include "../dem-handler/DemHandler.hpp"
 
+/* mempa::SlopeRaster */
+#include "../dem-handler/SlopeRaster.hpp"
+
+/* mempa::LandmarkTable */
+#include "../dem-handler/LandmarkTable.hpp"
+
+/* mempa::CoarseCostField */
+#include "../dem-handler/CoarseCostField.hpp"
+
+/* mempa::MemoryGovernor */
+#include "../memory/MemoryGovernor.hpp"
+
 /* mempa::RoverSimulator */
 #include "../rover-simulator/RoverSimulator.hpp"
 
-/* Dijkstras */
-#include "../src/rover-pathfinding-module/NewDijkstras.hpp"
+/* mempa::HierarchicalPlanner */
+#include "../hierarchical-planner/HierarchicalPlanner.hpp"
+
+/* mempa::ContractionHierarchy */
+#include "../hierarchical-planner/ContractionHierarchy.hpp"
+
+/* SearchAlgorithm */
+#include "../src/rover-pathfinding-module/SearchAlgorithm.hpp"
+#include "../src/rover-pathfinding-module/AltSearch.hpp"
+#include "../src/rover-pathfinding-module/DStarLite.hpp"
 
 /* PathLogger */
 #include "../logger/PathLogger.hpp"
@@ -19,8 +39,14 @@
 #include <nlohmann/json.hpp>
 
 /* C++ Standard Libraries */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
+#include <string>
 
 /**
  * @brief Main function to run the MEMPA project.
@@ -65,14 +91,273 @@ int main(int argc, char *argv[]) {
       throw std::runtime_error("Input CRS must be geospatial or image based.");
     }
 
+    if (commandLineInterface.getMaxOpenFiles() > 0) {
+      marsDemHandler.setMaxOpenFiles(commandLineInterface.getMaxOpenFiles());
+    }
+
+    std::unique_ptr<SearchAlgorithm> roverRoutingAlgorithm =
+        SearchAlgorithm::createAlgorithm(
+            commandLineInterface.getSearchAlgorithm()); /* --algorithm */
+
+    /* Sidecar builds read the whole DEM, so cap the caches first and give the
+     * builds the rest of the budget. */
+    std::size_t buildBytes = 0; /* Most a sidecar build may hold, 0 if unlimited. */
+    if (commandLineInterface.getMemorySize() > 0) {
+      const mempa::MemoryGovernor memoryGovernor(
+          commandLineInterface.getMemorySize());
+      const mempa::MemoryPlan buildPlan =
+          memoryGovernor.planBuild(marsDemHandler);
+      memoryGovernor.apply(buildPlan, marsDemHandler);
+      buildBytes = buildPlan.workspaceBytes;
+    }
+
+    /* Codes come from full precision elevations, so read them before tiles
+     * may be quantized. */
+    mempa::SlopeRaster slopeRaster; /* Step slopes for --slope-raster. */
+    if (commandLineInterface.getSlopeRasterFlag() &&
+        !commandLineInterface.getHierarchicalFlag()) {
+      const char *const demFilepath = commandLineInterface.getGeotiffFilepath();
+      const float pixelSize =
+          static_cast<float>(marsDemHandler.getImageResolution());
+      const std::pair<int, int> rasterSize{marsDemHandler.getXSize(),
+                                           marsDemHandler.getYSize()};
+      const auto startTime = std::chrono::steady_clock::now();
+      bool slopeRasterLoaded =
+          slopeRaster.load(demFilepath, rasterSize, pixelSize);
+      const bool slopeRasterBuilt = !slopeRasterLoaded;
+      if (!slopeRasterLoaded) {
+        try {
+          mempa::SlopeRaster::build(marsDemHandler, demFilepath, pixelSize,
+                                    buildBytes);
+          slopeRasterLoaded =
+              slopeRaster.load(demFilepath, rasterSize, pixelSize);
+        } catch (const std::exception &e) {
+          std::cerr << "Slope raster not built: " << e.what() << std::endl;
+        }
+      }
+      if (slopeRasterLoaded) {
+        std::cout << "Slope raster " << (slopeRasterBuilt ? "built" : "loaded")
+                  << " in "
+                  << std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - startTime)
+                         .count()
+                  << "s" << std::endl;
+      }
+    }
+
+    /* Landmark costs are searched over full precision elevations too. Rounded
+     * heights make some steps look a little less steep, so tables for
+     * quantized chunks allow slightly steeper steps than the search. */
+    mempa::LandmarkTable landmarkTable; /* Distance tables for --algorithm alt. */
+    if (commandLineInterface.getSearchAlgorithm() == "alt" &&
+        !commandLineInterface.getHierarchicalFlag()) {
+      const char *const demFilepath = commandLineInterface.getGeotiffFilepath();
+      const int landmarkCount = commandLineInterface.getLandmarkCount();
+      const float maxSlope =
+          commandLineInterface.getQuantizeFlag()
+              ? std::min(89.0f, commandLineInterface.getSlopeTolerance() +
+                                    AltSearch::QUANTIZED_SLOPE_MARGIN)
+              : commandLineInterface.getSlopeTolerance();
+      const float pixelSize =
+          static_cast<float>(marsDemHandler.getImageResolution());
+      const std::pair<int, int> rasterSize{marsDemHandler.getXSize(),
+                                           marsDemHandler.getYSize()};
+      const auto startTime = std::chrono::steady_clock::now();
+      bool landmarksLoaded = landmarkTable.load(
+          demFilepath, rasterSize, landmarkCount, maxSlope, pixelSize);
+      const bool landmarksBuilt = !landmarksLoaded;
+      if (!landmarksLoaded) {
+        try {
+          mempa::LandmarkTable::build(marsDemHandler, demFilepath,
+                                      landmarkCount, maxSlope, pixelSize,
+                                      buildBytes);
+          landmarksLoaded = landmarkTable.load(demFilepath, rasterSize,
+                                               landmarkCount, maxSlope,
+                                               pixelSize);
+        } catch (const std::exception &e) {
+          std::cerr << "Landmark tables not built: " << e.what() << std::endl;
+        }
+      }
+      if (landmarksLoaded) {
+        std::cout << "Landmark tables "
+                  << (landmarksBuilt ? "built" : "loaded") << " in "
+                  << std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - startTime)
+                         .count()
+                  << "s: " << landmarkTable.getLandmarkCount()
+                  << " landmarks" << std::endl;
+      }
+    }
+
+    /* D* Lite estimates costs beyond its chunk from the coarsest search that
+     * fits, so leaving a chunk does not undo the plan behind it. */
+    mempa::CoarseCostField costField; /* Costs to go for --algorithm dstar. */
+    if (commandLineInterface.getSearchAlgorithm() == "dstar" &&
+        !commandLineInterface.getHierarchicalFlag() &&
+        !commandLineInterface.getContractionFlag()) {
+      const int level = mempa::CoarseCostField::levelFor(marsDemHandler,
+                                                         buildBytes);
+      const auto startTime = std::chrono::steady_clock::now();
+      try {
+        if (level < 0) {
+          throw std::invalid_argument("no pyramid level fits");
+        }
+        costField.build(marsDemHandler, imgGoalCoordinates,
+                        commandLineInterface.getSlopeTolerance(), level);
+        std::cout << "Cost field built in "
+                  << std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - startTime)
+                         .count()
+                  << "s: level " << costField.getLevel() << std::endl;
+      } catch (const std::exception &e) {
+        std::cerr << "Cost field not built: " << e.what() << std::endl;
+      }
+    }
+
+    marsDemHandler.setQuantizedStorage(commandLineInterface.getQuantizeFlag());
+    if (!landmarkTable.empty()) {
+      static_cast<AltSearch *>(roverRoutingAlgorithm.get())
+          ->set_landmarks(&landmarkTable);
+    }
+    if (!costField.empty()) {
+      static_cast<DStarLite *>(roverRoutingAlgorithm.get())
+          ->set_cost_field(&costField);
+    }
+
+    /* Fit the chunk size and caches to the rover's memory budget. */
+    int bufferSize = commandLineInterface.getBufferSize(); /* Chunk buffer to run with. */
+    bool prefetchChunks = commandLineInterface.getPrefetchFlag(); /* Prefetch setting to run with. */
+    if (commandLineInterface.getMemorySize() > 0) {
+      const mempa::MemoryGovernor memoryGovernor(
+          commandLineInterface.getMemorySize());
+      const mempa::MemoryPlan memoryPlan = memoryGovernor.plan(
+          marsDemHandler, bufferSize,
+          roverRoutingAlgorithm->workspaceBytesPerCell(),
+          roverRoutingAlgorithm->precomputedBytesPerCell(),
+          slopeRaster.empty() ? 0 : mempa::SlopeRaster::maskBytesPerCell(),
+          prefetchChunks, costField.getBytes());
+      memoryGovernor.apply(memoryPlan, marsDemHandler);
+      if (memoryPlan.reduced) {
+        std::cout << "Memory budget of " << memoryPlan.budgetBytes
+                  << " bytes: radius " << bufferSize << " reduced to "
+                  << memoryPlan.buffer
+                  << (prefetchChunks && !memoryPlan.prefetch
+                          ? ", prefetching disabled"
+                          : "")
+                  << (!memoryPlan.precompute ? ", slope precompute disabled"
+                                             : "")
+                  << std::endl;
+      }
+      if (!memoryPlan.precompute) {
+        roverRoutingAlgorithm->dropPrecomputed();
+      }
+      bufferSize = memoryPlan.buffer;
+      prefetchChunks = memoryPlan.prefetch;
+    }
+
     mempa::RoverSimulator marsSimulator(&marsDemHandler, imgStartCoordinates,
                                         imgGoalCoordinates);
+    marsSimulator.setPrefetching(prefetchChunks);
+    if (!slopeRaster.empty()) {
+      marsSimulator.setSlopeRaster(&slopeRaster);
+    }
 
-    /* TODO: Change this out for D* Lite Algorithm! */
-    NewDijkstras roverRoutingAlgorithm; /* Dijkstra's Algorithm */
-    std::vector<std::pair<int, int>> routedPath = marsSimulator.runSimulator(
-        &roverRoutingAlgorithm, commandLineInterface.getSlopeTolerance(),
-        commandLineInterface.getBufferSize());
+    const bool hierarchicalPlanning =
+        commandLineInterface.getHierarchicalFlag(); /* --hierarchical */
+    mempa::ContractionHierarchy contractionHierarchy; /* Hierarchy for --contraction, empty without it. */
+    if (!hierarchicalPlanning && commandLineInterface.getContractionFlag()) {
+      const char *const demFilepath = commandLineInterface.getGeotiffFilepath();
+      const float maxSlope = commandLineInterface.getSlopeTolerance();
+      const float pixelSize =
+          static_cast<float>(marsDemHandler.getImageResolution());
+      const std::pair<int, int> rasterSize{marsDemHandler.getXSize(),
+                                           marsDemHandler.getYSize()};
+      const auto startTime = std::chrono::steady_clock::now();
+      /* A sidecar built around other ends may not reach these. */
+      const bool contractionLoaded =
+          contractionHierarchy.load(demFilepath, rasterSize, maxSlope,
+                                    pixelSize) &&
+          contractionHierarchy.covers(imgStartCoordinates) &&
+          contractionHierarchy.covers(imgGoalCoordinates);
+      if (!contractionLoaded) {
+        try {
+          contractionHierarchy.build(
+              marsDemHandler,
+              mempa::ContractionHierarchy::regionFor(
+                  rasterSize, imgStartCoordinates, imgGoalCoordinates,
+                  buildBytes),
+              maxSlope, pixelSize, buildBytes);
+        } catch (const std::invalid_argument &e) {
+          /* Asked for by name, so never fall back to chunked searches. */
+          throw std::runtime_error(
+              std::string("Contraction hierarchy not built: ") + e.what());
+        }
+        if (!contractionHierarchy.empty()) {
+          try {
+            contractionHierarchy.save(demFilepath);
+          } catch (const std::runtime_error &e) {
+            /* The sidecar is only a cache. */
+            std::cerr << "Contraction hierarchy not cached: " << e.what()
+                      << std::endl;
+          }
+        }
+      }
+      if (!contractionHierarchy.empty()) {
+        std::cout << "Contraction hierarchy "
+                  << (contractionLoaded ? "loaded" : "built") << " in "
+                  << std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - startTime)
+                         .count()
+                  << "s: " << contractionHierarchy.getXSize() << "x"
+                  << contractionHierarchy.getYSize() << " pixels, "
+                  << contractionHierarchy.getArcCount() << " arcs, "
+                  << contractionHierarchy.getShortcutCount() << " shortcuts, "
+                  << contractionHierarchy.getRoundCount() << " rounds, "
+                  << contractionHierarchy.getCoreCount() << " core nodes"
+                  << std::endl;
+      }
+    }
+    const bool contractionPlanning =
+        !contractionHierarchy.empty(); /* --contraction */
+    std::vector<std::pair<int, int>> routedPath;
+    if (hierarchicalPlanning) {
+      /* Pick the corridor over the cluster graph, then search only the
+       * clusters on it. */
+      mempa::HierarchicalPlanner hierarchicalPlanner(
+          &marsDemHandler, commandLineInterface.getGeotiffFilepath(),
+          commandLineInterface.getSlopeTolerance());
+      routedPath =
+          hierarchicalPlanner.plan(imgStartCoordinates, imgGoalCoordinates);
+      const mempa::PlanStats &planStats = hierarchicalPlanner.getStats();
+      const mempa::ClusterGraph &clusterGraph = hierarchicalPlanner.getGraph();
+      std::cout << "Cluster graph "
+                << (planStats.graphLoaded ? "loaded" : "built") << " in " << planStats.graphSeconds << "s: "
+                << clusterGraph.getClusterCount() << " clusters, "
+                << clusterGraph.getNodeCount() << " nodes, "
+                << clusterGraph.getEdgeCount() << " edges" << std::endl;
+      std::cout << "Hierarchical plan in " << planStats.planSeconds << "s: "
+                << planStats.abstractExpansions << " nodes expanded, "
+                << planStats.clustersRefined << " clusters refined, "
+                << planStats.cellExpansions << " cells expanded" << std::endl;
+    } else if (contractionPlanning) {
+      /* Route between the ends over the hierarchy, then unpack the
+       * shortcuts back into pixels. */
+      mempa::ContractionHierarchy::QueryWorkspace queryWorkspace;
+      const auto startTime = std::chrono::steady_clock::now();
+      routedPath = contractionHierarchy.route(
+          imgStartCoordinates, imgGoalCoordinates, queryWorkspace);
+      std::cout << "Contraction query in "
+                << std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - startTime)
+                       .count()
+                << "s: " << queryWorkspace.stats.settledNodes
+                << " nodes settled, " << queryWorkspace.stats.stalledNodes
+                << " stalled" << std::endl;
+    } else {
+      routedPath = marsSimulator.runSimulator(
+          roverRoutingAlgorithm.get(), commandLineInterface.getSlopeTolerance(),
+          bufferSize);
+    }
 
     // Calculate metrics WITH elevation data using the DEM handler
     Metrics metrics;
@@ -83,6 +368,62 @@ int main(int argc, char *argv[]) {
     
     // Use analyzePath instead of analizePath to include elevation data
     metrics.analyzePath(routedPath, &marsDemHandler);
+    const bool searchedOnline =
+        !hierarchicalPlanning &&
+        !contractionPlanning; /* Whether the simulator searched chunk by chunk. */
+    if (searchedOnline) {
+      std::cout << "Search expansions: "
+                << marsSimulator.getSearchExpansions() << std::endl;
+    }
+    std::cout << "Tile cache hits: " << marsDemHandler.getCacheHits()
+              << ", misses: " << marsDemHandler.getCacheMisses() << std::endl;
+    if (searchedOnline && prefetchChunks) {
+      const mempa::PrefetchStats &prefetchStats =
+          marsSimulator.getPrefetchStats();
+      std::cout << "Prefetch hits: " << prefetchStats.hits << " of "
+                << prefetchStats.requests << " chunk requests ("
+                << prefetchStats.prefetches << " prefetched), I/O hidden: "
+                << prefetchStats.hiddenSeconds << "s of "
+                << prefetchStats.readSeconds << "s" << std::endl;
+    }
+    if (searchedOnline && !prefetchChunks) {
+      const mempa::SlidingStats &slidingStats = marsSimulator.getSlidingStats();
+      std::cout << "Sliding chunk read " << slidingStats.cellsRead << " of "
+                << slidingStats.cellsServed << " cells over "
+                << slidingStats.requests << " chunk requests ("
+                << slidingStats.fullReads << " full reads)" << std::endl;
+    }
+    if (const mempa::DemMosaic *mosaic = marsDemHandler.getMosaic()) {
+      std::cout << "Mosaic of " << mosaic->getFileCount()
+                << " files: " << mosaic->getFileOpens() << " opens, at most "
+                << mosaic->getPeakOpenFiles() << " open at once (cap "
+                << mosaic->getMaxOpenFiles() << ")" << std::endl;
+    }
+    if (marsDemHandler.isQuantizedStorage()) {
+      /* Both ends of a step can be off by the error, so the rise can be off
+       * by twice it over one pixel of run. Chunk codes are made from decoded
+       * tile values, so their error adds to the tile's. */
+      constexpr double MAX_QUANTIZED_SLOPE_ERROR =
+          0.5; /* Degrees, the step of the slope raster's codes. */
+      const double quantizationError = marsDemHandler.getMaxQuantizationError() +
+                                       marsDemHandler.getMaxChunkError();
+      const double slopeError =
+          std::atan(2.0 * quantizationError /
+                    marsDemHandler.getImageResolution()) *
+          180.0 / M_PI;
+      std::cout << std::defaultfloat
+                << "Max quantization error: " << quantizationError
+                << " m, worst case slope error: " << slopeError << " degrees"
+                << std::endl;
+      if (slopeError > MAX_QUANTIZED_SLOPE_ERROR) {
+        std::cerr << "WARNING: --quantize may have changed slope decisions by "
+                     "up to "
+                  << slopeError << " degrees, more than "
+                  << MAX_QUANTIZED_SLOPE_ERROR
+                  << ". Run without --quantize to plan on exact slopes."
+                  << std::endl;
+      }
+    }
 
     std::unique_ptr<PathLogger> roverPathLogger =
         PathLogger::createLogger(commandLineInterface.getJSONFlag());
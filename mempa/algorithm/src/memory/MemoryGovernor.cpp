@@ -0,0 +1,177 @@
+/* Local Header */
+#include "MemoryGovernor.hpp"
+
+/* libgdal-dev */
+#include <gdal_priv.h>
+
+/* C++ Standard Libraries */
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace mempa
+{
+    /**
+     * @brief Construct a new MemoryGovernor.
+     *
+     * @param memoryKilobytes Budget from `--memory`, in kilobytes.
+     *
+     * @throws The budget is not positive.
+     */
+    MemoryGovernor::MemoryGovernor(const int memoryKilobytes)
+        : budgetBytes(memoryKilobytes > 0 ? static_cast<std::size_t>(memoryKilobytes) * BYTES_PER_KILOBYTE : 0)
+    {
+        if (budgetBytes == 0)
+        {
+            throw std::invalid_argument("MemoryGovernor: memory budget must be greater than 0");
+        }
+    }
+
+    /**
+     * @brief Split the budget for a run, scaling the request back if it does not fit.
+     *
+     * @param elevationRaster Handler whose tile size sets the smallest usable tile cache and whose storage mode sets the bytes per chunk cell.
+     * @param requestedBuffer Chunk buffer the user asked for.
+     * @param bytesPerCell Search workspace per chunk cell, from SearchAlgorithm::workspaceBytesPerCell().
+     * @param precomputedBytesPerCell Part of bytesPerCell the search can do without, from SearchAlgorithm::precomputedBytesPerCell().
+     * @param maskBytesPerCell Traversability mask per chunk cell the simulator hands the search, such as SlopeRaster::maskBytesPerCell(), or 0 for none. The search then precomputes nothing.
+     * @param prefetch Whether the user asked for chunk prefetching.
+     * @param reservedBytes Bytes already held for the whole run, such as a loaded sidecar, left out of the split.
+     *
+     * @return MemoryPlan The split to run with.
+     *
+     * @throws The budget cannot fit even a one pixel buffer.
+     */
+    MemoryPlan MemoryGovernor::plan(const DemHandler &elevationRaster, const int requestedBuffer, std::size_t bytesPerCell, std::size_t precomputedBytesPerCell, const std::size_t maskBytesPerCell, const bool prefetch, const std::size_t reservedBytes) const
+    {
+        if (maskBytesPerCell > 0)
+        {
+            bytesPerCell = bytesPerCell - precomputedBytesPerCell + maskBytesPerCell;
+            precomputedBytesPerCell = 0;
+        }
+
+        /* Prepared DEMs are served from the page cache and never touch the tile cache or GDAL. */
+        const std::size_t minimumCacheBytes = elevationRaster.isPrepared() ? 0 : elevationRaster.getTileBytes(); /* Room for the tile being copied from. */
+        if (budgetBytes <= reservedBytes || budgetBytes - reservedBytes <= minimumCacheBytes)
+        {
+            throw std::runtime_error("MemoryGovernor: memory budget is smaller than one raster tile");
+        }
+        const std::size_t runBytes = budgetBytes - reservedBytes;        /* Budget left to split. */
+        const std::size_t workspaceLimit = runBytes - minimumCacheBytes; /* Most the workspace may take. */
+
+        const std::size_t elevationBytes = elevationRaster.isQuantizedStorage() ? sizeof(std::int16_t) : sizeof(float); /* Bytes per chunk cell. */
+
+        MemoryPlan memoryPlan;
+        memoryPlan.budgetBytes = budgetBytes;
+        memoryPlan.buffer = requestedBuffer;
+        memoryPlan.prefetch = prefetch;
+
+        if (workspaceBytesFor(memoryPlan.buffer, bytesPerCell, elevationBytes, memoryPlan.prefetch) > workspaceLimit && memoryPlan.prefetch)
+        {
+            memoryPlan.prefetch = false;
+            memoryPlan.reduced = true;
+        }
+        if (workspaceBytesFor(memoryPlan.buffer, bytesPerCell, elevationBytes, memoryPlan.prefetch) > workspaceLimit && precomputedBytesPerCell > 0)
+        {
+            bytesPerCell -= precomputedBytesPerCell;
+            memoryPlan.precompute = false;
+            memoryPlan.reduced = true;
+        }
+        if (workspaceBytesFor(memoryPlan.buffer, bytesPerCell, elevationBytes, memoryPlan.prefetch) > workspaceLimit)
+        {
+            /* Largest buffer whose (2 * buffer + 1)^2 cells fit, then step down past rounding. */
+            const double cellsThatFit = static_cast<double>(workspaceLimit) / static_cast<double>(bytesPerCell + elevationBytes);
+            memoryPlan.buffer = static_cast<int>((std::sqrt(cellsThatFit) - 1.0) / 2.0);
+            while (memoryPlan.buffer > 0 && workspaceBytesFor(memoryPlan.buffer, bytesPerCell, elevationBytes, false) > workspaceLimit)
+            {
+                --memoryPlan.buffer;
+            }
+            memoryPlan.reduced = true;
+        }
+        if (memoryPlan.buffer < 1)
+        {
+            throw std::runtime_error("MemoryGovernor: memory budget is too small for any chunk");
+        }
+
+        memoryPlan.workspaceBytes = workspaceBytesFor(memoryPlan.buffer, bytesPerCell, elevationBytes, memoryPlan.prefetch);
+        if (!elevationRaster.isPrepared())
+        {
+            const std::size_t cacheBytes = runBytes - memoryPlan.workspaceBytes; /* Everything the workspace leaves over. */
+            memoryPlan.gdalCacheBytes = cacheBytes * GDAL_CACHE_SHARE / (TILE_CACHE_SHARE + GDAL_CACHE_SHARE);
+            memoryPlan.tileCacheBytes = cacheBytes - memoryPlan.gdalCacheBytes;
+        }
+        return memoryPlan;
+    }
+
+    /**
+     * @brief Split the budget for an offline build over the whole DEM, such as a sidecar's, which holds no chunk.
+     *
+     * @details The caches get only the smallest usable share, since a build reads each tile once, and the workspace gets the rest.
+     *
+     * @param elevationRaster Handler whose tile size sets the smallest usable tile cache.
+     *
+     * @return MemoryPlan The split to build with. Its buffer is 0, as no chunk is planned on.
+     *
+     * @throws The budget cannot fit the smallest caches.
+     */
+    MemoryPlan MemoryGovernor::planBuild(const DemHandler &elevationRaster) const
+    {
+        MemoryPlan memoryPlan;
+        memoryPlan.budgetBytes = budgetBytes;
+        if (!elevationRaster.isPrepared())
+        {
+            memoryPlan.tileCacheBytes = elevationRaster.getTileBytes();
+            memoryPlan.gdalCacheBytes = memoryPlan.tileCacheBytes * GDAL_CACHE_SHARE / TILE_CACHE_SHARE;
+        }
+        if (budgetBytes <= memoryPlan.tileCacheBytes + memoryPlan.gdalCacheBytes)
+        {
+            throw std::runtime_error("MemoryGovernor: memory budget is smaller than one raster tile");
+        }
+        memoryPlan.workspaceBytes = budgetBytes - memoryPlan.tileCacheBytes - memoryPlan.gdalCacheBytes;
+        return memoryPlan;
+    }
+
+    /**
+     * @brief Size the GDAL block cache and the tile cache to a plan.
+     *
+     * @param memoryPlan Plan from @ref plan.
+     * @param elevationRaster Handler whose tile cache is resized.
+     */
+    void MemoryGovernor::apply(const MemoryPlan &memoryPlan, const DemHandler &elevationRaster) const
+    {
+        if (elevationRaster.isPrepared())
+        {
+            return;
+        }
+        GDALSetCacheMax64(static_cast<GIntBig>(memoryPlan.gdalCacheBytes));
+        elevationRaster.setTileCacheCapacity(memoryPlan.tileCacheBytes);
+    }
+
+    /**
+     * @brief Number of cells in a square chunk.
+     *
+     * @param buffer Chunk buffer.
+     * @return std::size_t (2 * buffer + 1)^2
+     */
+    std::size_t MemoryGovernor::chunkCells(const int buffer) noexcept
+    {
+        const std::size_t side = 2 * static_cast<std::size_t>(buffer) + 1; /* Width and height of the chunk. */
+        return side * side;
+    }
+
+    /**
+     * @brief Bytes held while planning on one chunk.
+     *
+     * @param buffer Chunk buffer.
+     * @param bytesPerCell Search workspace per chunk cell.
+     * @param elevationBytes Bytes of one chunk cell's elevation, 2 for codes and 4 for floats.
+     * @param prefetch Whether a second chunk is read ahead at the same time.
+     * @return std::size_t Chunk elevations plus search workspace.
+     */
+    std::size_t MemoryGovernor::workspaceBytesFor(const int buffer, const std::size_t bytesPerCell, const std::size_t elevationBytes, const bool prefetch) noexcept
+    {
+        const std::size_t chunksInFlight = prefetch ? 2 : 1; /* The chunk planned on, plus one read ahead. */
+        return chunkCells(buffer) * (bytesPerCell + chunksInFlight * elevationBytes);
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+/* mempa::DemHandler */
+#include "../dem-handler/DemHandler.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+
+namespace mempa
+{
+    /**
+     * @brief How a memory budget is split across the pipeline for one run.
+     */
+    struct MemoryPlan
+    {
+        std::size_t budgetBytes = 0;    /* Total budget the plan was made for. */
+        std::size_t workspaceBytes = 0; /* Chunks in flight plus the search workspace over them. */
+        std::size_t tileCacheBytes = 0; /* Capacity of the DemHandler tile cache. */
+        std::size_t gdalCacheBytes = 0; /* Capacity of the GDAL block cache. */
+        int buffer = 0;                 /* Chunk buffer to run with, no larger than requested. */
+        bool prefetch = false;          /* Whether chunk prefetching still fits. */
+        bool precompute = true;         /* Whether the search's precomputed per-cell state still fits. */
+        bool reduced = false;           /* Whether the request had to be scaled back to fit. */
+    };
+
+    /**
+     * @brief Splits the `--memory` budget between the GDAL block cache, the DemHandler tile cache and the search workspace.
+     *
+     * @details The workspace is sized first, because a chunk and its search state must fit for the rover to move at all. A chunk takes 2 bytes per cell when the DEM is read with quantized storage, since the search decodes its codes in place, and 4 otherwise. What is left goes to the caches, mostly to the tile cache since every read goes through it. When the requested buffer does not fit next to the smallest usable tile cache, prefetching is dropped first (it doubles the chunks in flight), then whatever the search precomputes per cell, and only then is the buffer shrunk. A traversability mask handed to the search, such as a slope raster's, takes the place of the search's precomputed state and cannot be dropped.
+     *
+     * @note The budget covers the data the pipeline allocates per run, not the program image or GDAL's own fixed overhead.
+     */
+    class MemoryGovernor
+    {
+    private:
+        inline static constexpr std::size_t BYTES_PER_KILOBYTE = 1024; /* `--memory` is given in kilobytes. */
+        inline static constexpr int TILE_CACHE_SHARE = 3;              /* Parts of the cache budget given to the tile cache. */
+        inline static constexpr int GDAL_CACHE_SHARE = 1;              /* Parts of the cache budget given to the GDAL block cache. */
+        const std::size_t budgetBytes;                                 /* Total budget in bytes. */
+
+        static std::size_t chunkCells(int buffer) noexcept;
+        static std::size_t workspaceBytesFor(int buffer, std::size_t bytesPerCell, std::size_t elevationBytes, bool prefetch) noexcept;
+
+    protected:
+        /* MemoryGovernor is not designed to be subclassed. */
+
+    public:
+        explicit MemoryGovernor(int memoryKilobytes);
+        MemoryPlan plan(const DemHandler &elevationRaster, int requestedBuffer, std::size_t bytesPerCell, std::size_t precomputedBytesPerCell, std::size_t maskBytesPerCell, bool prefetch, std::size_t reservedBytes) const;
+        MemoryPlan planBuild(const DemHandler &elevationRaster) const;
+        void apply(const MemoryPlan &memoryPlan, const DemHandler &elevationRaster) const;
+        inline std::size_t getBudgetBytes() const noexcept;
+    };
+}
+
+#include "MemoryGovernor.inl"
@@ -0,0 +1,15 @@
+/* Local Header */
+#include "MemoryGovernor.hpp"
+
+namespace mempa
+{
+    /**
+     * @brief Get the total budget in bytes.
+     *
+     * @return std::size_t
+     */
+    inline std::size_t MemoryGovernor::getBudgetBytes() const noexcept
+    {
+        return budgetBytes;
+    }
+}
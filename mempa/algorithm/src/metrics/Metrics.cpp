@@ -5,6 +5,27 @@
 #include <iostream>
 #include <math.h>
 
+/**
+ * @brief Sample the elevation of every point on a path in one batched read
+ *
+ * @param path The sequence of coordinates representing the path
+ * @param demHandler Pointer to the DEM handler that provides elevation data
+ * @param elevations Output, one elevation per path point
+ * @return true if the elevations were read, false if the DEM read failed
+ */
+static bool sampleElevations(const std::vector<std::pair<int, int>> &path,
+                             const mempa::DemHandler *demHandler,
+                             std::vector<float> &elevations) {
+  try {
+    demHandler->getValues(path, elevations);
+  } catch (const std::exception &e) {
+    std::cerr << "Error getting elevations along path: " << e.what()
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
 /**
  * @brief Reset all metric values to their default values
  * 
@@ -86,36 +107,36 @@ void Metrics::calculateTotalDistance(
   bool hasElevationData = false;
   float firstElev = 0.0f;
 
-  try {
-    // Sample a few points along the path
-    for (int i = 0; i < std::min(5, static_cast<int>(path.size())); i++) {
-      int idx = i * path.size() / 5; // spaced out indices
-      float elev = demHandler->getValue(path[idx].first, path[idx].second);
-      std::cout << "Sample elevation at point " << idx << " ("
-                << path[idx].first << ", " << path[idx].second
-                << "): " << std::fixed << std::setprecision(2) << elev
-                << std::endl;
+  std::vector<float> elevations;
+  if (!sampleElevations(path, demHandler, elevations)) {
+    this->totalDistance = this->horizontalDistance;
+    return;
+  }
 
-      if (i == 0) {
-        firstElev = elev;
-      } else if (std::abs(elev - firstElev) > 0.01) {
-        // If we find at least one elevation that differs from the first, we
-        // have variable terrain
-        hasElevationData = true;
-      }
-    }
+  // Sample a few points along the path
+  for (int i = 0; i < std::min(5, static_cast<int>(path.size())); i++) {
+    int idx = i * path.size() / 5; // spaced out indices
+    float elev = elevations[idx];
+    std::cout << "Sample elevation at point " << idx << " ("
+              << path[idx].first << ", " << path[idx].second
+              << "): " << std::fixed << std::setprecision(2) << elev
+              << std::endl;
 
-    if (!hasElevationData) {
-      std::cout
-          << "WARNING: All sampled elevations are identical or very similar!"
-          << std::endl;
-      std::cout << "This may indicate a flat DEM or issue with elevation data."
-                << std::endl;
+    if (i == 0) {
+      firstElev = elev;
+    } else if (std::abs(elev - firstElev) > 0.01) {
+      // If we find at least one elevation that differs from the first, we
+      // have variable terrain
+      hasElevationData = true;
     }
-  } catch (const std::exception &e) {
-    std::cerr << "Error accessing sample DEM data: " << e.what() << std::endl;
-    this->totalDistance = this->horizontalDistance;
-    return;
+  }
+
+  if (!hasElevationData) {
+    std::cout
+        << "WARNING: All sampled elevations are identical or very similar!"
+        << std::endl;
+    std::cout << "This may indicate a flat DEM or issue with elevation data."
+              << std::endl;
   }
 
   // Now calculate the total 3D distance
@@ -128,19 +149,8 @@ void Metrics::calculateTotalDistance(
                                      std::pow(after.second - before.second, 2));
 
     // Get elevation data
-    float elevBefore = 0.0f;
-    float elevAfter = 0.0f;
-
-    try {
-      elevBefore = demHandler->getValue(before.first, before.second);
-      elevAfter = demHandler->getValue(after.first, after.second);
-    } catch (const std::exception &e) {
-      std::cerr << "Error getting elevation at segment " << i << ": "
-                << e.what() << std::endl;
-      // Fall back to horizontal distance for this segment
-      this->totalDistance += horizontalDist;
-      continue;
-    }
+    float elevBefore = elevations[i - 1];
+    float elevAfter = elevations[i];
 
     // Debug output for a few points to verify calculations
     if (i < 3 || i > path.size() - 3) { // First and last few points
@@ -189,32 +199,24 @@ void Metrics::calculateTotalElevationChange(
     const mempa::DemHandler *demHandler) {
   this->totalElevationChange = 0.0;
 
-  if (!demHandler || path.size() < 2) {
+  std::vector<float> elevations;
+  if (!demHandler || path.size() < 2 ||
+      !sampleElevations(path, demHandler, elevations)) {
     return;
   }
 
   for (size_t i = 1; i < path.size(); i++) {
-    std::pair<int, int> before = path[i - 1];
-    std::pair<int, int> after = path[i];
-
-    float elevBefore = 0.0f;
-    float elevAfter = 0.0f;
+    float elevBefore = elevations[i - 1];
+    float elevAfter = elevations[i];
 
-    try {
-      elevBefore = demHandler->getValue(before.first, before.second);
-      elevAfter = demHandler->getValue(after.first, after.second);
-
-      // Add absolute elevation change for this segment
-      float change = std::abs(elevAfter - elevBefore);
-      this->totalElevationChange += change;
+    // Add absolute elevation change for this segment
+    float change = std::abs(elevAfter - elevBefore);
+    this->totalElevationChange += change;
 
-      // Debug output for significant changes
-      if (change > 1.0) {
-        std::cout << "Significant elevation change at segment " << i << ": "
-                  << change << " units" << std::endl;
-      }
-    } catch (const std::exception &e) {
-      continue; // Skip segments with invalid elevation data
+    // Debug output for significant changes
+    if (change > 1.0) {
+      std::cout << "Significant elevation change at segment " << i << ": "
+                << change << " units" << std::endl;
     }
   }
 
@@ -247,8 +249,10 @@ void Metrics::calculateNetElevationChange(
   float endElev = 0.0f;
 
   try {
-    startElev = demHandler->getValue(startPoint.first, startPoint.second);
-    endElev = demHandler->getValue(endPoint.first, endPoint.second);
+    std::vector<float> endpointElevations;
+    demHandler->getValues({startPoint, endPoint}, endpointElevations);
+    startElev = endpointElevations[0];
+    endElev = endpointElevations[1];
     this->netElevationChange = endElev - startElev;
 
     std::cout << "Net elevation change (end-start): " << endElev << " - "
@@ -273,7 +277,9 @@ void Metrics::calculateMaxSlope(const std::vector<std::pair<int, int>> &path,
   const mempa::DemHandler *demHandler) {
 this->maxSlope = 0.0;
 
-if (!demHandler || path.size() < 2) {
+std::vector<float> elevations;
+if (!demHandler || path.size() < 2 ||
+    !sampleElevations(path, demHandler, elevations)) {
 return;
 }
 
@@ -292,9 +298,8 @@ if (horizontalDist < 0.001) {
 continue;
 }
 
-try {
-float elevBefore = demHandler->getValue(before.first, before.second);
-float elevAfter = demHandler->getValue(after.first, after.second);
+float elevBefore = elevations[i - 1];
+float elevAfter = elevations[i];
 float elevDiff = std::abs(elevAfter - elevBefore);
 
 // Calculate run based on whether the step is diagonal or cardinal
@@ -317,9 +322,6 @@ std::cout << "New max slope at segment " << i << ": " << segmentSlope
 << " degrees (elev diff: " << elevDiff
 << ", run: " << run << ")" << std::endl;
 }
-} catch (const std::exception &e) {
-continue;
-}
 }
 
 std::cout << "Maximum slope along path: " << this->maxSlope << " degrees"
@@ -340,7 +342,9 @@ void Metrics::calculateAverageSlope(
   const mempa::DemHandler *demHandler) {
 this->averageSlope = 0.0;
 
-if (!demHandler || path.size() < 2) {
+std::vector<float> elevations;
+if (!demHandler || path.size() < 2 ||
+    !sampleElevations(path, demHandler, elevations)) {
   return;
 }
 
@@ -355,39 +359,32 @@ for (size_t i = 1; i < path.size(); i++) {
   std::pair<int, int> after = path[i];
 
   // Get elevation data
-  float elevBefore = 0.0f;
-  float elevAfter = 0.0f;
-
-  try {
-    elevBefore = demHandler->getValue(before.first, before.second);
-    elevAfter = demHandler->getValue(after.first, after.second);
-
-    float elevDiff = std::abs(elevAfter - elevBefore);
-
-    // Determine if this is a cardinal or diagonal move
-    bool isDiagonal = (before.first != after.first && before.second != after.second);
-    
-    // Calculate the actual physical distance (run)
-    float run;
-    if (isDiagonal) {
-      // Diagonal moves are √2 times longer
-      run = std::sqrt(2.0f) * pixelSize;
-    } else {
-      // Cardinal moves (horizontal/vertical)
-      run = pixelSize;
-    }
+  float elevBefore = elevations[i - 1];
+  float elevAfter = elevations[i];
+
+  float elevDiff = std::abs(elevAfter - elevBefore);
+
+  // Determine if this is a cardinal or diagonal move
+  bool isDiagonal = (before.first != after.first && before.second != after.second);
+  
+  // Calculate the actual physical distance (run)
+  float run;
+  if (isDiagonal) {
+    // Diagonal moves are √2 times longer
+    run = std::sqrt(2.0f) * pixelSize;
+  } else {
+    // Cardinal moves (horizontal/vertical)
+    run = pixelSize;
+  }
 
-    // Rise is the elevation difference in meters
-    float rise = elevDiff;
-    
-    // Calculate slope in degrees - use the same formula as pathfinding
-    float segmentSlope = std::atan(rise / run) * (180.0f / M_PI);
+  // Rise is the elevation difference in meters
+  float rise = elevDiff;
+  
+  // Calculate slope in degrees - use the same formula as pathfinding
+  float segmentSlope = std::atan(rise / run) * (180.0f / M_PI);
 
-    totalSlope += segmentSlope;
-    validSegments++;
-  } catch (const std::exception &e) {
-    continue;
-  }
+  totalSlope += segmentSlope;
+  validSegments++;
 }
 
 // Calculate average if we have valid segments
@@ -413,32 +410,21 @@ void Metrics::calculateElevationGain(
     const mempa::DemHandler *demHandler) {
   this->elevationGain = 0.0;
 
-  if (!demHandler || path.size() < 2) {
+  std::vector<float> elevations;
+  if (!demHandler || path.size() < 2 ||
+      !sampleElevations(path, demHandler, elevations)) {
     return;
   }
 
-  float totalSlope = 0.0;
-  int validSegments = 0;
-
   for (size_t i = 1; i < path.size(); i++) {
-    std::pair<int, int> before = path[i - 1];
-    std::pair<int, int> after = path[i];
-
     // Get elevation data
-    float elevBefore = 0.0f;
-    float elevAfter = 0.0f;
-
-    try {
-      elevBefore = demHandler->getValue(before.first, before.second);
-      elevAfter = demHandler->getValue(after.first, after.second);
+    float elevBefore = elevations[i - 1];
+    float elevAfter = elevations[i];
 
-      float elevDiff = elevAfter - elevBefore;
+    float elevDiff = elevAfter - elevBefore;
 
-      if (elevDiff > 0) {
-        this->elevationGain += elevDiff;
-      }
-    } catch (const std::exception &e) {
-      continue;
+    if (elevDiff > 0) {
+      this->elevationGain += elevDiff;
     }
   }
 }
@@ -457,32 +443,21 @@ void Metrics::calculateElevationLoss(
     const mempa::DemHandler *demHandler) {
   this->elevationLoss = 0.0;
 
-  if (!demHandler || path.size() < 2) {
+  std::vector<float> elevations;
+  if (!demHandler || path.size() < 2 ||
+      !sampleElevations(path, demHandler, elevations)) {
     return;
   }
 
-  float totalSlope = 0.0;
-  int validSegments = 0;
-
   for (size_t i = 1; i < path.size(); i++) {
-    std::pair<int, int> before = path[i - 1];
-    std::pair<int, int> after = path[i];
-
     // Get elevation data
-    float elevBefore = 0.0f;
-    float elevAfter = 0.0f;
-
-    try {
-      elevBefore = demHandler->getValue(before.first, before.second);
-      elevAfter = demHandler->getValue(after.first, after.second);
+    float elevBefore = elevations[i - 1];
+    float elevAfter = elevations[i];
 
-      float elevDiff = elevAfter - elevBefore;
+    float elevDiff = elevAfter - elevBefore;
 
-      if (elevDiff < 0) {
-        this->elevationLoss -= elevDiff;
-      }
-    } catch (const std::exception &e) {
-      continue;
+    if (elevDiff < 0) {
+      this->elevationLoss -= elevDiff;
     }
   }
 }
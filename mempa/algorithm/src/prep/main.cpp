@@ -0,0 +1,95 @@
+/* mempa::PreparedDem */
+#include "../dem-handler/PreparedDem.hpp"
+
+/* C++ Standard Libraries */
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+/* POSIX Libraries */
+#include <getopt.h>
+
+/**
+ * @brief Print the usage of the preprocessing tool.
+ */
+static void printUsage()
+{
+    std::cout << R"(
+            Usage: mempa-prep --input <DEM Filepath> [options]
+
+            Options:
+              --input          Input DEM file (.tif format)
+              --output         Prepared output file (default: <input>.mempa)
+              --tile-size      Tile width and height in pixels (default: 256)
+              --help           Print help message
+            )" << std::endl;
+}
+
+/**
+ * @brief Convert a GeoTIFF DEM once into the memory-mappable format read by mempa::DemHandler.
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int main(int argc, char *argv[])
+{
+    static constexpr struct option longOptions[] = {
+        {"input", required_argument, nullptr, 'i'},
+        {"output", required_argument, nullptr, 'o'},
+        {"tile-size", required_argument, nullptr, 't'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0}};
+
+    try
+    {
+        std::string inputFilepath;                               /* Source DEM. */
+        std::string outputFilepath;                              /* Prepared DEM to write. */
+        int tileSize = mempa::PreparedDem::DEFAULT_TILE_SIZE;    /* Tile edge length. */
+
+        int option; /* Option for parsing each user argument. */
+        while ((option = getopt_long(argc, argv, "i:o:t:h", longOptions, nullptr)) != -1)
+        {
+            switch (option)
+            {
+            case 'i':
+                inputFilepath = optarg;
+                break;
+            case 'o':
+                outputFilepath = optarg;
+                break;
+            case 't':
+                tileSize = std::stoi(optarg);
+                break;
+            case 'h':
+                printUsage();
+                return 0;
+            default:
+                printUsage();
+                return 1;
+            }
+        }
+
+        if (inputFilepath.empty())
+        {
+            printUsage();
+            return 1;
+        }
+        if (outputFilepath.empty())
+        {
+            outputFilepath = mempa::PreparedDem::preparedPathFor(inputFilepath.c_str());
+        }
+
+        const auto startTime = std::chrono::steady_clock::now();
+        mempa::PreparedDem::convert(inputFilepath.c_str(), outputFilepath.c_str(), tileSize);
+        const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+        std::cout << "Prepared " << inputFilepath << " -> " << outputFilepath << " in " << elapsedMs << " ms" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include "AStar.hpp"
+
+/**
+ * @brief Construct a new AStar object
+ * 
+ * @details A* expands a small part of the chunk, so working out every step's cost up front costs more than it saves and the steps are
+ * costed as they are reached instead
+ * 
+ * @param useElevation whether the height difference to the goal tightens the bound. Without it the bound is the flat octile distance
+ */
+AStar::AStar(bool useElevation) : _useElevation(useElevation)
+{
+    set_precompute_edges(false);
+}
+
+/**
+ * @brief lower bound on the cost from a cell to the goal
+ * 
+ * @param row row of the cell
+ * @param col column of the cell
+ * @param goalRow row of the goal in the chunk
+ * @param goalCol column of the goal in the chunk
+ * @return double the octile distance in meters, combined with the height difference to the goal the same way
+ * calculate_distance_between_nodes combines a step's run and rise
+ */
+double AStar::estimate_remaining(int row, int col, int goalRow, int goalCol) const
+{
+    int rowSteps = std::abs(goalRow - row);
+    int colSteps = std::abs(goalCol - col);
+    int diagonalSteps = std::min(rowSteps, colSteps);
+    int straightSteps = std::max(rowSteps, colSteps) - diagonalSteps;
+    double run = (straightSteps + diagonalSteps * std::sqrt(2.0)) * _pixelSize;
+    if (!_useElevation)
+    {
+        return run;
+    }
+
+    //a NaN goal height would make every key NaN, so it falls back to the flat bound
+    double rise = std::abs(_heightmap.at(goalCol, goalRow) - _heightmap.at(col, row));
+    if (std::isnan(rise))
+    {
+        return run;
+    }
+    return std::sqrt(run * run + rise * rise);
+}
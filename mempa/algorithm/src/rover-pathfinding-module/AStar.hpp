@@ -0,0 +1,25 @@
+#pragma once
+#include "NewDijkstras.hpp"
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A* search, NewDijkstras with a lower bound on the remaining cost added to every key
+ * 
+ * @details the bound is the octile distance to the goal in pixels times _pixelSize, which is the shortest a route over 8-connected
+ * cells can be on flat ground. Every step costs the length of (run, rise), so by the triangle inequality a route costs at least the
+ * length of (total run, total rise), and the total rise is at least the height difference to the goal. Folding that difference in keeps
+ * the bound admissible and consistent while tightening it on slopes, so the first time the goal is popped the route is a least cost one
+ */
+class AStar: public NewDijkstras
+{
+    public:
+    explicit AStar(bool useElevation = true);
+    bool uses_elevation() const { return _useElevation; }
+
+    protected:
+    double estimate_remaining(int row, int col, int goalRow, int goalCol) const override;
+
+    private:
+    bool _useElevation; // fold the height difference to the goal into the bound
+};
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "AltSearch.hpp"
+#include "../dem-handler/LandmarkTable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * @brief Sets up and runs the search, with the landmark bounds if the tables fit it
+ * 
+ * @param heightmap contains the height values to be used for naviagtion, Usualy a chunk of a larger heightmap
+ * @param chunkLocation 0,0 in the passed heightmap is this value in the whole larger heightmap (global context)
+ * @param startPoint the start point for navigation in the whole larger heightmap (global context)
+ * @param endPoint the end point for nagivation in the whole larger heightmap (global context)
+ * @param maxSlope the maximum slope that is allowed to be navigated over
+ * @param pixelSize the size (in meters) of the resolution of the heightmap
+ * @return std::vector<std::pair<int,int>> the route NewDijkstras::get_step returns
+ */
+std::vector<std::pair<int,int>> AltSearch::get_step(const mempa::ElevationView &heightmap,
+    std::pair<int, int> chunkLocation, std::pair<int, int> startPoint,
+    std::pair<int, int> endPoint, float maxSlope, float pixelSize)
+{
+    int cols = heightmap.getXSize();
+    int rows = heightmap.getYSize();
+    _useLandmarks = _landmarks != nullptr && !_landmarks->empty() && !heightmap.empty() && maxSlope <= _landmarks->getMaxSlope() &&
+                    pixelSize == _landmarks->getPixelSize() && chunkLocation.first >= 0 && chunkLocation.second >= 0 &&
+                    chunkLocation.first + cols <= _landmarks->getXSize() && chunkLocation.second + rows <= _landmarks->getYSize();
+    //a quantized chunk can take steps up to 2e steeper than the tables saw, and charge up to 2e less for each
+    double riseError = 2.0 * heightmap.getMaxError() / pixelSize;
+    _costScale = 1.0 + riseError;
+    if (_useLandmarks && riseError > 0.0)
+    {
+        double allowed = std::tan(maxSlope * M_PI / 180.0) + riseError;
+        _useLandmarks = allowed * (1.0 + COST_SLACK) <= std::tan(_landmarks->getMaxSlope() * M_PI / 180.0);
+    }
+    if (_useLandmarks)
+    {
+        //the goal clamped to the chunk the same way newDijkstras clamps it
+        int goalX = chunkLocation.first + std::min(cols - 1, std::max(0, endPoint.first - chunkLocation.first));
+        int goalY = chunkLocation.second + std::min(rows - 1, std::max(0, endPoint.second - chunkLocation.second));
+        _goalCosts.resize(_landmarks->getLandmarkCount());
+        for (int landmark = 0; landmark < _landmarks->getLandmarkCount(); landmark++)
+        {
+            _goalCosts[landmark] = _landmarks->getCost(landmark, goalX, goalY);
+        }
+    }
+    return NewDijkstras::get_step(heightmap, chunkLocation, startPoint, endPoint, maxSlope, pixelSize);
+}
+
+/**
+ * @brief lower bound on the cost from a cell to the goal
+ * 
+ * @param row row of the cell
+ * @param col column of the cell
+ * @param goalRow row of the goal in the chunk
+ * @param goalCol column of the goal in the chunk
+ * @return double the larger of AStar's bound and the best landmark bound, infinite if the cell cannot reach the goal
+ */
+double AltSearch::estimate_remaining(int row, int col, int goalRow, int goalCol) const
+{
+    double bound = AStar::estimate_remaining(row, col, goalRow, goalCol);
+    if (!_useLandmarks)
+    {
+        return bound;
+    }
+
+    int x = col + _chunkLocaiton.first;
+    int y = row + _chunkLocaiton.second;
+    for (int landmark = 0; landmark < static_cast<int>(_goalCosts.size()); landmark++)
+    {
+        float goalCost = _goalCosts[landmark];
+        float cellCost = _landmarks->getCost(landmark, x, y);
+        bool goalReached = std::isfinite(goalCost);
+        bool cellReached = std::isfinite(cellCost);
+        if (goalReached != cellReached)
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+        if (goalReached)
+        {
+            double difference = std::abs(static_cast<double>(goalCost) - cellCost) / _costScale;
+            bound = std::max(bound, difference - COST_SLACK * std::max(goalCost, cellCost));
+        }
+    }
+    return bound;
+}
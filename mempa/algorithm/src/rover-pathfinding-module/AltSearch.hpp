@@ -0,0 +1,50 @@
+#pragma once
+#include "AStar.hpp"
+#include <utility>
+#include <vector>
+
+namespace mempa
+{
+class LandmarkTable;
+}
+
+/**
+ * @brief A* with ALT bounds: the octile bound of AStar, raised to the best bound the landmark tables of the DEM give
+ * 
+ * @details a step costs the same both ways, so by the triangle inequality a route from a cell to the goal costs at least the difference
+ * between their costs from any landmark. The tables are exact over the whole DEM and a chunk only removes steps, so the bound never
+ * overestimates, and as the largest of consistent bounds it stays consistent. A cell one landmark reaches and the goal not, or the other
+ * way round, cannot reach the goal at all and gets an infinite bound. The bound is trimmed by COST_SLACK of the costs it comes from to
+ * cover their float rounding
+ * 
+ * A quantized chunk's heights are off by up to its error e, so its rises are off by up to 2e. Its steps stay a subset of the tables'
+ * only while tan(maxSlope) + 2e / pixelSize is within the tables' slope limit, and each step can cost up to 1 + 2e / pixelSize times
+ * less than the tables charge for it, so the differences are divided by that before the slack comes off
+ * 
+ * Without tables, or with tables built for a lower slope limit (after the quantization allowance), another pixel size or a smaller
+ * raster, the search is plain AStar
+ */
+class AltSearch: public AStar
+{
+    public:
+    std::vector<std::pair<int,int>> get_step(const mempa::ElevationView &heightmap,
+        std::pair<int, int> chunkLocation, std::pair<int, int> startPoint,
+        std::pair<int, int> endPoint, float maxSlope, float pixelSize) override;
+    // tables covering the whole raster the chunks come from, owned by the caller, or nullptr for none
+    void set_landmarks(const mempa::LandmarkTable *landmarks) { _landmarks = landmarks; }
+    // whether the last search used the tables
+    bool uses_landmarks() const { return _useLandmarks; }
+
+    static constexpr double COST_SLACK = 1e-5;
+    // degrees added to the slope limit of tables meant for quantized chunks, room for heights about 0.1 m off on 10 m pixels
+    static constexpr float QUANTIZED_SLOPE_MARGIN = 1.0f;
+
+    protected:
+    double estimate_remaining(int row, int col, int goalRow, int goalCol) const override;
+
+    private:
+    const mempa::LandmarkTable *_landmarks = nullptr;
+    bool _useLandmarks = false;
+    double _costScale = 1.0; // divides the table differences, above 1 on quantized chunks
+    std::vector<float> _goalCosts; // cost from each landmark to the goal of the current search
+};
\ No newline at end of file
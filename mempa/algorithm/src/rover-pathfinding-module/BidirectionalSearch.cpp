@@ -0,0 +1,246 @@
+#include "BidirectionalSearch.hpp"
+#include "NewDijkstras.hpp"
+
+/**
+ * @brief Construct a new BidirectionalSearch object
+ * 
+ * @param useHeuristic whether both directions are goal directed, making it bidirectional A* rather than bidirectional Dijkstra's
+ */
+BidirectionalSearch::BidirectionalSearch(bool useHeuristic) : _useHeuristic(useHeuristic) {}
+
+/**
+ * @brief Sets up and runs the search from both ends
+ * 
+ * @param heightmap contains the height values to be used for naviagtion, Usualy a chunk of a larger heightmap
+ * @param chunkLocation 0,0 in the passed heightmap is this value in the whole larger heightmap (global context)
+ * @param startPoint the start point for navigation in the whole larger heightmap (global context)
+ * @param endPoint the end point for nagivation in the whole larger heightmap (global context), clamped to the chunk like NewDijkstras does
+ * @param maxSlope the maximum slope that is allowed to be navigated over
+ * @param pixelSize the size (in meters) of the resolution of the heightmap
+ * @return std::vector<std::pair<int,int>> the least cost route in global x,y pairs starting with the startPoint, empty if there is none
+ */
+std::vector<std::pair<int,int>> BidirectionalSearch::get_step(const mempa::ElevationView &heightmap,
+    std::pair<int, int> chunkLocation, std::pair<int, int> startPoint,
+    std::pair<int, int> endPoint, float maxSlope, float pixelSize)
+{
+    this->setUpAlgo(heightmap, chunkLocation, startPoint, endPoint, maxSlope, pixelSize);
+    _expansions = 0;
+    if (_heightmap.empty())
+    {
+        std::cout << "Error: Empty heightmap provided" << std::endl;
+        return {};
+    }
+
+    int rows = _heightmap.getYSize();
+    _cols = _heightmap.getXSize();
+    int startX = _startPoint.first - _chunkLocaiton.first;
+    int startY = _startPoint.second - _chunkLocaiton.second;
+    if (startX < 0 || startX >= _cols || startY < 0 || startY >= rows)
+    {
+        std::cout << "Error: Start point is outside the heightmap" << std::endl;
+        return {};
+    }
+    int endX = std::min(_cols - 1, std::max(0, _endPoint.first - _chunkLocaiton.first));
+    int endY = std::min(rows - 1, std::max(0, _endPoint.second - _chunkLocaiton.second));
+
+    begin_search(rows * _cols);
+    _forward.origin = startY * _cols + startX;
+    _backward.origin = endY * _cols + endX;
+    _goalIndex = _backward.origin;
+    reach(_forward, _forward.origin, 0, 0);
+    reach(_backward, _backward.origin, 0, 0);
+    _forward.frontier.push_or_decrease(_forward.origin, potential(_forward.origin));
+    _backward.frontier.push_or_decrease(_backward.origin, -potential(_backward.origin));
+
+    double bestCost = _forward.origin == _backward.origin ? 0 : UNREACHED;
+    int meetForward = _forward.origin;
+    int meetBackward = _backward.origin;
+    while (!_forward.frontier.empty() && !_backward.frontier.empty() &&
+           _forward.frontier.top_key() + _backward.frontier.top_key() < bestCost)
+    {
+        bool forward = _forward.frontier.top_key() <= _backward.frontier.top_key();
+        expand(forward ? _forward : _backward, forward ? _backward : _forward, forward, bestCost, meetForward, meetBackward);
+    }
+
+    if (bestCost == UNREACHED)
+    {
+        std::cout << "No route found " << std::endl;
+        return {};
+    }
+    return join_route(meetForward, meetBackward);
+}
+
+/**
+ * @brief Upper bound on the bytes BidirectionalSearch holds per heightmap cell
+ * 
+ * @return std::size_t a cost, a tag and a heap slot for each direction
+ */
+std::size_t BidirectionalSearch::workspaceBytesPerCell() const
+{
+    return 2 * (sizeof(float) + sizeof(std::uint8_t) + IndexedHeap::bytes_per_index());
+}
+
+/**
+ * @brief readies both sides for a search over cellCount cells without clearing them, see NewDijkstras::begin_search
+ * 
+ * @param cellCount number of cells in the chunk about to be searched
+ */
+void BidirectionalSearch::begin_search(int cellCount)
+{
+    for (Side *side : {&_forward, &_backward})
+    {
+        if (static_cast<std::size_t>(cellCount) > side->costs.size())
+        {
+            side->costs.resize(cellCount);
+            side->tags.resize(cellCount, 0);
+        }
+        side->frontier.reset(cellCount);
+    }
+
+    if (++_generation > LAST_GENERATION)
+    {
+        std::fill(_forward.tags.begin(), _forward.tags.end(), 0);
+        std::fill(_backward.tags.begin(), _backward.tags.end(), 0);
+        _generation = 1;
+    }
+}
+
+/**
+ * @brief finalizes the cell at the top of one side's heap and relaxes the steps out of it, recording any route that joins the two sides
+ * 
+ * @param side the side to expand
+ * @param other the opposite side
+ * @param forward whether side is the forward one, so its potential is added rather than subtracted
+ * @param bestCost cost of the cheapest route found so far, lowered when a step meets the other side
+ * @param meetForward last cell of the forward part of the cheapest route
+ * @param meetBackward first cell of the backward part of the cheapest route
+ * @return bool whether a cell was expanded
+ */
+bool BidirectionalSearch::expand(Side &side, Side &other, bool forward, double &bestCost, int &meetForward, int &meetBackward)
+{
+    if (side.frontier.empty())
+    {
+        return false;
+    }
+
+    int currentIndex = side.frontier.pop();
+    _expansions++;
+
+    int rows = _heightmap.getYSize();
+    int row = currentIndex / _cols;
+    int col = currentIndex % _cols;
+    float currentHeight = _heightmap.at(col, row);
+    double sign = forward ? 1 : -1;
+    //a mask for this chunk replaces the arctangent with a bit test. Steps cost the same both ways, so the backward side reads it too
+    const bool useMask = hasTraversability();
+    for (int i = 0; i < 8; i++)
+    {
+        int neighborRow = row + NewDijkstras::ROW_STEPS[i];
+        int neighborCol = col + NewDijkstras::COL_STEPS[i];
+        if (neighborRow < 0 || neighborRow >= rows || neighborCol < 0 || neighborCol >= _cols)
+        {
+            continue;
+        }
+        int neighborIndex = currentIndex + NewDijkstras::ROW_STEPS[i] * _cols + NewDijkstras::COL_STEPS[i];
+        if (is_reached(side, neighborIndex) && !side.frontier.contains(neighborIndex))
+        {
+            continue;
+        }
+
+        bool diagonal = NewDijkstras::ROW_STEPS[i] != 0 && NewDijkstras::COL_STEPS[i] != 0;
+        double rise = std::abs(currentHeight - _heightmap.at(neighborCol, neighborRow));
+        bool navigable = useMask ? (_traversability[row][col] >> i) & 1 : NewDijkstras::step_navigable(rise, diagonal, _maxSlope, _pixelSize);
+        if (!navigable)
+        {
+            continue;
+        }
+
+        double alt = side.costs[currentIndex] + NewDijkstras::calculate_distance_between_nodes(diagonal, rise, _pixelSize);
+        if (alt < cost_of(side, neighborIndex))
+        {
+            reach(side, neighborIndex, alt, i);
+            side.frontier.push_or_decrease(neighborIndex, alt + sign * potential(neighborIndex));
+        }
+
+        //the step joins the two sides, so the route through it is a candidate
+        double joined = alt + cost_of(other, neighborIndex);
+        if (joined < bestCost)
+        {
+            bestCost = joined;
+            meetForward = forward ? currentIndex : neighborIndex;
+            meetBackward = forward ? neighborIndex : currentIndex;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief forward potential of a cell, half its octile distance to the goal minus half its octile distance to the start
+ * 
+ * @param index flat index of the cell
+ * @return double the potential in meters, 0 without the heuristic
+ */
+double BidirectionalSearch::potential(int index) const
+{
+    if (!_useHeuristic)
+    {
+        return 0;
+    }
+    return (octile_distance(index, _goalIndex) - octile_distance(index, _forward.origin)) / 2;
+}
+
+/**
+ * @brief shortest distance between two cells over flat 8-connected ground
+ * 
+ * @return double the octile distance in meters
+ */
+double BidirectionalSearch::octile_distance(int index, int otherIndex) const
+{
+    int colDistance = std::abs(index % _cols - otherIndex % _cols);
+    int rowDistance = std::abs(index / _cols - otherIndex / _cols);
+    int diagonalSteps = std::min(colDistance, rowDistance);
+    int straightSteps = std::max(colDistance, rowDistance) - diagonalSteps;
+    return (straightSteps + diagonalSteps * std::sqrt(2.0)) * _pixelSize;
+}
+
+/**
+ * @brief walks the forward parents back to the start and the backward parents on to the goal
+ * 
+ * @param meetForward last cell of the forward part of the route
+ * @param meetBackward first cell of the backward part of the route, the same cell or a neighbour of meetForward
+ * @return std::vector<std::pair<int, int>> the route in global x,y pairs from the start to the goal
+ */
+std::vector<std::pair<int, int>> BidirectionalSearch::join_route(int meetForward, int meetBackward) const
+{
+    std::vector<int> cells;
+    for (int index = meetForward; ; )
+    {
+        cells.push_back(index);
+        if (index == _forward.origin)
+        {
+            break;
+        }
+        int step = _forward.tags[index] & PARENT_MASK;
+        index -= NewDijkstras::ROW_STEPS[step] * _cols + NewDijkstras::COL_STEPS[step];
+    }
+    std::reverse(cells.begin(), cells.end());
+
+    for (int index = meetBackward; meetBackward != meetForward; )
+    {
+        cells.push_back(index);
+        if (index == _backward.origin)
+        {
+            break;
+        }
+        int step = _backward.tags[index] & PARENT_MASK;
+        index -= NewDijkstras::ROW_STEPS[step] * _cols + NewDijkstras::COL_STEPS[step];
+    }
+
+    std::vector<std::pair<int, int>> out;
+    out.reserve(cells.size());
+    for (int index : cells)
+    {
+        out.push_back({index % _cols + _chunkLocaiton.first, index / _cols + _chunkLocaiton.second});
+    }
+    return out;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "SearchAlgorithm.hpp"
+#include "IndexedHeap.hpp"
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Dijkstra's or A* grown from both ends at once, meeting in the middle
+ * 
+ * @details a forward search from the start and a backward search from the goal take turns expanding whichever queued cell has the
+ * smaller key. Steps cost the same both ways, since the slope check and cost only use the absolute rise, so both directions share one
+ * edge cost. Whenever a step joins a cell reached from one end to a cell reached from the other, the route through it is a candidate, and
+ * the search stops once the two smallest keys add up to at least the best candidate.
+ * 
+ * With the heuristic on, keys use the average of the two octile bounds, half the distance to the goal minus half the distance to the
+ * start forwards, and its negation backwards. That keeps both directions consistent, so the same stopping rule stays exact. Two frontiers of
+ * half the radius cover about half the cells one frontier of the full radius does, which is where the saving comes from on long routes
+ */
+class BidirectionalSearch: public SearchAlgorithm
+{
+    public:
+    explicit BidirectionalSearch(bool useHeuristic = false);
+    std::vector<std::pair<int,int>> get_step(const mempa::ElevationView &heightmap,
+        std::pair<int, int> chunkLocation, std::pair<int, int> startPoint,
+        std::pair<int, int> endPoint, float maxSlope, float pixelSize) override;
+    std::size_t workspaceBytesPerCell() const override;
+    bool uses_heuristic() const { return _useHeuristic; }
+
+    private:
+    static constexpr float UNREACHED = std::numeric_limits<float>::infinity();
+    static constexpr int PARENT_BITS = 3;
+    static constexpr std::uint8_t PARENT_MASK = (1 << PARENT_BITS) - 1;
+    static constexpr int LAST_GENERATION = 0xFF >> PARENT_BITS;
+
+    // one end's search, kept between calls and stamped with the generation like NewDijkstras
+    struct Side
+    {
+        std::vector<float> costs;       // cost from this side's end to each cell
+        std::vector<std::uint8_t> tags; // generation above the 3-bit code of the step that reached the cell
+        IndexedHeap frontier;           // reached cells that are not finalized yet
+        int origin = -1;                // flat index this side grows from
+    };
+
+    bool _useHeuristic;
+    Side _forward;
+    Side _backward;
+    int _generation = 0;
+    int _cols = 0;
+    int _goalIndex = -1;
+
+    void begin_search(int cellCount);
+    bool expand(Side &side, Side &other, bool forward, double &bestCost, int &meetForward, int &meetBackward);
+    double potential(int index) const;
+    double octile_distance(int index, int otherIndex) const;
+    std::vector<std::pair<int, int>> join_route(int meetForward, int meetBackward) const;
+    bool is_reached(const Side &side, int index) const { return (side.tags[index] >> PARENT_BITS) == _generation; }
+    float cost_of(const Side &side, int index) const { return is_reached(side, index) ? side.costs[index] : UNREACHED; }
+    void reach(Side &side, int index, float cost, int step) const
+    {
+        side.costs[index] = cost;
+        side.tags[index] = static_cast<std::uint8_t>((_generation << PARENT_BITS) | step);
+    }
+};
\ No newline at end of file
@@ -0,0 +1,282 @@
+#include "BucketQueueSearch.hpp"
+#include "NewDijkstras.hpp"
+
+/**
+ * @brief Sets up and runs the search
+ * 
+ * @param heightmap contains the height values to be used for naviagtion, Usualy a chunk of a larger heightmap
+ * @param chunkLocation 0,0 in the passed heightmap is this value in the whole larger heightmap (global context)
+ * @param startPoint the start point for navigation in the whole larger heightmap (global context)
+ * @param endPoint the end point for nagivation in the whole larger heightmap (global context), clamped to the chunk like NewDijkstras does
+ * @param maxSlope the maximum slope that is allowed to be navigated over
+ * @param pixelSize the size (in meters) of the resolution of the heightmap
+ * @return std::vector<std::pair<int,int>> the least cost route in global x,y pairs starting with the startPoint, empty if there is none
+ */
+std::vector<std::pair<int,int>> BucketQueueSearch::get_step(const mempa::ElevationView &heightmap,
+    std::pair<int, int> chunkLocation, std::pair<int, int> startPoint,
+    std::pair<int, int> endPoint, float maxSlope, float pixelSize)
+{
+    this->setUpAlgo(heightmap, chunkLocation, startPoint, endPoint, maxSlope, pixelSize);
+    _expansions = 0;
+    if (_heightmap.empty())
+    {
+        std::cout << "Error: Empty heightmap provided" << std::endl;
+        return {};
+    }
+
+    int rows = _heightmap.getYSize();
+    _cols = _heightmap.getXSize();
+    int startX = _startPoint.first - _chunkLocaiton.first;
+    int startY = _startPoint.second - _chunkLocaiton.second;
+    if (startX < 0 || startX >= _cols || startY < 0 || startY >= rows)
+    {
+        std::cout << "Error: Start point is outside the heightmap" << std::endl;
+        return {};
+    }
+    int endX = std::min(_cols - 1, std::max(0, _endPoint.first - _chunkLocaiton.first));
+    int endY = std::min(rows - 1, std::max(0, _endPoint.second - _chunkLocaiton.second));
+    int startIndex = startY * _cols + startX;
+    int endIndex = endY * _cols + endX;
+
+    begin_search(rows * _cols, ring_length());
+    reach(startIndex, 0, 0);
+    _buckets[0].push_back(startIndex);
+    std::size_t queued = 1;
+
+    int indexSteps[8];
+    for (int i = 0; i < 8; i++)
+    {
+        indexSteps[i] = NewDijkstras::ROW_STEPS[i] * _cols + NewDijkstras::COL_STEPS[i];
+    }
+    //a mask for this chunk replaces the arctangent with a bit test, given with the chunk or worked out here in one pass
+    mempa::RasterView<const std::uint8_t> steps = _traversability;
+    bool useMask = hasTraversability();
+    if (_precomputeEdges && !useMask)
+    {
+        _edgeCosts.compute(_heightmap, _maxSlope, _pixelSize);
+        steps = _edgeCosts.steps();
+        useMask = true;
+    }
+
+    //the cursor only moves forward, so a bucket is emptied once and every entry left in it with a lower cost than the cursor is stale
+    for (std::uint32_t cursor = 0; queued > 0; cursor++)
+    {
+        if ((cursor & _ringMask) == 0 && !_overflow.empty())
+        {
+            queued -= promote_overflow(cursor);
+        }
+        std::vector<int> &bucket = _buckets[cursor & _ringMask];
+        while (!bucket.empty())
+        {
+            int currentIndex = bucket.back();
+            bucket.pop_back();
+            queued--;
+            if (_costs[currentIndex] != cursor)
+            {
+                continue;
+            }
+            _expansions++;
+
+            if (currentIndex == endIndex)
+            {
+                return path_to_list(startIndex, endIndex);
+            }
+
+            int row = currentIndex / _cols;
+            int col = currentIndex % _cols;
+            float currentHeight = _heightmap.at(col, row);
+            for (int i = 0; i < 8; i++)
+            {
+                int neighborRow = row + NewDijkstras::ROW_STEPS[i];
+                int neighborCol = col + NewDijkstras::COL_STEPS[i];
+                if (neighborRow < 0 || neighborRow >= rows || neighborCol < 0 || neighborCol >= _cols)
+                {
+                    continue;
+                }
+
+                if (useMask && ((steps[row][col] >> i) & 1) == 0)
+                {
+                    continue;
+                }
+                bool diagonal = NewDijkstras::ROW_STEPS[i] != 0 && NewDijkstras::COL_STEPS[i] != 0;
+                double rise = std::abs(currentHeight - _heightmap.at(neighborCol, neighborRow));
+                if (!useMask && !NewDijkstras::step_navigable(rise, diagonal, _maxSlope, _pixelSize))
+                {
+                    continue;
+                }
+                std::uint32_t units = step_units(diagonal, rise);
+
+                //every step costs at least COST_SCALE, so this never lowers a cell that has already been expanded
+                int neighborIndex = currentIndex + indexSteps[i];
+                std::uint32_t alt = cursor + units;
+                if (alt < cost_of(neighborIndex))
+                {
+                    reach(neighborIndex, alt, i);
+                    if (alt - cursor <= _ringMask)
+                    {
+                        _buckets[alt & _ringMask].push_back(neighborIndex);
+                    }
+                    else
+                    {
+                        _overflow.push_back({neighborIndex, alt});
+                    }
+                    queued++;
+                }
+            }
+        }
+    }
+
+    std::cout << "No route found " << std::endl;
+    return {};
+}
+
+/**
+ * @brief Upper bound on the bytes BucketQueueSearch holds per heightmap cell
+ * 
+ * @details a cell is queued again each time one of its 8 neighbours lowers its cost, so it can hold up to 8 queue entries, none larger
+ * than an overflow entry. The ring itself is at most MAX_RING_BUCKETS empty vectors, a fixed amount whatever the chunk size
+ * 
+ * @return std::size_t the cell's cost and parent code, its queue entries and its step mask when it is precomputed
+ */
+std::size_t BucketQueueSearch::workspaceBytesPerCell() const
+{
+    return sizeof(std::uint32_t) + sizeof(std::uint8_t) + 8 * sizeof(Overflowed) + (_precomputeEdges ? EdgeCostKernel::bytes_per_cell() : 0);
+}
+
+/**
+ * @brief readies the cell arrays and ring for a search over cellCount cells, see NewDijkstras::begin_search
+ * 
+ * @param cellCount number of cells in the chunk about to be searched
+ * @param ringLength the fewest buckets the ring needs, a power of two
+ */
+void BucketQueueSearch::begin_search(int cellCount, std::uint32_t ringLength)
+{
+    if (static_cast<std::size_t>(cellCount) > _costs.size())
+    {
+        _costs.resize(cellCount);
+        _tags.resize(cellCount, 0);
+    }
+
+    //a search that stopped at the goal leaves entries behind, which would otherwise be read as queued in this one
+    for (std::vector<int> &bucket : _buckets)
+    {
+        bucket.clear();
+    }
+    _overflow.clear();
+    if (ringLength > _buckets.size())
+    {
+        _buckets.resize(ringLength);
+    }
+    _ringMask = static_cast<std::uint32_t>(_buckets.size() - 1);
+
+    if (++_generation > LAST_GENERATION)
+    {
+        std::fill(_tags.begin(), _tags.end(), 0);
+        _generation = 1;
+    }
+}
+
+/**
+ * @brief the number of buckets that holds every step the search could take, up to MAX_RING_BUCKETS
+ * 
+ * @details a step under the slope limit rises at most run * tan(maxSlope), so it costs at most its run over cos(maxSlope). Steep limits
+ * make that bound long or infinite, and then the ring stops at MAX_RING_BUCKETS and the overflow list takes the longer steps
+ * 
+ * @return std::uint32_t the smallest power of two longer than the dearest step in units, or MAX_RING_BUCKETS if that is smaller
+ */
+std::uint32_t BucketQueueSearch::ring_length() const
+{
+    const double diagonalRun = _pixelSize * std::sqrt(2.0);
+    double steepest = std::min(_maxSlope, 90.0) * M_PI / 180;
+    double maxRise = diagonalRun * std::tan(steepest);
+    if (!(maxRise <= MAX_RING_BUCKETS / COST_SCALE * _pixelSize))
+    {
+        return MAX_RING_BUCKETS;
+    }
+    std::uint32_t longestStep = step_units(true, maxRise);
+    std::uint32_t ringLength = 1;
+    while (ringLength <= longestStep && ringLength < MAX_RING_BUCKETS)
+    {
+        ringLength *= 2;
+    }
+    return ringLength;
+}
+
+/**
+ * @brief moves the overflow entries whose costs fall in the turn of the ring starting at cursor into their buckets
+ * 
+ * @details an entry is only overflowed when its cost is a whole ring past the cursor, so it is still ahead of the cursor at the start
+ * of every turn before its own. Entries for cells whose cost has dropped since are dropped rather than queued twice
+ * 
+ * @param cursor the cost the ring's first bucket now stands for
+ * @return std::size_t how many stale entries were dropped
+ */
+std::size_t BucketQueueSearch::promote_overflow(std::uint32_t cursor)
+{
+    std::size_t dropped = 0;
+    std::size_t kept = 0;
+    for (const Overflowed &entry : _overflow)
+    {
+        if (_costs[entry.index] != entry.cost)
+        {
+            dropped++;
+        }
+        else if (entry.cost - cursor <= _ringMask)
+        {
+            _buckets[entry.cost & _ringMask].push_back(entry.index);
+        }
+        else
+        {
+            _overflow[kept++] = entry;
+        }
+    }
+    _overflow.resize(kept);
+    return dropped;
+}
+
+/**
+ * @brief the cost of a step in whole units
+ * 
+ * @param diagonal whether the cells are diagonal neighbours rather than sharing an edge
+ * @param rise the absolute difference in height between the two cells
+ * @return std::uint32_t NewDijkstras::calculate_distance_between_nodes in pixels times COST_SCALE, rounded to the nearest unit
+ */
+std::uint32_t BucketQueueSearch::step_units(bool diagonal, double rise) const
+{
+    return cost_units(NewDijkstras::calculate_distance_between_nodes(diagonal, rise, _pixelSize));
+}
+
+/**
+ * @brief a step's cost in whole units
+ * 
+ * @param cost the step's 3d length in meters, as NewDijkstras::calculate_distance_between_nodes gives it
+ * @return std::uint32_t the length in pixels times COST_SCALE, rounded to the nearest unit
+ */
+std::uint32_t BucketQueueSearch::cost_units(double cost) const
+{
+    return static_cast<std::uint32_t>(std::lround(cost / _pixelSize * COST_SCALE));
+}
+
+/**
+ * @brief follows the parent codes back from the end to the start
+ * 
+ * @param startIndex flat index the search started from
+ * @param endIndex flat index of the (clamped) end point
+ * @return std::vector<std::pair<int, int>> the route in global x,y pairs from the start to the end
+ */
+std::vector<std::pair<int, int>> BucketQueueSearch::path_to_list(int startIndex, int endIndex) const
+{
+    std::vector<std::pair<int, int>> out;
+    for (int index = endIndex; ; )
+    {
+        out.push_back({index % _cols + _chunkLocaiton.first, index / _cols + _chunkLocaiton.second});
+        if (index == startIndex)
+        {
+            break;
+        }
+        int step = _tags[index] & PARENT_MASK;
+        index -= NewDijkstras::ROW_STEPS[step] * _cols + NewDijkstras::COL_STEPS[step];
+    }
+    std::reverse(out.begin(), out.end());
+    return out;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "SearchAlgorithm.hpp"
+#include "EdgeCostKernel.hpp"
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Dial's algorithm, Dijkstra's with a circular array of buckets in place of the heap, over fixed-point costs
+ * 
+ * @details every step costs its 3d length rounded to a whole number of units, COST_SCALE of them to a pixel, so costs are integers and
+ * a cell waits in the bucket numbered by its cost. No step under the slope limit costs more than the steepest allowed diagonal, so every
+ * queued cost lies within that many units of the cost being expanded, and a ring of buckets one longer than that never wraps onto itself.
+ * The ring is never longer than MAX_RING_BUCKETS, so a step dearer than the ring is long waits in an overflow list instead, and moves
+ * into the ring at the start of the turn of the ring its cost falls in. Pushing is an append and popping moves a cursor forward through
+ * the ring, so there are no comparisons and no sift operations. A cell whose cost drops is appended again rather than moved, and the
+ * old entry is skipped when its bucket comes up.
+ * 
+ * Rounding each step to 1/COST_SCALE of a pixel can pick a route a few units dearer than NewDijkstras finds, well under a thousandth of
+ * its cost. The slope check itself is the same exact one. Like NewDijkstras, the steps within the slope limit are worked out in one
+ * EdgeCostKernel pass over the chunk before searching unless that is turned off
+ */
+class BucketQueueSearch: public SearchAlgorithm
+{
+    public:
+    std::vector<std::pair<int,int>> get_step(const mempa::ElevationView &heightmap,
+        std::pair<int, int> chunkLocation, std::pair<int, int> startPoint,
+        std::pair<int, int> endPoint, float maxSlope, float pixelSize) override;
+    std::size_t workspaceBytesPerCell() const override;
+    std::size_t precomputedBytesPerCell() const override { return _precomputeEdges ? EdgeCostKernel::bytes_per_cell() : 0; }
+    void dropPrecomputed() override { _precomputeEdges = false; }
+
+    // check every step's slope in one pass over the chunk before searching, rather than each time a cell is expanded
+    void set_precompute_edges(bool enabled) { _precomputeEdges = enabled; }
+
+    static constexpr std::uint32_t COST_SCALE = 1024; // cost units to a flat straight step
+    static constexpr std::uint32_t MAX_RING_BUCKETS = 4 * COST_SCALE; // longest ring, covering any step under 4 pixels long
+
+    private:
+    static constexpr std::uint32_t UNREACHED = std::numeric_limits<std::uint32_t>::max();
+
+    static constexpr int PARENT_BITS = 3;                      // low bits of a cell's tag, the step code
+    static constexpr std::uint8_t PARENT_MASK = (1 << PARENT_BITS) - 1;
+    static constexpr int LAST_GENERATION = 0xFF >> PARENT_BITS; // generations wrap after this, 0 never matches
+
+    //kept between searches and stamped with the generation like NewDijkstras
+    std::vector<std::uint32_t> _costs;       // cost from the start to each cell in units
+    std::vector<std::uint8_t> _tags;         // generation the cell was reached in, above the 3-bit code of the step that reached it
+    //a cell queued with a cost too far past the cursor for the ring
+    struct Overflowed
+    {
+        int index;
+        std::uint32_t cost;
+    };
+
+    std::vector<std::vector<int>> _buckets;  // ring of cells by cost, a power of two long so a cost's slot is its low bits
+    std::uint32_t _ringMask = 0;             // ring length minus one
+    std::vector<Overflowed> _overflow;       // cells queued past the end of the ring
+    int _generation = 0;
+    int _cols = 0;
+    EdgeCostKernel _edgeCosts;               // steps of the chunk within the slope limit, when _precomputeEdges
+    bool _precomputeEdges = true;
+
+    void begin_search(int cellCount, std::uint32_t ringLength);
+    std::uint32_t ring_length() const;
+    std::size_t promote_overflow(std::uint32_t cursor);
+    std::uint32_t step_units(bool diagonal, double rise) const;
+    std::uint32_t cost_units(double cost) const;
+    std::vector<std::pair<int, int>> path_to_list(int startIndex, int endIndex) const;
+    bool is_reached(int index) const { return (_tags[index] >> PARENT_BITS) == _generation; }
+    std::uint32_t cost_of(int index) const { return is_reached(index) ? _costs[index] : UNREACHED; }
+    void reach(int index, std::uint32_t cost, int step)
+    {
+        _costs[index] = cost;
+        _tags[index] = static_cast<std::uint8_t>((_generation << PARENT_BITS) | step);
+    }
+};
\ No newline at end of file
@@ -0,0 +1,435 @@
+#include "DStarLite.hpp"
+#include "NewDijkstras.hpp"
+
+//index in NewDijkstras' step order of the step by dx, dy, at (dy + 1) * 3 + dx + 1
+static constexpr int stepIndex[9] = {4, 0, 5, 2, -1, 3, 6, 1, 7};
+
+/**
+ * @brief Plans from startPoint toward endPoint over the chunk, repairing the costs left by the last call instead of searching from scratch
+ * 
+ * @param heightmap contains the height values to be used for naviagtion, Usualy a chunk of a larger heightmap
+ * @param chunkLocation 0,0 in the passed heightmap is this value in the whole larger heightmap (global context)
+ * @param startPoint the start point for navigation in the whole larger heightmap (global context)
+ * @param endPoint the end point for nagivation in the whole larger heightmap (global context)
+ * @param maxSlope the maximum slope that is allowed to be navigated over
+ * @param pixelSize the size (in meters) of the resolution of the heightmap
+ * @return std::vector<std::pair<int,int>> the route from the startPoint to the endPoint, or to the cell it leaves the chunk from, in global
+ * x,y pairs starting with the startPoint. Empty if no route is found
+ */
+std::vector<std::pair<int,int>> DStarLite::get_step(const mempa::ElevationView &heightmap,
+    std::pair<int, int> chunkLocation, std::pair<int, int> startPoint,
+    std::pair<int, int> endPoint, float maxSlope, float pixelSize)
+{
+    this->setUpAlgo(heightmap, chunkLocation, startPoint, endPoint, maxSlope, pixelSize);
+    _expansions = 0;
+    if (_heightmap.empty())
+    {
+        std::cout << "Error: Empty heightmap provided" << std::endl;
+        return {};
+    }
+
+    Window window;
+    window.x = chunkLocation.first;
+    window.y = chunkLocation.second;
+    window.cols = _heightmap.getXSize();
+    window.rows = _heightmap.getYSize();
+    if (!window.contains(_startPoint.first, _startPoint.second))
+    {
+        std::cout << "Error: Start point is outside the heightmap" << std::endl;
+        return {};
+    }
+
+    const mempa::CoarseCostField *field = _costField != nullptr && _costField->fits(_endPoint, _maxSlope) ? _costField : nullptr;
+    if (!_planned || _endPoint != _plannedGoal || _maxSlope != _plannedSlope || _pixelSize != _plannedPixelSize ||
+        field != _plannedField || window.cols > _slotCols || window.rows > _slotRows)
+    {
+        _plannedField = field;
+        restart(window.cols, window.rows);
+    }
+    else
+    {
+        //queued keys were measured from the last start, so new keys carry the distance moved since to stay comparable
+        _keyModifier += octile_distance(_lastStart.first, _lastStart.second, _startPoint.first, _startPoint.second);
+    }
+    _lastStart = _startPoint;
+
+    move_window(window);
+    compute_shortest_path();
+    return extract_path();
+}
+
+/**
+ * @brief forgets every cost, so the next call searches from scratch. Called at the start of every simulator run
+ */
+void DStarLite::reset()
+{
+    _planned = false;
+}
+
+/**
+ * @brief Upper bound on the bytes DStarLite holds per heightmap cell
+ * 
+ * @return std::size_t the cell's g and rhs, plus its slot in the heap
+ */
+std::size_t DStarLite::workspaceBytesPerCell() const
+{
+    return 2 * sizeof(double) + IndexedHeap::bytes_per_index();
+}
+
+/**
+ * @brief calls visit(x, y) on every cell of area that is not in exclude
+ * 
+ * @param area cells to visit
+ * @param exclude cells to skip, may be empty
+ * @param visit callable taking a raster column and row
+ */
+template <typename Visit>
+void DStarLite::for_each_cell_outside(const Window &area, const Window &exclude, Visit visit)
+{
+    int areaEnd = area.x + area.cols;
+    for (int y = area.y; y < area.y + area.rows; y++)
+    {
+        if (y < exclude.y || y >= exclude.y + exclude.rows)
+        {
+            for (int x = area.x; x < areaEnd; x++)
+            {
+                visit(x, y);
+            }
+            continue;
+        }
+        for (int x = area.x; x < std::min(areaEnd, exclude.x); x++)
+        {
+            visit(x, y);
+        }
+        for (int x = std::max(area.x, exclude.x + exclude.cols); x < areaEnd; x++)
+        {
+            visit(x, y);
+        }
+    }
+}
+
+/**
+ * @brief drops every cost and sizes the slots for a chunk, leaving the window empty so every cell of the next chunk is added
+ * 
+ * @param cols width of the largest chunk the slots must hold
+ * @param rows height of the largest chunk the slots must hold
+ */
+void DStarLite::restart(int cols, int rows)
+{
+    _slotCols = cols;
+    _slotRows = rows;
+    _g.assign(cols * rows, UNREACHED);
+    _rhs.assign(cols * rows, UNREACHED);
+    _open.reset(cols * rows);
+    _window = Window();
+    _keyModifier = 0;
+    _plannedGoal = _endPoint;
+    _plannedSlope = _maxSlope;
+    _plannedPixelSize = _pixelSize;
+    _planned = true;
+}
+
+/**
+ * @brief moves the known cells to a new chunk and queues the cells whose lookahead that changes
+ * 
+ * @details cells that leave the chunk turn into assumed flat cells and cells that enter turn into real ones, so the lookaheads that change
+ * are those of entering cells and of cells next to a cell that entered or left. Those are the only cells touched, so the work is in
+ * proportion to how far the chunk moved. No cell that stays can share a slot with one that enters, since both fit in one slot grid
+ * 
+ * @param window the chunk to move to, no larger than the slot grid
+ */
+void DStarLite::move_window(const Window &window)
+{
+    Window old = _window;
+    for_each_cell_outside(old, window, [this](int x, int y) {
+        int leaving = slot(x, y);
+        _open.remove(leaving);
+        _g[leaving] = UNREACHED;
+        _rhs[leaving] = UNREACHED;
+    });
+    _window = window;
+
+    auto refresh = [this](int x, int y) {
+        for (int dy = -1; dy <= 1; dy++)
+        {
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                if (_window.contains(x + dx, y + dy))
+                {
+                    update_vertex(x + dx, y + dy);
+                }
+            }
+        }
+    };
+    for_each_cell_outside(old, window, refresh);
+    for_each_cell_outside(window, old, refresh);
+}
+
+/**
+ * @brief expands queued cells in key order until the start's cost to go is settled
+ * 
+ * @details keys are compared on their first term only, and cells with the same key as the start are expanded too, which covers the
+ * ties the usual second term would break. Every edge costs at least the pixel size, so that still settles the start correctly
+ */
+void DStarLite::compute_shortest_path()
+{
+    int startSlot = slot(_startPoint.first, _startPoint.second);
+    while (!_open.empty() &&
+           (_open.top_key() <= calculate_key(_startPoint.first, _startPoint.second) || _rhs[startSlot] != _g[startSlot]))
+    {
+        int current = _open.top();
+        std::pair<int, int> cell = cell_of(current);
+        double newKey = calculate_key(cell.first, cell.second);
+        if (_open.top_key() < newKey)
+        {
+            //queued before the start moved, so it is only now known to wait
+            _open.push_or_update(current, newKey);
+            continue;
+        }
+
+        _open.pop();
+        _expansions++;
+        if (_g[current] > _rhs[current])
+        {
+            _g[current] = _rhs[current];
+        }
+        else
+        {
+            _g[current] = UNREACHED;
+            update_vertex(cell.first, cell.second);
+        }
+
+        for (int i = 0; i < 8; i++)
+        {
+            int neighborX = cell.first + NewDijkstras::COL_STEPS[i];
+            int neighborY = cell.second + NewDijkstras::ROW_STEPS[i];
+            if (_window.contains(neighborX, neighborY))
+            {
+                update_vertex(neighborX, neighborY);
+            }
+        }
+    }
+}
+
+/**
+ * @brief recomputes a cell's lookahead from its neighbours and queues or unqueues it to match
+ * 
+ * @param x raster column of a cell in the window
+ * @param y raster row of a cell in the window
+ */
+void DStarLite::update_vertex(int x, int y)
+{
+    int cell = slot(x, y);
+    if (std::make_pair(x, y) == _endPoint)
+    {
+        _rhs[cell] = 0;
+    }
+    else
+    {
+        double best = UNREACHED;
+        for (int i = 0; i < 8; i++)
+        {
+            int neighborX = x + NewDijkstras::COL_STEPS[i];
+            int neighborY = y + NewDijkstras::ROW_STEPS[i];
+            if (on_raster(neighborX, neighborY))
+            {
+                best = std::min(best, step_cost(x, y, neighborX, neighborY) + cost_to_go(neighborX, neighborY));
+            }
+        }
+        _rhs[cell] = best;
+    }
+
+    if (_g[cell] != _rhs[cell])
+    {
+        _open.push_or_update(cell, calculate_key(x, y));
+    }
+    else
+    {
+        _open.remove(cell);
+    }
+}
+
+/**
+ * @brief follows the cheapest step from the start until the goal is reached or the cheapest step leaves the chunk
+ * 
+ * @return std::vector<std::pair<int, int>> the route in global x,y pairs starting with the start, empty if the start cannot reach the goal
+ */
+std::vector<std::pair<int, int>> DStarLite::extract_path() const
+{
+    if (_g[slot(_startPoint.first, _startPoint.second)] == UNREACHED)
+    {
+        std::cout << "No route found " << std::endl;
+        return {};
+    }
+
+    std::vector<std::pair<int, int>> out = {_startPoint};
+    std::pair<int, int> current = _startPoint;
+    //costs are settled, so the walk cannot cycle, the limit only guards against that being wrong
+    for (int steps = _window.cols * _window.rows; current != _endPoint && steps > 0; steps--)
+    {
+        double best = UNREACHED;
+        std::pair<int, int> next = current;
+        for (int i = 0; i < 8; i++)
+        {
+            int neighborX = current.first + NewDijkstras::COL_STEPS[i];
+            int neighborY = current.second + NewDijkstras::ROW_STEPS[i];
+            if (!on_raster(neighborX, neighborY))
+            {
+                continue;
+            }
+            double cost = step_cost(current.first, current.second, neighborX, neighborY) + cost_to_go(neighborX, neighborY);
+            if (cost < best)
+            {
+                best = cost;
+                next = {neighborX, neighborY};
+            }
+        }
+        if (best == UNREACHED || !_window.contains(next.first, next.second))
+        {
+            break;
+        }
+        current = next;
+        out.push_back(current);
+    }
+    return out;
+}
+
+/**
+ * @brief heap key of a cell, its best known cost to go plus a lower bound on the cost from the start to it
+ * 
+ * @param x raster column of a cell in the window
+ * @param y raster row of a cell in the window
+ * @return double the key, infinite if the cell cannot reach the goal
+ */
+double DStarLite::calculate_key(int x, int y) const
+{
+    int cell = slot(x, y);
+    return std::min(_g[cell], _rhs[cell]) + octile_distance(_startPoint.first, _startPoint.second, x, y) + _keyModifier;
+}
+
+/**
+ * @brief cost to go of any cell on the raster
+ * 
+ * @param x raster column
+ * @param y raster row
+ * @return double g for cells in the window, the estimate for cells outside it
+ */
+double DStarLite::cost_to_go(int x, int y) const
+{
+    if (_window.contains(x, y))
+    {
+        return _g[slot(x, y)];
+    }
+    return estimate_to_go(x, y);
+}
+
+/**
+ * @brief cost to go of a cell as estimated without searching it
+ * 
+ * @param x raster column
+ * @param y raster row
+ * @return double the flat octile distance to the goal, raised to the cost field's estimate where it has one
+ */
+double DStarLite::estimate_to_go(int x, int y) const
+{
+    double flat = octile_distance(x, y, _endPoint.first, _endPoint.second);
+    if (_plannedField == nullptr)
+    {
+        return flat;
+    }
+    //the field can miss connections finer than its level, so cells it cannot reach fall back to flat ground
+    double estimate = _plannedField->getCost(x, y);
+    return std::isinf(estimate) ? flat : std::max(flat, estimate);
+}
+
+/**
+ * @brief cost of stepping between neighbouring cells, the same cost NewDijkstras uses
+ * 
+ * @param x raster column of the cell stepped from
+ * @param y raster row of the cell stepped from
+ * @param neighborX raster column of the cell stepped to
+ * @param neighborY raster row of the cell stepped to
+ * @return double the 3d distance between the cells, or infinite if the step is steeper than the slope limit or touches a NaN height, or the
+ * chunk's traversability mask, if one is set, does not allow it. A step out of the window costs the flat distance, or with a cost field, at
+ * least what the estimate drops by
+ */
+double DStarLite::step_cost(int x, int y, int neighborX, int neighborY) const
+{
+    bool diagonal = x != neighborX && y != neighborY;
+    double run = diagonal ? _pixelSize * std::sqrt(2.0) : _pixelSize;
+    if (!_window.contains(x, y) || !_window.contains(neighborX, neighborY))
+    {
+        //otherwise an edge cell could leave for less than its own estimate, and its cost would rise as soon as the window took in the
+        //cell it left to, dragging every cost that led through it along
+        if (_plannedField != nullptr)
+        {
+            return std::max(run, estimate_to_go(x, y) - estimate_to_go(neighborX, neighborY));
+        }
+        return run;
+    }
+
+    double rise = std::abs(_heightmap.at(x - _window.x, y - _window.y) - _heightmap.at(neighborX - _window.x, neighborY - _window.y));
+    bool navigable;
+    if (hasTraversability())
+    {
+        int step = stepIndex[(neighborY - y + 1) * 3 + neighborX - x + 1];
+        navigable = (_traversability[y - _window.y][x - _window.x] >> step) & 1;
+    }
+    else
+    {
+        navigable = NewDijkstras::step_navigable(rise, diagonal, _maxSlope, _pixelSize);
+    }
+    if (!navigable)
+    {
+        return UNREACHED;
+    }
+    return NewDijkstras::calculate_distance_between_nodes(diagonal, rise, _pixelSize);
+}
+
+/**
+ * @brief shortest distance between two cells over flat 8-connected ground
+ * 
+ * @return double the octile distance in meters
+ */
+double DStarLite::octile_distance(int x, int y, int otherX, int otherY) const
+{
+    int colDistance = std::abs(otherX - x);
+    int rowDistance = std::abs(otherY - y);
+    int diagonalSteps = std::min(colDistance, rowDistance);
+    int straightSteps = std::max(colDistance, rowDistance) - diagonalSteps;
+    return (straightSteps + diagonalSteps * std::sqrt(2.0)) * _pixelSize;
+}
+
+/**
+ * @brief whether a cell is on the raster, every cell with non-negative coordinates if the raster size is unknown
+ */
+bool DStarLite::on_raster(int x, int y) const
+{
+    return x >= 0 && y >= 0 && (_rasterSize.first <= 0 || x < _rasterSize.first) && (_rasterSize.second <= 0 || y < _rasterSize.second);
+}
+
+/**
+ * @brief slot holding a cell's costs
+ * 
+ * @param x raster column of a cell in the window
+ * @param y raster row of a cell in the window
+ * @return int index into _g, _rhs and _open
+ */
+int DStarLite::slot(int x, int y) const
+{
+    return (y % _slotRows) * _slotCols + x % _slotCols;
+}
+
+/**
+ * @brief cell in the window a slot holds
+ * 
+ * @param slot index into _g, _rhs and _open
+ * @return std::pair<int, int> raster x,y of the cell
+ */
+std::pair<int, int> DStarLite::cell_of(int slot) const
+{
+    int slotCol = slot % _slotCols;
+    int slotRow = slot / _slotCols;
+    return {_window.x + ((slotCol - _window.x % _slotCols) + _slotCols) % _slotCols,
+            _window.y + ((slotRow - _window.y % _slotRows) + _slotRows) % _slotRows};
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "SearchAlgorithm.hpp"
+#include "IndexedHeap.hpp"
+#include "../dem-handler/CoarseCostField.hpp"
+#include <limits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief D* Lite search that keeps its costs between calls to get_step and repairs them as the rover and its chunk move
+ * 
+ * @details the search runs backwards from the goal, so the costs it finds are costs to go and stay valid when the start moves. Every cell
+ * of the chunk keeps g, its cost to go as of its last expansion, and rhs, a one step lookahead from its neighbours. Only cells where the
+ * two differ are queued, keyed by min(g, rhs) plus the octile distance from the start. The start moves between calls, so instead of
+ * rekeying the heap, _keyModifier grows by the distance it moved and is added to every new key.
+ * 
+ * Only the current chunk is known. The cost to go from a cell outside it comes from the cost field given to set_cost_field, or is the
+ * octile distance to the goal, as if the terrain were flat, when there is none. When the chunk moves, cells that leave it are forgotten,
+ * cells that enter it are added, and only cells next to the change get new lookaheads. How far a repair spreads depends on how well the
+ * estimate matches the terrain that enters: with the flat estimate every entering band lowers the costs behind it, and a repair expanded
+ * more cells than a fresh search of the chunk (3951 against 2575 in the replanning test), while with an exact one it expanded 692 against
+ * 1655. A rover that drives to the edge of each chunk replaces most of it, so there a repair costs about as much as a fresh search
+ * whatever the estimate. The route ends at the goal, or at the edge cell the search expects to leave the chunk from.
+ * 
+ * costs are kept until reset is called or the goal, slope limit or pixel size change, so every chunk passed in between must come from the
+ * same raster
+ */
+class DStarLite: public SearchAlgorithm
+{
+    public:
+    std::vector<std::pair<int,int>> get_step(const mempa::ElevationView &heightmap,
+        std::pair<int, int> chunkLocation, std::pair<int, int> startPoint,
+        std::pair<int, int> endPoint, float maxSlope, float pixelSize) override;
+    void reset() override;
+    std::size_t workspaceBytesPerCell() const override;
+    void set_cost_field(const mempa::CoarseCostField *costField) { _costField = costField; }
+    bool uses_cost_field() const { return _plannedField != nullptr; }
+
+    private:
+    // cells of the raster the search currently knows
+    struct Window
+    {
+        int x = 0;
+        int y = 0;
+        int cols = 0;
+        int rows = 0;
+        bool contains(int cellX, int cellY) const
+        {
+            return cellX >= x && cellX < x + cols && cellY >= y && cellY < y + rows;
+        }
+    };
+
+    static constexpr double UNREACHED = std::numeric_limits<double>::infinity();
+
+    std::vector<double> _g;              // cost to go of each slot as of its last expansion
+    std::vector<double> _rhs;            // one step lookahead of the cost to go of each slot
+    IndexedHeap _open;                   // slots whose g and rhs differ
+    int _slotCols = 0;                   // cells map to slots by their raster position modulo the slot grid
+    int _slotRows = 0;
+    Window _window;                      // cells the slots hold
+    bool _planned = false;               // whether the slots hold a search that can be repaired
+    std::pair<int, int> _lastStart;      // start the last keys were measured from
+    double _keyModifier = 0;             // distance the start has moved since the search began
+    std::pair<int, int> _plannedGoal;    // goal, slope limit and pixel size the search was made for
+    double _plannedSlope = 0;
+    double _plannedPixelSize = 0;
+    const mempa::CoarseCostField *_costField = nullptr;
+    const mempa::CoarseCostField *_plannedField = nullptr; // field the search estimates with, null when it fits neither goal nor slope
+
+    void restart(int cols, int rows);
+    void move_window(const Window &window);
+    void compute_shortest_path();
+    void update_vertex(int x, int y);
+    std::vector<std::pair<int, int>> extract_path() const;
+    double calculate_key(int x, int y) const;
+    double cost_to_go(int x, int y) const;
+    double estimate_to_go(int x, int y) const;
+    double step_cost(int x, int y, int neighborX, int neighborY) const;
+    double octile_distance(int x, int y, int otherX, int otherY) const;
+    bool on_raster(int x, int y) const;
+    int slot(int x, int y) const;
+    std::pair<int, int> cell_of(int slot) const;
+    template <typename Visit>
+    static void for_each_cell_outside(const Window &area, const Window &exclude, Visit visit);
+};
\ No newline at end of file
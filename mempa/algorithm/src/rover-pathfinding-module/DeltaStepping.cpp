@@ -0,0 +1,408 @@
+#include "DeltaStepping.hpp"
+#include "NewDijkstras.hpp"
+#include <cstring>
+
+//row and column steps to the 8 neighbours, straight ones first. A cell's parent code is the index of the step that reached it
+
+/**
+ * @brief Construct a new DeltaStepping object and start its threads
+ *
+ * @param threadCount threads to relax cells on, counting the calling thread, 0 for one per hardware thread
+ */
+DeltaStepping::DeltaStepping(unsigned threadCount)
+    : _threadCount(threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency()))
+{
+    _lowered.resize(_threadCount);
+    _relaxed.resize(_threadCount, 0);
+    for (unsigned worker = 1; worker < _threadCount; worker++)
+    {
+        _workers.emplace_back(&DeltaStepping::worker_loop, this, worker);
+    }
+}
+
+/**
+ * @brief Destroy the DeltaStepping object, waking its threads to stop and joining them
+ */
+DeltaStepping::~DeltaStepping()
+{
+    {
+        std::lock_guard<std::mutex> lock(_poolMutex);
+        _stopping = true;
+    }
+    _workReady.notify_all();
+    for (std::thread &worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Sets up and runs the search
+ *
+ * @param heightmap contains the height values to be used for naviagtion, Usualy a chunk of a larger heightmap
+ * @param chunkLocation 0,0 in the passed heightmap is this value in the whole larger heightmap (global context)
+ * @param startPoint the start point for navigation in the whole larger heightmap (global context)
+ * @param endPoint the end point for nagivation in the whole larger heightmap (global context), clamped to the chunk like NewDijkstras does
+ * @param maxSlope the maximum slope that is allowed to be navigated over
+ * @param pixelSize the size (in meters) of the resolution of the heightmap
+ * @return std::vector<std::pair<int,int>> the least cost route in global x,y pairs starting with the startPoint, empty if there is none
+ */
+std::vector<std::pair<int,int>> DeltaStepping::get_step(const mempa::ElevationView &heightmap,
+    std::pair<int, int> chunkLocation, std::pair<int, int> startPoint,
+    std::pair<int, int> endPoint, float maxSlope, float pixelSize)
+{
+    this->setUpAlgo(heightmap, chunkLocation, startPoint, endPoint, maxSlope, pixelSize);
+    _expansions = 0;
+    if (_heightmap.empty())
+    {
+        std::cout << "Error: Empty heightmap provided" << std::endl;
+        return {};
+    }
+
+    _rows = _heightmap.getYSize();
+    _cols = _heightmap.getXSize();
+    int startX = _startPoint.first - _chunkLocaiton.first;
+    int startY = _startPoint.second - _chunkLocaiton.second;
+    if (startX < 0 || startX >= _cols || startY < 0 || startY >= _rows)
+    {
+        std::cout << "Error: Start point is outside the heightmap" << std::endl;
+        return {};
+    }
+    int endX = std::min(_cols - 1, std::max(0, _endPoint.first - _chunkLocaiton.first));
+    int endY = std::min(_rows - 1, std::max(0, _endPoint.second - _chunkLocaiton.second));
+    int startIndex = startY * _cols + startX;
+    int endIndex = endY * _cols + endX;
+
+    //the steepest step allowed costs its run over the cosine of the slope, so heavy steps only exist when that is over a bucket's width
+    _delta = DELTA_STEPS * _pixelSize;
+    double steepest = std::min(_maxSlope, 90.0) * M_PI / 180;
+    bool heavySteps = !(_pixelSize * std::sqrt(2.0) <= _delta * std::cos(steepest));
+
+    begin_search(_rows * _cols);
+    lower_label(startIndex, pack(0, 0));
+    _queuedIn[startIndex] = 0;
+    _buckets.push_back({startIndex});
+
+    std::vector<int> current;
+    std::vector<int> settled;
+    for (std::size_t bucket = 0; bucket < _buckets.size(); bucket++)
+    {
+        std::uint64_t endLabel = _labels[endIndex].load(std::memory_order_relaxed);
+        if (endLabel != UNREACHED && bucket_of(cost_of(endLabel)) < bucket)
+        {
+            break;
+        }
+
+        //light steps can refill the bucket, and a heavy step rounding down onto its edge can too, so loop until it stays empty
+        while (!_buckets[bucket].empty())
+        {
+            settled.clear();
+            while (!_buckets[bucket].empty())
+            {
+                current.clear();
+                current.swap(_buckets[bucket]);
+                current.erase(std::remove_if(current.begin(), current.end(),
+                    [&](int index) { return _queuedIn[index] != static_cast<int>(bucket); }), current.end());
+                for (int index : current)
+                {
+                    _queuedIn[index] = NOT_QUEUED;
+                }
+                relax_cells(current, true);
+                settled.insert(settled.end(), current.begin(), current.end());
+                queue_lowered();
+            }
+            if (heavySteps)
+            {
+                relax_cells(settled, false);
+                queue_lowered();
+            }
+        }
+        std::vector<int>().swap(_buckets[bucket]);
+    }
+
+    for (std::size_t relaxed : _relaxed)
+    {
+        _expansions += relaxed;
+    }
+    if (_labels[endIndex].load(std::memory_order_relaxed) == UNREACHED)
+    {
+        std::cout << "No route found " << std::endl;
+        return {};
+    }
+    return path_to_list(startIndex, endIndex);
+}
+
+/**
+ * @brief Upper bound on the bytes DeltaStepping holds per heightmap cell
+ *
+ * @return std::size_t the cell's label and bucket, plus room for it in a bucket and in a thread's list of lowered cells
+ */
+std::size_t DeltaStepping::workspaceBytesPerCell() const
+{
+    return sizeof(std::uint64_t) + sizeof(int) + 2 * sizeof(int);
+}
+
+/**
+ * @brief Share of the last search's relaxing done in phases split over the pool
+ *
+ * @details the rest ran on the calling thread alone, so by Amdahl's law n threads can be at most 1 / (1 - share + share / n) times
+ * faster than one
+ *
+ * @return double cells relaxed from in phases of at least PARALLEL_CELLS over all cells relaxed from, 0 before any search
+ */
+double DeltaStepping::parallel_share() const
+{
+    return _phaseCells == 0 ? 0 : static_cast<double>(_pooledCells) / _phaseCells;
+}
+
+/**
+ * @brief runs on each worker thread, taking its share of every task run_parallel hands out until the pool stops
+ *
+ * @param worker which share of each task this thread runs, from 1 since the calling thread runs share 0
+ */
+void DeltaStepping::worker_loop(unsigned worker)
+{
+    std::size_t seenRound = 0;
+    std::unique_lock<std::mutex> lock(_poolMutex);
+    while (true)
+    {
+        _workReady.wait(lock, [&] { return _stopping || _round != seenRound; });
+        if (_stopping)
+        {
+            return;
+        }
+        seenRound = _round;
+        std::size_t itemCount = _taskSize;
+        lock.unlock();
+        (*_task)(worker, itemCount * worker / _threadCount, itemCount * (worker + 1) / _threadCount);
+        lock.lock();
+        if (--_busyWorkers == 0)
+        {
+            _workDone.notify_one();
+        }
+    }
+}
+
+/**
+ * @brief splits itemCount items into one even share per thread and returns once every share is done
+ *
+ * @details too few items to be worth waking the pool for are all run on the calling thread as share 0
+ *
+ * @param itemCount number of items to split
+ * @param task called with the thread's share number and the range of items it should run
+ */
+void DeltaStepping::run_parallel(std::size_t itemCount, const std::function<void(unsigned, std::size_t, std::size_t)> &task)
+{
+    if (_workers.empty() || itemCount < PARALLEL_CELLS)
+    {
+        task(0, 0, itemCount);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_poolMutex);
+        _task = &task;
+        _taskSize = itemCount;
+        _busyWorkers = static_cast<unsigned>(_workers.size());
+        _round++;
+    }
+    _workReady.notify_all();
+    task(0, 0, itemCount / _threadCount);
+
+    std::unique_lock<std::mutex> lock(_poolMutex);
+    _workDone.wait(lock, [&] { return _busyWorkers == 0; });
+}
+
+/**
+ * @brief readies the labels and buckets for a search over cellCount cells, growing them if the chunk is larger than any before
+ *
+ * @param cellCount number of cells in the chunk about to be searched
+ */
+void DeltaStepping::begin_search(int cellCount)
+{
+    if (static_cast<std::size_t>(cellCount) > _labelCapacity)
+    {
+        _labels.reset(new std::atomic<std::uint64_t>[cellCount]);
+        _labelCapacity = cellCount;
+        _queuedIn.resize(cellCount);
+    }
+    run_parallel(cellCount, [&](unsigned, std::size_t begin, std::size_t end)
+    {
+        for (std::size_t index = begin; index < end; index++)
+        {
+            _labels[index].store(UNREACHED, std::memory_order_relaxed);
+            _queuedIn[index] = NOT_QUEUED;
+        }
+    });
+
+    _buckets.clear();
+    for (unsigned worker = 0; worker < _threadCount; worker++)
+    {
+        _lowered[worker].clear();
+        _relaxed[worker] = 0;
+    }
+    _phaseCells = 0;
+    _pooledCells = 0;
+}
+
+/**
+ * @brief relaxes either the light or the heavy steps out of each cell, spread over the pool
+ *
+ * @details each thread lowers labels with lower_label and notes the cells it lowered in its own list for queue_lowered. A cell lowered
+ * by two threads is noted twice, which queue_lowered sees through
+ *
+ * @param cells flat indices of the cells to relax from
+ * @param light whether to relax the steps no longer than a bucket's width, or the ones longer
+ */
+void DeltaStepping::relax_cells(const std::vector<int> &cells, bool light)
+{
+    //a mask for this chunk replaces the arctangent with a bit test
+    const bool useMask = hasTraversability();
+    _phaseCells += cells.size();
+    if (cells.size() >= PARALLEL_CELLS)
+    {
+        _pooledCells += cells.size();
+    }
+    run_parallel(cells.size(), [&](unsigned worker, std::size_t begin, std::size_t end)
+    {
+        std::vector<int> &lowered = _lowered[worker];
+        for (std::size_t item = begin; item < end; item++)
+        {
+            int currentIndex = cells[item];
+            float currentCost = cost_of(_labels[currentIndex].load(std::memory_order_relaxed));
+            int row = currentIndex / _cols;
+            int col = currentIndex % _cols;
+            float currentHeight = _heightmap.at(col, row);
+            for (int i = 0; i < 8; i++)
+            {
+                int neighborRow = row + NewDijkstras::ROW_STEPS[i];
+                int neighborCol = col + NewDijkstras::COL_STEPS[i];
+                if (neighborRow < 0 || neighborRow >= _rows || neighborCol < 0 || neighborCol >= _cols)
+                {
+                    continue;
+                }
+
+                bool diagonal = NewDijkstras::ROW_STEPS[i] != 0 && NewDijkstras::COL_STEPS[i] != 0;
+                double rise = std::abs(currentHeight - _heightmap.at(neighborCol, neighborRow));
+                bool navigable = useMask ? (_traversability[row][col] >> i) & 1 : NewDijkstras::step_navigable(rise, diagonal, _maxSlope, _pixelSize);
+                if (!navigable)
+                {
+                    continue;
+                }
+
+                double stepCost = NewDijkstras::calculate_distance_between_nodes(diagonal, rise, _pixelSize);
+                if ((stepCost <= _delta) != light)
+                {
+                    continue;
+                }
+                int neighborIndex = currentIndex + NewDijkstras::ROW_STEPS[i] * _cols + NewDijkstras::COL_STEPS[i];
+                double alt = currentCost + stepCost;
+                if (lower_label(neighborIndex, pack(static_cast<float>(alt), i)))
+                {
+                    lowered.push_back(neighborIndex);
+                }
+            }
+        }
+        if (light)
+        {
+            _relaxed[worker] += end - begin;
+        }
+    });
+}
+
+/**
+ * @brief moves every cell the last phase lowered into the bucket its new cost falls in, unless it already waits there
+ *
+ * @details runs on the calling thread once the phase is over, so every label it reads is settled for now. Older entries for a cell
+ * that moved are left in their buckets and skipped when those are popped
+ */
+void DeltaStepping::queue_lowered()
+{
+    for (std::vector<int> &lowered : _lowered)
+    {
+        for (int index : lowered)
+        {
+            std::size_t bucket = bucket_of(cost_of(_labels[index].load(std::memory_order_relaxed)));
+            if (_queuedIn[index] == static_cast<int>(bucket))
+            {
+                continue;
+            }
+            if (bucket >= _buckets.size())
+            {
+                _buckets.resize(bucket + 1);
+            }
+            _buckets[bucket].push_back(index);
+            _queuedIn[index] = static_cast<int>(bucket);
+        }
+        lowered.clear();
+    }
+}
+
+/**
+ * @brief follows the parent codes back from the end to the start
+ *
+ * @param startIndex flat index the search started from
+ * @param endIndex flat index of the (clamped) end point
+ * @return std::vector<std::pair<int, int>> the route in global x,y pairs from the start to the end
+ */
+std::vector<std::pair<int, int>> DeltaStepping::path_to_list(int startIndex, int endIndex) const
+{
+    std::vector<std::pair<int, int>> out;
+    for (int index = endIndex; ; )
+    {
+        out.push_back({index % _cols + _chunkLocaiton.first, index / _cols + _chunkLocaiton.second});
+        if (index == startIndex)
+        {
+            break;
+        }
+        int step = static_cast<int>(_labels[index].load(std::memory_order_relaxed) & 0xFFFFFFFF);
+        index -= NewDijkstras::ROW_STEPS[step] * _cols + NewDijkstras::COL_STEPS[step];
+    }
+    std::reverse(out.begin(), out.end());
+    return out;
+}
+
+/**
+ * @brief packs a cost and the code of the step that reached a cell into one label
+ *
+ * @return std::uint64_t the bits of the cost above the step code, so labels order by cost first
+ */
+std::uint64_t DeltaStepping::pack(float cost, int step)
+{
+    std::uint32_t costBits;
+    std::memcpy(&costBits, &cost, sizeof(costBits));
+    return (static_cast<std::uint64_t>(costBits) << 32) | static_cast<std::uint32_t>(step);
+}
+
+/**
+ * @brief unpacks the cost from a label
+ *
+ * @return float the cost from the start to the cell
+ */
+float DeltaStepping::cost_of(std::uint64_t label)
+{
+    std::uint32_t costBits = static_cast<std::uint32_t>(label >> 32);
+    float cost;
+    std::memcpy(&cost, &costBits, sizeof(cost));
+    return cost;
+}
+
+/**
+ * @brief lowers a cell's label to the given one if that is smaller, safe to race with other threads doing the same
+ *
+ * @param index flat index of the cell
+ * @param label the new label
+ * @return bool whether this call lowered the label
+ */
+bool DeltaStepping::lower_label(int index, std::uint64_t label)
+{
+    std::uint64_t current = _labels[index].load(std::memory_order_relaxed);
+    while (label < current)
+    {
+        if (_labels[index].compare_exchange_weak(current, label, std::memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+    return false;
+}
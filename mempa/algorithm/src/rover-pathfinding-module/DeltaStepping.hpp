@@ -0,0 +1,85 @@
+#pragma once
+#include "SearchAlgorithm.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief delta-stepping shortest paths, relaxing each bucket of cells on a pool of threads
+ *
+ * @details cells are kept in buckets of width DELTA_STEPS straight steps by their cost so far, and the lowest non-empty bucket is worked on
+ * until it empties. Steps no longer than a bucket's width are light. The light steps out of the bucket are relaxed in parallel, which may
+ * refill the same bucket, and once it stays empty the heavy steps out of every cell it held are relaxed too. Cells are relaxed again
+ * whenever their cost drops, so the order cells are relaxed in does not matter and threads need no locks, only an atomic min on each
+ * cell's label.
+ *
+ * A label packs the float bits of a cell's cost above the code of the step that reached it. Non-negative floats order the same as their
+ * bits, so the smallest label is the cheapest cost and, among equal costs, the lowest step code. Every cell ends with the smallest label
+ * any neighbour gives it from that neighbour's final cost, which is the cost Dijkstra's finds, and the route does not depend on how many
+ * threads ran. The search stops once every bucket up to the goal's cost is finished
+ */
+class DeltaStepping: public SearchAlgorithm
+{
+    public:
+    explicit DeltaStepping(unsigned threadCount = 0);
+    ~DeltaStepping() override;
+    DeltaStepping(const DeltaStepping &) = delete;
+    DeltaStepping &operator=(const DeltaStepping &) = delete;
+    std::vector<std::pair<int,int>> get_step(const mempa::ElevationView &heightmap,
+        std::pair<int, int> chunkLocation, std::pair<int, int> startPoint,
+        std::pair<int, int> endPoint, float maxSlope, float pixelSize) override;
+    std::size_t workspaceBytesPerCell() const override;
+    unsigned thread_count() const { return _threadCount; }
+    double parallel_share() const;
+
+    // a phase relaxes about one ring of the wavefront whatever the bucket width, so wider buckets only add relaxations and the pool
+    // is kept busy by handing it small phases instead. One cell takes microseconds to relax, far longer than waking the pool
+    static constexpr int DELTA_STEPS = 4;                // bucket width in straight steps on flat ground
+    static constexpr std::size_t PARALLEL_CELLS = 256;   // fewer cells than this are relaxed on the calling thread alone
+
+    private:
+    static constexpr std::uint64_t UNREACHED = ~std::uint64_t(0);
+    static constexpr int NOT_QUEUED = -1;
+
+    unsigned _threadCount;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> _labels; // cost bits above the parent code, one per cell
+    std::size_t _labelCapacity = 0;
+    std::vector<int> _queuedIn;                 // bucket each cell waits in, or NOT_QUEUED
+    std::vector<std::vector<int>> _buckets;     // cells by floor(cost / delta), with stale entries skipped when popped
+    std::vector<std::vector<int>> _lowered;     // cells each thread lowered the label of during a phase
+    std::vector<std::size_t> _relaxed;          // cells each thread relaxed the light steps of during the search
+    std::size_t _phaseCells = 0;                // cells relaxed from during the search, light and heavy phases alike
+    std::size_t _pooledCells = 0;               // those of them in phases big enough to be split over the pool
+    int _cols = 0;
+    int _rows = 0;
+    double _delta = 0;
+
+    // the pool: workers sleep until _round changes, each runs its share of _task, and the last to finish wakes the caller
+    std::vector<std::thread> _workers;
+    std::mutex _poolMutex;
+    std::condition_variable _workReady;
+    std::condition_variable _workDone;
+    const std::function<void(unsigned, std::size_t, std::size_t)> *_task = nullptr;
+    std::size_t _taskSize = 0;
+    std::size_t _round = 0;
+    unsigned _busyWorkers = 0;
+    bool _stopping = false;
+
+    void worker_loop(unsigned worker);
+    void run_parallel(std::size_t itemCount, const std::function<void(unsigned, std::size_t, std::size_t)> &task);
+    void begin_search(int cellCount);
+    void relax_cells(const std::vector<int> &cells, bool light);
+    void queue_lowered();
+    std::size_t bucket_of(float cost) const { return static_cast<std::size_t>(cost / _delta); }
+    std::vector<std::pair<int, int>> path_to_list(int startIndex, int endIndex) const;
+    static std::uint64_t pack(float cost, int step);
+    static float cost_of(std::uint64_t label);
+    bool lower_label(int index, std::uint64_t label);
+};
\ No newline at end of file
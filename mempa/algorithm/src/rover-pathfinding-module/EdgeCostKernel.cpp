@@ -0,0 +1,252 @@
+#include "EdgeCostKernel.hpp"
+#include "NewDijkstras.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define EDGE_COST_AVX2 1
+#include <immintrin.h>
+#else
+#define EDGE_COST_AVX2 0
+#endif
+
+namespace
+{
+//rises this close to the limit, relative to it, could land either side of it through rounding in tan or atan, so they get the exact check
+constexpr double LIMIT_MARGIN = 1e-6;
+
+//the slope limit of one kind of step as a rise, with the band around it where the exact check decides
+struct RiseLimit
+{
+    double lower;     // rises below this are within the slope limit
+    double upper;     // rises above this are not
+    bool diagonal;    // whether the step is diagonal, for the exact check
+    double pixelSize; // the size (in meters) of the resolution of the heightmap, for the exact check
+    double maxSlope;  // the limit in degrees, for the exact check
+};
+
+RiseLimit rise_limit(bool diagonal, double pixelSize, double maxSlope)
+{
+    if (!(maxSlope >= 0))
+    {
+        return {-1.0, -1.0, diagonal, pixelSize, maxSlope};
+    }
+    if (maxSlope >= 90)
+    {
+        return {EdgeCostKernel::BLOCKED, EdgeCostKernel::BLOCKED, diagonal, pixelSize, maxSlope};
+    }
+    double run = diagonal ? pixelSize * std::sqrt(2.0) : pixelSize;
+    double limit = run * std::tan(maxSlope * M_PI / 180);
+    return {limit * (1 - LIMIT_MARGIN), limit * (1 + LIMIT_MARGIN), diagonal, pixelSize, maxSlope};
+}
+
+//the slope check NewDijkstras makes, for rises inside the band
+bool within_slope(double rise, const RiseLimit &limit)
+{
+    return NewDijkstras::step_navigable(rise, limit.diagonal, limit.maxSlope, limit.pixelSize);
+}
+
+//the limits of straight and diagonal steps
+struct StepSetup
+{
+    RiseLimit straight;
+    RiseLimit diagonal;
+};
+
+bool within_limit(float fromHeight, float toHeight, const RiseLimit &limit)
+{
+    double rise = std::abs(fromHeight - toHeight);
+    //a NaN rise fails both comparisons
+    return rise < limit.lower || (rise <= limit.upper && within_slope(rise, limit));
+}
+
+//the bit of each checked direction in a mask, which numbers steps in NewDijkstras' order, the bit of the step back, and the column step
+constexpr int MASK_BITS[EdgeCostKernel::DIRECTIONS] = {3, 7, 1, 6};
+constexpr int REVERSE_BITS[EdgeCostKernel::DIRECTIONS] = {2, 4, 0, 5};
+constexpr int COL_STEPS[EdgeCostKernel::DIRECTIONS] = {1, 1, 0, -1};
+
+//sets the bit of each checked direction out of a cell that is set in within (bit d for direction d), and the bit of the step back on the
+//cell it leads to. below is the next row's mask
+inline void set_steps(std::uint8_t *steps, std::uint8_t *below, int col, int within)
+{
+    for (int d = 0; d < EdgeCostKernel::DIRECTIONS; d++)
+    {
+        if (((within >> d) & 1) != 0)
+        {
+            steps[col] |= static_cast<std::uint8_t>(1 << MASK_BITS[d]);
+            (d == 0 ? steps : below)[col + COL_STEPS[d]] |= static_cast<std::uint8_t>(1 << REVERSE_BITS[d]);
+        }
+    }
+}
+
+//which of the steps east, south-east, south and south-west out of one cell of a row are within the limit, none of those leaving the
+//chunk. below is the next row, null on the last one
+int check_cell(const float *heights, const float *below, int cols, int col, const StepSetup &setup)
+{
+    const float height = heights[col];
+    int within = col + 1 < cols && within_limit(height, heights[col + 1], setup.straight) ? 1 : 0;
+    if (below == nullptr)
+    {
+        return within;
+    }
+    within |= col + 1 < cols && within_limit(height, below[col + 1], setup.diagonal) ? 2 : 0;
+    within |= within_limit(height, below[col], setup.straight) ? 4 : 0;
+    within |= col > 0 && within_limit(height, below[col - 1], setup.diagonal) ? 8 : 0;
+    return within;
+}
+
+//the heights of one row of a quantized chunk
+void decode_row(const mempa::ElevationView &heightmap, int row, float *heights)
+{
+    const std::int16_t *codes = heightmap.getCodes()[row];
+    const mempa::ElevationCodec &codec = heightmap.getCodec();
+    for (int col = 0; col < heightmap.getXSize(); col++)
+    {
+        heights[col] = codec.decode(codes[col]);
+    }
+}
+
+#if EDGE_COST_AVX2
+//one checked direction for four cells: the height differences in float like the search takes them, then widened to doubles for the
+//comparison. Returns the lanes whose rises are below the band and sets inBand to the lanes the exact check has to decide
+__attribute__((target("avx2"))) inline int direction_within_avx2(const float *from, const float *to, const RiseLimit &limit, int &inBand)
+{
+    __m128 difference = _mm_sub_ps(_mm_loadu_ps(from), _mm_loadu_ps(to));
+    __m256d rise = _mm256_cvtps_pd(_mm_andnot_ps(_mm_set1_ps(-0.0f), difference));
+    __m256d below = _mm256_cmp_pd(rise, _mm256_set1_pd(limit.lower), _CMP_LT_OQ);
+    inBand = _mm256_movemask_pd(_mm256_andnot_pd(below, _mm256_cmp_pd(rise, _mm256_set1_pd(limit.upper), _CMP_LE_OQ)));
+    return _mm256_movemask_pd(below);
+}
+
+//the cells of a row that is not the last and whose four steps all stay on the chunk, four at a time. The four directions are checked
+//as vectors across the cells, then each cell's bits are gathered. Returns the first column left undone
+__attribute__((target("avx2"))) int check_row_avx2(const float *heights, const float *below, int firstCol, int endCol, const StepSetup &setup,
+                                                    std::uint8_t *steps, std::uint8_t *belowSteps)
+{
+    int col = firstCol;
+    for (; col + 4 <= endCol; col += 4)
+    {
+        int inBand[EdgeCostKernel::DIRECTIONS];
+        int within[EdgeCostKernel::DIRECTIONS];
+        within[0] = direction_within_avx2(heights + col, heights + col + 1, setup.straight, inBand[0]);
+        within[1] = direction_within_avx2(heights + col, below + col + 1, setup.diagonal, inBand[1]);
+        within[2] = direction_within_avx2(heights + col, below + col, setup.straight, inBand[2]);
+        within[3] = direction_within_avx2(heights + col, below + col - 1, setup.diagonal, inBand[3]);
+
+        for (int d = 0; d < EdgeCostKernel::DIRECTIONS; d++)
+        {
+            const RiseLimit &limit = d == 1 || d == 3 ? setup.diagonal : setup.straight;
+            const float *to = (d == 0 ? heights : below) + col + COL_STEPS[d];
+            for (int lanes = inBand[d]; lanes != 0; lanes &= lanes - 1)
+            {
+                int lane = __builtin_ctz(lanes);
+                if (within_slope(std::abs(heights[col + lane] - to[lane]), limit))
+                {
+                    within[d] |= 1 << lane;
+                }
+            }
+        }
+        for (int lane = 0; lane < 4; lane++)
+        {
+            int cell = 0;
+            for (int d = 0; d < EdgeCostKernel::DIRECTIONS; d++)
+            {
+                cell |= ((within[d] >> lane) & 1) << d;
+            }
+            set_steps(steps, belowSteps, col + lane, cell);
+        }
+    }
+    return col;
+}
+#endif
+}
+
+/**
+ * @brief whether this build and processor can use the AVX2 pass
+ *
+ * @return true on x86 processors with AVX2
+ */
+bool EdgeCostKernel::simd_supported()
+{
+#if EDGE_COST_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief works out which steps of a chunk are within the slope limit, replacing the mask of the last chunk
+ *
+ * @details the heights are read a row and the row below at a time. Steps off the chunk never get a bit, so the search needs no bounds
+ * check beyond the one it makes anyway
+ *
+ * @param heightmap the chunk the search runs over
+ * @param maxSlope the maximum slope in degrees that may be navigated over
+ * @param pixelSize the size (in meters) of the resolution of the heightmap
+ */
+void EdgeCostKernel::compute(const mempa::ElevationView &heightmap, double maxSlope, double pixelSize)
+{
+    const int rows = heightmap.getYSize();
+    const int cols = heightmap.getXSize();
+    const std::size_t cells = static_cast<std::size_t>(rows) * cols;
+    _cols = cols;
+    _rowCount = rows;
+    if (_steps.size() < cells)
+    {
+        _steps.resize(cells);
+    }
+    std::fill(_steps.begin(), _steps.begin() + cells, std::uint8_t(0));
+
+    const StepSetup setup = {rise_limit(false, pixelSize, maxSlope), rise_limit(true, pixelSize, maxSlope)};
+
+    //a quantized chunk's rows are decoded once each, into whichever of the two scratch rows the row two back used
+    const bool quantized = heightmap.isQuantized();
+    if (quantized && rows > 0)
+    {
+        if (_rows.size() < 2 * static_cast<std::size_t>(cols))
+        {
+            _rows.resize(2 * static_cast<std::size_t>(cols));
+        }
+        decode_row(heightmap, 0, _rows.data());
+    }
+
+    for (int row = 0; row < rows; row++)
+    {
+        std::uint8_t *steps = _steps.data() + static_cast<std::size_t>(row) * cols;
+        std::uint8_t *belowSteps = row + 1 < rows ? steps + cols : nullptr;
+        const float *heights;
+        const float *below = nullptr;
+        if (quantized)
+        {
+            heights = _rows.data() + static_cast<std::size_t>(row % 2) * cols;
+            if (row + 1 < rows)
+            {
+                float *next = _rows.data() + static_cast<std::size_t>((row + 1) % 2) * cols;
+                decode_row(heightmap, row + 1, next);
+                below = next;
+            }
+        }
+        else
+        {
+            heights = heightmap.getValues()[row];
+            below = row + 1 < rows ? heightmap.getValues()[row + 1] : nullptr;
+        }
+        int col = 0;
+#if EDGE_COST_AVX2
+        //the first and last cells have steps off the chunk, so only those between them go four at a time
+        if (_simd && row + 1 < rows && cols > 2)
+        {
+            set_steps(steps, belowSteps, 0, check_cell(heights, below, cols, 0, setup));
+            col = check_row_avx2(heights, below, 1, cols - 1, setup, steps, belowSteps);
+        }
+#endif
+        for (; col < cols; col++)
+        {
+            set_steps(steps, belowSteps, col, check_cell(heights, below, cols, col, setup));
+        }
+    }
+}
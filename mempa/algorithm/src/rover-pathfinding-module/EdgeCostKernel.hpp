@@ -0,0 +1,44 @@
+#pragma once
+#include "../dem-handler/ElevationView.hpp"
+#include "../dem-handler/Raster2D.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief Which steps between neighbouring cells of a chunk are within the slope limit, worked out in one pass before a search so its inner
+ * loop only tests a bit
+ *
+ * @details the result is a traversability mask in the layout SearchAlgorithm::setTraversability takes, one byte per cell with bit i set when
+ * step i of NewDijkstras' order stays on the chunk within the limit, so a search reads it exactly as it reads the slope raster's masks and
+ * still costs each step with NewDijkstras::calculate_distance_between_nodes. A step is as steep both ways, so only the steps east, south-east,
+ * south and south-west are checked, and each sets the bit of the opposite step on the cell it leads to.
+ *
+ * The slope check compares the rise with run * tan(maxSlope) instead of taking an arctangent per step. Rises within a hair of that limit
+ * could fall either side of it through rounding, so those few are checked with the arctangent the search would have used, and the
+ * result always matches the search's own check. On x86 processors with AVX2 four cells are checked at a time, otherwise one at a time,
+ * with the same operations in the same order, so both give the same bits. A quantized chunk is decoded a row at a time into two rows of
+ * floats as the pass goes, so it gets the same bits its decoded heights would
+ */
+class EdgeCostKernel
+{
+    public:
+    static constexpr int DIRECTIONS = 4; // checked steps per cell: east, south-east, south, south-west
+    static constexpr double BLOCKED = std::numeric_limits<double>::infinity(); // cost the searches give a step they cannot take
+
+    void compute(const mempa::ElevationView &heightmap, double maxSlope, double pixelSize);
+    // the mask of the last chunk, valid until the next compute
+    mempa::RasterView<const std::uint8_t> steps() const { return {_steps.data(), _cols, _rowCount, _cols}; }
+    static bool simd_supported();
+    void set_simd(bool enabled) { _simd = enabled && simd_supported(); }
+    bool uses_simd() const { return _simd; }
+    static constexpr std::size_t bytes_per_cell() { return sizeof(std::uint8_t); }
+
+    private:
+    std::vector<std::uint8_t> _steps; // one mask byte per cell, only growing
+    std::vector<float> _rows;         // a quantized chunk's row and the row below, decoded, only growing
+    int _cols = 0;                    // width of the last chunk
+    int _rowCount = 0;                // height of the last chunk
+    bool _simd = simd_supported();
+};
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "IndexedHeap.hpp"
+#include <algorithm>
+
+/**
+ * @brief empties the heap and makes room for indices 0 to capacity - 1
+ * 
+ * @details only the indices still queued are cleared, and the storage is kept, so resetting a heap that already has the capacity costs
+ * the size of what was left in it and allocates nothing. Room for an entry per index is reserved up front, so the heap never grows past
+ * what bytes_per_index charges for, however much of the chunk ends up queued at once
+ * 
+ * @param capacity number of distinct indices that may be pushed
+ */
+void IndexedHeap::reset(int capacity)
+{
+    for (const Entry &entry : _entries)
+    {
+        _positions[entry.index] = NOT_IN_HEAP;
+    }
+    _entries.clear();
+    if (static_cast<std::size_t>(capacity) > _positions.size())
+    {
+        _positions.resize(capacity, NOT_IN_HEAP);
+        _entries.reserve(capacity);
+    }
+}
+
+/**
+ * @brief adds an index to the heap, or lowers its key if it is already there
+ * 
+ * @param index flat index to push, less than the capacity given to reset
+ * @param key cost of the index. Keys larger than the one already held are ignored
+ */
+void IndexedHeap::push_or_decrease(int index, double key)
+{
+    if (contains(index))
+    {
+        std::size_t position = _positions[index];
+        if (key < _entries[position].key)
+        {
+            _entries[position].key = key;
+            sift_up(position);
+        }
+        return;
+    }
+
+    _entries.push_back({key, index});
+    _positions[index] = _entries.size() - 1;
+    sift_up(_entries.size() - 1);
+}
+
+/**
+ * @brief adds an index to the heap, or moves it to a new key whether that is smaller or larger than the one it holds
+ * 
+ * @param index flat index to push, less than the capacity given to reset
+ * @param key new cost of the index
+ */
+void IndexedHeap::push_or_update(int index, double key)
+{
+    if (!contains(index))
+    {
+        push_or_decrease(index, key);
+        return;
+    }
+
+    std::size_t position = _positions[index];
+    _entries[position].key = key;
+    sift_up(position);
+    sift_down(_positions[index]);
+}
+
+/**
+ * @brief takes an index out of the heap wherever it is, does nothing if it is not in the heap
+ * 
+ * @param index flat index to remove
+ */
+void IndexedHeap::remove(int index)
+{
+    if (!contains(index))
+    {
+        return;
+    }
+
+    std::size_t position = _positions[index];
+    _positions[index] = NOT_IN_HEAP;
+    Entry last = _entries.back();
+    _entries.pop_back();
+    if (position < _entries.size())
+    {
+        place(position, last);
+        sift_up(position);
+        sift_down(_positions[last.index]);
+    }
+}
+
+/**
+ * @brief removes the index with the smallest key
+ * 
+ * @return int the removed index. The heap must not be empty
+ */
+int IndexedHeap::pop()
+{
+    int top = _entries.front().index;
+    _positions[top] = NOT_IN_HEAP;
+
+    Entry last = _entries.back();
+    _entries.pop_back();
+    if (!_entries.empty())
+    {
+        place(0, last);
+        sift_down(0);
+    }
+    return top;
+}
+
+/**
+ * @brief bytes the heap holds per index it has capacity for
+ * 
+ * @details every index has a position slot and can be queued at most once, so at most one entry. A search's frontier is usually a thin
+ * ring, but nothing keeps it below the whole chunk, so entries are charged in full
+ * 
+ * @return std::size_t one position slot plus one entry
+ */
+std::size_t IndexedHeap::bytes_per_index()
+{
+    return sizeof(int) + sizeof(Entry);
+}
+
+/**
+ * @brief moves an entry toward the root until its parent has a smaller key
+ * 
+ * @param position where the entry is now
+ */
+void IndexedHeap::sift_up(std::size_t position)
+{
+    Entry moving = _entries[position];
+    while (position > 0)
+    {
+        std::size_t parent = (position - 1) / ARITY;
+        if (!(moving.key < _entries[parent].key))
+        {
+            break;
+        }
+        place(position, _entries[parent]);
+        position = parent;
+    }
+    place(position, moving);
+}
+
+/**
+ * @brief moves an entry away from the root until none of its children has a smaller key
+ * 
+ * @param position where the entry is now
+ */
+void IndexedHeap::sift_down(std::size_t position)
+{
+    Entry moving = _entries[position];
+    std::size_t count = _entries.size();
+    while (true)
+    {
+        std::size_t firstChild = position * ARITY + 1;
+        if (firstChild >= count)
+        {
+            break;
+        }
+
+        std::size_t smallest = firstChild;
+        std::size_t lastChild = std::min(firstChild + ARITY, count);
+        for (std::size_t child = firstChild + 1; child < lastChild; child++)
+        {
+            if (_entries[child].key < _entries[smallest].key)
+            {
+                smallest = child;
+            }
+        }
+        if (!(_entries[smallest].key < moving.key))
+        {
+            break;
+        }
+        place(position, _entries[smallest]);
+        position = smallest;
+    }
+    place(position, moving);
+}
+
+/**
+ * @brief writes an entry into a slot of the heap and records where its index now is
+ * 
+ * @param position slot to write
+ * @param entry entry to write
+ */
+void IndexedHeap::place(std::size_t position, const Entry &entry)
+{
+    _entries[position] = entry;
+    _positions[entry.index] = position;
+}
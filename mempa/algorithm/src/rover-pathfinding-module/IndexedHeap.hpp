@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief min-heap of flat cell indices keyed by cost, with decrease-key
+ * 
+ * @details a 4-ary heap is half as deep as a binary one, so pushes and decrease-keys move an entry fewer levels, and the four children
+ * of an entry sit next to each other in memory. Every index remembers where it is in the heap, so lowering its key is O(log n) instead of
+ * pushing a duplicate entry that has to be skipped later
+ */
+class IndexedHeap
+{
+    public:
+    static constexpr std::size_t ARITY = 4;
+    static constexpr int NOT_IN_HEAP = -1;
+
+    void reset(int capacity);
+    bool empty() const { return _entries.empty(); }
+    std::size_t size() const { return _entries.size(); }
+    bool contains(int index) const { return _positions[index] != NOT_IN_HEAP; }
+    double top_key() const { return _entries.front().key; }
+    int top() const { return _entries.front().index; }
+    void push_or_decrease(int index, double key);
+    void push_or_update(int index, double key);
+    void remove(int index);
+    int pop();
+    static std::size_t bytes_per_index();
+
+    private:
+    struct Entry
+    {
+        double key;
+        int index;
+    };
+
+    std::vector<Entry> _entries;  // the heap itself, smallest key first
+    std::vector<int> _positions;  // where each index sits in _entries, or NOT_IN_HEAP
+
+    void sift_up(std::size_t position);
+    void sift_down(std::size_t position);
+    void place(std::size_t position, const Entry &entry);
+};
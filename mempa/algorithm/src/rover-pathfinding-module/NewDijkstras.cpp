@@ -13,7 +13,7 @@
   * 
   * @author Oscar Mikus <osmi3783@colorado.edu>
   */
-std::vector<std::pair<int,int>> NewDijkstras::get_step(std::vector<std::vector<float>> &heightmap,
+std::vector<std::pair<int,int>> NewDijkstras::get_step(const mempa::ElevationView &heightmap,
     std::pair<int, int> chunkLocation, std::pair<int, int> startPoint,
     std::pair<int, int> endPoint, float maxSlope, float pixelSize){
                 this->setUpAlgo(heightmap, chunkLocation, startPoint, endPoint, maxSlope,
@@ -22,6 +22,7 @@ std::vector<std::pair<int,int>> NewDijkstras::get_step(std::vector<std::vector<f
         // std::cout << "AT: start newDijkstras" << std::endl;
         std::vector<std::pair<int, int>> realPath = newDijkstras();
         std::vector<std::pair<int, int>> globalPath;
+        globalPath.reserve(realPath.size());
         // std::cout << "AT: after newDijkstras" << std::endl;
 
         // for (size_t i = static_cast<size_t>(0); i < realPath.size(); i++) {
@@ -38,121 +39,157 @@ std::vector<std::pair<int,int>> NewDijkstras::get_step(std::vector<std::vector<f
         return globalPath;
 }
 
+/**
+ * @brief Upper bound on the bytes NewDijkstras holds per heightmap cell
+ * 
+ * @return std::size_t the cell's cost and parent code, plus its slot in the heap and its step mask when it is precomputed
+ */
+std::size_t NewDijkstras::workspaceBytesPerCell() const
+{
+    return sizeof(float) + sizeof(std::uint8_t) + IndexedHeap::bytes_per_index() + (_precomputeEdges ? EdgeCostKernel::bytes_per_cell() : 0);
+}
+
 /**
  * @brief Runs the search algoritm after being set up by SearchAlgorithm::set_up_algo
  * 
+ * @details the grid is never built: a cell's neighbours are found by adding fixed offsets to its flat index, and its state is one float
+ * cost and one byte tag holding its parent code, kept from search to search and invalidated by bumping the generation. A cell is finalized once it has been reached and has left the heap, so no visited flags are kept either.
+ * Cells are finalized in cost order from an indexed 4-ary heap, so every cell is expanded at most once and the search stops as
+ * soon as the goal is popped. That bounds a search at O((V + E) log V) and makes the returned route a least cost one. The number of cells
+ * expanded is left in _expansions. A cell's key is its cost from the start plus estimate_remaining, which subclasses override to make
+ * the search goal directed
+ * 
  * @return std::vector<std::pair<int, int>> retruns the route taken from the startPoint to the endPoint or if that is not in range the closest point in the heightmap chunk to the endPoint
  * 
  * @author Oscar Mikus <osmi3783@colorado.edu>
  */
 std::vector<std::pair<int, int>> NewDijkstras::newDijkstras()
 {
-    if (_heightmap.empty() || _heightmap[0].empty()) {
+    _expansions = 0;
+    if (_heightmap.empty()) {
         std::cout << "Error: Empty heightmap provided" << std::endl;
         return {};
     }
     
-    int rows = _heightmap.size();
-    int cols = _heightmap[0].size();
-
-    std::vector<Node> graph(rows * cols);
-
-    std::queue<Node*> Q;
+    int rows = _heightmap.getYSize();
+    int cols = _heightmap.getXSize();
 
-    for (int row = 0; row < rows; row++) {
-        for (int col = 0; col < cols; col++) {
-
-            int index = calc_flat_index(cols, row, col);
-
-            graph[index].height = _heightmap[row][col];
-            graph[index].distFromPrevious = DBL_MAX;
-            graph[index].visited = false;
-            graph[index].neighborIndex = get_neighbor_indexs(rows, cols, row, col);
-            graph[index].selfIndex = index;
-            graph[index].x = col;
-            graph[index].y = row;
+    //points are (x, y), so x picks the column and y the row
+    std::pair<int,int> localStart = std::make_pair(_startPoint.first - _chunkLocaiton.first, _startPoint.second - _chunkLocaiton.second);
+    std::pair<int,int> localEnd = std::make_pair(std::min(cols - 1, std::max(0, _endPoint.first - _chunkLocaiton.first)), 
+                                                    std::min(rows - 1, std::max(0, _endPoint.second - _chunkLocaiton.second)));
 
-        }
+    if (localStart.first < 0 || localStart.first >= cols || localStart.second < 0 || localStart.second >= rows) {
+        std::cout << "Error: Start point is outside the heightmap" << std::endl;
+        return {};
     }
 
-    std::pair<int,int> localStart = std::make_pair(_startPoint.first - _chunkLocaiton.first, _startPoint.second - _chunkLocaiton.second);
-    std::pair<int,int> localEnd = std::make_pair(std::min(rows - 1, std::max(0, _endPoint.first - _chunkLocaiton.first)), 
-                                                    std::min(cols - 1, std::max(0, _endPoint.second - _chunkLocaiton.second)));
-
-    std::cout << "localEnd: " << localEnd.first << "," << localEnd.second << std::endl;
+    int startNodeIndex = calc_flat_index(cols, localStart.second, localStart.first);
+    int endNodeIndex = calc_flat_index(cols, localEnd.second, localEnd.first);
 
-    int startNodeIndex = calc_flat_index(cols, localStart.first, localStart.second);
-    graph[startNodeIndex].distFromPrevious = 0;
-    Q.push(&graph[startNodeIndex]);
+    begin_search(rows * cols);
+    _startIndex = startNodeIndex;
+    reach(startNodeIndex, 0, 0);
+    _frontier.push_or_decrease(startNodeIndex, estimate_remaining(localStart.second, localStart.first, localEnd.second, localEnd.first));
 
-    while (!Q.empty())
+    int indexSteps[8];
+    for (int i = 0; i < 8; i++)
     {
-        Node *currentNode = Q.front();
-        Q.pop();
-        if(currentNode->visited == true){
-            continue;
-        }
-        currentNode->visited = true;
+        indexSteps[i] = ROW_STEPS[i] * cols + COL_STEPS[i];
+    }
+    //a mask for this chunk replaces the arctangent with a bit test, given with the chunk or worked out here in one pass
+    mempa::RasterView<const std::uint8_t> steps = _traversability;
+    bool useMask = hasTraversability();
+    if (_precomputeEdges && !useMask)
+    {
+        _edgeCosts.compute(_heightmap, _maxSlope, _pixelSize);
+        steps = _edgeCosts.steps();
+        useMask = true;
+    }
 
-        // std::cout << "current Node: " << currentNode->x << "," << currentNode->y <<".currentNode height " << currentNode->height <<std::endl;
+    while (!_frontier.empty())
+    {
+        int currentIndex = _frontier.pop();
+        _expansions++;
 
-        if(currentNode->x == localEnd.second && currentNode->y == localEnd.first)
+        if (currentIndex == endNodeIndex)
         {
-            return path_to_list(graph[calc_flat_index(cols, localEnd.second, localEnd.first)]);
+            return path_to_list(endNodeIndex, cols);
         }
 
-        std::vector<Node*> neighbors;
-        for(int i = 0; i < currentNode->neighborIndex.size(); i++)
+        int row = currentIndex / cols;
+        int col = currentIndex % cols;
+        float currentHeight = _heightmap.at(col, row);
+        for (int i = 0; i < 8; i++)
         {
-            Node *currentNeighbor;
-            currentNeighbor = &graph[currentNode->neighborIndex[i]];
-            currentNeighbor->distFromNeighbor = DBL_MAX;
-
-            double rise = abs(currentNode->height - currentNeighbor->height);
-            double run = 0.0;
-            if(currentNode->x == currentNeighbor->x || currentNode->y == currentNeighbor->y){
-                run = _pixelSize;
-            }
-            else{
-                run = sqrt(pow(_pixelSize,1)+pow(_pixelSize,1));
+            int neighborRow = row + ROW_STEPS[i];
+            int neighborCol = col + COL_STEPS[i];
+            int neighborIndex = currentIndex + indexSteps[i];
+            if (neighborRow < 0 || neighborRow >= rows || neighborCol < 0 || neighborCol >= cols || is_finalized(neighborIndex))
+            {
+                continue;
             }
 
-            double slope = rise/run;
-            slope = std::atan(slope)*180/M_PI;
-            double distanceBetweenNodeAndNeighbor = calculate_distance_between_nodes(currentNode, currentNeighbor, rise, _pixelSize);
-            currentNeighbor->distFromNeighbor = distanceBetweenNodeAndNeighbor;
-            
-
-            if (slope <= _maxSlope)
+            if (useMask && ((steps[row][col] >> i) & 1) == 0)
             {
-                double alt = currentNode->distFromPrevious + distanceBetweenNodeAndNeighbor;
-                neighbors.push_back(currentNeighbor);
-
-
-                if (alt < currentNeighbor->distFromPrevious)
+                continue;
+            }
+            bool diagonal = ROW_STEPS[i] != 0 && COL_STEPS[i] != 0;
+            double rise = std::abs(currentHeight - _heightmap.at(neighborCol, neighborRow));
+            if (useMask || step_navigable(rise, diagonal, _maxSlope, _pixelSize))
+            {
+                double stepCost = calculate_distance_between_nodes(diagonal, rise, _pixelSize);
+                double alt = _costs[currentIndex] + stepCost;
+                if (alt < cost_of(neighborIndex))
                 {
-                    currentNeighbor->distFromPrevious = alt;
-                    currentNeighbor->previous = currentNode;
+                    reach(neighborIndex, alt, i);
+                    _frontier.push_or_decrease(neighborIndex, alt + estimate_remaining(neighborRow, neighborCol, localEnd.second, localEnd.first));
                 }
-
             }
         }
+    }
 
-        //sort neighbors by desried value here so that the first in the list is the "closests" and the last is "farthest"
-        std::sort(neighbors.begin(), neighbors.end(), compare_nodes_by_dist_from_neighbor);
+    std::cout << "No route found " << std::endl;
+    return {};
 
-        for (Node* node : neighbors){
-            if(node->visited != true)
-            {
-                Q.push(node);
-            }
-        }
+}
 
+/**
+ * @brief readies the cell arrays and heap for a search over cellCount cells without clearing them
+ * 
+ * @details the arrays only grow, so once they fit the largest chunk, searches allocate nothing. Bumping the generation makes every tag
+ * stale at once; only when the generation wraps, once every LAST_GENERATION searches, are the tags actually zeroed
+ * 
+ * @param cellCount number of cells in the chunk about to be searched
+ */
+void NewDijkstras::begin_search(int cellCount)
+{
+    if (static_cast<std::size_t>(cellCount) > _costs.size())
+    {
+        _costs.resize(cellCount);
+        _tags.resize(cellCount, 0);
     }
+    _frontier.reset(cellCount);
 
-    std::cout << "No route found " << std::endl;
-    return {};
+    if (++_generation > LAST_GENERATION)
+    {
+        std::fill(_tags.begin(), _tags.end(), 0);
+        _generation = 1;
+    }
+}
 
+/**
+ * @brief lower bound on the cost from a cell to the goal, added to the cell's key in the heap
+ * 
+ * @param row row of the cell
+ * @param col column of the cell
+ * @param goalRow row of the goal in the chunk
+ * @param goalCol column of the goal in the chunk
+ * @return double always 0, which turns the search into plain Dijkstra's
+ */
+double NewDijkstras::estimate_remaining(int, int, int, int) const
+{
+    return 0;
 }
 
 /**
@@ -221,65 +258,78 @@ std::vector<int> NewDijkstras::get_neighbor_indexs(int rows, int cols, int row,
 }
 
 /**
- * @brief used to find the path from a node back to the start point by tracing from a final node along pointers to previous nodes until the start node is reached
+ * @brief used to find the path from a cell back to the start point by undoing the step each cell was reached by until the start is reached
  * 
- * @param finalNode The Node that coresponds to the final endPosition after the search algorithm is completed
- * @return std::vector<std::pair<int, int>> the path in x,y pairs that the search algorithm found.  
+ * @param finalIndex flat index of the cell that coresponds to the final endPosition after the search algorithm is completed
+ * @param cols number of columns in the heightmap
+ * @return std::vector<std::pair<int, int>> the path in x,y pairs that the search algorithm found, from the end back to the start
  * 
  * @author Oscar Mikus <osmi3783@colorado.edu>
  */
-std::vector<std::pair<int, int>> NewDijkstras::path_to_list(Node finalNode)
+std::vector<std::pair<int, int>> NewDijkstras::path_to_list(int finalIndex, int cols)
 {
-    Node *workingNode = &finalNode;
     std::vector<std::pair<int, int>> out;
 
-    while(workingNode->distFromPrevious != 0)
+    int workingIndex = finalIndex;
+    out.push_back({workingIndex % cols, workingIndex / cols});
+    while (workingIndex != _startIndex)
     {
-        out.push_back({workingNode->x, workingNode->y});
-        workingNode = workingNode->previous;
+        int step = _tags[workingIndex] & PARENT_MASK;
+        workingIndex -= ROW_STEPS[step] * cols + COL_STEPS[step];
+        out.push_back({workingIndex % cols, workingIndex / cols});
     }
-    std::cout << workingNode->x << "," << workingNode->y <<std::endl;
-    out.push_back({workingNode->x, workingNode->y});
 
     //reverse(out.begin(), out.end());
     return out;
 }
 
 /**
- * @brief used to compare two Nodes together
- * 
- * @param node1 First Node to compare
- * @param node2 Second Node to compare
- * @return true if the first Node has a smaller distance to its neighbor than the second Node
- * @return false if the first Node has a larger distance to its neighbor than the second Node
- * 
- * @author Oscar Mikus <osmi3783@colorado.edu>
- */
-bool NewDijkstras::compare_nodes_by_dist_from_neighbor(Node* node1, Node* node2)
-{
-    return node1->distFromNeighbor < node2->distFromNeighbor;
-}
-
-/**
- * @brief calcualates the 3d distance between two nodes, takes into account diagonal/or not and the diffrernce in height between two Nodes/points
+ * @brief calcualates the 3d distance between two neighbouring cells, takes into account diagonal/or not and the diffrernce in height between them
  * 
- * @param node1 First Node for distance calculation
- * @param node2 Second Node for distance calculation
- * @param rise the absolute differnece in height between node1 and node2
+ * @param diagonal whether the cells are diagonal neighbours rather than sharing an edge
+ * @param rise the absolute differnece in height between the two cells
  * @param pixelSize the size (in meters) of the resolution of the heightmap
- * @return double the 3d distance between node1 and node2
+ * @return double the 3d distance between the two cells
  * 
  * @author Oscar Mikus <osmi3783@colorado.edu>
  */
-double NewDijkstras::calculate_distance_between_nodes(Node* node1, Node* node2, double rise, double pixelSize)
+double NewDijkstras::calculate_distance_between_nodes(bool diagonal, double rise, double pixelSize)
 {
-    if(node1->x == node2->x || node1->y == node2->y)
+    if(!diagonal)
     {
-        return (sqrt(pow(rise,2) + pow(pixelSize,2)));
+        return (sqrt(rise * rise + pixelSize * pixelSize));
     }
     else
     {
-        double diagonalHorizontalDistance = (sqrt(pow(pixelSize,2) + pow(pixelSize,2)));
-        return(sqrt(pow(rise,2) + pow(diagonalHorizontalDistance,2)));
+        double diagonalHorizontalDistance = (sqrt(pixelSize * pixelSize + pixelSize * pixelSize));
+        return(sqrt(rise * rise + diagonalHorizontalDistance * diagonalHorizontalDistance));
     }
 }
+
+/**
+ * @brief the slope of one step, as every search and precomputed table works it out
+ *
+ * @param rise the absolute height difference between the two cells, NaN if either height is
+ * @param diagonal whether the cells are diagonal neighbours
+ * @param pixelSize the size (in meters) of the resolution of the heightmap
+ * @return the slope in degrees
+ */
+double NewDijkstras::step_slope(double rise, bool diagonal, double pixelSize)
+{
+    double run = diagonal ? pixelSize * std::sqrt(2.0) : pixelSize;
+    return std::atan(rise/run)*180/M_PI;
+}
+
+/**
+ * @brief whether the rover can take one step
+ *
+ * @param rise the absolute height difference between the two cells, NaN if either height is
+ * @param diagonal whether the cells are diagonal neighbours
+ * @param maxSlope the maximum slope in degrees that may be navigated over
+ * @param pixelSize the size (in meters) of the resolution of the heightmap
+ * @return true if the step is within the slope limit. A NaN height gives a NaN slope, which never is
+ */
+bool NewDijkstras::step_navigable(double rise, bool diagonal, double maxSlope, double pixelSize)
+{
+    return step_slope(rise, diagonal, pixelSize) <= maxSlope;
+}
@@ -1,19 +1,65 @@
 #pragma once
 #include "SearchAlgorithm.hpp"
+#include "IndexedHeap.hpp"
+#include "EdgeCostKernel.hpp"
+#include <cstdint>
+#include <limits>
 #include <utility>
 #include <vector>
-#include <queue>
 
 class NewDijkstras: public SearchAlgorithm
 {
     public:
-    std::vector<std::pair<int,int>> get_step(std::vector<std::vector<float>> &heightmap,
+    std::vector<std::pair<int,int>> get_step(const mempa::ElevationView &heightmap,
         std::pair<int, int> chunkLocation, std::pair<int, int> startPoint,
         std::pair<int, int> endPoint, float maxSlope, float pixelSize) override;
+    std::size_t workspaceBytesPerCell() const override;
+    std::size_t precomputedBytesPerCell() const override { return _precomputeEdges ? EdgeCostKernel::bytes_per_cell() : 0; }
+    void dropPrecomputed() override { _precomputeEdges = false; }
     std::vector<std::pair<int, int>> newDijkstras();
     int calc_flat_index(int cols, int row, int col);
     std::vector<int> get_neighbor_indexs(int rows, int cols, int row, int col);
-    std::vector<std::pair<int, int>> path_to_list(Node finalNode);
-    static bool compare_nodes_by_dist_from_neighbor(Node* node1, Node* node2);
-    double calculate_distance_between_nodes(Node* node1, Node* node2, double rise, double pixelSize);
+    std::vector<std::pair<int, int>> path_to_list(int finalIndex, int cols);
+    static double calculate_distance_between_nodes(bool diagonal, double rise, double pixelSize);
+    // row and column steps to the 8 neighbours, straight ones first. Every search, mask and table numbers steps in this order,
+    // and a cell's parent code is the index of the step that reached it
+    static constexpr int ROW_STEPS[8] = {-1, 1, 0, 0, -1, -1, 1, 1};
+    static constexpr int COL_STEPS[8] = {0, 0, -1, 1, -1, 1, -1, 1};
+    static double step_slope(double rise, bool diagonal, double pixelSize);
+    static bool step_navigable(double rise, bool diagonal, double maxSlope, double pixelSize);
+    // check every step's slope in one pass over the chunk before searching, rather than each time a cell is expanded
+    void set_precompute_edges(bool enabled) { _precomputeEdges = enabled; }
+    bool precomputes_edges() const { return _precomputeEdges; }
+    EdgeCostKernel &edge_costs() { return _edgeCosts; }
+
+    protected:
+    // lower bound on the cost from a cell to the goal, 0 here so the search is plain Dijkstra's
+    virtual double estimate_remaining(int row, int col, int goalRow, int goalCol) const;
+
+    private:
+    static constexpr float UNREACHED = std::numeric_limits<float>::infinity();
+
+    static constexpr int PARENT_BITS = 3;                      // low bits of a cell's tag, the step code
+    static constexpr std::uint8_t PARENT_MASK = (1 << PARENT_BITS) - 1;
+    static constexpr int LAST_GENERATION = 0xFF >> PARENT_BITS; // generations wrap after this, 0 never matches
+
+    //the grid is implicit, so the only state is one entry per cell in each of these arrays. They are kept between searches and only
+    //grow, and a cell's entries count only if its tag carries the current generation, so starting a search clears nothing
+    std::vector<float> _costs;          // cost from the start to each cell
+    std::vector<std::uint8_t> _tags;    // generation the cell was reached in, above the 3-bit code of the step that reached it
+    IndexedHeap _frontier;              // reached cells that are not finalized yet
+    int _generation = 0;                // generation of the current search
+    int _startIndex = -1;               // flat index of the start, the only reached cell without a parent
+    EdgeCostKernel _edgeCosts;          // steps of the chunk within the slope limit, when _precomputeEdges
+    bool _precomputeEdges = true;
+
+    void begin_search(int cellCount);
+    bool is_reached(int index) const { return (_tags[index] >> PARENT_BITS) == _generation; }
+    float cost_of(int index) const { return is_reached(index) ? _costs[index] : UNREACHED; }
+    bool is_finalized(int index) const { return is_reached(index) && !_frontier.contains(index); }
+    void reach(int index, float cost, int step)
+    {
+        _costs[index] = cost;
+        _tags[index] = static_cast<std::uint8_t>((_generation << PARENT_BITS) | step);
+    }
 };
\ No newline at end of file
@@ -1,18 +1,61 @@
 #include "SearchAlgorithm.hpp"
+#include "AStar.hpp"
+#include "AltSearch.hpp"
+#include "BidirectionalSearch.hpp"
+#include "BucketQueueSearch.hpp"
+#include "DStarLite.hpp"
+#include "DeltaStepping.hpp"
+#include "NewDijkstras.hpp"
+#include <stdexcept>
 
 SearchAlgorithm::SearchAlgorithm() noexcept {}
 
+/**
+ * @brief builds a search algorithm from its command line name
+ * 
+ * @param name "dijkstra" for NewDijkstras, "astar" for AStar, "dstar" for DStarLite, "bidijkstra" or "biastar" for BidirectionalSearch
+ * without or with its heuristic, "deltastep" for DeltaStepping on every hardware thread, "dial" for BucketQueueSearch, or "alt" for
+ * AltSearch, which runs as AStar until it is given landmark tables
+ * @return std::unique_ptr<SearchAlgorithm> the algorithm, ready for get_step
+ * @throws std::invalid_argument if no algorithm has that name
+ */
+std::unique_ptr<SearchAlgorithm> SearchAlgorithm::createAlgorithm(const std::string &name)
+{
+  if (name == "dijkstra") {
+    return std::make_unique<NewDijkstras>();
+  }
+  if (name == "astar") {
+    return std::make_unique<AStar>();
+  }
+  if (name == "dstar") {
+    return std::make_unique<DStarLite>();
+  }
+  if (name == "bidijkstra" || name == "biastar") {
+    return std::make_unique<BidirectionalSearch>(name == "biastar");
+  }
+  if (name == "deltastep") {
+    return std::make_unique<DeltaStepping>();
+  }
+  if (name == "dial") {
+    return std::make_unique<BucketQueueSearch>();
+  }
+  if (name == "alt") {
+    return std::make_unique<AltSearch>();
+  }
+  throw std::invalid_argument("Unknown search algorithm: " + name);
+}
+
 /**
  * @brief non-default way to set up internal parameters to be used with a SearchAlgorithm subclass
  * 
- * @param heightmap contains the height values to be used for naviagtion, Usualy a chunk of a larger heightmap
+ * @param heightmap contains the height values to be used for naviagtion, Usualy a chunk of a larger heightmap. Only the view is kept, so the chunk must outlive the search
  * @param chunkLocation 0,0 in the passed heightmap is this value in the whole larger heightmap (global context)
  * @param startPoint the start point for navigation in the whole larger heightmap (global context)
  * @param endPoint the end point for nagivation in the whole larger heightmap (global context)
  * @param maxSlope the maximum slope that is allowed to be navigated over
  * @param pixelSize the size (in meters) of the resolution of the heightmap
  */
-void SearchAlgorithm::setUpAlgo(std::vector<std::vector<float>> &heightmap,
+void SearchAlgorithm::setUpAlgo(const mempa::ElevationView &heightmap,
                                 std::pair<int, int> chunkLocation,
                                 std::pair<int, int> startPoint,
                                 std::pair<int, int> endPoint, float maxSlope,
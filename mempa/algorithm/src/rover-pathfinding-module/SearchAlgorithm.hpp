@@ -1,29 +1,19 @@
 #pragma once
+#include "../dem-handler/ElevationView.hpp"
+#include "../dem-handler/Raster2D.hpp"
 #include <algorithm>
 #include <cassert>
 #include <cfloat>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <memory>
 #include <queue>
+#include <string>
 #include <utility>
 #include <vector>
 
-class Node;
-class SearchAlgorithm;
-
-class Node {
-public:
-  int height;
-  Node *previous;
-  double distFromPrevious;
-  double distFromNeighbor;
-  bool visited;
-  std::vector<int> neighborIndex;
-  int selfIndex;
-  int x;
-  int y;
-};
-
 class SearchAlgorithm {
 public:
   SearchAlgorithm() noexcept;
@@ -33,28 +23,43 @@ public:
   // virtual bool can_get_next_step() = 0;
   // virtual bool is_path_storage_empty() = 0;
   virtual std::vector<std::pair<int, int>>
-  get_step(std::vector<std::vector<float>> &heightmap,
+  get_step(const mempa::ElevationView &heightmap,
            std::pair<int, int> chunkLocation, std::pair<int, int> startPoint,
            std::pair<int, int> endPoint, float maxSlope, float pixelSize) = 0;
   virtual void reset() {};
 
+  // Builds the algorithm named by --algorithm: "dijkstra", "astar", "dstar",
+  // "bidijkstra", "biastar", "deltastep", "dial" or "alt"
+  static std::unique_ptr<SearchAlgorithm> createAlgorithm(const std::string &name);
+
+  // Upper bound on the bytes of search state per heightmap cell, used to size
+  // chunks to the --memory budget
+  virtual std::size_t workspaceBytesPerCell() const = 0;
+  // Part of workspaceBytesPerCell() the search can do without by checking
+  // slopes as it reaches each step, 0 if it precomputes nothing
+  virtual std::size_t precomputedBytesPerCell() const { return 0; }
+  // Stop precomputing, so the workspace drops by precomputedBytesPerCell()
+  virtual void dropPrecomputed() {}
+
   // virtual std::vector<std::pair<int, int>> newDijkstras() = 0;
 
   // Add the missing declaration here
-  void setUpAlgo(std::vector<std::vector<float>> &heightmap,
+  void setUpAlgo(const mempa::ElevationView &heightmap,
                  std::pair<int, int> chunkLocation,
                  std::pair<int, int> startPoint, std::pair<int, int> endPoint,
                  float maxSlope, float pixelSize);
 
   // Getters
-  std::vector<std::vector<float>> getHeightmap() const { return _heightmap; }
+  mempa::ElevationView getHeightmap() const { return _heightmap; }
   std::pair<int, int> getStartPoint() const { return _startPoint; }
   std::pair<int, int> getEndPoint() const { return _endPoint; }
   double getMaxSlope() const { return _maxSlope; }
   double getPixelSize() const { return _pixelSize; }
+  // Cells expanded by the last search
+  std::size_t getExpansions() const { return _expansions; }
 
   // Setters
-  void setHeightmap(const std::vector<std::vector<float>> &heightmap) {
+  void setHeightmap(const mempa::ElevationView &heightmap) {
     _heightmap = heightmap;
   }
   void setStartPoint(const std::pair<int, int> &startPoint) {
@@ -65,12 +70,33 @@ public:
   }
   void setMaxSlope(double maxSlope) { _maxSlope = maxSlope; }
   void setPixelSize(double pixelSize) { _pixelSize = pixelSize; }
+  // Size of the whole raster the chunks come from, {0, 0} if unknown
+  void setRasterSize(const std::pair<int, int> &rasterSize) {
+    _rasterSize = rasterSize;
+  }
+  // Precomputed steps for the next chunk: bit i of a cell is set when step i
+  // (N, S, W, E, NW, NE, SW, SE) stays on the chunk within the slope
+  // tolerance. An empty view means the search checks slopes itself
+  void setTraversability(const mempa::RasterView<const std::uint8_t> &mask) {
+    _traversability = mask;
+  }
 
 protected:
-  std::vector<std::vector<float>> _heightmap;
+  // Whether the mask set for the next chunk covers the chunk being searched,
+  // so its bits replace the slope check
+  bool hasTraversability() const {
+    return !_traversability.empty() &&
+           _traversability.getXSize() == _heightmap.getXSize() &&
+           _traversability.getYSize() == _heightmap.getYSize();
+  }
+
+  mempa::ElevationView _heightmap; // borrowed, the caller owns the chunk. Read heights with at(), which decodes quantized chunks
   std::pair<int, int> _chunkLocaiton;
   std::pair<int, int> _startPoint;
   std::pair<int, int> _endPoint;
   double _maxSlope;
   double _pixelSize;
+  std::size_t _expansions = 0;
+  std::pair<int, int> _rasterSize{0, 0};
+  mempa::RasterView<const std::uint8_t> _traversability; // borrowed, may be empty
 };
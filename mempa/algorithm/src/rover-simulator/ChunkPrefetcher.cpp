@@ -0,0 +1,128 @@
+/* Local Header */
+#include "ChunkPrefetcher.hpp"
+
+/* C++ Standard Libraries */
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <utility>
+
+namespace mempa
+{
+    /**
+     * @brief Construct a new ChunkPrefetcher.
+     *
+     * @param elevationRaster Handler to read chunks from. Must outlive the prefetcher.
+     * @param buffer Buffer passed to readSquareChunk for every chunk.
+     */
+    ChunkPrefetcher::ChunkPrefetcher(const DemHandler *const elevationRaster, const int buffer) noexcept
+        : elevationRaster(elevationRaster), buffer(buffer)
+    {
+    }
+
+    /**
+     * @brief Wait for any chunk still being read ahead, discarding it.
+     */
+    ChunkPrefetcher::~ChunkPrefetcher()
+    {
+        if (pending.valid())
+        {
+            pending.wait();
+        }
+    }
+
+    /**
+     * @brief Start reading a chunk on a background thread.
+     *
+     * @param center Predicted center of the next chunk the simulator will request.
+     */
+    void ChunkPrefetcher::prefetch(const std::pair<int, int> center)
+    {
+        /* Only one read at a time may use the DemHandler. */
+        if (pending.valid())
+        {
+            pending.wait();
+        }
+
+        pendingCenter = center;
+        ++stats.prefetches;
+        pending = std::async(std::launch::async, [raster = elevationRaster, center, buffer = buffer]()
+                             {
+                                 const std::chrono::steady_clock::time_point readStart = std::chrono::steady_clock::now();
+                                 ElevationChunk chunk = readChunk(raster, center, buffer);
+                                 const std::chrono::duration<double> readTime = std::chrono::steady_clock::now() - readStart;
+                                 return PrefetchedChunk{std::move(chunk), readTime.count()}; });
+    }
+
+    /**
+     * @brief Get the square chunk around a coordinate, using the prefetched chunk when the prediction was right.
+     *
+     * @param center Image coordinate to center the chunk on.
+     * @param relativeCoordinate Optional parameter to reflect the local vector index of the image coordinate.
+     *
+     * @return ElevationChunk Elevation values, as returned by DemHandler::readSquareChunk, or their codes when quantized.
+     *
+     * @throws Failure to read raster values.
+     */
+    ElevationChunk ChunkPrefetcher::readSquareChunk(const std::pair<int, int> center, std::pair<int, int> *const relativeCoordinate)
+    {
+        ++stats.requests;
+        lastRequestHit = false;
+
+        if (pending.valid())
+        {
+            const bool predicted = (pendingCenter == center); /* The prefetched chunk is the one requested. */
+            const std::chrono::steady_clock::time_point waitStart = std::chrono::steady_clock::now();
+            if (!predicted)
+            {
+                /* Let the wrong read finish before reading on this thread; a failure there does not matter. */
+                pending.wait();
+                pending = std::future<PrefetchedChunk>();
+            }
+            else
+            {
+                PrefetchedChunk prefetched = pending.get();
+                const std::chrono::duration<double> waitTime = std::chrono::steady_clock::now() - waitStart;
+
+                ++stats.hits;
+                lastRequestHit = true;
+                stats.readSeconds += prefetched.readSeconds;
+                stats.hiddenSeconds += std::max(0.0, prefetched.readSeconds - waitTime.count());
+
+                if (relativeCoordinate != nullptr)
+                {
+                    const std::pair<int, int> origin = prefetched.chunk.getOrigin();
+                    *relativeCoordinate = std::pair<int, int>(center.first - origin.first, center.second - origin.second);
+                }
+                return std::move(prefetched.chunk);
+            }
+        }
+
+        ElevationChunk chunk = readChunk(elevationRaster, center, buffer);
+        if (relativeCoordinate != nullptr)
+        {
+            const std::pair<int, int> origin = chunk.getOrigin();
+            *relativeCoordinate = std::pair<int, int>(center.first - origin.first, center.second - origin.second);
+        }
+        return chunk;
+    }
+
+    /**
+     * @brief Read the square chunk around a coordinate in the handler's storage mode.
+     *
+     * @param elevationRaster Handler to read from.
+     * @param center Image coordinate to center the chunk on.
+     * @param buffer Cells on each side of the center.
+     * @return ElevationChunk Floats, or codes with a codec fitted to the chunk when the handler stores quantized tiles.
+     *
+     * @throws Failure to read raster values.
+     */
+    ElevationChunk ChunkPrefetcher::readChunk(const DemHandler *const elevationRaster, const std::pair<int, int> center, const int buffer)
+    {
+        if (elevationRaster->isQuantizedStorage())
+        {
+            return elevationRaster->readQuantizedChunk(std::pair<std::pair<int, int>, std::pair<int, int>>(center, center), buffer);
+        }
+        return ElevationChunk(elevationRaster->readSquareChunk(center, buffer));
+    }
+}
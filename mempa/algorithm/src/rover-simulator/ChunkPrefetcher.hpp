@@ -0,0 +1,70 @@
+#pragma once
+
+/* mempa::DemHandler */
+#include "../dem-handler/DemHandler.hpp"
+
+/* mempa::ElevationChunk */
+#include "../dem-handler/ElevationView.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <future>
+#include <utility>
+
+namespace mempa
+{
+    /**
+     * @brief How well chunk prefetching kept raster I/O out of the planning loop.
+     */
+    struct PrefetchStats
+    {
+        std::size_t requests = 0;   /* Chunks the simulator asked for. */
+        std::size_t prefetches = 0; /* Chunks read ahead on the background thread. */
+        std::size_t hits = 0;       /* Requests served by a chunk that was read ahead. */
+        double readSeconds = 0.0;   /* Time spent reading chunks that were hits. */
+        double hiddenSeconds = 0.0; /* Part of readSeconds that overlapped planning instead of blocking it. */
+    };
+
+    /**
+     * @brief Reads square chunks for the RoverSimulator, optionally reading the predicted next chunk on a background thread.
+     *
+     * @details At most one chunk is read ahead at a time, and every request waits for it before touching the DemHandler again, so the DemHandler is never used by two threads at once. When the handler stores quantized tiles, chunks are read as codes with a codec fitted to each chunk.
+     */
+    class ChunkPrefetcher
+    {
+    private:
+        /**
+         * @brief A chunk read on the background thread and how long the read took.
+         */
+        struct PrefetchedChunk
+        {
+            ElevationChunk chunk; /* The chunk that was read. */
+            double readSeconds;   /* Wall time of the read. */
+        };
+
+        const DemHandler *elevationRaster;       /* Handler to read chunks from. */
+        const int buffer;                        /* Buffer passed to readSquareChunk. */
+        std::future<PrefetchedChunk> pending;    /* Chunk being read ahead. Invalid when nothing is pending. */
+        std::pair<int, int> pendingCenter{0, 0}; /* Center of the chunk being read ahead. */
+        bool lastRequestHit = false;             /* Whether the most recent request was a prefetch hit. */
+        PrefetchStats stats;                     /* Running totals. */
+
+        static ElevationChunk readChunk(const DemHandler *elevationRaster, std::pair<int, int> center, int buffer);
+
+    protected:
+        /* ChunkPrefetcher is not designed to be subclassed. */
+
+    public:
+        explicit ChunkPrefetcher(const DemHandler *elevationRaster, int buffer) noexcept;
+        ~ChunkPrefetcher();
+        ChunkPrefetcher(const ChunkPrefetcher &) = delete;
+        ChunkPrefetcher &operator=(const ChunkPrefetcher &) = delete;
+
+        void prefetch(std::pair<int, int> center);
+        ElevationChunk readSquareChunk(std::pair<int, int> center, std::pair<int, int> *relativeCoordinate = nullptr);
+        inline bool wasLastRequestHit() const noexcept;
+        inline const PrefetchStats &getStats() const noexcept;
+    };
+}
+
+#include "ChunkPrefetcher.inl"
@@ -0,0 +1,26 @@
+/* Local Header */
+#include "ChunkPrefetcher.hpp"
+
+namespace mempa
+{
+    /**
+     * @brief Check whether the most recent chunk came from a prefetch.
+     *
+     * @return true The chunk had been read ahead.
+     * @return false The chunk was read on demand.
+     */
+    inline bool ChunkPrefetcher::wasLastRequestHit() const noexcept
+    {
+        return lastRequestHit;
+    }
+
+    /**
+     * @brief Get the prefetch totals so far.
+     *
+     * @return const PrefetchStats&
+     */
+    inline const PrefetchStats &ChunkPrefetcher::getStats() const noexcept
+    {
+        return stats;
+    }
+}
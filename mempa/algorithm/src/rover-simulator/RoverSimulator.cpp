@@ -4,12 +4,22 @@
 /* mempa::DemHandler */
 #include "../dem-handler/DemHandler.hpp"
 
+/* mempa::SlopeRaster */
+#include "../dem-handler/SlopeRaster.hpp"
+
+/* mempa::ChunkPrefetcher */
+#include "ChunkPrefetcher.hpp"
+
+/* mempa::SlidingChunk */
+#include "SlidingChunk.hpp"
+
 /* SearchAlgorithms */
 #include "../rover-pathfinding-module/SearchAlgorithm.hpp"
 
 /* C++ Standard Libraries */
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <limits>
 #include <utility>
 #include <vector>
@@ -88,24 +98,67 @@ RoverSimulator::runSimulator(SearchAlgorithm *algorithm, const float max_slope,
                startPosition.second))); /* Reserve enough memory in the vector
                                            for a straight line. */
 
+  ChunkPrefetcher chunkReader(
+      elevationRaster, buffer); /* Reads whole chunks ahead of time. */
+  SlidingChunk slidingChunk(
+      elevationRaster,
+      buffer); /* Reads only what each move uncovers, when not prefetching. */
+  std::pair<int, int> lastStep{0, 0}; /* Displacement of the previous step. */
+  searchExpansions = 0;
+  Raster2D<std::uint8_t> traversableSteps; /* Steps within max_slope for the
+                                             current chunk, when edgeSlopes is
+                                             set. */
+
+  /* Searches that keep state between steps must not reuse a previous run's. */
+  algorithm->setRasterSize(
+      {elevationRaster->getXSize(), elevationRaster->getYSize()});
+  algorithm->reset();
+
   do {
     std::pair<int, int>
         vectorPosition; /* Will be updated to relative (currentPosition,
                            goalPosition) coordinates within the vector. */
-    std::vector<std::vector<float>> elevationMap =
-        elevationRaster->readSquareChunk(
-            currentPosition, buffer,
-            &vectorPosition); /* The elevation data we read from the DemHandler
-                                 elevationRaster. */
-    std::pair<int, int> chunkLocation = globalVectorCorner(
-        currentPosition, buffer); /* Contains the (0, 0) position in the vector
-                                     as a globally spaced coordinate. */
+    ElevationChunk prefetchedMap; /* Chunk from the prefetcher. Unused when
+                                     sliding. */
+    if (prefetchChunks) {
+      prefetchedMap =
+          chunkReader.readSquareChunk(currentPosition, &vectorPosition);
+    }
+    const ElevationView elevationMap =
+        prefetchChunks
+            ? prefetchedMap.view()
+            : slidingChunk.moveTo(
+                  currentPosition,
+                  &vectorPosition); /* The elevation data we read from the
+                                       DemHandler elevationRaster. */
+    const std::pair<int, int> chunkLocation =
+        elevationMap.getOrigin(); /* Contains the (0, 0) position in the
+                                     vector as a globally spaced coordinate,
+                                     clipped to the raster edges. */
+
+    /* Read the likely next chunk while this one is planned on. */
+    if (prefetchChunks) {
+      chunkReader.prefetch(predictNextCenter(
+          elevationMap, lastStep,
+          chunkReader.getStats().prefetches == 0 ||
+              chunkReader.wasLastRequestHit()));
+    }
+    const std::pair<int, int> stepStart =
+        currentPosition; /* Where this step began. */
+
+    if (edgeSlopes != nullptr) {
+      edgeSlopes->traversability(elevationMap, max_slope,
+                                 traversableSteps);
+      algorithm->setTraversability(traversableSteps.view());
+    }
 
     std::cout << "BEFORE GET STEP" << std::endl;
     std::vector<std::pair<int, int>> pathSegment =
-        algorithm->get_step(elevationMap, chunkLocation, currentPosition,
-                            goalPosition, max_slope, imageResolution);
+        algorithm->get_step(elevationMap, chunkLocation,
+                            currentPosition, goalPosition, max_slope,
+                            imageResolution);
     std::cout << "AFTER GET STEP " << pathSegment.size() << std::endl;
+    searchExpansions += algorithm->getExpansions();
 
     for (auto &pathStep : pathSegment) {
       /* Add the step made to the route and update current position. */
@@ -115,8 +168,14 @@ RoverSimulator::runSimulator(SearchAlgorithm *algorithm, const float max_slope,
                 << currentPosition.second << ")" << std::endl;
     }
 
+    lastStep = coordinateDifference(stepStart, currentPosition);
   } while (currentPosition != goalPosition);
 
+  /* The mask is about to go out of scope. */
+  algorithm->setTraversability({});
+
+  prefetchStats = chunkReader.getStats();
+  slidingStats = slidingChunk.getStats();
   return routedRasterPath;
 }
 } // namespace mempa
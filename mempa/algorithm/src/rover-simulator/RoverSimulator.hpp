@@ -4,11 +4,24 @@
 /* mempa::DemHandler */
 #include "../dem-handler/DemHandler.hpp"
 
+/* mempa::SlopeRaster */
+#include "../dem-handler/SlopeRaster.hpp"
+
+/* mempa::ElevationView */
+#include "../dem-handler/ElevationView.hpp"
+
+/* mempa::ChunkPrefetcher */
+#include "ChunkPrefetcher.hpp"
+
+/* mempa::SlidingChunk */
+#include "SlidingChunk.hpp"
+
 /* mempa::SearchAlgorithm */
 #include "../rover-pathfinding-module/SearchAlgorithm.hpp"
 
 /* C++ Standard Libraries */
 #include <cmath>
+#include <cstddef>
 #include <vector>
 #include <utility>
 
@@ -31,6 +44,13 @@ namespace mempa
         const std::pair<int, int> goalPosition;                         /* The rover's image-based coordinate desination. */
         std::pair<int, int> currentPosition;                            /* The rover's current image-based coordinate position. */
         inline static constexpr std::pair<int, int> BREAK_STEP{-1, -1}; /* The value that a pathfinding algorithm returns when it is complete. */
+        bool prefetchChunks = false;                                    /* Read the predicted next chunk in the background while planning. */
+        PrefetchStats prefetchStats;                                    /* Prefetch totals from the last run. */
+        SlidingStats slidingStats;                                      /* Sliding chunk totals from the last run. */
+        std::size_t searchExpansions = 0;                               /* Cells the search expanded over the last run. */
+        const SlopeRaster *edgeSlopes = nullptr;                        /* Precomputed step slopes of the DEM, if any. */
+
+        inline std::pair<int, int> predictNextCenter(const ElevationView &chunk, std::pair<int, int> lastStep, bool lastPredictionHit) const noexcept;
 
     protected:
         /* RoverSimulator is not designed to be subclassed. */
@@ -43,9 +63,14 @@ namespace mempa
 #endif
         std::vector<std::pair<int, int>> runSimulator(SearchAlgorithm *algorithmType, float max_slope, int buffer);
         inline bool validateElevation(float elevationValue) const noexcept;
-        inline bool validateCoordinate(std::pair<int, int> vecCoordinate, std::vector<std::vector<float>> rasterVector) const noexcept;
+        inline bool validateCoordinate(std::pair<int, int> vecCoordinate, const RasterView<const float> &rasterView) const noexcept;
         inline std::pair<int, int> coordinateDifference(std::pair<int, int> coordinate1, std::pair<int, int> coordinate2) const noexcept;
         inline std::pair<int, int> globalVectorCorner(std::pair<int, int> globalCoordinate, int buffer) const noexcept;
+        inline void setPrefetching(bool enabled) noexcept;
+        inline void setSlopeRaster(const SlopeRaster *slopeCodes) noexcept;
+        inline const PrefetchStats &getPrefetchStats() const noexcept;
+        inline const SlidingStats &getSlidingStats() const noexcept;
+        inline std::size_t getSearchExpansions() const noexcept;
     };
 }
 #include "RoverSimulator.inl"
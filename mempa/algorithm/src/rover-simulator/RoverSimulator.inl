@@ -2,6 +2,7 @@
 #include "RoverSimulator.hpp"
 
 /* C++ Standard Libraries */
+#include <algorithm>
 #include <cmath>
 #include <vector>
 #include <utility>
@@ -12,16 +13,16 @@ namespace mempa
      * @brief Ensures that a requested coordinate is within the 2D vector of read values.
      *
      * @param vecCoordinate Coordinate of vector indices requested. Should be in (x, y) format.
-     * @param rasterVector The vector to check if vecCoordinate is valid within.
+     * @param rasterView The chunk to check if vecCoordinate is valid within.
      * @return true Coordinate is within the vector.
      * @return false Coordinate is outside the vector, would segfault.
      * 
      * @author Ryan Wagster <rywa2447@colorado.edu>
      */
-    inline bool RoverSimulator::validateCoordinate(const std::pair<int, int> vecCoordinate, const std::vector<std::vector<float>> rasterVector) const noexcept
+    inline bool RoverSimulator::validateCoordinate(const std::pair<int, int> vecCoordinate, const RasterView<const float> &rasterView) const noexcept
     {
-        return ((vecCoordinate.first >= 0) && (static_cast<size_t>(vecCoordinate.first) < rasterVector.front().size())) &&
-               ((vecCoordinate.second >= 0) && (static_cast<size_t>(vecCoordinate.second) < rasterVector.size()));
+        return ((vecCoordinate.first >= 0) && (vecCoordinate.first < rasterView.getXSize())) &&
+               ((vecCoordinate.second >= 0) && (vecCoordinate.second < rasterView.getYSize()));
     }
 
     /**
@@ -66,4 +67,74 @@ namespace mempa
     {
         return std::pair<int, int>(globalCoordinate.first - buffer, globalCoordinate.second - buffer);
     }
+
+    /**
+     * @brief Predict where the next chunk will be centered before the current step is planned.
+     *
+     * @details An unobstructed step ends on the chunk cell closest to the goal, so that is the first guess. If the last guess missed, the rover is detouring around something, so the previous step is repeated instead.
+     *
+     * @param chunk The chunk being planned on.
+     * @param lastStep Displacement made by the previous step. (0, 0) before the first step.
+     * @param lastPredictionHit Whether the previous prediction was right.
+     * @return std::pair<int, int> Predicted image coordinate of the next chunk center.
+     */
+    inline std::pair<int, int> RoverSimulator::predictNextCenter(const ElevationView &chunk, const std::pair<int, int> lastStep, const bool lastPredictionHit) const noexcept
+    {
+        const std::pair<int, int> origin = chunk.getOrigin(); /* Top left of the chunk in global coordinates. */
+        const std::pair<int, int> target = (lastPredictionHit || lastStep == std::pair<int, int>(0, 0))
+                                               ? goalPosition
+                                               : std::pair<int, int>(currentPosition.first + lastStep.first, currentPosition.second + lastStep.second);
+        return std::pair<int, int>(std::clamp(target.first, origin.first, origin.first + chunk.getXSize() - 1),
+                                   std::clamp(target.second, origin.second, origin.second + chunk.getYSize() - 1));
+    }
+
+    /**
+     * @brief Enable or disable reading the predicted next chunk on a background thread.
+     *
+     * @param enabled Whether to prefetch.
+     */
+    inline void RoverSimulator::setPrefetching(const bool enabled) noexcept
+    {
+        prefetchChunks = enabled;
+    }
+
+    /**
+     * @brief Check slopes against precomputed codes instead of in the search.
+     *
+     * @param slopeCodes Step slopes covering the whole DEM, computed with the DEM's image resolution, or nullptr to let the search check slopes itself.
+     */
+    inline void RoverSimulator::setSlopeRaster(const SlopeRaster *const slopeCodes) noexcept
+    {
+        edgeSlopes = slopeCodes;
+    }
+
+    /**
+     * @brief Get the prefetch totals from the last call to runSimulator.
+     *
+     * @return const PrefetchStats&
+     */
+    inline const PrefetchStats &RoverSimulator::getPrefetchStats() const noexcept
+    {
+        return prefetchStats;
+    }
+
+    /**
+     * @brief Get the sliding chunk totals from the last call to runSimulator. Empty when prefetching was on.
+     *
+     * @return const SlidingStats&
+     */
+    inline const SlidingStats &RoverSimulator::getSlidingStats() const noexcept
+    {
+        return slidingStats;
+    }
+
+    /**
+     * @brief Get the number of cells the search algorithm expanded over the last call to runSimulator.
+     *
+     * @return std::size_t Expansions summed over every step.
+     */
+    inline std::size_t RoverSimulator::getSearchExpansions() const noexcept
+    {
+        return searchExpansions;
+    }
 }
@@ -0,0 +1,243 @@
+/* Local Header */
+#include "SlidingChunk.hpp"
+
+/* C++ Standard Libraries */
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace mempa
+{
+    /**
+     * @brief Construct a new SlidingChunk.
+     *
+     * @param elevationRaster Handler to read from. Must outlive the chunk, and its quantized storage setting must not change while the chunk is used.
+     * @param buffer Cells on each side of the center, as for DemHandler::readSquareChunk.
+     */
+    SlidingChunk::SlidingChunk(const DemHandler *const elevationRaster, const int buffer) noexcept
+        : elevationRaster(elevationRaster), buffer(buffer), quantized(elevationRaster->isQuantizedStorage())
+    {
+    }
+
+    /**
+     * @brief Move the chunk to a new center, reusing every cell it shares with the previous chunk.
+     *
+     * @param center Image coordinate to center the chunk on.
+     * @param relativeCoordinate Optional parameter to reflect the local vector index of the center.
+     * @return ElevationView The chunk, holding the same values DemHandler::readSquareChunk would return, or their codes when quantized. Valid until the next call.
+     *
+     * @throws Failure to read raster values.
+     */
+    ElevationView SlidingChunk::moveTo(const std::pair<int, int> center, std::pair<int, int> *relativeCoordinate)
+    {
+        /* Bounds of the new chunk, clipped like readSquareChunk. */
+        const int xOff = std::max(0, center.first - buffer);
+        const int yOff = std::max(0, center.second - buffer);
+        const int xEnd = std::min(elevationRaster->getXSize(), center.first + buffer + 1);
+        const int yEnd = std::min(elevationRaster->getYSize(), center.second + buffer + 1);
+        ++stats.requests;
+        stats.cellsServed += static_cast<std::size_t>(xEnd - xOff) * (yEnd - yOff);
+        if (relativeCoordinate != nullptr)
+        {
+            *relativeCoordinate = std::pair<int, int>(center.first - xOff, center.second - yOff);
+        }
+
+        if (quantized)
+        {
+            slide(codeChunk, xOff, yOff, xEnd, yEnd);
+            return ElevationView(codeChunk.view(), codec, codeError);
+        }
+        slide(chunk, xOff, yOff, xEnd, yEnd);
+        return chunk.view();
+    }
+
+    /**
+     * @brief Move a chunk to new bounds, shifting the cells it shares with its old bounds and reading the rest.
+     *
+     * @param current Chunk to move, floats or codes.
+     * @param xOff Left X offset of the new bounds.
+     * @param yOff Top Y offset of the new bounds.
+     * @param xEnd Right X offset of the new bounds, exclusive.
+     * @param yEnd Bottom Y offset of the new bounds, exclusive.
+     *
+     * @throws Failure to read raster values.
+     */
+    template <typename T>
+    void SlidingChunk::slide(Raster2D<T> &current, const int xOff, const int yOff, const int xEnd, const int yEnd)
+    {
+        const int xSize = xEnd - xOff;
+        const int ySize = yEnd - yOff;
+
+        /* Part of the previous chunk that is still inside the new one. */
+        const std::pair<int, int> oldOrigin = current.getOrigin();
+        const int keepXOff = std::max(xOff, oldOrigin.first);
+        const int keepYOff = std::max(yOff, oldOrigin.second);
+        const int keepXEnd = std::min(xEnd, oldOrigin.first + current.getXSize());
+        const int keepYEnd = std::min(yEnd, oldOrigin.second + current.getYSize());
+        bool shares = !current.empty() && keepXOff < keepXEnd && keepYOff < keepYEnd; /* Whether the shared block can be kept. */
+        if constexpr (std::is_same_v<T, std::int16_t>)
+        {
+            shares = shares && codecSuits(keepXOff, keepYOff, keepXEnd, keepYEnd, xOff, yOff, xEnd, yEnd);
+        }
+        if (!shares)
+        {
+            current = readRectangle<T>(xOff, yOff, xEnd, yEnd, true);
+            ++stats.fullReads;
+            stats.cellsRead += static_cast<std::size_t>(xSize) * ySize;
+            return;
+        }
+
+        const std::size_t keepCols = static_cast<std::size_t>(keepXEnd - keepXOff); /* Width of the shared block. */
+        if (xSize == current.getXSize() && ySize == current.getYSize())
+        {
+            /* Same shape, so shift the shared block in place. Walk rows away from the direction of travel so no row is overwritten before it is moved. */
+            const int oldYOff = oldOrigin.second;
+            const int oldXOff = oldOrigin.first;
+            const bool movedDown = yOff >= oldYOff;
+            for (int step = 0; step < keepYEnd - keepYOff; ++step)
+            {
+                const int row = movedDown ? keepYOff + step : keepYEnd - 1 - step; /* Global row being moved. */
+                const T *const source = current.data() + static_cast<std::size_t>(row - oldYOff) * xSize + (keepXOff - oldXOff);
+                T *const destination = current.data() + static_cast<std::size_t>(row - yOff) * xSize + (keepXOff - xOff);
+                std::memmove(destination, source, keepCols * sizeof(T));
+            }
+            current.setOrigin(std::pair<int, int>(xOff, yOff));
+        }
+        else
+        {
+            /* The chunk crossed a raster edge and changed shape, so copy the shared block into a new one. */
+            Raster2D<T> resized(xSize, ySize, std::pair<int, int>(xOff, yOff)); /* Chunk at its new shape. */
+            for (int row = keepYOff; row < keepYEnd; ++row)
+            {
+                const T *const source = current.data() + static_cast<std::size_t>(row - oldOrigin.second) * current.getXSize() + (keepXOff - oldOrigin.first);
+                std::copy(source, source + keepCols, resized.data() + static_cast<std::size_t>(row - yOff) * xSize + (keepXOff - xOff));
+            }
+            current = std::move(resized);
+        }
+
+        /* Read the strips the move uncovered: full-width bands above and below, then the sides of the shared block. */
+        readStrip(current, xOff, yOff, xEnd, keepYOff);
+        readStrip(current, xOff, keepYEnd, xEnd, yEnd);
+        readStrip(current, xOff, keepYOff, keepXOff, keepYEnd);
+        readStrip(current, keepXEnd, keepYOff, xEnd, keepYEnd);
+    }
+
+    /**
+     * @brief Check whether the codes of the shared block and the codec can be kept for a new chunk.
+     *
+     * @param keepXOff Left X offset of the shared block.
+     * @param keepYOff Top Y offset of the shared block.
+     * @param keepXEnd Right X offset of the shared block, exclusive.
+     * @param keepYEnd Bottom Y offset of the shared block, exclusive.
+     * @param xOff Left X offset of the new chunk.
+     * @param yOff Top Y offset of the new chunk.
+     * @param xEnd Right X offset of the new chunk, exclusive.
+     * @param yEnd Bottom Y offset of the new chunk, exclusive.
+     * @return true The codec still suits the new chunk's elevations, allowing it twice the slack a newly fitted chunk gets so that it is not refitted on every move.
+     * @return false The chunk has to be read whole with a new codec.
+     *
+     * @throws Failure to read raster values.
+     */
+    bool SlidingChunk::codecSuits(const int keepXOff, const int keepYOff, const int keepXEnd, const int keepYEnd, const int xOff, const int yOff, const int xEnd, const int yEnd) const
+    {
+        /* Codes grow with elevation, so the shared block's range comes from its extreme codes. */
+        const std::pair<int, int> origin = codeChunk.getOrigin();
+        int lowest = DemTile::MAX_CODE + 1;
+        int highest = -DemTile::MAX_CODE - 1;
+        for (int row = keepYOff; row < keepYEnd; ++row)
+        {
+            const std::int16_t *const codes = codeChunk.data() + static_cast<std::size_t>(row - origin.second) * codeChunk.getXSize() - origin.first;
+            for (int col = keepXOff; col < keepXEnd; ++col)
+            {
+                if (codes[col] != DemTile::NAN_CODE)
+                {
+                    lowest = std::min(lowest, static_cast<int>(codes[col]));
+                    highest = std::max(highest, static_cast<int>(codes[col]));
+                }
+            }
+        }
+        double minimum = lowest <= highest ? codec.decode(static_cast<std::int16_t>(lowest)) : std::numeric_limits<double>::infinity();
+        double maximum = lowest <= highest ? codec.decode(static_cast<std::int16_t>(highest)) : -std::numeric_limits<double>::infinity();
+
+        /* The strips readStrip will fill: full-width bands above and below, then the sides of the shared block. */
+        const int strips[4][4] = {{xOff, yOff, xEnd, keepYOff}, {xOff, keepYEnd, xEnd, yEnd}, {xOff, keepYOff, keepXOff, keepYEnd}, {keepXEnd, keepYOff, xEnd, keepYEnd}};
+        for (const auto &strip : strips)
+        {
+            if (strip[0] < strip[2] && strip[1] < strip[3])
+            {
+                const std::pair<double, double> range = elevationRaster->getElevationRange({{strip[0], strip[1]}, {strip[2] - 1, strip[3] - 1}}, 0);
+                minimum = std::min(minimum, range.first);
+                maximum = std::max(maximum, range.second);
+            }
+        }
+        return codec.suits(minimum, maximum, 2.0f * ElevationCodec::REUSE_SLACK);
+    }
+
+    /**
+     * @brief Read a rectangle of the raster as floats or as codes.
+     *
+     * @details A whole quantized chunk gets a codec of its own, which replaces the chunk codec, and a strip is encoded with the chunk codec.
+     *
+     * @param xOff Left X offset of the rectangle.
+     * @param yOff Top Y offset of the rectangle.
+     * @param xEnd Right X offset of the rectangle, exclusive.
+     * @param yEnd Bottom Y offset of the rectangle, exclusive.
+     * @param whole Whether the rectangle is the whole chunk.
+     * @return Raster2D<T> The rectangle, with its origin at (xOff, yOff).
+     *
+     * @throws Failure to read raster values.
+     */
+    template <typename T>
+    Raster2D<T> SlidingChunk::readRectangle(const int xOff, const int yOff, const int xEnd, const int yEnd, const bool whole)
+    {
+        const std::pair<std::pair<int, int>, std::pair<int, int>> corners({xOff, yOff}, {xEnd - 1, yEnd - 1}); /* Inclusive corners of the rectangle. */
+        if constexpr (std::is_same_v<T, std::int16_t>)
+        {
+            ElevationChunk rectangle = whole ? elevationRaster->readQuantizedChunk(corners, 0) : elevationRaster->readQuantizedChunk(corners, 0, codec);
+            if (whole)
+            {
+                codec = rectangle.getCodec();
+                codeError = 0.0f;
+            }
+            codeError = std::max(codeError, rectangle.getMaxError());
+            return std::move(rectangle.getCodes());
+        }
+        else
+        {
+            return elevationRaster->readRectangleChunk(corners, 0);
+        }
+    }
+
+    /**
+     * @brief Read a rectangle of the raster into the matching cells of a chunk.
+     *
+     * @param destination Chunk to fill. Must contain the rectangle.
+     * @param xOff Left X offset of the rectangle.
+     * @param yOff Top Y offset of the rectangle.
+     * @param xEnd Right X offset of the rectangle, exclusive.
+     * @param yEnd Bottom Y offset of the rectangle, exclusive.
+     *
+     * @throws Failure to read raster values.
+     */
+    template <typename T>
+    void SlidingChunk::readStrip(Raster2D<T> &destination, const int xOff, const int yOff, const int xEnd, const int yEnd)
+    {
+        if (xOff >= xEnd || yOff >= yEnd)
+        {
+            return;
+        }
+
+        const Raster2D<T> strip = readRectangle<T>(xOff, yOff, xEnd, yEnd, false); /* Newly exposed cells. */
+        const std::pair<int, int> origin = destination.getOrigin();
+        for (int row = 0; row < strip.getYSize(); ++row)
+        {
+            const T *const source = strip.data() + static_cast<std::size_t>(row) * strip.getXSize();
+            std::copy(source, source + strip.getXSize(), destination.data() + static_cast<std::size_t>(yOff + row - origin.second) * destination.getXSize() + (xOff - origin.first));
+        }
+        stats.cellsRead += static_cast<std::size_t>(strip.getXSize()) * strip.getYSize();
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+/* mempa::DemHandler */
+#include "../dem-handler/DemHandler.hpp"
+
+/* mempa::Raster2D */
+#include "../dem-handler/Raster2D.hpp"
+
+/* mempa::ElevationView */
+#include "../dem-handler/ElevationView.hpp"
+
+/* C++ Standard Libraries */
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace mempa
+{
+    /**
+     * @brief How much raster I/O the sliding chunk saved.
+     */
+    struct SlidingStats
+    {
+        std::size_t requests = 0;    /* Chunks the simulator asked for. */
+        std::size_t fullReads = 0;   /* Requests that shared nothing with the previous chunk. */
+        std::size_t cellsServed = 0; /* Cells in every chunk handed out. */
+        std::size_t cellsRead = 0;   /* Cells read from the DemHandler to build them. */
+    };
+
+    /**
+     * @brief Square chunk around the rover that slides with it, reading only the strips uncovered by each move.
+     *
+     * @details Consecutive chunks overlap almost entirely, so the cells they share are shifted in place and only the newly exposed rows and columns are read from the DemHandler. The chunk stays one contiguous row-major block, so the search sees it through the same view as a freshly read chunk. Near the raster edges the chunk is clipped exactly like DemHandler::readSquareChunk.
+     *
+     * When the handler stores quantized tiles, the chunk holds codes instead of floats, with a codec fitted when it was last read whole. Strips are encoded with that codec, so the codes shifted along stay valid. Once the new chunk's elevations no longer suit it, by falling outside its range or needing a codec more than twice as fine as it allows for, the chunk is read whole again with a new codec rather than re-encoding the shifted codes, whose rounding would otherwise stack up move after move.
+     */
+    class SlidingChunk
+    {
+    private:
+        const DemHandler *elevationRaster; /* Handler to read strips from. */
+        const int buffer;                  /* Cells on each side of the center. */
+        const bool quantized;              /* Whether the chunk holds codes rather than floats, fixed at construction. */
+        ElevationCodec codec;              /* Offset and scale of the codes when quantized. */
+        float codeError = 0.0f;            /* Largest error of any cell of the quantized chunk. */
+        Raster2D<float> chunk;             /* Current chunk when not quantized. Empty before the first request. */
+        Raster2D<std::int16_t> codeChunk;  /* Current chunk when quantized. Empty before the first request. */
+        SlidingStats stats;                /* Running totals. */
+
+        template <typename T>
+        void slide(Raster2D<T> &current, int xOff, int yOff, int xEnd, int yEnd);
+        bool codecSuits(int keepXOff, int keepYOff, int keepXEnd, int keepYEnd, int xOff, int yOff, int xEnd, int yEnd) const;
+        template <typename T>
+        Raster2D<T> readRectangle(int xOff, int yOff, int xEnd, int yEnd, bool whole);
+        template <typename T>
+        void readStrip(Raster2D<T> &destination, int xOff, int yOff, int xEnd, int yEnd);
+
+    protected:
+        /* SlidingChunk is not designed to be subclassed. */
+
+    public:
+        explicit SlidingChunk(const DemHandler *elevationRaster, int buffer) noexcept;
+
+        ElevationView moveTo(std::pair<int, int> center, std::pair<int, int> *relativeCoordinate = nullptr);
+        inline const SlidingStats &getStats() const noexcept;
+    };
+}
+
+#include "SlidingChunk.inl"
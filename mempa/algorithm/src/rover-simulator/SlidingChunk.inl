@@ -0,0 +1,15 @@
+/* Local Header */
+#include "SlidingChunk.hpp"
+
+namespace mempa
+{
+    /**
+     * @brief Get the running I/O totals.
+     *
+     * @return const SlidingStats&
+     */
+    inline const SlidingStats &SlidingChunk::getStats() const noexcept
+    {
+        return stats;
+    }
+}
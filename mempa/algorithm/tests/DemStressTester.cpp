@@ -0,0 +1,114 @@
+#include "../src/dem-handler/DemHandler.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Hammers one DemHandler from many threads at once and checks every value
+// against a single-threaded read of the same coordinates.
+
+namespace {
+constexpr int DEFAULT_THREADS = 8;
+constexpr int READS_PER_THREAD = 200;
+constexpr int CHUNK_BUFFER = 40;
+constexpr std::size_t SMALL_CACHE_BYTES = static_cast<std::size_t>(1) << 20;
+
+struct ChunkRequest {
+  std::pair<int, int> center;
+  std::vector<float> expected;
+};
+
+std::vector<float> flatten(const mempa::Raster2D<float> &chunk) {
+  return std::vector<float>(chunk.data(),
+                            chunk.data() + static_cast<std::size_t>(
+                                               chunk.getXSize()) *
+                                               chunk.getYSize());
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " <DEM Filepath> [Thread Count]\n";
+    return 1;
+  }
+  const char *demFilepath = argv[1];
+  const int threadCount = argc == 3 ? std::stoi(argv[2]) : DEFAULT_THREADS;
+
+  try {
+    // Expected values come from a separate handler used by one thread only
+    mempa::DemHandler referenceRaster(demFilepath);
+    std::mt19937 generator(2024);
+    std::uniform_int_distribution<int> xDistribution(
+        0, referenceRaster.getXSize() - 1);
+    std::uniform_int_distribution<int> yDistribution(
+        0, referenceRaster.getYSize() - 1);
+
+    std::vector<std::vector<ChunkRequest>> requests(threadCount);
+    for (std::vector<ChunkRequest> &threadRequests : requests) {
+      for (int i = 0; i < READS_PER_THREAD; ++i) {
+        const std::pair<int, int> center(xDistribution(generator),
+                                         yDistribution(generator));
+        threadRequests.push_back(
+            {center, flatten(referenceRaster.readSquareChunk(center,
+                                                             CHUNK_BUFFER))});
+      }
+    }
+
+    // A small cache keeps threads evicting tiles out from under each other
+    mempa::DemHandler sharedRaster(demFilepath);
+    sharedRaster.setTileCacheCapacity(SMALL_CACHE_BYTES);
+
+    std::atomic<int> mismatches{0};
+    std::atomic<int> failures{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; ++t) {
+      workers.emplace_back([&, t]() {
+        try {
+          for (const ChunkRequest &request : requests[t]) {
+            const mempa::Raster2D<float> chunk =
+                sharedRaster.readSquareChunk(request.center, CHUNK_BUFFER);
+            if (flatten(chunk) != request.expected) {
+              ++mismatches;
+            }
+            const std::pair<int, int> origin = chunk.getOrigin();
+            if (sharedRaster.getValue(request.center.first,
+                                      request.center.second) !=
+                chunk[request.center.second - origin.second]
+                     [request.center.first - origin.first]) {
+              ++mismatches;
+            }
+          }
+        } catch (const std::exception &readError) {
+          std::cerr << "Thread " << t << ": " << readError.what() << "\n";
+          ++failures;
+        }
+      });
+    }
+    for (std::thread &worker : workers) {
+      worker.join();
+    }
+
+    std::cout << "Concurrent reads: " << threadCount << " threads x "
+              << READS_PER_THREAD << " chunks, " << mismatches
+              << " mismatches, " << failures << " failures\n";
+    std::cout << "Tile cache hits: " << sharedRaster.getCacheHits()
+              << ", misses: " << sharedRaster.getCacheMisses() << "\n";
+    assert(mismatches == 0 && "concurrent reads returned wrong values");
+    assert(failures == 0 && "concurrent reads threw");
+    if (mismatches != 0 || failures != 0) {
+      return 1;
+    }
+  } catch (const std::exception &demError) {
+    std::cerr << "Error: " << demError.what() << "\n";
+    return 1;
+  }
+
+  std::cout << "All DEM stress tests PASSED!" << std::endl;
+  return 0;
+}
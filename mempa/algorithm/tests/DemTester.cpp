@@ -1,18 +1,31 @@
 #include "../src/dem-handler/DemHandler.hpp"
+#include "../src/dem-handler/SourceKey.hpp"
+#include "../src/hierarchical-planner/HierarchicalPlanner.hpp"
+#include "../src/hierarchical-planner/ContractionHierarchy.hpp"
 #include "../src/rover-pathfinding-module/SearchAlgorithm.hpp"
+#include "../src/rover-pathfinding-module/AStar.hpp"
 #include "../src/rover-pathfinding-module/NewDijkstras.hpp"
 #include "../src/rover-simulator/RoverSimulator.hpp"
+#include "../src/rover-simulator/SlidingChunk.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
 
 #define BASIC_DEMTEST true
 #define BASIC_SIMTEST true
+#define BASIC_HPATEST true
+#define BASIC_CHTEST true
 
 int main(int argc, char *argv[]) {
   if (argc != 3) {
@@ -42,20 +55,193 @@ int main(int argc, char *argv[]) {
         imageCoordinates, imageCoordinates2);
 
     // Read the elevation chunk
-    std::vector<std::vector<float>> elevationDataChunk =
+    const mempa::Raster2D<float> elevationDataChunk =
         marsRaster.readRectangleChunk(rectCoordinates, chunkSize);
 
+    // Batched sampling must agree with the chunk read
+    const std::pair<int, int> chunkOrigin = elevationDataChunk.getOrigin();
+    std::vector<std::pair<int, int>> samplePoints;
+    std::vector<std::pair<double, double>> interpolatedPoints;
+    for (int row = 0; row < elevationDataChunk.getYSize(); row += 3) {
+      for (int col = 0; col < elevationDataChunk.getXSize(); col += 7) {
+        samplePoints.emplace_back(chunkOrigin.first + col,
+                                  chunkOrigin.second + row);
+        interpolatedPoints.emplace_back(chunkOrigin.first + col,
+                                        chunkOrigin.second + row);
+      }
+    }
+    std::vector<float> sampledValues;
+    std::vector<float> interpolatedValues;
+    marsRaster.getValues(samplePoints, sampledValues);
+    marsRaster.getInterpolatedValues(interpolatedPoints, interpolatedValues);
+    for (size_t i = 0; i < samplePoints.size(); ++i) {
+      const float chunkValue =
+          elevationDataChunk[samplePoints[i].second - chunkOrigin.second]
+                            [samplePoints[i].first - chunkOrigin.first];
+      assert(sampledValues[i] == chunkValue && "getValues mismatch");
+      assert(interpolatedValues[i] == chunkValue &&
+             "getInterpolatedValues mismatch at a pixel center");
+    }
+
     // Ensure pixel resolution is 200
     const double sizetest = marsRaster.getImageResolution();
     std::cout << "Image resoluation: " << sizetest;
 
+    // Reduced resolution levels halve the raster
+    const int coarseLevel = 1;
+    assert(marsRaster.getXSize(coarseLevel) ==
+           (marsRaster.getXSize() + 1) / 2);
+    assert(marsRaster.getYSize(coarseLevel) ==
+           (marsRaster.getYSize() + 1) / 2);
+    const std::pair<int, int> coarseCoordinates(imageCoordinates.first / 2,
+                                                imageCoordinates.second / 2);
+    const mempa::Raster2D<float> coarseChunk = marsRaster.readSquareChunk(
+        coarseCoordinates, chunkSize, nullptr, coarseLevel);
+    assert(!coarseChunk.empty() && "coarse level read failed");
+
+    // Statistics cover every valid value, and a second handler gets the same
+    // ones back from the sidecar
+    for (int row = 0; row < elevationDataChunk.getYSize(); ++row) {
+      for (int col = 0; col < elevationDataChunk.getXSize(); ++col) {
+        const float value = elevationDataChunk[row][col];
+        assert((std::isnan(value) ||
+                (value >= marsRaster.getMinElevation() &&
+                 value <= marsRaster.getMaxElevation())) &&
+               "value outside the raster statistics");
+      }
+    }
+    const mempa::DemHandler reopenedRaster(demFilepath);
+    assert(reopenedRaster.getMinElevation() == marsRaster.getMinElevation());
+    assert(reopenedRaster.getMaxElevation() == marsRaster.getMaxElevation());
+
+    // Quantized tiles must stay within the reported error of the float tiles
+    mempa::DemHandler quantizedRaster(demFilepath);
+    quantizedRaster.setQuantizedStorage(true);
+    const mempa::Raster2D<float> quantizedChunk =
+        quantizedRaster.readRectangleChunk(rectCoordinates, chunkSize);
+    const float quantizationError = quantizedRaster.getMaxQuantizationError();
+    for (int row = 0; row < quantizedChunk.getYSize(); ++row) {
+      for (int col = 0; col < quantizedChunk.getXSize(); ++col) {
+        const float expected = elevationDataChunk[row][col];
+        const float actual = quantizedChunk[row][col];
+        assert((std::isnan(expected)
+                    ? std::isnan(actual)
+                    : std::abs(actual - expected) <= quantizationError) &&
+               "quantized value outside the reported error");
+      }
+    }
+
+    // Quantized chunks get a codec fitted to their own range and stay within
+    // their reported error of the float values
+    const mempa::ElevationChunk codeChunk =
+        quantizedRaster.readQuantizedChunk(rectCoordinates, chunkSize);
+    const mempa::ElevationView codeView = codeChunk.view();
+    const std::pair<double, double> chunkRange =
+        quantizedRaster.getElevationRange(rectCoordinates, chunkSize);
+    assert(codeView.isQuantized() &&
+           codeView.getXSize() == elevationDataChunk.getXSize() &&
+           codeView.getYSize() == elevationDataChunk.getYSize());
+    assert(codeView.getCodec().suits(chunkRange.first, chunkRange.second) &&
+           "chunk codec not fitted to the chunk");
+    for (int row = 0; row < codeView.getYSize(); ++row) {
+      for (int col = 0; col < codeView.getXSize(); ++col) {
+        const float expected = elevationDataChunk[row][col];
+        const float actual = codeView.at(col, row);
+        assert((std::isnan(expected)
+                    ? std::isnan(actual)
+                    : std::abs(actual - expected) <= codeView.getMaxError()) &&
+               "chunk code outside the reported error");
+      }
+    }
+
+    // A sliding quantized chunk stays within its reported error as it moves,
+    // and keeps its codec over short moves rather than being read whole
+    const int slidingBuffer = 40;
+    const int moves = 12;
+    mempa::SlidingChunk slidingCodes(&quantizedRaster, slidingBuffer);
+    for (int move = 0; move < moves; ++move) {
+      const std::pair<int, int> center(imageCoordinates.first + 7 * move,
+                                       imageCoordinates.second + 3 * move);
+      const mempa::ElevationView slid = slidingCodes.moveTo(center);
+      const mempa::Raster2D<float> expectedChunk =
+          marsRaster.readSquareChunk(center, slidingBuffer);
+      assert(slid.getXSize() == expectedChunk.getXSize() &&
+             slid.getYSize() == expectedChunk.getYSize());
+      for (int row = 0; row < slid.getYSize(); ++row) {
+        for (int col = 0; col < slid.getXSize(); ++col) {
+          const float expected = expectedChunk[row][col];
+          const float actual = slid.at(col, row);
+          assert((std::isnan(expected)
+                      ? std::isnan(actual)
+                      : std::abs(actual - expected) <= slid.getMaxError()) &&
+                 "sliding chunk code outside the reported error");
+        }
+      }
+    }
+    assert(slidingCodes.getStats().fullReads < static_cast<std::size_t>(moves) &&
+           "sliding quantized chunk refitted on every move");
+
+    // A mosaic of the DEM listed twice must read the same values, with
+    // nodata turned into NaN
+    const std::string demPath = demFilepath;
+    const std::string manifestPath = demPath + ".mosaic";
+    {
+      const std::string demName = demPath.substr(demPath.rfind('/') + 1);
+      std::ofstream manifest(manifestPath);
+      manifest << "# Test mosaic\n" << demName << "\n" << demName << "\n";
+    }
+    const mempa::DemHandler mosaicRaster(manifestPath.c_str());
+
+    // A mosaic's sidecars are keyed on its members, not the manifest alone
+    std::uint64_t demKeySize = 0;
+    std::int64_t demKeyModified = 0;
+    std::uint64_t mosaicKeySize = 0;
+    std::int64_t mosaicKeyModified = 0;
+    assert(mempa::getSourceKey(demFilepath, demKeySize, demKeyModified));
+    assert(mempa::getSourceKey(manifestPath.c_str(), mosaicKeySize,
+                               mosaicKeyModified));
+    assert(mosaicKeySize == 2 * demKeySize &&
+           "mosaic key must total its members' sizes");
+    {
+      const std::string demName = demPath.substr(demPath.rfind('/') + 1);
+      std::ofstream manifest(manifestPath);
+      manifest << demName << "\n";
+    }
+    std::uint64_t singleKeySize = 0;
+    std::int64_t singleKeyModified = 0;
+    assert(mempa::getSourceKey(manifestPath.c_str(), singleKeySize,
+                               singleKeyModified));
+    assert(singleKeySize == demKeySize &&
+           singleKeyModified != mosaicKeyModified &&
+           "mosaic key must change with its members");
+    std::remove(manifestPath.c_str());
+    assert(mosaicRaster.getMosaic() != nullptr &&
+           mosaicRaster.getMosaic()->getFileCount() == 2);
+    assert(mosaicRaster.getXSize() == marsRaster.getXSize() &&
+           mosaicRaster.getYSize() == marsRaster.getYSize());
+    const mempa::Raster2D<float> mosaicChunk =
+        mosaicRaster.readRectangleChunk(rectCoordinates, chunkSize);
+    const mempa::DemMetadata &demMetadata = marsRaster.getMetadata();
+    for (int row = 0; row < mosaicChunk.getYSize(); ++row) {
+      for (int col = 0; col < mosaicChunk.getXSize(); ++col) {
+        const float expected = elevationDataChunk[row][col];
+        const bool missing = std::isnan(expected) ||
+                             (demMetadata.hasNoDataValue() &&
+                              expected == static_cast<float>(
+                                              demMetadata.getNoDataValue()));
+        assert((missing ? std::isnan(mosaicChunk[row][col])
+                        : mosaicChunk[row][col] == expected) &&
+               "mosaic value differs from the single raster");
+      }
+    }
+
     const char *ci_env = std::getenv("CI");
     if (!ci_env) // If CI variable is not set
     {
       constexpr int lineWidth = 5;
-      for (std::vector<float> elevationDataRow : elevationDataChunk) {
-        for (float elevationDataValue : elevationDataRow) {
-          std::cout << std::setw(lineWidth) << elevationDataValue;
+      for (int row = 0; row < elevationDataChunk.getYSize(); ++row) {
+        for (int col = 0; col < elevationDataChunk.getXSize(); ++col) {
+          std::cout << std::setw(lineWidth) << elevationDataChunk[row][col];
         }
         std::cout << "\n";
       }
@@ -107,5 +293,288 @@ int main(int argc, char *argv[]) {
   }
 #endif
 
+#if BASIC_HPATEST
+  try {
+    mempa::DemHandler marsRaster(demFilepath);
+    const int xSize = marsRaster.getXSize();
+    const int ySize = marsRaster.getYSize();
+
+    // The graph covers the whole DEM, so only build it for test-sized DEMs
+    constexpr long long maxGraphCells = 4096LL * 4096LL;
+    if (static_cast<long long>(xSize) * ySize > maxGraphCells) {
+      std::cout << "Skipping hierarchical test: DEM too large to build its "
+                   "cluster graph quickly\n";
+    } else {
+      const std::string graphPath =
+          mempa::ClusterGraph::sidecarPathFor(demFilepath);
+      std::remove(graphPath.c_str());
+
+      constexpr float maxSlope = 35.0f;
+      const float pixelSize =
+          static_cast<float>(marsRaster.getImageResolution());
+      const auto checkRoute = [&](const std::vector<std::pair<int, int>> &route,
+                                  std::pair<int, int> start,
+                                  std::pair<int, int> goal) {
+        assert(!route.empty() && route.front() == start &&
+               route.back() == goal && "route must join start and goal");
+        double cost = 0.0;
+        for (std::size_t i = 1; i < route.size(); ++i) {
+          const int dx = route[i].first - route[i - 1].first;
+          const int dy = route[i].second - route[i - 1].second;
+          assert(std::abs(dx) <= 1 && std::abs(dy) <= 1 && (dx || dy) &&
+                 "route steps must be to neighbouring cells");
+          double stepCost = 0.0;
+          const bool navigable = mempa::ClusterGraph::stepCost(
+              marsRaster.getValue(route[i - 1].first, route[i - 1].second),
+              marsRaster.getValue(route[i].first, route[i].second), dx && dy,
+              maxSlope, pixelSize, stepCost);
+          assert(navigable && "route steps must be within the slope limit");
+          cost += stepCost;
+        }
+        return cost;
+      };
+
+      // Building the graph saves it next to the DEM
+      mempa::HierarchicalPlanner builtPlanner(&marsRaster, demFilepath,
+                                              maxSlope);
+      assert(!builtPlanner.getStats().graphLoaded);
+      const std::pair<int, int> start(xSize / 8, ySize / 8);
+      const std::pair<int, int> goal(xSize * 7 / 8, ySize * 6 / 8);
+      const std::vector<std::pair<int, int>> route =
+          builtPlanner.plan(start, goal);
+      checkRoute(route, start, goal);
+
+      // A short route must come close to A* over a window around it, which
+      // can only be as cheap as the best route anywhere
+      const std::pair<int, int> nearStart(xSize / 4, ySize / 4);
+      const std::pair<int, int> nearGoal(std::min(xSize - 1, xSize / 4 + 300),
+                                         std::min(ySize - 1, ySize / 4 + 200));
+      const double hierarchicalCost = checkRoute(
+          builtPlanner.plan(nearStart, nearGoal), nearStart, nearGoal);
+      const mempa::Raster2D<float> window =
+          marsRaster.readRectangleChunk({nearStart, nearGoal}, 64);
+      AStar windowSearch;
+      const std::vector<std::pair<int, int>> windowRoute =
+          windowSearch.get_step(window.view(), window.getOrigin(), nearStart,
+                                nearGoal, maxSlope, pixelSize);
+      if (!windowRoute.empty()) {
+        const double windowCost = checkRoute(windowRoute, nearStart, nearGoal);
+        assert(hierarchicalCost <= windowCost * 1.1 &&
+               "hierarchical route more than 10% above a full search");
+      }
+
+      // A second planner loads the same graph and plans the same route, and
+      // the sidecar is not reused for another slope limit
+      mempa::HierarchicalPlanner loadedPlanner(&marsRaster, demFilepath,
+                                               maxSlope);
+      assert(loadedPlanner.getStats().graphLoaded);
+      assert(loadedPlanner.getGraph().getEdgeCount() ==
+             builtPlanner.getGraph().getEdgeCount());
+      assert(loadedPlanner.plan(start, goal) == route);
+      mempa::ClusterGraph otherGraph;
+      assert(!otherGraph.load(demFilepath, {xSize, ySize},
+                              mempa::ClusterGraph::DEFAULT_CLUSTER_SIZE,
+                              maxSlope - 5.0f, pixelSize));
+
+      std::remove(graphPath.c_str());
+    }
+  } catch (const std::exception &hpaError) {
+    std::cerr << "Error: " << hpaError.what() << "\n";
+    return 1;
+  }
+#endif
+
+#if BASIC_CHTEST
+  try {
+    mempa::DemHandler marsRaster(demFilepath);
+    constexpr float maxSlope = 35.0f;
+    const float pixelSize =
+        static_cast<float>(marsRaster.getImageResolution());
+
+    // Contracting a whole test DEM takes too long, so build over a region
+    const std::pair<int, int> windowStart(marsRaster.getXSize() / 4,
+                                          marsRaster.getYSize() / 4);
+    const std::pair<int, int> windowEnd(
+        std::min(marsRaster.getXSize() - 1, windowStart.first + 63),
+        std::min(marsRaster.getYSize() - 1, windowStart.second + 47));
+    const mempa::Raster2D<float> window =
+        marsRaster.readRectangleChunk({windowStart, windowEnd}, 0);
+    const std::pair<int, int> windowSize(window.getXSize(), window.getYSize());
+    const std::pair<int, int> rasterSize(marsRaster.getXSize(),
+                                         marsRaster.getYSize());
+    mempa::ContractionHierarchy builtHierarchy;
+    builtHierarchy.build(marsRaster, {windowStart, windowEnd}, maxSlope,
+                         pixelSize);
+    assert(!builtHierarchy.empty());
+    assert(builtHierarchy.getOrigin() == windowStart &&
+           builtHierarchy.covers(windowEnd) &&
+           !builtHierarchy.covers({windowEnd.first + 1, windowEnd.second}));
+
+    // Routes are in DEM pixels, the window search in window pixels
+    const auto toDem = [&](const std::pair<int, int> cell) {
+      return std::make_pair(cell.first + windowStart.first,
+                            cell.second + windowStart.second);
+    };
+    const auto toWindow = [&](std::vector<std::pair<int, int>> route) {
+      for (std::pair<int, int> &cell : route) {
+        cell.first -= windowStart.first;
+        cell.second -= windowStart.second;
+      }
+      return route;
+    };
+
+    const auto routeCost = [&](const std::vector<std::pair<int, int>> &route) {
+      double cost = 0.0;
+      for (std::size_t i = 1; i < route.size(); ++i) {
+        const int dx = route[i].first - route[i - 1].first;
+        const int dy = route[i].second - route[i - 1].second;
+        assert(std::abs(dx) <= 1 && std::abs(dy) <= 1 && (dx || dy) &&
+               "route steps must be to neighbouring cells");
+        double stepCost = 0.0;
+        const bool navigable = mempa::ClusterGraph::stepCost(
+            window[route[i - 1].second][route[i - 1].first],
+            window[route[i].second][route[i].first], dx && dy, maxSlope,
+            pixelSize, stepCost);
+        assert(navigable && "route steps must be within the slope limit");
+        cost += stepCost;
+      }
+      return cost;
+    };
+
+    // Routes must cost what Dijkstra's finds over the same window
+    const std::pair<int, int> ends[][2] = {
+        {{0, 0}, {windowSize.first - 1, windowSize.second - 1}},
+        {{2, windowSize.second - 3}, {windowSize.first - 4, 1}},
+        {{windowSize.first / 2, 3},
+         {windowSize.first / 2 + 1, windowSize.second - 2}},
+        {{7, 9}, {7, 9}}};
+    mempa::ContractionHierarchy::QueryWorkspace queryWorkspace;
+    for (const auto &end : ends) {
+      NewDijkstras windowSearch;
+      const std::vector<std::pair<int, int>> windowRoute =
+          windowSearch.get_step(window.view(), {0, 0}, end[0], end[1],
+                                maxSlope, pixelSize);
+      if (windowRoute.empty() || windowRoute.back() != end[1]) {
+        continue;
+      }
+      const std::vector<std::pair<int, int>> route = toWindow(
+          builtHierarchy.route(toDem(end[0]), toDem(end[1]), queryWorkspace));
+      assert(!route.empty() && route.front() == end[0] &&
+             route.back() == end[1] && "route must join start and goal");
+      const double windowCost = routeCost(windowRoute);
+      assert(std::abs(routeCost(route) - windowCost) <= windowCost * 1e-4 &&
+             "contraction route must cost the same as Dijkstra's");
+    }
+
+    // The saved hierarchy loads back for the same settings only
+    const std::string hierarchyPath =
+        mempa::ContractionHierarchy::sidecarPathFor(demFilepath);
+    builtHierarchy.save(demFilepath);
+    mempa::ContractionHierarchy loadedHierarchy;
+    assert(loadedHierarchy.load(demFilepath, rasterSize, maxSlope, pixelSize));
+    assert(loadedHierarchy.getOrigin() == windowStart);
+    assert(loadedHierarchy.getArcCount() == builtHierarchy.getArcCount());
+    assert(loadedHierarchy.getCoreCount() == builtHierarchy.getCoreCount());
+    assert(loadedHierarchy.route(toDem(ends[0][0]), toDem(ends[0][1]),
+                                 queryWorkspace) ==
+           builtHierarchy.route(toDem(ends[0][0]), toDem(ends[0][1]),
+                                queryWorkspace));
+    mempa::ContractionHierarchy otherHierarchy;
+    assert(!otherHierarchy.load(demFilepath, rasterSize, maxSlope - 5.0f,
+                                pixelSize));
+    assert(!otherHierarchy.load(demFilepath, windowSize, maxSlope, pixelSize) &&
+           "a region off the DEM must not load");
+    std::remove(hierarchyPath.c_str());
+
+    // Regions fit the whole DEM when it is small enough, otherwise a margin
+    // around the ends within the budget
+    const auto regionCells =
+        [](const std::pair<std::pair<int, int>, std::pair<int, int>> &region) {
+          return static_cast<std::size_t>(region.second.first -
+                                          region.first.first + 1) *
+                 static_cast<std::size_t>(region.second.second -
+                                          region.first.second + 1);
+        };
+    const auto wholeRegion = mempa::ContractionHierarchy::regionFor(
+        {640, 480}, {10, 10}, {20, 20}, 0);
+    assert(wholeRegion.first == std::make_pair(0, 0) &&
+           wholeRegion.second == std::make_pair(639, 479));
+    const auto wideRegion = mempa::ContractionHierarchy::regionFor(
+        {4096, 4096}, {1000, 1000}, {1100, 1050}, 0);
+    assert(wideRegion.first == std::make_pair(872, 872) &&
+           wideRegion.second == std::make_pair(1228, 1178));
+    const std::size_t regionBudget =
+        200 * 200 * mempa::ContractionHierarchy::BUILD_BYTES_PER_CELL;
+    const auto budgetRegion = mempa::ContractionHierarchy::regionFor(
+        {4096, 4096}, {1000, 1000}, {1100, 1050}, regionBudget);
+    const auto halfBudgetRegion = mempa::ContractionHierarchy::regionFor(
+        {4096, 4096}, {1000, 1000}, {1100, 1050}, regionBudget / 2);
+    assert(budgetRegion.first.first <= 1000 &&
+           budgetRegion.second.first >= 1100 &&
+           budgetRegion.second.second >= 1050 &&
+           regionCells(budgetRegion) <=
+               mempa::ContractionHierarchy::maxBuildCells(regionBudget) &&
+           regionCells(budgetRegion) > regionCells(halfBudgetRegion));
+    bool regionRefused = false;
+    try {
+      mempa::ContractionHierarchy::regionFor({4096, 4096}, {1000, 1000},
+                                             {1100, 1050}, 1000);
+    } catch (const std::invalid_argument &) {
+      regionRefused = true;
+    }
+    assert(regionRefused && "ends farther apart than the budget allows must "
+                            "be refused");
+
+    // A raster at the cap builds and one column past it is refused. Every
+    // column rises too steeply to leave, so each is a chain that contracts
+    // quickly.
+    constexpr int capColumns = 1024;
+    const int capRows = static_cast<int>(
+        mempa::ContractionHierarchy::MAX_BUILD_CELLS / capColumns);
+    mempa::Raster2D<float> ridges(capColumns + 1, capRows);
+    for (int y = 0; y < capRows; ++y) {
+      for (int x = 0; x <= capColumns; ++x) {
+        ridges[y][x] = static_cast<float>(x) * 10.0f * pixelSize;
+      }
+    }
+    bool refused = false;
+    try {
+      mempa::ContractionHierarchy oversizedHierarchy;
+      oversizedHierarchy.build(ridges.view(), maxSlope, pixelSize);
+    } catch (const std::invalid_argument &) {
+      refused = true;
+    }
+    assert(refused && "rasters past the cap must be refused");
+    refused = false;
+    try {
+      mempa::ContractionHierarchy budgetHierarchy;
+      budgetHierarchy.build(
+          ridges.view().subview(0, 0, 64, 64), maxSlope, pixelSize,
+          64 * 64 * mempa::ContractionHierarchy::BUILD_BYTES_PER_CELL - 1);
+    } catch (const std::invalid_argument &) {
+      refused = true;
+    }
+    assert(refused && "rasters past the memory budget must be refused");
+    mempa::ContractionHierarchy capHierarchy;
+    capHierarchy.build(ridges.view().subview(0, 0, capColumns, capRows),
+                       maxSlope, pixelSize);
+    const std::vector<std::pair<int, int>> columnRoute =
+        capHierarchy.route({5, 0}, {5, capRows - 1}, queryWorkspace);
+    assert(static_cast<int>(columnRoute.size()) == capRows &&
+           columnRoute.back() == std::make_pair(5, capRows - 1) &&
+           "route at the cap must follow its column");
+    bool blocked = false;
+    try {
+      capHierarchy.route({5, 0}, {6, 0}, queryWorkspace);
+    } catch (const std::runtime_error &) {
+      blocked = true;
+    }
+    assert(blocked && "route at the cap must not cross a ridge");
+  } catch (const std::exception &chError) {
+    std::cerr << "Error: " << chError.what() << "\n";
+    return 1;
+  }
+#endif
+
   return 0;
 }
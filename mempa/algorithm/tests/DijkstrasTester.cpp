@@ -1,8 +1,26 @@
 #include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
+#include "dem-handler/CoarseCostField.hpp"
+#include "dem-handler/ElevationView.hpp"
+#include "dem-handler/LandmarkTable.hpp"
+#include "dem-handler/Raster2D.hpp"
+#include "dem-handler/SlopeRaster.hpp"
+#include "rover-pathfinding-module/AStar.hpp"
+#include "rover-pathfinding-module/AltSearch.hpp"
+#include "rover-pathfinding-module/BidirectionalSearch.hpp"
+#include "rover-pathfinding-module/BucketQueueSearch.hpp"
+#include "rover-pathfinding-module/DStarLite.hpp"
+#include "rover-pathfinding-module/DeltaStepping.hpp"
+#include "rover-pathfinding-module/EdgeCostKernel.hpp"
 #include "rover-pathfinding-module/NewDijkstras.hpp"
 
 using namespace std;
@@ -80,13 +98,13 @@ void test_get_neighbor_indexs() {
 // Test 3: Test dijkstras with a simple 2x2 grid
 void test_dijkstras_simple() {
   NewDijkstras dijkstra;
-  vector<vector<float>> heightmap = {{0.0f, 0.0f}, {0.0f, 0.0f}};
+  const mempa::Raster2D<float> heightmap(2, 2, {0, 0}, 0.0f);
   pair<int, int> start = {0, 0};
   pair<int, int> end = {1, 1};
   double maxSlope = 45.0;
   double pixelSize = 200.0;
 
-  dijkstra.setHeightmap(heightmap);
+  dijkstra.setHeightmap(heightmap.view());
   dijkstra.setStartPoint(start);
   dijkstra.setEndPoint(end);
   dijkstra.setMaxSlope(maxSlope);
@@ -112,13 +130,13 @@ void test_dijkstras_simple() {
 // Test 4: Test dijkstras with invalid coordinates
 void test_dijkstras_invalid_coords() {
   NewDijkstras dijkstra;
-  vector<vector<float>> heightmap = {{0.0f, 0.0f}, {0.0f, 0.0f}};
+  const mempa::Raster2D<float> heightmap(2, 2, {0, 0}, 0.0f);
   pair<int, int> start = {0, 0};
   pair<int, int> end = {2, 2}; // Out of bounds
   double maxSlope = 45.0;
   double pixelSize = 200.0;
 
-  dijkstra.setHeightmap(heightmap);
+  dijkstra.setHeightmap(heightmap.view());
   dijkstra.setStartPoint(start);
   dijkstra.setEndPoint(end);
   dijkstra.setMaxSlope(maxSlope);
@@ -130,11 +148,910 @@ void test_dijkstras_invalid_coords() {
   assert(passed && "dijkstras_invalid_coords failed");
 }
 
+// Test 5: Routes must be least cost, checked against Bellman-Ford on a rough
+// map, and points are (x, y) on a map that is wider than it is tall
+void test_dijkstras_optimal() {
+  NewDijkstras dijkstra;
+  const int cols = 12;
+  const int rows = 9;
+  const double maxSlope = 30.0;
+  const double pixelSize = 10.0;
+  mempa::Raster2D<float> heightmap(cols, rows, {0, 0}, 0.0f);
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> heights(0.0f, 8.0f);
+  for (int row = 0; row < rows; ++row) {
+    for (int col = 0; col < cols; ++col) {
+      heightmap[row][col] = heights(rng);
+    }
+  }
+  pair<int, int> start = {1, 2};
+  pair<int, int> end = {10, 7};
+
+  dijkstra.setHeightmap(heightmap.view());
+  dijkstra.setStartPoint(start);
+  dijkstra.setEndPoint(end);
+  dijkstra.setMaxSlope(maxSlope);
+  dijkstra.setPixelSize(pixelSize);
+  vector<pair<int, int>> path = dijkstra.newDijkstras();
+
+  // Cost of a step between neighbouring (x, y) cells, or DBL_MAX if too steep
+  auto stepCost = [&](pair<int, int> from, pair<int, int> to) {
+    const bool diagonal = from.first != to.first && from.second != to.second;
+    const double rise = std::abs(heightmap[from.second][from.first] -
+                                 heightmap[to.second][to.first]);
+    if (!NewDijkstras::step_navigable(rise, diagonal, maxSlope, pixelSize)) {
+      return DBL_MAX;
+    }
+    return NewDijkstras::calculate_distance_between_nodes(diagonal, rise,
+                                                          pixelSize);
+  };
+
+  vector<double> best(rows * cols, DBL_MAX);
+  best[start.second * cols + start.first] = 0.0;
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (int y = 0; y < rows; ++y) {
+      for (int x = 0; x < cols; ++x) {
+        for (int dy = -1; dy <= 1; ++dy) {
+          for (int dx = -1; dx <= 1; ++dx) {
+            const int ny = y + dy;
+            const int nx = x + dx;
+            if ((dx == 0 && dy == 0) || nx < 0 || nx >= cols || ny < 0 ||
+                ny >= rows || best[y * cols + x] == DBL_MAX) {
+              continue;
+            }
+            const double cost = stepCost({x, y}, {nx, ny});
+            if (cost != DBL_MAX &&
+                best[y * cols + x] + cost < best[ny * cols + nx] - 1e-9) {
+              best[ny * cols + nx] = best[y * cols + x] + cost;
+              changed = true;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  bool passed = !path.empty() && path.front() == end && path.back() == start;
+  double pathCost = 0.0;
+  for (size_t i = 1; passed && i < path.size(); ++i) {
+    const double cost = stepCost(path[i], path[i - 1]);
+    passed = cost != DBL_MAX && std::abs(path[i].first - path[i - 1].first) <= 1 &&
+             std::abs(path[i].second - path[i - 1].second) <= 1;
+    pathCost += cost;
+  }
+  passed = passed && std::abs(pathCost - best[end.second * cols + end.first]) < 1e-6 &&
+           dijkstra.getExpansions() <= static_cast<size_t>(rows * cols);
+  print_test_result("dijkstras_optimal", passed);
+  assert(passed && "dijkstras_optimal failed");
+}
+
+// Cost of a route of (x, y) points over a heightmap, as the searches cost it
+double route_cost(const vector<pair<int, int>> &route,
+                  const mempa::Raster2D<float> &heightmap, double pixelSize) {
+  double cost = 0.0;
+  for (size_t i = 1; i < route.size(); ++i) {
+    const bool diagonal = route[i].first != route[i - 1].first &&
+                          route[i].second != route[i - 1].second;
+    const double rise =
+        std::abs(heightmap[route[i].second][route[i].first] -
+                 heightmap[route[i - 1].second][route[i - 1].first]);
+    cost += NewDijkstras::calculate_distance_between_nodes(diagonal, rise,
+                                                           pixelSize);
+  }
+  return cost;
+}
+
+// Rolling terrain: waves of the given amplitude across the columns and three
+// quarters of it down the rows, with up to a tenth of it in noise
+mempa::Raster2D<float> make_terrain(int cols, int rows, unsigned seed,
+                                    float amplitude) {
+  mempa::Raster2D<float> heightmap(cols, rows, {0, 0}, 0.0f);
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> noise(0.0f, amplitude / 10.0f);
+  for (int row = 0; row < rows; ++row) {
+    for (int col = 0; col < cols; ++col) {
+      heightmap[row][col] = amplitude * std::sin(col / 9.0f) +
+                            0.75f * amplitude * std::cos(row / 7.0f) +
+                            noise(rng);
+    }
+  }
+  return heightmap;
+}
+
+// Whether a route has more than one point, each a neighbour of the one before
+bool is_connected(const vector<pair<int, int>> &route) {
+  bool connected = route.size() > 1;
+  for (size_t i = 1; connected && i < route.size(); ++i) {
+    connected = std::abs(route[i].first - route[i - 1].first) <= 1 &&
+                std::abs(route[i].second - route[i - 1].second) <= 1;
+  }
+  return connected;
+}
+
+// Raise the square ring radius cells out from a cell into a wall no slope
+// limit lets a route cross, clipped to the map
+void wall_in(mempa::Raster2D<float> &heightmap, pair<int, int> cell,
+             int radius) {
+  for (int row = cell.second - radius; row <= cell.second + radius; ++row) {
+    for (int col = cell.first - radius; col <= cell.first + radius; ++col) {
+      const bool onRing = std::abs(row - cell.second) == radius ||
+                          std::abs(col - cell.first) == radius;
+      if (onRing && row >= 0 && row < heightmap.getYSize() && col >= 0 &&
+          col < heightmap.getXSize()) {
+        heightmap[row][col] = 1000.0f;
+      }
+    }
+  }
+}
+
+// Test 6: A* must find routes as cheap as Dijkstra's while expanding far
+// fewer cells, with and without the elevation term in its heuristic
+void test_astar_matches_dijkstra() {
+  const int cols = 64;
+  const int rows = 48;
+  const float maxSlope = 30.0f;
+  const float pixelSize = 10.0f;
+  mempa::Raster2D<float> heightmap = make_terrain(cols, rows, 11, 20.0f);
+  pair<int, int> start = {3, 40};
+  pair<int, int> end = {58, 6};
+
+  NewDijkstras dijkstra;
+  vector<pair<int, int>> dijkstraRoute = dijkstra.get_step(
+      heightmap.view(), {0, 0}, start, end, maxSlope, pixelSize);
+  const double dijkstraCost = route_cost(dijkstraRoute, heightmap, pixelSize);
+
+  bool passed = !dijkstraRoute.empty() && dijkstraRoute.back() == end;
+  for (bool useElevation : {true, false}) {
+    AStar astar(useElevation);
+    vector<pair<int, int>> astarRoute = astar.get_step(
+        heightmap.view(), {0, 0}, start, end, maxSlope, pixelSize);
+    cout << "  A*" << (useElevation ? " (elevation)" : " (flat)")
+         << " expanded " << astar.getExpansions() << " cells, Dijkstra's "
+         << dijkstra.getExpansions() << endl;
+    passed = passed && !astarRoute.empty() && astarRoute.front() == start &&
+             astarRoute.back() == end &&
+             std::abs(route_cost(astarRoute, heightmap, pixelSize) -
+                      dijkstraCost) < 1e-6 &&
+             astar.getExpansions() * 2 < dijkstra.getExpansions();
+  }
+  print_test_result("astar_matches_dijkstra", passed);
+  assert(passed && "astar_matches_dijkstra failed");
+}
+
+// Test 7: D* Lite must match Dijkstra's when the chunk is the whole map, and
+// its repaired plans must match fresh ones as the chunk follows the rover,
+// with repairs staying local once the estimate beyond the chunk is exact
+void test_dstar_lite_replanning() {
+  const int cols = 120;
+  const int rows = 90;
+  const int buffer = 15;
+  const float maxSlope = 30.0f;
+  const float pixelSize = 10.0f;
+  mempa::Raster2D<float> heightmap = make_terrain(cols, rows, 5, 25.0f);
+  const pair<int, int> origin = {4, 6};
+  const pair<int, int> end = {112, 80};
+
+  NewDijkstras dijkstra;
+  DStarLite whole;
+  whole.setRasterSize({cols, rows});
+  const double dijkstraCost = route_cost(
+      dijkstra.get_step(heightmap.view(), {0, 0}, origin, end, maxSlope,
+                        pixelSize),
+      heightmap, pixelSize);
+  vector<pair<int, int>> wholeRoute = whole.get_step(
+      heightmap.view(), {0, 0}, origin, end, maxSlope, pixelSize);
+  bool passed = !wholeRoute.empty() && wholeRoute.back() == end &&
+                std::abs(route_cost(wholeRoute, heightmap, pixelSize) -
+                         dijkstraCost) < 1e-6;
+
+  // Follow the rover chunk by chunk, checking each repaired plan against a
+  // fresh one and counting the cells both expand after the first chunk
+  mempa::CoarseCostField exactField;
+  exactField.build(heightmap.view(), end, maxSlope, pixelSize);
+  auto followRover = [&](const mempa::CoarseCostField *costField,
+                         size_t &repairedExpansions, size_t &freshExpansions) {
+    // Cost of a plan: its route, then the estimate from where it leaves
+    auto planCost = [&](const vector<pair<int, int>> &plan) {
+      const int dx = std::abs(end.first - plan.back().first);
+      const int dy = std::abs(end.second - plan.back().second);
+      const double flat = (std::max(dx, dy) - std::min(dx, dy) +
+                           std::min(dx, dy) * std::sqrt(2.0)) *
+                          pixelSize;
+      return route_cost(plan, heightmap, pixelSize) +
+             (costField != nullptr
+                  ? std::max(flat, costField->getCost(plan.back().first,
+                                                      plan.back().second))
+                  : flat);
+    };
+    DStarLite repaired;
+    repaired.setRasterSize({cols, rows});
+    repaired.set_cost_field(costField);
+    pair<int, int> start = origin;
+    bool followed = true;
+    repairedExpansions = 0;
+    freshExpansions = 0;
+    for (int step = 0; followed && start != end && step < 100; ++step) {
+      const int x0 = std::max(0, start.first - buffer);
+      const int y0 = std::max(0, start.second - buffer);
+      mempa::Raster2D<float> chunk(
+          std::min(cols, start.first + buffer + 1) - x0,
+          std::min(rows, start.second + buffer + 1) - y0, {x0, y0}, 0.0f);
+      for (int row = 0; row < chunk.getYSize(); ++row) {
+        for (int col = 0; col < chunk.getXSize(); ++col) {
+          chunk[row][col] = heightmap[row + y0][col + x0];
+        }
+      }
+      DStarLite fresh;
+      fresh.setRasterSize({cols, rows});
+      fresh.set_cost_field(costField);
+      vector<pair<int, int>> repairedPlan = repaired.get_step(
+          chunk.view(), {x0, y0}, start, end, maxSlope, pixelSize);
+      vector<pair<int, int>> freshPlan = fresh.get_step(
+          chunk.view(), {x0, y0}, start, end, maxSlope, pixelSize);
+      followed = repairedPlan.size() > 1 && !freshPlan.empty() &&
+                 std::abs(planCost(repairedPlan) - planCost(freshPlan)) <
+                     1e-6 * planCost(freshPlan);
+      if (step > 0) {
+        repairedExpansions += repaired.getExpansions();
+        freshExpansions += fresh.getExpansions();
+      }
+      if (followed) {
+        // Move a few cells so consecutive chunks mostly overlap
+        start = repairedPlan[std::min<size_t>(4, repairedPlan.size() - 1)];
+      }
+    }
+    return followed && start == end;
+  };
+  size_t flatRepaired = 0, flatFresh = 0, exactRepaired = 0, exactFresh = 0;
+  passed = passed && followRover(nullptr, flatRepaired, flatFresh) &&
+           followRover(&exactField, exactRepaired, exactFresh);
+  cout << "  Repairs expanded " << flatRepaired << " cells on flat ground, "
+       << exactRepaired << " with an exact estimate; fresh searches "
+       << flatFresh << " and " << exactFresh << endl;
+  passed = passed && exactRepaired * 2 < exactFresh;
+  print_test_result("dstar_lite_replanning", passed);
+  assert(passed && "dstar_lite_replanning failed");
+}
+
+// Test 8: One NewDijkstras reused over many searches, on chunks of different
+// shapes and past the point where its generations wrap, must route exactly
+// like a fresh one every time
+void test_dijkstras_reuse() {
+  const float maxSlope = 30.0f;
+  const float pixelSize = 10.0f;
+  std::mt19937 rng(13);
+  std::uniform_real_distribution<float> heights(0.0f, 9.0f);
+  std::uniform_int_distribution<int> sizes(3, 24);
+
+  NewDijkstras reused;
+  bool passed = true;
+  for (int search = 0; passed && search < 80; ++search) {
+    const int cols = sizes(rng);
+    const int rows = sizes(rng);
+    mempa::Raster2D<float> heightmap(cols, rows, {0, 0}, 0.0f);
+    for (int row = 0; row < rows; ++row) {
+      for (int col = 0; col < cols; ++col) {
+        heightmap[row][col] = heights(rng);
+      }
+    }
+    const pair<int, int> start = {std::uniform_int_distribution<int>(0, cols - 1)(rng),
+                                  std::uniform_int_distribution<int>(0, rows - 1)(rng)};
+    const pair<int, int> end = {cols - 1 - start.first, rows - 1 - start.second};
+
+    NewDijkstras fresh;
+    passed = reused.get_step(heightmap.view(), {0, 0}, start, end, maxSlope,
+                             pixelSize) ==
+                 fresh.get_step(heightmap.view(), {0, 0}, start, end,
+                                maxSlope, pixelSize) &&
+             reused.getExpansions() == fresh.getExpansions();
+  }
+  print_test_result("dijkstras_reuse", passed);
+  assert(passed && "dijkstras_reuse failed");
+}
+
+// Test 9: Bidirectional searches must route as cheaply as Dijkstra's between
+// two cells far apart in the middle of a chunk, expanding fewer cells, and
+// must agree with it when the start is walled in
+void test_bidirectional_search() {
+  const int cols = 200;
+  const int rows = 200;
+  const float maxSlope = 30.0f;
+  const float pixelSize = 10.0f;
+  mempa::Raster2D<float> heightmap = make_terrain(cols, rows, 17, 15.0f);
+  const pair<int, int> start = {50, 95};
+  const pair<int, int> end = {150, 105};
+
+  NewDijkstras dijkstra;
+  const double dijkstraCost = route_cost(
+      dijkstra.get_step(heightmap.view(), {0, 0}, start, end, maxSlope,
+                        pixelSize),
+      heightmap, pixelSize);
+  bool passed = true;
+  for (bool useHeuristic : {false, true}) {
+    BidirectionalSearch bidirectional(useHeuristic);
+    vector<pair<int, int>> route = bidirectional.get_step(
+        heightmap.view(), {0, 0}, start, end, maxSlope, pixelSize);
+    cout << "  Bidirectional" << (useHeuristic ? " A*" : " Dijkstra's")
+         << " expanded " << bidirectional.getExpansions()
+         << " cells, Dijkstra's " << dijkstra.getExpansions() << endl;
+    passed = passed && is_connected(route) && route.front() == start &&
+             route.back() == end &&
+             std::abs(route_cost(route, heightmap, pixelSize) - dijkstraCost) <
+                 1e-3 &&
+             bidirectional.getExpansions() * 3 < dijkstra.getExpansions() * 2;
+  }
+
+  // Wall the start in, which both ends must notice
+  wall_in(heightmap, start, 5);
+  BidirectionalSearch walledIn;
+  passed = passed && walledIn.get_step(heightmap.view(), {0, 0}, start, end,
+                                       maxSlope, pixelSize)
+                         .empty();
+  print_test_result("bidirectional_search", passed);
+  assert(passed && "bidirectional_search failed");
+}
+
+// Test 10: Delta-stepping must route as cheaply as Dijkstra's across a chunk
+// large enough that its buckets are split over the threads, with and without
+// heavy steps, must give the same route on one thread as on four, and must
+// find nothing when the start is walled in. Cliffs the 80 degree limit climbs
+// as heavy steps and the 30 degree one walks around make the two differ
+void test_delta_stepping() {
+  const int cols = 300;
+  const int rows = 300;
+  const float pixelSize = 10.0f;
+  mempa::Raster2D<float> heightmap = make_terrain(cols, rows, 23, 25.0f);
+  // 45 m cliffs, under 80 degrees but costing more than a bucket's width
+  const auto onCliff = [](pair<int, int> cell) {
+    return (cell.first == 100 || cell.first == 200) && cell.second < 270;
+  };
+  for (int row = 0; row < 270; ++row) {
+    heightmap[row][100] += 45.0f;
+    heightmap[row][200] += 45.0f;
+  }
+  const pair<int, int> start = {20, 150};
+  const pair<int, int> end = {280, 40};
+
+  bool passed = true;
+  std::size_t relaxations[2] = {};
+  for (float maxSlope : {30.0f, 80.0f}) {
+    NewDijkstras dijkstra;
+    const double dijkstraCost = route_cost(
+        dijkstra.get_step(heightmap.view(), {0, 0}, start, end, maxSlope,
+                          pixelSize),
+        heightmap, pixelSize);
+    DeltaStepping oneThread(1);
+    DeltaStepping fourThreads(4);
+    vector<pair<int, int>> route = oneThread.get_step(
+        heightmap.view(), {0, 0}, start, end, maxSlope, pixelSize);
+    cout << "  Delta-stepping at " << maxSlope << " degrees relaxed "
+         << oneThread.getExpansions() << " cells, Dijkstra's expanded "
+         << dijkstra.getExpansions() << endl;
+    const bool steep = maxSlope > 45.0f;
+    relaxations[steep] = oneThread.getExpansions();
+    bool climbed = false;
+    for (const auto &cell : route) {
+      climbed = climbed || onCliff(cell);
+    }
+    passed = passed && climbed == steep;
+    passed = passed && is_connected(route) && route.front() == start &&
+             route.back() == end &&
+             std::abs(route_cost(route, heightmap, pixelSize) - dijkstraCost) <
+                 1e-3 &&
+             fourThreads.get_step(heightmap.view(), {0, 0}, start, end,
+                                  maxSlope, pixelSize) == route;
+  }
+  passed = passed && relaxations[0] != relaxations[1];
+
+  // Wall the start in
+  wall_in(heightmap, start, 5);
+  DeltaStepping walledIn(4);
+  passed = passed && walledIn.get_step(heightmap.view(), {0, 0}, start, end,
+                                       30.0f, pixelSize)
+                         .empty();
+  print_test_result("delta_stepping", passed);
+  assert(passed && "delta_stepping failed");
+}
+
+// Test 11: Dial's bucket queue must route within rounding of Dijkstra's, the
+// same again when reused after stopping early and with its step costs worked
+// out per step, at a 90 degree limit where the cliffs are longer steps than
+// the ring holds, and find nothing when walled in. Cliffs the 90 degree limit climbs
+// and the 30 degree one walks around make the two searches differ
+void test_bucket_queue_search() {
+  const int cols = 160;
+  const int rows = 120;
+  const float pixelSize = 10.0f;
+  mempa::Raster2D<float> heightmap = make_terrain(cols, rows, 29, 20.0f);
+  const auto onCliff = [](pair<int, int> cell) {
+    return (cell.first == 50 || cell.first == 100) && cell.second < 100;
+  };
+  for (int row = 0; row < 100; ++row) {
+    heightmap[row][50] += 45.0f;
+    heightmap[row][100] += 45.0f;
+  }
+  const pair<int, int> start = {5, 60};
+  const pair<int, int> end = {150, 20};
+
+  bool passed = true;
+  BucketQueueSearch dial;
+  BucketQueueSearch perStep;
+  perStep.set_precompute_edges(false);
+  std::size_t expansions[2] = {};
+  for (float maxSlope : {30.0f, 90.0f}) {
+    NewDijkstras dijkstra;
+    const double dijkstraCost = route_cost(
+        dijkstra.get_step(heightmap.view(), {0, 0}, start, end, maxSlope,
+                          pixelSize),
+        heightmap, pixelSize);
+    for (int run = 0; run < 2; ++run) {
+      vector<pair<int, int>> route = dial.get_step(
+          heightmap.view(), {0, 0}, start, end, maxSlope, pixelSize);
+      passed = passed && is_connected(route) && route.front() == start &&
+               route.back() == end &&
+               std::abs(route_cost(route, heightmap, pixelSize) -
+                        dijkstraCost) <= 1e-3 * dijkstraCost &&
+               perStep.get_step(heightmap.view(), {0, 0}, start, end,
+                                maxSlope, pixelSize) == route;
+      bool climbed = false;
+      for (const auto &cell : route) {
+        climbed = climbed || onCliff(cell);
+      }
+      passed = passed && climbed == (maxSlope > 45.0f);
+    }
+    cout << "  Dial's at " << maxSlope << " degrees expanded "
+         << dial.getExpansions() << " cells, Dijkstra's "
+         << dijkstra.getExpansions() << endl;
+    expansions[maxSlope > 45.0f] = dial.getExpansions();
+  }
+  passed = passed && expansions[0] != expansions[1];
+
+  // Wall the start in
+  wall_in(heightmap, start, 5);
+  passed = passed && dial.get_step(heightmap.view(), {0, 0}, start, end,
+                                   30.0f, pixelSize)
+                         .empty();
+  print_test_result("bucket_queue_search", passed);
+  assert(passed && "bucket_queue_search failed");
+}
+
+// Test 12: Masks built from precomputed slope codes must agree bit for bit with
+// the search's own slope check, including tolerances that fall exactly on a
+// step's slope, for a chunk inside the raster, and Dijkstra's must route the
+// same with and without them
+void test_slope_raster_masks() {
+  const int cols = 140;
+  const int rows = 110;
+  const float pixelSize = 10.0f;
+  mempa::Raster2D<float> heightmap = make_terrain(cols, rows, 31, 25.0f);
+  heightmap[40][40] = NAN;
+  const mempa::SlopeRaster slopeCodes(heightmap.view(), pixelSize);
+
+  // The slope of one step exactly, so its code equals the tolerance's
+  const double exactSlope = NewDijkstras::step_slope(
+      std::abs(heightmap[20][20] - heightmap[20][21]), false, pixelSize);
+
+  // A chunk away from the raster's corner
+  const mempa::RasterView<const float> chunk(&heightmap[10][15], 100, 90,
+                                             cols, {15, 10});
+
+  bool passed = true;
+  mempa::Raster2D<std::uint8_t> mask;
+  for (float maxSlope :
+       {0.0f, 12.5f, 30.0f, 45.25f, 90.0f, static_cast<float>(exactSlope)}) {
+    slopeCodes.traversability(chunk, maxSlope, mask);
+    passed = passed && mask.getOrigin() == chunk.getOrigin();
+    for (int row = 0; row < chunk.getYSize(); ++row) {
+      for (int col = 0; col < chunk.getXSize(); ++col) {
+        for (int i = 0; i < 8; ++i) {
+          const int neighborRow = row + NewDijkstras::ROW_STEPS[i];
+          const int neighborCol = col + NewDijkstras::COL_STEPS[i];
+          bool expected = false;
+          if (neighborRow >= 0 && neighborRow < chunk.getYSize() &&
+              neighborCol >= 0 && neighborCol < chunk.getXSize()) {
+            const bool diagonal = NewDijkstras::ROW_STEPS[i] != 0 &&
+                                  NewDijkstras::COL_STEPS[i] != 0;
+            const double rise =
+                std::abs(chunk[row][col] - chunk[neighborRow][neighborCol]);
+            expected = NewDijkstras::step_navigable(rise, diagonal, maxSlope,
+                                                    pixelSize);
+          }
+          passed = passed && (((mask[row][col] >> i) & 1) != 0) == expected;
+        }
+      }
+    }
+
+    NewDijkstras plain;
+    NewDijkstras masked;
+    masked.setTraversability(mask.view());
+    passed = passed && plain.get_step(chunk, chunk.getOrigin(), {20, 15},
+                                      {105, 90}, maxSlope, pixelSize) ==
+                           masked.get_step(chunk, chunk.getOrigin(), {20, 15},
+                                           {105, 90}, maxSlope, pixelSize);
+  }
+
+  // Chunks reaching past the raster are rejected
+  bool rejected = false;
+  try {
+    slopeCodes.traversability(
+        mempa::RasterView<const float>(&heightmap[0][0], 10, 10, cols,
+                                       {cols - 5, 0}),
+        30.0f, mask);
+  } catch (const std::out_of_range &) {
+    rejected = true;
+  }
+  passed = passed && rejected;
+  print_test_result("slope_raster_masks", passed);
+  assert(passed && "slope_raster_masks failed");
+}
+
+// Test 13: The edge pass must give every step the slope check the search makes
+// itself and no step off the chunk, the same with AVX2 and without, including
+// at a tolerance exactly on a step's slope, next to NaN heights and at 0 and
+// 90 degrees, and Dijkstra's must route the same with and without it
+void test_edge_cost_kernel() {
+  const int cols = 67; // not a multiple of 4, so the vector pass has a tail
+  const int rows = 45;
+  const float pixelSize = 5.0f;
+  mempa::Raster2D<float> heightmap = make_terrain(cols, rows, 37, 10.0f);
+  heightmap[12][30] = NAN;
+  const double exactSlope = NewDijkstras::step_slope(
+      std::abs(heightmap[7][20] - heightmap[8][21]), true, pixelSize);
+
+  bool passed = true;
+  EdgeCostKernel vectorPass;
+  EdgeCostKernel scalarPass;
+  scalarPass.set_simd(false);
+  for (float maxSlope :
+       {0.0f, 20.0f, 35.5f, 90.0f, static_cast<float>(exactSlope)}) {
+    vectorPass.compute(heightmap.view(), maxSlope, pixelSize);
+    scalarPass.compute(heightmap.view(), maxSlope, pixelSize);
+    for (int row = 0; row < rows; ++row) {
+      for (int col = 0; col < cols; ++col) {
+        for (int i = 0; i < 8; ++i) {
+          const int neighborRow = row + NewDijkstras::ROW_STEPS[i];
+          const int neighborCol = col + NewDijkstras::COL_STEPS[i];
+          bool expected = false;
+          if (neighborRow >= 0 && neighborRow < rows && neighborCol >= 0 &&
+              neighborCol < cols) {
+            const bool diagonal = NewDijkstras::ROW_STEPS[i] != 0 &&
+                                  NewDijkstras::COL_STEPS[i] != 0;
+            const double rise = std::abs(heightmap[row][col] -
+                                         heightmap[neighborRow][neighborCol]);
+            expected = NewDijkstras::step_navigable(rise, diagonal, maxSlope,
+                                                    pixelSize);
+          }
+          passed = passed &&
+                   ((vectorPass.steps()[row][col] >> i) & 1) == expected &&
+                   ((scalarPass.steps()[row][col] >> i) & 1) == expected;
+        }
+      }
+    }
+
+    NewDijkstras precomputed;
+    NewDijkstras perStep;
+    perStep.set_precompute_edges(false);
+    passed = passed && precomputed.get_step(heightmap.view(), {0, 0}, {2, 3},
+                                            {60, 40}, maxSlope, pixelSize) ==
+                           perStep.get_step(heightmap.view(), {0, 0}, {2, 3},
+                                            {60, 40}, maxSlope, pixelSize);
+  }
+  cout << "  Edge slopes checked with "
+       << (vectorPass.uses_simd() ? "AVX2" : "scalar code only") << endl;
+  print_test_result("edge_cost_kernel", passed);
+  assert(passed && "edge_cost_kernel failed");
+}
+
+// Test 14: Given a traversability mask, Dijkstra's must route by it whether or
+// not it would precompute its own. A mask that closes a wall the slope limit
+// allows has to change the route and the work, and every other algorithm has
+// to route around the wall too
+void test_traversability_mask() {
+  const int cols = 67;
+  const int rows = 45;
+  const float pixelSize = 5.0f;
+  const float maxSlope = 30.0f;
+  mempa::Raster2D<float> heightmap = make_terrain(cols, rows, 41, 2.0f);
+  const mempa::SlopeRaster slopeCodes(heightmap.view(), pixelSize);
+  mempa::Raster2D<std::uint8_t> mask;
+  slopeCodes.traversability(heightmap.view(), maxSlope, mask);
+
+  // Close column 30 above row 40 by clearing every step into or out of it
+  const auto inWall = [](int row, int col) { return col == 30 && row < 40; };
+  for (int row = 0; row < rows; ++row) {
+    for (int col = 0; col < cols; ++col) {
+      for (int i = 0; i < 8; ++i) {
+        if (inWall(row, col) || inWall(row + NewDijkstras::ROW_STEPS[i],
+                                       col + NewDijkstras::COL_STEPS[i])) {
+          mask[row][col] &= static_cast<std::uint8_t>(~(1 << i));
+        }
+      }
+    }
+  }
+
+  bool passed = true;
+  NewDijkstras unmasked;
+  NewDijkstras precomputed;
+  NewDijkstras perStep;
+  precomputed.setTraversability(mask.view());
+  perStep.setTraversability(mask.view());
+  perStep.set_precompute_edges(false);
+  const auto open = unmasked.get_step(heightmap.view(), {0, 0}, {2, 3},
+                                      {60, 10}, maxSlope, pixelSize);
+  const auto walled = precomputed.get_step(heightmap.view(), {0, 0}, {2, 3},
+                                           {60, 10}, maxSlope, pixelSize);
+  passed = passed && walled == perStep.get_step(heightmap.view(), {0, 0},
+                                                {2, 3}, {60, 10}, maxSlope,
+                                                pixelSize);
+  passed = passed && !walled.empty() && walled != open &&
+           precomputed.getExpansions() != unmasked.getExpansions();
+  for (const auto &cell : walled) {
+    passed = passed && !inWall(cell.second, cell.first);
+  }
+  cout << "  Expansions without the wall: " << unmasked.getExpansions()
+       << ", with it: " << precomputed.getExpansions() << endl;
+
+  for (const char *name :
+       {"astar", "dstar", "bidijkstra", "biastar", "deltastep", "dial"}) {
+    std::unique_ptr<SearchAlgorithm> algorithm =
+        SearchAlgorithm::createAlgorithm(name);
+    algorithm->setTraversability(mask.view());
+    const auto route = algorithm->get_step(heightmap.view(), {0, 0}, {2, 3},
+                                           {60, 10}, maxSlope, pixelSize);
+    bool avoided = !route.empty() && route.back() == std::make_pair(60, 10);
+    for (const auto &cell : route) {
+      avoided = avoided && !inWall(cell.second, cell.first);
+    }
+    if (!avoided) {
+      cout << "  " << name << " ignored the mask" << endl;
+    }
+    passed = passed && avoided;
+  }
+  print_test_result("traversability_mask", passed);
+  assert(passed && "traversability_mask failed");
+}
+
+// Test 15: Landmark bounds must keep A*'s routes least cost while expanding no
+// more cells than A*, over the whole raster and a chunk inside it, fall back to
+// A* above the tables' slope limit, and find nothing when the goal is cut off
+void test_alt_search() {
+  const int cols = 120;
+  const int rows = 100;
+  const float pixelSize = 10.0f;
+  const float maxSlope = 30.0f;
+  mempa::Raster2D<float> heightmap = make_terrain(cols, rows, 41, 10.0f);
+  // Two cliffs with gaps at opposite ends, so routes wind between them
+  for (int row = 0; row < rows; ++row) {
+    if (row < rows - 12) {
+      heightmap[row][40] = 500.0f;
+    }
+    if (row >= 12) {
+      heightmap[row][80] = 500.0f;
+    }
+  }
+  const mempa::LandmarkTable landmarks(heightmap.view(), 6, maxSlope,
+                                       pixelSize);
+  const pair<int, int> start = {10, 10};
+  const pair<int, int> end = {110, 90};
+
+  bool passed = landmarks.getLandmarkCount() == 6;
+  AltSearch alt;
+  alt.set_landmarks(&landmarks);
+  // The whole raster, then a chunk away from its corner
+  const vector<mempa::RasterView<const float>> chunks = {
+      heightmap.view(), heightmap.view().subview(5, 4, 110, 92)};
+  for (const mempa::RasterView<const float> &chunk : chunks) {
+    NewDijkstras dijkstra;
+    AStar astar;
+    const double dijkstraCost =
+        route_cost(dijkstra.get_step(chunk, chunk.getOrigin(), start, end,
+                                     maxSlope, pixelSize),
+                   heightmap, pixelSize);
+    astar.get_step(chunk, chunk.getOrigin(), start, end, maxSlope, pixelSize);
+    const vector<pair<int, int>> route = alt.get_step(
+        chunk, chunk.getOrigin(), start, end, maxSlope, pixelSize);
+    passed = passed && alt.uses_landmarks() && !route.empty() &&
+             route.back() == end &&
+             std::abs(route_cost(route, heightmap, pixelSize) -
+                      dijkstraCost) <= 1e-4 * dijkstraCost &&
+             alt.getExpansions() <= astar.getExpansions();
+    cout << "  ALT expanded " << alt.getExpansions() << " cells, A* "
+         << astar.getExpansions() << ", Dijkstra's "
+         << dijkstra.getExpansions() << endl;
+  }
+
+  // Steeper steps than the tables allow for are not bounded by them
+  NewDijkstras steeper;
+  const double steeperCost =
+      route_cost(steeper.get_step(heightmap.view(), {0, 0}, start, end, 45.0f,
+                                  pixelSize),
+                 heightmap, pixelSize);
+  const vector<pair<int, int>> steeperRoute =
+      alt.get_step(heightmap.view(), {0, 0}, start, end, 45.0f, pixelSize);
+  passed = passed && !alt.uses_landmarks() &&
+           std::abs(route_cost(steeperRoute, heightmap, pixelSize) -
+                    steeperCost) <= 1e-9 * steeperCost;
+
+  // Close the second gap, cutting the goal off from the start
+  for (int row = 0; row < 12; ++row) {
+    heightmap[row][80] = 500.0f;
+  }
+  const mempa::LandmarkTable cutOff(heightmap.view(), 6, maxSlope, pixelSize);
+  alt.set_landmarks(&cutOff);
+  passed = passed && alt.get_step(heightmap.view(), {0, 0}, start, end,
+                                  maxSlope, pixelSize)
+                         .empty();
+  print_test_result("alt_search", passed);
+  assert(passed && "alt_search failed");
+}
+
+// Test 16: Searching a chunk held as 16-bit codes must give the same step
+// checks, routes and work as searching its decoded floats, with every algorithm
+// that reads heights, and the codes must be within half a step of the heights,
+// give or take float rounding
+void test_quantized_heightmap() {
+  const int cols = 67; // not a multiple of 4, so the vector pass has a tail
+  const int rows = 45;
+  const float pixelSize = 5.0f;
+  const float maxSlope = 30.0f;
+  mempa::Raster2D<float> heightmap = make_terrain(cols, rows, 43, 10.0f);
+  // A wall with a gap, so routes have to detour
+  for (int row = 8; row < rows; ++row) {
+    heightmap[row][33] = 100.0f;
+  }
+  heightmap[20][10] = NAN;
+
+  const mempa::ElevationCodec codec = mempa::ElevationCodec::fit(-20.0, 100.0);
+  mempa::Raster2D<std::int16_t> codes(cols, rows, {0, 0}, 0);
+  mempa::Raster2D<float> decoded(cols, rows, {0, 0}, 0.0f);
+  bool passed = true;
+  for (int row = 0; row < rows; ++row) {
+    for (int col = 0; col < cols; ++col) {
+      codes[row][col] = codec.encode(heightmap[row][col]);
+      decoded[row][col] = codec.decode(codes[row][col]);
+      passed = passed && (std::isnan(heightmap[row][col])
+                              ? std::isnan(decoded[row][col])
+                              : std::abs(decoded[row][col] -
+                                         heightmap[row][col]) <=
+                                    codec.getMaxError() + 1e-5f);
+    }
+  }
+  const mempa::ElevationView quantized(codes.view(), codec, codec.getMaxError());
+  passed = passed && quantized.isQuantized() &&
+           quantized.at(7, 11) == decoded[11][7];
+
+  EdgeCostKernel fromCodes;
+  EdgeCostKernel fromFloats;
+  EdgeCostKernel scalarFromCodes;
+  scalarFromCodes.set_simd(false);
+  fromCodes.compute(quantized, maxSlope, pixelSize);
+  fromFloats.compute(decoded.view(), maxSlope, pixelSize);
+  scalarFromCodes.compute(quantized, maxSlope, pixelSize);
+  for (int row = 0; row < rows; ++row) {
+    for (int col = 0; col < cols; ++col) {
+      passed = passed &&
+               fromCodes.steps()[row][col] == fromFloats.steps()[row][col] &&
+               scalarFromCodes.steps()[row][col] ==
+                   fromFloats.steps()[row][col];
+    }
+  }
+
+  const pair<int, int> start = {2, 3};
+  const pair<int, int> end = {60, 40};
+  const auto matches = [&](SearchAlgorithm &onCodes,
+                           SearchAlgorithm &onFloats) {
+    const vector<pair<int, int>> route = onCodes.get_step(
+        quantized, {0, 0}, start, end, maxSlope, pixelSize);
+    return !route.empty() && route.back() == end &&
+           route == onFloats.get_step(decoded.view(), {0, 0}, start, end,
+                                      maxSlope, pixelSize) &&
+           onCodes.getExpansions() == onFloats.getExpansions();
+  };
+  NewDijkstras dijkstra[2];
+  NewDijkstras perStep[2];
+  perStep[0].set_precompute_edges(false);
+  perStep[1].set_precompute_edges(false);
+  AStar astar[2];
+  BidirectionalSearch bidirectional[2];
+  BucketQueueSearch dial[2];
+  DeltaStepping deltaStepping[2] = {DeltaStepping(1), DeltaStepping(1)};
+  passed = passed && matches(dijkstra[0], dijkstra[1]) &&
+           matches(perStep[0], perStep[1]) && matches(astar[0], astar[1]) &&
+           matches(bidirectional[0], bidirectional[1]) &&
+           matches(dial[0], dial[1]) &&
+           matches(deltaStepping[0], deltaStepping[1]);
+  print_test_result("quantized_heightmap", passed);
+  assert(passed && "quantized_heightmap failed");
+}
+
+// Test 17: Landmark tables built from exact heights must not bound a quantized
+// chunk whose rounding opens steps the tables saw as too steep, and must still
+// bound it when their slope limit leaves room for the rounding
+void test_alt_quantized() {
+  const int cols = 60;
+  const int rows = 40;
+  const float pixelSize = 10.0f;
+  const float maxSlope = 30.0f;
+  mempa::Raster2D<float> heightmap(cols, rows, {0, 0}, 0.0f);
+  // A wall open only at the bottom row and through a one-cell gap, whose rise
+  // is just over the slope limit until its codes round it under. The crest is
+  // jagged so the tables cannot walk along it
+  for (int row = 0; row < rows - 1; ++row) {
+    heightmap[row][30] = 500.0f + 100.0f * (row % 2);
+  }
+  for (int col : {29, 31}) {
+    heightmap[9][col] = 700.0f;
+    heightmap[11][col] = 700.0f;
+  }
+  heightmap[10][30] = 5.7736f;
+
+  const mempa::ElevationCodec codec = mempa::ElevationCodec::fit(-20.0, 2000.0);
+  mempa::Raster2D<std::int16_t> codes(cols, rows, {0, 0}, 0);
+  mempa::Raster2D<float> decoded(cols, rows, {0, 0}, 0.0f);
+  for (int row = 0; row < rows; ++row) {
+    for (int col = 0; col < cols; ++col) {
+      codes[row][col] = codec.encode(heightmap[row][col]);
+      decoded[row][col] = codec.decode(codes[row][col]);
+    }
+  }
+  const mempa::ElevationView quantized(codes.view(), codec, codec.getMaxError());
+  const pair<int, int> start = {5, 10};
+  const pair<int, int> end = {55, 10};
+
+  NewDijkstras exact;
+  NewDijkstras dijkstra;
+  const double exactCost =
+      route_cost(exact.get_step(heightmap.view(), {0, 0}, start, end, maxSlope,
+                                pixelSize),
+                 heightmap, pixelSize);
+  const double dijkstraCost =
+      route_cost(dijkstra.get_step(quantized, {0, 0}, start, end, maxSlope,
+                                   pixelSize),
+                 decoded, pixelSize);
+  // The codes open the gap, so the quantized route is shorter
+  bool passed = dijkstraCost < 0.8 * exactCost;
+
+  const auto matches = [&](const mempa::LandmarkTable &landmarks,
+                           bool usesLandmarks) {
+    AltSearch alt;
+    alt.set_landmarks(&landmarks);
+    const vector<pair<int, int>> route =
+        alt.get_step(quantized, {0, 0}, start, end, maxSlope, pixelSize);
+    return alt.uses_landmarks() == usesLandmarks && !route.empty() &&
+           route.back() == end &&
+           std::abs(route_cost(route, decoded, pixelSize) - dijkstraCost) <=
+               1e-4 * dijkstraCost;
+  };
+  // Tables at the search's own limit would cut off the gap
+  passed = passed && matches(mempa::LandmarkTable(heightmap.view(), 6,
+                                                  maxSlope, pixelSize),
+                             false);
+  passed = passed && matches(mempa::LandmarkTable(heightmap.view(), 6, 45.0f,
+                                                  pixelSize),
+                             true);
+  print_test_result("alt_quantized", passed);
+  assert(passed && "alt_quantized failed");
+}
+
 int main() {
   cout << "Running Dijkstra's tests..." << endl;
   test_calc_flat_index();
   test_get_neighbor_indexs();
   test_dijkstras_simple();
+  test_dijkstras_optimal();
+  test_astar_matches_dijkstra();
+  test_dstar_lite_replanning();
+  test_dijkstras_reuse();
+  test_bidirectional_search();
+  test_delta_stepping();
+  test_bucket_queue_search();
+  test_slope_raster_masks();
+  test_edge_cost_kernel();
+  test_traversability_mask();
+  test_alt_search();
+  test_quantized_heightmap();
+  test_alt_quantized();
   // test_dijkstras_invalid_coords();
   cout << "All Dijkstra tests PASSED!" << endl;
   return 0;
@@ -0,0 +1,171 @@
+#include "../src/dem-handler/Raster2D.hpp"
+#include "../src/rover-pathfinding-module/BucketQueueSearch.hpp"
+#include "../src/rover-pathfinding-module/DeltaStepping.hpp"
+#include "../src/rover-pathfinding-module/NewDijkstras.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Times one corner to corner search over a synthetic chunk with Dijkstra's on
+// its heap, with and without its step slopes checked up front, with Dial's
+// bucket queue, then with delta-stepping on 1, 2, 4 and so on up to the given
+// number of threads, and checks every search finds the same cost. Delta-
+// stepping also reports how much of its relaxing was split over the pool, and
+// the speedup that share allows on each thread count, so a run on a machine
+// with few cores still shows how far the search can scale.
+
+namespace {
+constexpr int DEFAULT_CHUNK_SIZE = 4001;
+constexpr float MAX_SLOPE = 30.0f;
+constexpr float PIXEL_SIZE = 1.0f;
+
+// Rolling hills with some noise, steep enough in places to force detours
+mempa::Raster2D<float> make_heightmap(int size) {
+  mempa::Raster2D<float> heightmap(size, size, {0, 0}, 0.0f);
+  std::mt19937 generator(2025);
+  std::uniform_real_distribution<float> noise(0.0f, 0.2f);
+  for (int row = 0; row < size; ++row) {
+    for (int col = 0; col < size; ++col) {
+      heightmap[row][col] = 3.0f * std::sin(col / 17.0f) +
+                            2.5f * std::cos(row / 13.0f) + noise(generator);
+    }
+  }
+  return heightmap;
+}
+
+double route_cost(const std::vector<std::pair<int, int>> &route,
+                  const mempa::Raster2D<float> &heightmap) {
+  double cost = 0.0;
+  for (std::size_t i = 1; i < route.size(); ++i) {
+    const bool diagonal = route[i].first != route[i - 1].first &&
+                          route[i].second != route[i - 1].second;
+    const double rise =
+        std::abs(heightmap[route[i].second][route[i].first] -
+                 heightmap[route[i - 1].second][route[i - 1].first]);
+    cost += NewDijkstras::calculate_distance_between_nodes(diagonal, rise,
+                                                           PIXEL_SIZE);
+  }
+  return cost;
+}
+
+// Runs one search and returns its wall time in seconds
+double time_search(SearchAlgorithm &search,
+                   const mempa::Raster2D<float> &heightmap,
+                   std::vector<std::pair<int, int>> &route) {
+  const int last = heightmap.getXSize() - 1;
+  const auto startTime = std::chrono::steady_clock::now();
+  route = search.get_step(heightmap.view(), {0, 0}, {0, 0}, {last, last},
+                          MAX_SLOPE, PIXEL_SIZE);
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       startTime)
+      .count();
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " [Chunk Size] [Max Threads]\n";
+    return 1;
+  }
+  const int chunkSize = argc >= 2 ? std::stoi(argv[1]) : DEFAULT_CHUNK_SIZE;
+  const unsigned maxThreads =
+      argc == 3 ? static_cast<unsigned>(std::stoi(argv[2]))
+                : std::max(1u, std::thread::hardware_concurrency());
+
+  const mempa::Raster2D<float> heightmap = make_heightmap(chunkSize);
+  std::cout << "Chunk: " << chunkSize << "x" << chunkSize << " cells, "
+            << std::thread::hardware_concurrency() << " hardware threads\n";
+
+  std::vector<std::pair<int, int>> route;
+  NewDijkstras dijkstra;
+  const double dijkstraSeconds = time_search(dijkstra, heightmap, route);
+  if (route.empty()) {
+    std::cerr << "Dijkstra's found no route across the chunk\n";
+    return 1;
+  }
+  const double dijkstraCost = route_cost(route, heightmap);
+  std::cout << std::fixed << std::setprecision(3)
+            << "dijkstra      " << dijkstraSeconds << " s, "
+            << dijkstra.getExpansions() << " cells expanded, cost "
+            << dijkstraCost << (dijkstra.edge_costs().uses_simd()
+                                    ? ", AVX2 slope pass\n"
+                                    : ", scalar slope pass\n");
+
+  // The same search with the scalar slope pass, and with no pass at all,
+  // must take the same route
+  const std::vector<std::pair<int, int>> dijkstraRoute = route;
+  NewDijkstras scalarPass;
+  scalarPass.edge_costs().set_simd(false);
+  NewDijkstras perStep;
+  perStep.set_precompute_edges(false);
+  bool passed = true;
+  for (NewDijkstras *variant : {&scalarPass, &perStep}) {
+    const double seconds = time_search(*variant, heightmap, route);
+    const bool sameRoute = route == dijkstraRoute;
+    passed = passed && sameRoute;
+    std::cout << (variant == &scalarPass ? "  scalar pass " : "  per step    ")
+              << seconds << " s, " << seconds / dijkstraSeconds
+              << "x the time" << (sameRoute ? "" : ", ROUTE DIFFERS") << "\n";
+  }
+
+  // Dial's rounds each step to 1/1024 of a pixel, which moves the total by far
+  // less than a thousandth
+  BucketQueueSearch dial;
+  const double dialSeconds = time_search(dial, heightmap, route);
+  const double dialCost = route_cost(route, heightmap);
+  passed = passed && std::abs(dialCost - dijkstraCost) <= 1e-3 * dijkstraCost;
+  std::cout << "dial          " << dialSeconds << " s, "
+            << dial.getExpansions() << " cells expanded, cost " << dialCost
+            << ", " << dijkstraSeconds / dialSeconds << "x over Dijkstra's\n";
+
+  // Powers of two below the maximum, then the maximum itself
+  std::vector<unsigned> threadCounts;
+  for (unsigned threads = 1; threads < maxThreads; threads *= 2) {
+    threadCounts.push_back(threads);
+  }
+  threadCounts.push_back(maxThreads);
+
+  double oneThreadSeconds = 0.0;
+  double share = 0.0;
+  for (const unsigned threads : threadCounts) {
+    DeltaStepping deltaStepping(threads);
+    const double seconds = time_search(deltaStepping, heightmap, route);
+    if (threads == 1) {
+      oneThreadSeconds = seconds;
+    }
+    const double cost = route_cost(route, heightmap);
+    // Both searches add up float costs, so routes of equal cost can differ in
+    // the last bits once summed again in double
+    const bool sameCost = std::abs(cost - dijkstraCost) <= 1e-4 * dijkstraCost;
+    passed = passed && sameCost;
+    std::cout << "deltastep x" << std::setw(2) << threads << " " << seconds
+              << " s, " << oneThreadSeconds / seconds << "x over 1 thread, "
+              << dijkstraSeconds / seconds << "x over Dijkstra's"
+              << (sameCost ? "" : ", COST DIFFERS") << "\n";
+    if (threads == 1) {
+      share = deltaStepping.parallel_share();
+    }
+  }
+
+  // Amdahl's law on the relaxing alone; the bucket bookkeeping between phases
+  // also runs on one thread and costs a few percent more
+  std::cout << "deltastep relaxed " << 100.0 * share
+            << "% of its cells in phases split over the pool, so at most";
+  for (const unsigned threads : threadCounts) {
+    std::cout << " " << 1.0 / (1.0 - share + share / threads) << "x on "
+              << threads << (threads == threadCounts.back() ? "\n" : ",");
+  }
+
+  std::cout << (passed ? "Search benchmark PASSED" : "Search benchmark FAILED")
+            << std::endl;
+  return passed ? 0 : 1;
+}